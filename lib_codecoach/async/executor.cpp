@@ -0,0 +1,118 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// executor.cpp — Implementación del pool de hilos para corrutinas.
+
+#include "executor.h"
+
+#include "logging/logger.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cc::async {
+
+struct Executor::State {
+    std::mutex                        m;
+    std::condition_variable           cv;
+    std::deque<std::function<void()>> queue;
+    std::vector<std::thread>          threads;
+    bool                              stop{false};
+};
+
+namespace {
+
+thread_local Executor* t_current = nullptr;
+
+detail::Detached spawn_on(Executor& ex, Task<void> task) {
+    co_await ex.schedule();
+    try {
+        co_await std::move(task);
+    } catch (const std::exception& e) {
+        CC_LOG_ERROR(std::string("[ASYNC] spawned task threw: ") + e.what());
+    } catch (...) {
+        CC_LOG_ERROR("[ASYNC] spawned task threw unknown exception");
+    }
+}
+
+} // namespace
+
+Executor::Executor(std::size_t threads)
+    : state_(new State())
+{
+    if (threads == 0) {
+        const std::size_t hw = std::thread::hardware_concurrency();
+        threads = std::min<std::size_t>(4, std::max<std::size_t>(2, hw));
+    }
+
+    for (std::size_t i = 0; i < threads; ++i) {
+        state_->threads.emplace_back([this] {
+            t_current = this;
+            auto& st = *state_;
+            while (true) {
+                std::function<void()> fn;
+                {
+                    std::unique_lock<std::mutex> lk(st.m);
+                    st.cv.wait(lk, [&] { return st.stop || !st.queue.empty(); });
+                    if (st.queue.empty()) return; // stop + cola drenada
+                    fn = std::move(st.queue.front());
+                    st.queue.pop_front();
+                }
+                try {
+                    fn();
+                } catch (const std::exception& e) {
+                    CC_LOG_ERROR(std::string("[ASYNC] executor task threw: ") + e.what());
+                } catch (...) {
+                    CC_LOG_ERROR("[ASYNC] executor task threw unknown exception");
+                }
+            }
+        });
+    }
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        state_->stop = true;
+    }
+    state_->cv.notify_all();
+    for (auto& t : state_->threads) {
+        if (t.joinable()) t.join();
+    }
+    delete state_;
+}
+
+Executor& Executor::global() {
+    // Como los singletons de cc::http: nunca se destruye (hay corrutinas suspendidas que
+    // el hilo de I/O podría reencolar durante la salida del proceso).
+    static Executor* inst = new Executor();
+    return *inst;
+}
+
+Executor* Executor::current() noexcept {
+    return t_current;
+}
+
+void Executor::post(std::function<void()> fn) {
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        state_->queue.push_back(std::move(fn));
+    }
+    state_->cv.notify_one();
+}
+
+std::size_t Executor::threadCount() const noexcept {
+    return state_->threads.size();
+}
+
+void Executor::spawn(Task<void> task) {
+    spawn_on(*this, std::move(task));
+}
+
+} // namespace cc::async
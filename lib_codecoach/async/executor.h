@@ -0,0 +1,60 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// executor.h — Pool pequeño de hilos donde se reanudan las corrutinas del SDK.
+// Las corrutinas nunca bloquean estos hilos esperando red: quedan suspendidas mientras el
+// AsyncEngine hace la I/O y se reencolan aquí al completar.
+#ifndef LIB_CODECOACH_EXECUTOR_H
+#define LIB_CODECOACH_EXECUTOR_H
+
+#include "task.h"
+
+#include <coroutine>
+#include <cstddef>
+#include <functional>
+
+namespace cc::async {
+
+    class Executor {
+    public:
+        // threads = 0 => min(4, max(2, hardware_concurrency))
+        explicit Executor(std::size_t threads = 0);
+        ~Executor(); // drena la cola y une los hilos
+        Executor(const Executor&) = delete;
+        Executor& operator=(const Executor&) = delete;
+
+        // Executor compartido por defecto del SDK.
+        static Executor& global();
+
+        // Executor en cuyo hilo corre el código actual (nullptr si no es un hilo de Executor).
+        static Executor* current() noexcept;
+
+        void post(std::function<void()> fn);
+        void resume_later(std::coroutine_handle<> h) { post([h] { h.resume(); }); }
+
+        std::size_t threadCount() const noexcept;
+
+        // co_await ex.schedule();  => continúa en un hilo de este Executor
+        auto schedule() noexcept {
+            struct Awaiter {
+                Executor* ex;
+                bool await_ready() const noexcept { return Executor::current() == ex; }
+                void await_suspend(std::coroutine_handle<> h) { ex->resume_later(h); }
+                void await_resume() const noexcept {}
+            };
+            return Awaiter{this};
+        }
+
+        // Lanza una Task<void> en segundo plano sobre este Executor (fire and forget).
+        void spawn(Task<void> task);
+
+        struct State;
+
+    private:
+        State* state_;
+    };
+
+} // namespace cc::async
+
+#endif // LIB_CODECOACH_EXECUTOR_H
@@ -0,0 +1,124 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// http_awaitable.cpp — Awaiters sobre HttpClient::requestAsync y AsyncEngine::schedule.
+
+#include "http_awaitable.h"
+#include "executor.h"
+#include "http/async_engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace cc::async {
+
+using cc::http::HttpClient;
+using cc::http::HttpResponse;
+using cc::http::RequestControl;
+
+namespace {
+
+struct HttpAwaiter {
+    HttpClient&                                         client;
+    const std::string&                                  method;
+    const std::string&                                  url;
+    std::string&                                        body; // se mueve al request
+    const cc::http::HeaderMap& headers;
+    const RequestControl&                               ctl;
+    HttpResponse*                                       out; // vive en el frame de http_request
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> h) {
+        Executor* ex = Executor::current() ? Executor::current() : &Executor::global();
+        // El callback corre en el hilo de I/O: solo guardamos el resultado y reencolamos.
+        // Tras requestAsync() no se toca el awaiter: la corrutina puede reanudarse ya.
+        client.requestAsync(method, url, std::move(body), headers, std::nullopt,
+                            [out = out, ex, h](HttpResponse r) {
+                                *out = std::move(r);
+                                ex->resume_later(h);
+                            },
+                            ctl);
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct SleepAwaiter {
+    cc::time::Millis delay;
+
+    bool await_ready() const noexcept { return delay.count() <= 0; }
+
+    void await_suspend(std::coroutine_handle<> h) {
+        Executor* ex = Executor::current() ? Executor::current() : &Executor::global();
+        cc::http::AsyncEngine::instance().schedule(delay, [ex, h] { ex->resume_later(h); });
+    }
+
+    void await_resume() const noexcept {}
+};
+
+constexpr cc::time::Millis kSleepCancelPoll{50};
+
+// Un timer por tramo de hasta kSleepCancelPoll: entre tramos se mira el token
+void sleep_tick(Executor* ex, std::coroutine_handle<> h, cc::time::SteadyClock::time_point until,
+                cc::time::CancellationToken cancel, bool* completed) {
+    const auto now = cc::time::SteadyClock::now();
+    if (cancel.is_cancelled() || now >= until) {
+        *completed = !cancel.is_cancelled();
+        ex->resume_later(h);
+        return;
+    }
+    const auto step = std::min(kSleepCancelPoll, std::chrono::ceil<cc::time::Millis>(until - now));
+    cc::http::AsyncEngine::instance().schedule(step, [ex, h, until, cancel = std::move(cancel), completed]() mutable {
+        sleep_tick(ex, h, until, std::move(cancel), completed);
+    });
+}
+
+struct CancellableSleepAwaiter {
+    cc::time::Millis            delay;
+    cc::time::CancellationToken cancel;
+    bool*                       completed; // vive en el frame de sleep_for
+
+    bool await_ready() const noexcept { return delay.count() <= 0 || cancel.is_cancelled(); }
+
+    void await_suspend(std::coroutine_handle<> h) {
+        Executor* ex = Executor::current() ? Executor::current() : &Executor::global();
+        sleep_tick(ex, h, cc::time::SteadyClock::now() + delay, cancel, completed);
+    }
+
+    void await_resume() const noexcept {}
+};
+
+} // namespace
+
+Task<HttpResponse> http_request(HttpClient& client,
+                                std::string method,
+                                std::string url,
+                                std::string body,
+                                cc::http::HeaderMap headers,
+                                RequestControl ctl)
+{
+    // El resultado se guarda fuera del awaiter: GCC puede copiar el temporal del awaiter
+    // y un puntero a él capturado en el callback quedaría colgando.
+    HttpResponse result;
+    co_await HttpAwaiter{client, method, url, body, headers, ctl, &result};
+    if (result.error) std::rethrow_exception(result.error);
+    co_return result;
+}
+
+Task<void> sleep_for(cc::time::Millis delay) {
+    co_await SleepAwaiter{delay};
+}
+
+Task<bool> sleep_for(cc::time::Millis delay, cc::time::CancellationToken cancel) {
+    bool completed = !cancel.is_cancelled(); // si no llega a suspender
+    co_await CancellableSleepAwaiter{delay, std::move(cancel), &completed};
+    co_return completed;
+}
+
+} // namespace cc::async
@@ -0,0 +1,41 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// http_awaitable.h — Puente entre HttpClient::requestAsync y las corrutinas: la corrutina queda
+// suspendida durante la I/O (sin ocupar hilo) y se reanuda en un Executor al completar.
+// sleep_for() usa la cola de timers del mismo AsyncEngine.
+#ifndef LIB_CODECOACH_HTTP_AWAITABLE_H
+#define LIB_CODECOACH_HTTP_AWAITABLE_H
+
+#include "task.h"
+#include "http/http_client.h"
+#include "metrics/timer.h"
+
+#include <string>
+
+namespace cc::async {
+
+    // co_await http_request(client, "GET", url) -> HttpResponse
+    // Respeta ctl.cancel (status 499) y ctl.deadline (timeouts recortados, sin reintentos
+    // que no quepan). Reanuda en el Executor actual o, si no hay, en Executor::global().
+    // `client` debe sobrevivir hasta que la Task termine.
+    Task<cc::http::HttpResponse> http_request(cc::http::HttpClient& client,
+                                              std::string method,
+                                              std::string url,
+                                              std::string body = {},
+                                              cc::http::HeaderMap headers = {},
+                                              cc::http::RequestControl ctl = {});
+
+    // co_await sleep_for(delay): espera sin ocupar un hilo (timer del AsyncEngine) y reanuda
+    // en el Executor actual o, si no hay, en Executor::global().
+    Task<void> sleep_for(cc::time::Millis delay);
+
+    // Igual, pero despierta antes si se cancela `cancel` (revisado cada ~50 ms, como las
+    // transferencias cancelables del AsyncEngine). true si completó la espera, false si se
+    // canceló (mismo contrato que cc::time::sleep_for).
+    Task<bool> sleep_for(cc::time::Millis delay, cc::time::CancellationToken cancel);
+
+} // namespace cc::async
+
+#endif // LIB_CODECOACH_HTTP_AWAITABLE_H
@@ -0,0 +1,163 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// task.h — Task<T>: corrutina C++20 perezosa (arranca al hacer co_await) con transferencia
+// simétrica al continuador. Más sync_wait() para consumir una Task desde código bloqueante.
+#ifndef LIB_CODECOACH_TASK_H
+#define LIB_CODECOACH_TASK_H
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace cc::async {
+
+    template <typename T = void>
+    class Task;
+
+    namespace detail {
+
+        struct PromiseBase {
+            std::coroutine_handle<> continuation{};
+            std::exception_ptr      error{};
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            struct FinalAwaiter {
+                bool await_ready() const noexcept { return false; }
+                template <typename P>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+                    auto c = h.promise().continuation;
+                    return c ? c : std::noop_coroutine();
+                }
+                void await_resume() const noexcept {}
+            };
+            FinalAwaiter final_suspend() noexcept { return {}; }
+
+            void unhandled_exception() noexcept { error = std::current_exception(); }
+        };
+
+        template <typename T>
+        struct Promise : PromiseBase {
+            std::optional<T> value{};
+
+            Task<T> get_return_object() noexcept;
+
+            template <typename U>
+            void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+
+            T take() {
+                if (error) std::rethrow_exception(error);
+                return std::move(*value);
+            }
+        };
+
+        template <>
+        struct Promise<void> : PromiseBase {
+            Task<void> get_return_object() noexcept;
+            void return_void() noexcept {}
+            void take() {
+                if (error) std::rethrow_exception(error);
+            }
+        };
+
+    } // namespace detail
+
+    template <typename T>
+    class [[nodiscard]] Task {
+    public:
+        using promise_type = detail::Promise<T>;
+        using handle_type  = std::coroutine_handle<promise_type>;
+
+        Task() noexcept = default;
+        explicit Task(handle_type h) noexcept : h_(h) {}
+        Task(Task&& o) noexcept : h_(std::exchange(o.h_, {})) {}
+        Task& operator=(Task&& o) noexcept {
+            if (this != &o) {
+                if (h_) h_.destroy();
+                h_ = std::exchange(o.h_, {});
+            }
+            return *this;
+        }
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+        ~Task() { if (h_) h_.destroy(); }
+
+        bool valid() const noexcept { return static_cast<bool>(h_); }
+
+        auto operator co_await() && noexcept {
+            struct Awaiter {
+                handle_type h;
+                // Una Task vacía (default o movida) no tiene resultado que esperar
+                bool await_ready() const {
+                    if (!h) throw std::logic_error("co_await on an empty Task");
+                    return h.done();
+                }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> cont) noexcept {
+                    h.promise().continuation = cont;
+                    return h; // arrancar la Task (transferencia simétrica)
+                }
+                T await_resume() { return h.promise().take(); }
+            };
+            return Awaiter{h_};
+        }
+        auto operator co_await() & noexcept { return std::move(*this).operator co_await(); }
+
+    private:
+        handle_type h_{};
+    };
+
+    namespace detail {
+        template <typename T>
+        Task<T> Promise<T>::get_return_object() noexcept {
+            return Task<T>{std::coroutine_handle<Promise<T>>::from_promise(*this)};
+        }
+        inline Task<void> Promise<void>::get_return_object() noexcept {
+            return Task<void>{std::coroutine_handle<Promise<void>>::from_promise(*this)};
+        }
+
+        // Corrutina "fire and forget": arranca de inmediato y se autodestruye al terminar.
+        struct Detached {
+            struct promise_type {
+                Detached get_return_object() noexcept { return {}; }
+                std::suspend_never initial_suspend() noexcept { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() noexcept {}
+                void unhandled_exception() noexcept { std::terminate(); }
+            };
+        };
+
+        template <typename T>
+        Detached run_into_promise(Task<T> task, std::shared_ptr<std::promise<T>> out) {
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    co_await std::move(task);
+                    out->set_value();
+                } else {
+                    out->set_value(co_await std::move(task));
+                }
+            } catch (...) {
+                out->set_exception(std::current_exception());
+            }
+        }
+    } // namespace detail
+
+    // Bloquea el hilo actual hasta que la Task termine (para main(), tests, GUI workers).
+    // No llamar desde un hilo del Executor que la Task necesita para avanzar.
+    template <typename T>
+    T sync_wait(Task<T> task) {
+        auto p = std::make_shared<std::promise<T>>();
+        auto f = p->get_future();
+        detail::run_into_promise(std::move(task), p);
+        return f.get();
+    }
+
+} // namespace cc::async
+
+#endif // LIB_CODECOACH_TASK_H
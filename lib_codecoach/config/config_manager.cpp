@@ -9,10 +9,52 @@
 
 //   CODECOACH_HTTP_TIMEOUT_MS (default: 10000, rango [100, 120000])
 //   CODECOACH_HTTP_RETRIES    (default: 2,     rango [0, 10])
+//   CODECOACH_HTTP_POOL_SIZE  (default: 8,     rango [0, 256]; 0 desactiva el pool)
+//   CODECOACH_HTTP_POOL_IDLE_MS (default: 60000, rango [1000, 600000])
+//   CODECOACH_HTTP_VERSION    (default: 1.1; valores: 1.1 | 2 | h2c)
+//   CODECOACH_HTTP_COMPRESS_MIN_BYTES (default: 0, rango [0, 67108864]; 0 no comprime requests)
+//   CODECOACH_HTTP_BREAKER_FAILURE_PCT (default: 50, rango [0, 100]; 0 desactiva el circuit breaker)
+//   CODECOACH_HTTP_BREAKER_MIN_CALLS   (default: 20, rango [1, 100000])
+//   CODECOACH_HTTP_BREAKER_OPEN_MS     (default: 5000, rango [100, 600000])
+//   CODECOACH_HTTP_BREAKER_SLOW_MS     (default: 0, rango [0, 600000]; 0 no mide latencia)
+//   CODECOACH_HTTP_RETRY_BUDGET_PCT    (default: 20, rango [0, 100])
+//   CODECOACH_HTTP_RETRY_BUDGET_MIN_PER_SEC (default: 5, rango [0, 10000])
+//   CODECOACH_HTTP_HEDGE_PERCENTILE    (default: 0, 0 o rango [50, 99]; p.ej. 95 activa el hedging)
+//   CODECOACH_HTTP_CACHE_MAX_BYTES     (default: 8388608, rango [0, 1073741824]; 0 desactiva la caché)
+//   CODECOACH_HTTP_CACHE_DIR           (default: vacío = caché solo en memoria)
+//   CODECOACH_HTTP_RATE_LIMIT_QPS      (default: 0, rango [0, 100000]; 0 sin límite de tasa por origen)
+//   CODECOACH_HTTP_RATE_LIMIT_BURST    (default: 0, rango [0, 100000]; 0 = igual a la tasa)
+//   CODECOACH_HTTP_MAX_IN_FLIGHT       (default: 0, rango [0, 10000]; 0 sin límite de concurrencia)
+//   CODECOACH_HTTP_ADAPTIVE_CONCURRENCY (default: 1; 0 | 1, AIMD bajo el límite de concurrencia)
+//   CODECOACH_ANALYZER_QPS / CODECOACH_ANALYZER_MAX_IN_FLIGHT (default: 0 = límites generales)
+//   CODECOACH_LLM_QPS / CODECOACH_LLM_MAX_IN_FLIGHT           (default: 0 = límites generales)
+//   CODECOACH_HTTP_BACKOFF             (default: decorrelated; valores: exponential | decorrelated)
+//   CODECOACH_HTTP_RETRY_AFTER_MAX_MS  (default: 30000, rango [0, 600000]; 0 ignora Retry-After)
+//   CODECOACH_HTTP_PREWARM             (default: 0, rango [0, 16]; conexiones por servicio abiertas
+//                                       en segundo plano al cargar la config; 0 no precalienta)
+//   CODECOACH_HTTP_ADAPTIVE_TIMEOUTS   (default: 0; 0 | 1, timeouts derivados del p99 por endpoint)
+//   CODECOACH_HTTP_ADAPTIVE_TIMEOUT_MULT     (default: 4, rango [2, 20]; timeout = N * p99)
+//   CODECOACH_HTTP_ADAPTIVE_TIMEOUT_FLOOR_MS (default: 1000, rango [50, 600000])
+
+//   CODECOACH_LLM_CACHE_MAX_BYTES      (default: 4194304, rango [0, 1073741824]; 0 desactiva la caché)
+//   CODECOACH_LLM_CACHE_DIR            (default: vacío = caché de respuestas solo en memoria)
+//   CODECOACH_LLM_CACHE_TTL_S          (default: 604800, rango [0, 31536000]; 0 no vence)
+//   CODECOACH_LLM_CACHE_DISK_MAX_BYTES (default: 268435456, rango [65536, 2147483647])
+//   CODECOACH_TOKENIZER_DIR            (default: vacío; directorio con cl100k_base.tiktoken /
+//                                       o200k_base.tiktoken; sin él los tokens se estiman)
+//   CODECOACH_LLM_BATCH_WINDOW_MS      (default: 5, rango [0, 1000]; 0 desactiva el batching)
+//   CODECOACH_LLM_BATCH_MAX            (default: 8, rango [1, 64])
+
+//   CODECOACH_EVAL_CACHE_MAX_BYTES      (default: 0, rango [0, 1073741824]; 0 desactiva la memoización)
+//   CODECOACH_EVAL_CACHE_DIR            (default: vacío = resultados memoizados solo en memoria)
+//   CODECOACH_EVAL_CACHE_TTL_S          (default: 2592000, rango [0, 31536000]; 0 no vence)
+//   CODECOACH_EVAL_CACHE_DISK_MAX_BYTES (default: 268435456, rango [65536, 2147483647])
+//   CODECOACH_EVAL_CACHE_NORMALIZE      (default: 0; 0 | 1, la clave ignora espacios y comentarios)
 
 
 #include "config_manager.h"
 #include "errors/exceptions.h"
+#include "http/http_client.h"
 
 #include <cstdlib>   // std::getenv
 #include <cctype>    // std::isdigit
@@ -86,6 +128,22 @@ namespace cc::config {
         return value;
     }
 
+    // Parsea CODECOACH_HTTP_VERSION. Lanza ConfigError si no es un valor conocido.
+    static HttpVersion parse_http_version_or_throw(const std::string& raw) {
+        if (raw == "1.1") return HttpVersion::Http1_1;
+        if (raw == "2")   return HttpVersion::Http2;
+        if (raw == "h2c") return HttpVersion::Http2PriorKnowledge;
+        throw ConfigError("Invalid value for env var CODECOACH_HTTP_VERSION: '" + raw +
+                          "' (expected 1.1, 2 or h2c)");
+    }
+
+    static RetryBackoff parse_backoff_or_throw(const std::string& raw) {
+        if (raw == "exponential")  return RetryBackoff::Exponential;
+        if (raw == "decorrelated") return RetryBackoff::Decorrelated;
+        throw ConfigError("Invalid value for env var CODECOACH_HTTP_BACKOFF: '" + raw +
+                          "' (expected exponential or decorrelated)");
+    }
+
     // Carga la config desde el entorno o usa defaults.
     static Config make_from_env_or_default() {
         Config cfg{};
@@ -131,11 +189,149 @@ namespace cc::config {
                     tRaw, 100, 120000, "CODECOACH_HTTP_TIMEOUT_MS");
             cfg.http.retries = parse_int_or_throw(
                     rRaw, 0, 10, "CODECOACH_HTTP_RETRIES");
+
+            std::string pRaw =
+                getenv_or("CODECOACH_HTTP_POOL_SIZE", "8");
+            std::string iRaw =
+                getenv_or("CODECOACH_HTTP_POOL_IDLE_MS", "60000");
+
+            cfg.http.poolMaxIdlePerHost = parse_int_or_throw(
+                    pRaw, 0, 256, "CODECOACH_HTTP_POOL_SIZE");
+            cfg.http.poolIdleTimeoutMs = parse_int_or_throw(
+                    iRaw, 1000, 600000, "CODECOACH_HTTP_POOL_IDLE_MS");
+
+            cfg.http.version = parse_http_version_or_throw(
+                    getenv_or("CODECOACH_HTTP_VERSION", "1.1"));
+
+            std::string cRaw =
+                getenv_or("CODECOACH_HTTP_COMPRESS_MIN_BYTES", "0");
+            cfg.http.compressMinBytes = parse_int_or_throw(
+                    cRaw, 0, 64 * 1024 * 1024, "CODECOACH_HTTP_COMPRESS_MIN_BYTES");
+
+            cfg.http.breakerFailurePct = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_BREAKER_FAILURE_PCT", "50"),
+                    0, 100, "CODECOACH_HTTP_BREAKER_FAILURE_PCT");
+            cfg.http.breakerMinCalls = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_BREAKER_MIN_CALLS", "20"),
+                    1, 100000, "CODECOACH_HTTP_BREAKER_MIN_CALLS");
+            cfg.http.breakerOpenMs = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_BREAKER_OPEN_MS", "5000"),
+                    100, 600000, "CODECOACH_HTTP_BREAKER_OPEN_MS");
+            cfg.http.breakerSlowCallMs = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_BREAKER_SLOW_MS", "0"),
+                    0, 600000, "CODECOACH_HTTP_BREAKER_SLOW_MS");
+            cfg.http.retryBudgetPct = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_RETRY_BUDGET_PCT", "20"),
+                    0, 100, "CODECOACH_HTTP_RETRY_BUDGET_PCT");
+            cfg.http.retryBudgetMinPerSec = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_RETRY_BUDGET_MIN_PER_SEC", "5"),
+                    0, 10000, "CODECOACH_HTTP_RETRY_BUDGET_MIN_PER_SEC");
+
+            cfg.http.hedgePercentile = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_HEDGE_PERCENTILE", "0"),
+                    0, 99, "CODECOACH_HTTP_HEDGE_PERCENTILE");
+            if (cfg.http.hedgePercentile != 0 && cfg.http.hedgePercentile < 50) {
+                throw ConfigError("Env var CODECOACH_HTTP_HEDGE_PERCENTILE must be 0 or between 50 and 99: " +
+                                  std::to_string(cfg.http.hedgePercentile));
+            }
+
+            cfg.http.cacheMaxBytes = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_CACHE_MAX_BYTES", "8388608"),
+                    0, 1024 * 1024 * 1024, "CODECOACH_HTTP_CACHE_MAX_BYTES");
+            cfg.http.cacheDir = getenv_or("CODECOACH_HTTP_CACHE_DIR", "");
+
+            cfg.http.rateLimitQps = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_RATE_LIMIT_QPS", "0"),
+                    0, 100000, "CODECOACH_HTTP_RATE_LIMIT_QPS");
+            cfg.http.rateLimitBurst = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_RATE_LIMIT_BURST", "0"),
+                    0, 100000, "CODECOACH_HTTP_RATE_LIMIT_BURST");
+            cfg.http.maxInFlight = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_MAX_IN_FLIGHT", "0"),
+                    0, 10000, "CODECOACH_HTTP_MAX_IN_FLIGHT");
+            cfg.http.adaptiveConcurrency = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_ADAPTIVE_CONCURRENCY", "1"),
+                    0, 1, "CODECOACH_HTTP_ADAPTIVE_CONCURRENCY") == 1;
+            cfg.http.analyzerQps = parse_int_or_throw(
+                    getenv_or("CODECOACH_ANALYZER_QPS", "0"),
+                    0, 100000, "CODECOACH_ANALYZER_QPS");
+            cfg.http.analyzerMaxInFlight = parse_int_or_throw(
+                    getenv_or("CODECOACH_ANALYZER_MAX_IN_FLIGHT", "0"),
+                    0, 10000, "CODECOACH_ANALYZER_MAX_IN_FLIGHT");
+            cfg.http.llmQps = parse_int_or_throw(
+                    getenv_or("CODECOACH_LLM_QPS", "0"),
+                    0, 100000, "CODECOACH_LLM_QPS");
+            cfg.http.llmMaxInFlight = parse_int_or_throw(
+                    getenv_or("CODECOACH_LLM_MAX_IN_FLIGHT", "0"),
+                    0, 10000, "CODECOACH_LLM_MAX_IN_FLIGHT");
+
+            cfg.http.backoff = parse_backoff_or_throw(
+                    getenv_or("CODECOACH_HTTP_BACKOFF", "decorrelated"));
+            cfg.http.retryAfterMaxMs = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_RETRY_AFTER_MAX_MS", "30000"),
+                    0, 600000, "CODECOACH_HTTP_RETRY_AFTER_MAX_MS");
+            cfg.http.prewarmConnections = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_PREWARM", "0"),
+                    0, 16, "CODECOACH_HTTP_PREWARM");
+
+            cfg.http.adaptiveTimeouts = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_ADAPTIVE_TIMEOUTS", "0"),
+                    0, 1, "CODECOACH_HTTP_ADAPTIVE_TIMEOUTS") == 1;
+            cfg.http.adaptiveTimeoutMultiplier = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_ADAPTIVE_TIMEOUT_MULT", "4"),
+                    2, 20, "CODECOACH_HTTP_ADAPTIVE_TIMEOUT_MULT");
+            cfg.http.adaptiveTimeoutFloorMs = parse_int_or_throw(
+                    getenv_or("CODECOACH_HTTP_ADAPTIVE_TIMEOUT_FLOOR_MS", "1000"),
+                    50, 600000, "CODECOACH_HTTP_ADAPTIVE_TIMEOUT_FLOOR_MS");
         }
 
+        // LLM
+        cfg.llm.cacheMaxBytes = parse_int_or_throw(
+                getenv_or("CODECOACH_LLM_CACHE_MAX_BYTES", "4194304"),
+                0, 1024 * 1024 * 1024, "CODECOACH_LLM_CACHE_MAX_BYTES");
+        cfg.llm.cacheDir = getenv_or("CODECOACH_LLM_CACHE_DIR", "");
+        cfg.llm.cacheTtlSec = parse_int_or_throw(
+                getenv_or("CODECOACH_LLM_CACHE_TTL_S", "604800"),
+                0, 365 * 24 * 3600, "CODECOACH_LLM_CACHE_TTL_S");
+        cfg.llm.cacheDiskMaxBytes = parse_int_or_throw(
+                getenv_or("CODECOACH_LLM_CACHE_DISK_MAX_BYTES", "268435456"),
+                64 * 1024, 2147483647, "CODECOACH_LLM_CACHE_DISK_MAX_BYTES");
+        cfg.llm.tokenizerDir = getenv_or("CODECOACH_TOKENIZER_DIR", "");
+        cfg.llm.batchWindowMs = parse_int_or_throw(
+                getenv_or("CODECOACH_LLM_BATCH_WINDOW_MS", "5"),
+                0, 1000, "CODECOACH_LLM_BATCH_WINDOW_MS");
+        cfg.llm.batchMax = parse_int_or_throw(
+                getenv_or("CODECOACH_LLM_BATCH_MAX", "8"),
+                1, 64, "CODECOACH_LLM_BATCH_MAX");
+
+        // Evaluaciones
+        cfg.eval.cacheMaxBytes = parse_int_or_throw(
+                getenv_or("CODECOACH_EVAL_CACHE_MAX_BYTES", "0"),
+                0, 1024 * 1024 * 1024, "CODECOACH_EVAL_CACHE_MAX_BYTES");
+        cfg.eval.cacheDir = getenv_or("CODECOACH_EVAL_CACHE_DIR", "");
+        cfg.eval.cacheTtlSec = parse_int_or_throw(
+                getenv_or("CODECOACH_EVAL_CACHE_TTL_S", "2592000"),
+                0, 365 * 24 * 3600, "CODECOACH_EVAL_CACHE_TTL_S");
+        cfg.eval.cacheDiskMaxBytes = parse_int_or_throw(
+                getenv_or("CODECOACH_EVAL_CACHE_DISK_MAX_BYTES", "268435456"),
+                64 * 1024, 2147483647, "CODECOACH_EVAL_CACHE_DISK_MAX_BYTES");
+        cfg.eval.cacheNormalize = parse_int_or_throw(
+                getenv_or("CODECOACH_EVAL_CACHE_NORMALIZE", "0"),
+                0, 1, "CODECOACH_EVAL_CACHE_NORMALIZE") == 1;
+
         return cfg;
     }
 
+    // DNS + TCP + TLS hacia los tres servicios en segundo plano: la carga no espera y la
+    // primera llamada real encuentra la conexión abierta en el pool.
+    static void prewarm_endpoints(const Config& cfg) {
+        if (cfg.http.prewarmConnections <= 0) return;
+        (void)cc::http::HttpClient::prewarm({cfg.endpoints.problemsBaseUrl,
+                                             cfg.endpoints.evalBaseUrl,
+                                             cfg.endpoints.analyzerBaseUrl},
+                                            cfg.http.prewarmConnections);
+    }
+
     // ------------------------
     // API pública
     // ------------------------
@@ -150,6 +346,7 @@ namespace cc::config {
         if (!g_loaded) {
             g_cfg = make_from_env_or_default();
             g_loaded = true;
+            prewarm_endpoints(g_cfg);
         }
         return g_cfg;
     }
@@ -161,6 +358,7 @@ namespace cc::config {
         }
         g_cfg = make_from_env_or_default();
         g_loaded = true;
+        prewarm_endpoints(g_cfg);
     }
 
     void set_for_tests(const Config& cfg) {
@@ -21,10 +21,72 @@ namespace cc::config {
         std::string dbName;            // p.ej. "codecoach"
     };
 
-    // Política HTTP (timeouts y reintentos)
+    // Versión de HTTP hacia los servicios
+    enum class HttpVersion {
+        Http1_1,             // una petición por conexión a la vez (default)
+        Http2,               // h2 negociado por ALPN en https; http:// sigue en 1.1
+        Http2PriorKnowledge  // h2c sin upgrade, para servicios locales en texto plano
+    };
+
+    // Forma de los delays entre reintentos
+    enum class RetryBackoff {
+        Exponential,   // base * 2^(k-1) ±20%
+        Decorrelated   // decorrelated jitter: U(base, 3 * delay anterior), tope max_delay
+    };
+
+    // Política HTTP (timeouts, reintentos, pool de conexiones, versión, compresión y protección
+    // ante servicios degradados: circuit breaker por origen + presupuesto global de reintentos)
     struct HttpPolicy {
         int timeoutMs{10000};
         int retries{2};
+        int poolMaxIdlePerHost{8};     // handles ociosos por origen; 0 => sin pool
+        int poolIdleTimeoutMs{60000};  // descartar handles/conexiones ociosos tras este tiempo
+        HttpVersion version{HttpVersion::Http1_1}; // con HTTP/2 todo se multiplexa en 1 conexión/origen
+        int compressMinBytes{0};       // gzip de bodies >= N bytes (Content-Encoding); 0 => nunca
+        int breakerFailurePct{50};     // abrir el circuito con >= N% de fallos; 0 => sin breaker
+        int breakerMinCalls{20};       // llamadas mínimas en la ventana (10 s) antes de evaluar
+        int breakerOpenMs{5000};       // tiempo en open antes de dejar pasar sondas
+        int breakerSlowCallMs{0};      // llamadas >= N ms cuentan como lentas; 0 => no se mide
+        int retryBudgetPct{20};        // reintentos permitidos como % de las llamadas nuevas
+        int retryBudgetMinPerSec{5};   // piso de reintentos/s (tráfico bajo)
+        int hedgePercentile{0};        // hedging de GET en Problems/Eval al pN de latencia; 0 => no
+        int cacheMaxBytes{8 * 1024 * 1024}; // caché de respuestas GET (ProblemsClient); 0 => sin caché
+        std::string cacheDir;          // capa en disco de la caché; vacío => solo memoria
+        int rateLimitQps{0};           // requests/s por origen (token bucket); 0 => sin límite
+        int rateLimitBurst{0};         // ráfaga permitida; 0 => igual a rateLimitQps
+        int maxInFlight{0};            // requests simultáneos por origen; 0 => sin límite
+        bool adaptiveConcurrency{true}; // AIMD bajo maxInFlight (recorta ante 429/5xx/Retry-After)
+        int analyzerQps{0};            // cuota propia del analizador (0 => la general)
+        int analyzerMaxInFlight{0};
+        int llmQps{0};                 // cuota propia del backend LLM (0 => la general)
+        int llmMaxInFlight{0};
+        RetryBackoff backoff{RetryBackoff::Decorrelated};
+        int retryAfterMaxMs{30000};    // Retry-After más largo que se espera antes de reintentar; 0 => se ignora
+        int prewarmConnections{0};     // conexiones a abrir por servicio al cargar la config; 0 => no
+        bool adaptiveTimeouts{false};  // timeouts total/conexión = N * p99 observado por endpoint
+        int adaptiveTimeoutMultiplier{4};
+        int adaptiveTimeoutFloorMs{1000}; // piso del timeout total aprendido
+    };
+
+    // Caché de respuestas del LLM (CachingLLMClient) y conteo local de tokens
+    struct LlmPolicy {
+        int cacheMaxBytes{4 * 1024 * 1024};  // LRU en memoria; 0 => sin caché
+        std::string cacheDir;                // capa en disco; vacío => solo memoria
+        int cacheTtlSec{7 * 24 * 3600};      // 0 => no vence
+        int cacheDiskMaxBytes{256 * 1024 * 1024}; // tope del archivo de datos en disco
+        std::string tokenizerDir;            // <encoding>.tiktoken; vacío => tokens estimados
+        int batchWindowMs{5};                // espera para juntar prompts de una entrega; 0 => sin batching
+        int batchMax{8};                     // prompts por batch (cierra antes de la ventana)
+    };
+
+    // Memoización de evaluaciones (EvalResultCache). Apagada por defecto: el juez mide
+    // tiempos y un envío al límite del time limit puede dar distinto en otra corrida.
+    struct EvalPolicy {
+        int cacheMaxBytes{0};                // LRU en memoria; 0 => sin memoización
+        std::string cacheDir;                // capa en disco; vacío => solo memoria
+        int cacheTtlSec{30 * 24 * 3600};     // 0 => no vence
+        int cacheDiskMaxBytes{256 * 1024 * 1024};
+        bool cacheNormalize{false};          // clave sin espacios ni comentarios (lenguajes tipo C)
     };
 
     // Configuración global de CodeCoach
@@ -32,6 +94,8 @@ namespace cc::config {
         Endpoints  endpoints;
         MongoConfig mongo;
         HttpPolicy http;
+        LlmPolicy  llm;
+        EvalPolicy eval;
     };
 
     // API principal
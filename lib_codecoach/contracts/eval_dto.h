@@ -13,6 +13,7 @@ namespace cc::contracts {
         std::string code;
         std::string problemId;
         std::string stdin; // para pruebas en la GUI, no es obligatorio
+        bool failFast{false}; // el juez deja de evaluar tras el primer caso fallido
     };
 
     // Resultado por caso de prueba
@@ -34,6 +35,8 @@ namespace cc::contracts {
         std::string stdout;  // salida global capturada
         std::string stderr;  // errores globales capturados
         int exitCode{0};     // código de salida del proceso
+        bool stoppedEarly{false}; // `cases` quedó incompleto (failFast o corte del caller)
+        std::string testSetVersion; // versión de los casos con que se evaluó (si el servicio la informa)
     };
 
 } // namespace cc::contracts
@@ -24,6 +24,7 @@ namespace cc::contracts {
     struct ProblemDetail : public ProblemSummary {
         std::string           statement; // enunciado completo (HTML o texto)
         std::vector<Sample>   samples;   // ejemplos de entrada/salida
+        std::string           testSetVersion; // cambia cuando cambian los casos ocultos (lo asigna el servicio)
     };
 
 } // namespace cc::contracts
@@ -0,0 +1,178 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// adaptive_timeouts.cpp — Histogramas por endpoint/origen y cálculo de timeouts aprendidos.
+
+#include "adaptive_timeouts.h"
+
+#include "metrics/latency_tracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace cc::http {
+
+using cc::metrics::LatencyTracker;
+using cc::time::Micros;
+using cc::time::Millis;
+
+namespace {
+
+// Ventana larga: los servicios lentos (eval, analizador) reciben pocas llamadas por minuto
+// y el p99 necesita ~100 muestras para significar algo.
+constexpr Millis kWindow{10 * 60 * 1000};
+
+// Tope de endpoints distintos (paths con ids); los que sobran solo cuentan en su origen
+constexpr std::size_t kMaxEndpoints = 1024;
+
+struct Entry {
+    LatencyTracker   total{kWindow};
+    LatencyTracker   connect{kWindow};
+    std::atomic<int> learnedTotalMs{0};
+    std::atomic<int> learnedConnectMs{0};
+};
+
+using EntryMap = std::unordered_map<std::string, std::unique_ptr<Entry>>;
+
+int scaled_ms(Micros q, double multiplier, Millis floor, Millis ceiling) {
+    const double ms = std::ceil(static_cast<double>(q.count()) * multiplier / 1000.0);
+    const double v  = std::min(std::max(ms, static_cast<double>(floor.count())),
+                               static_cast<double>(ceiling.count()));
+    return std::max(1, static_cast<int>(v));
+}
+
+} // namespace
+
+// -------------------------------
+// Estado interno
+// -------------------------------
+struct EndpointLatencies::State {
+    mutable std::mutex m;
+    EntryMap endpoints;
+    EntryMap origins;
+
+    // Las entradas nunca se borran (reset() solo las vacía): los punteros siguen válidos
+    Entry* find(const EntryMap& map, const std::string& key) const {
+        std::lock_guard<std::mutex> lk(m);
+        auto it = map.find(key);
+        return it == map.end() ? nullptr : it->second.get();
+    }
+
+    Entry* find_or_create(EntryMap& map, const std::string& key, std::size_t maxEntries) {
+        std::lock_guard<std::mutex> lk(m);
+        auto it = map.find(key);
+        if (it != map.end()) return it->second.get();
+        if (map.size() >= maxEntries) return nullptr;
+        return map.emplace(key, std::make_unique<Entry>()).first->second.get();
+    }
+};
+
+// -------------------------------
+// EndpointLatencies
+// -------------------------------
+EndpointLatencies& EndpointLatencies::instance() {
+    // Igual que ConnectionPool: nunca se destruye (hilos de I/O pueden registrar al salir)
+    static EndpointLatencies* inst = new EndpointLatencies();
+    return *inst;
+}
+
+EndpointLatencies::EndpointLatencies() : state_(new State()) {}
+
+EndpointLatencies::~EndpointLatencies() {
+    delete state_;
+}
+
+void EndpointLatencies::record_response(const std::string& endpoint, const std::string& origin, Micros total) {
+    if (Entry* e = state_->find_or_create(state_->endpoints, endpoint, kMaxEndpoints)) e->total.record(total);
+    if (Entry* o = state_->find_or_create(state_->origins, origin, kMaxEndpoints)) o->total.record(total);
+}
+
+void EndpointLatencies::record_connect(const std::string& origin, Micros connect) {
+    if (Entry* o = state_->find_or_create(state_->origins, origin, kMaxEndpoints)) o->connect.record(connect);
+}
+
+LearnedTimeouts EndpointLatencies::timeouts(const AdaptiveTimeoutPolicy& policy, const std::string& endpoint,
+                                            const std::string& origin, int fixedMs) {
+    LearnedTimeouts out;
+    out.totalMs = fixedMs;
+
+    Entry* ep = state_->find(state_->endpoints, endpoint);
+    Entry* og = state_->find(state_->origins, origin);
+
+    // Total: el endpoint si ya tiene muestras; si no, el agregado del origen
+    Entry* from = nullptr;
+    std::optional<Micros> q;
+    if (ep && (q = ep->total.quantile(policy.percentile, policy.minSamples))) {
+        from = ep;
+    } else if (og && (q = og->total.quantile(policy.percentile, policy.minSamples))) {
+        from = og;
+    }
+    if (q) {
+        const Millis ceiling = policy.ceiling.count() > 0 ? policy.ceiling : Millis{fixedMs};
+        out.totalMs = scaled_ms(*q, policy.multiplier, policy.floor, ceiling);
+        from->learnedTotalMs.store(out.totalMs, std::memory_order_relaxed);
+    }
+
+    // Conexión: siempre por origen (es la misma para todos sus endpoints)
+    if (og) {
+        if (const auto c = og->connect.quantile(policy.percentile, policy.minSamples)) {
+            Millis ceiling{out.totalMs};
+            if (policy.connectCeiling.count() > 0) ceiling = std::min(ceiling, policy.connectCeiling);
+            out.connectMs = scaled_ms(*c, policy.multiplier, policy.connectFloor, ceiling);
+            og->learnedConnectMs.store(out.connectMs, std::memory_order_relaxed);
+        }
+    }
+    return out;
+}
+
+std::vector<EndpointLatencySnapshot> EndpointLatencies::snapshot() const {
+    std::vector<std::pair<std::string, const Entry*>> origins, endpoints;
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        for (const auto& [k, e] : state_->origins) origins.emplace_back(k, e.get());
+        for (const auto& [k, e] : state_->endpoints) endpoints.emplace_back(k, e.get());
+    }
+    std::sort(origins.begin(), origins.end());
+    std::sort(endpoints.begin(), endpoints.end());
+
+    std::vector<EndpointLatencySnapshot> out;
+    out.reserve(origins.size() + endpoints.size());
+    auto add = [&out](const std::string& key, const Entry& e, bool isOrigin) {
+        EndpointLatencySnapshot s;
+        s.key              = key;
+        s.origin           = isOrigin;
+        s.samples          = e.total.count();
+        s.p50              = e.total.quantile(0.50).value_or(Micros{0});
+        s.p99              = e.total.quantile(0.99).value_or(Micros{0});
+        s.learnedTotalMs   = e.learnedTotalMs.load(std::memory_order_relaxed);
+        if (isOrigin) {
+            s.connectSamples   = e.connect.count();
+            s.connectP99       = e.connect.quantile(0.99).value_or(Micros{0});
+            s.learnedConnectMs = e.learnedConnectMs.load(std::memory_order_relaxed);
+        }
+        out.push_back(std::move(s));
+    };
+    for (const auto& [k, e] : origins) add(k, *e, true);
+    for (const auto& [k, e] : endpoints) add(k, *e, false);
+    return out;
+}
+
+void EndpointLatencies::reset() {
+    std::lock_guard<std::mutex> lk(state_->m);
+    for (EntryMap* map : {&state_->endpoints, &state_->origins}) {
+        for (auto& [k, e] : *map) {
+            e->total.reset();
+            e->connect.reset();
+            e->learnedTotalMs.store(0, std::memory_order_relaxed);
+            e->learnedConnectMs.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace cc::http
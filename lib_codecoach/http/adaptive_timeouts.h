@@ -0,0 +1,82 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// adaptive_timeouts.h — Latencia observada por endpoint ("METHOD origin/path") y por origen,
+// compartida por todos los HttpClient del proceso: tiempo total de cada respuesta y tiempo de
+// conexión (DNS + TCP + TLS) de cada conexión nueva, en histogramas LatencyTracker. De ahí
+// salen los timeouts aprendidos (multiplier * pN acotado a [floor, ceiling]); sin muestras
+// suficientes queda el timeout fijo del cliente. snapshot() expone cuantiles y timeouts.
+#ifndef LIB_CODECOACH_ADAPTIVE_TIMEOUTS_H
+#define LIB_CODECOACH_ADAPTIVE_TIMEOUTS_H
+
+#include "metrics/timer.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cc::http {
+
+    struct AdaptiveTimeoutPolicy {
+        double           percentile{0.99};
+        double           multiplier{4.0};     // timeout = multiplier * percentil observado
+        std::uint64_t    minSamples{100};     // sin estas muestras en la ventana => timeout fijo
+        cc::time::Millis floor{1000};         // piso del timeout total
+        cc::time::Millis ceiling{0};          // techo del total; 0 => el timeout fijo del cliente
+        cc::time::Millis connectFloor{250};   // piso del timeout de conexión
+        cc::time::Millis connectCeiling{0};   // techo de conexión; 0 => el timeout total
+    };
+
+    // Timeouts para un intento. connectMs = 0 => sin límite propio (el de libcurl).
+    struct LearnedTimeouts {
+        int totalMs{0};
+        int connectMs{0};
+    };
+
+    struct EndpointLatencySnapshot {
+        std::string      key;               // endpoint "METHOD origin/path" u origen (agregado)
+        bool             origin{false};     // true => fila agregada del origen
+        std::uint64_t    samples{0};        // respuestas en la ventana
+        cc::time::Micros p50{0};
+        cc::time::Micros p99{0};
+        std::uint64_t    connectSamples{0}; // conexiones nuevas en la ventana (solo orígenes)
+        cc::time::Micros connectP99{0};
+        int              learnedTotalMs{0};   // último timeout total aplicado (0 => nunca/fijo)
+        int              learnedConnectMs{0}; // último timeout de conexión aplicado (solo orígenes)
+    };
+
+    class EndpointLatencies {
+    public:
+        static EndpointLatencies& instance();
+
+        // Respuesta completa, o timeout como muestra censurada en su valor (no cuentan
+        // cancelaciones ni bodies en streaming).
+        void record_response(const std::string& endpoint, const std::string& origin, cc::time::Micros total);
+        // Conexión nueva hasta quedar lista (incluye DNS y TLS).
+        void record_connect(const std::string& origin, cc::time::Micros connect);
+
+        // Timeouts para una llamada a `endpoint` cuyo timeout fijo es `fixedMs`. Si el endpoint
+        // aún no tiene muestras usa las del origen.
+        LearnedTimeouts timeouts(const AdaptiveTimeoutPolicy& policy, const std::string& endpoint,
+                                 const std::string& origin, int fixedMs);
+
+        std::vector<EndpointLatencySnapshot> snapshot() const; // orígenes primero, luego por clave
+        void reset();
+
+        ~EndpointLatencies();
+        EndpointLatencies(const EndpointLatencies&) = delete;
+        EndpointLatencies& operator=(const EndpointLatencies&) = delete;
+
+        struct State;
+
+    private:
+        EndpointLatencies();
+
+        // PIMPL: mapas de histogramas por endpoint/origen viven en el .cpp
+        State* state_;
+    };
+
+} // namespace cc::http
+
+#endif // LIB_CODECOACH_ADAPTIVE_TIMEOUTS_H
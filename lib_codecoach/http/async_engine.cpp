@@ -0,0 +1,291 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// async_engine.cpp — Loop de I/O sobre curl_multi + cola de timers.
+
+#include "async_engine.h"
+
+#include "logging/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef CC_USE_CURL
+  #include "curl_transfer.h"
+  #include <curl/curl.h>
+#endif
+
+namespace cc::http {
+
+using cc::time::Millis;
+using cc::time::SteadyClock;
+
+namespace {
+
+constexpr std::size_t kMaxFreeHandles = 64;   // handles reciclables guardados por el loop
+constexpr Millis      kMaxPollWait{1000};     // el loop despierta al menos 1 vez/s
+constexpr Millis      kCancelPollWait{50};    // con transferencias cancelables: chequeo más fino
+
+struct Pending {
+    std::shared_ptr<const HttpRequest> req;
+    AsyncEngine::Callback              onDone;
+};
+
+struct Timer {
+    SteadyClock::time_point when;
+    std::uint64_t           seq; // desempate FIFO para timers con igual vencimiento
+    AsyncEngine::Task       fn;
+};
+
+// Min-heap por (when, seq)
+struct TimerLater {
+    bool operator()(const Timer& a, const Timer& b) const noexcept {
+        return a.when != b.when ? a.when > b.when : a.seq > b.seq;
+    }
+};
+
+#ifdef CC_USE_CURL
+struct Active {
+    std::shared_ptr<const HttpRequest> req;
+    AsyncEngine::Callback              onDone;
+    CurlTransfer                       xfer;
+};
+#endif
+
+void invoke_safely(const AsyncEngine::Callback& cb, HttpResponse resp) {
+    try {
+        if (cb) cb(std::move(resp));
+    } catch (const std::exception& e) {
+        CC_LOG_ERROR(std::string("[HTTP] async callback threw: ") + e.what());
+    } catch (...) {
+        CC_LOG_ERROR("[HTTP] async callback threw unknown exception");
+    }
+}
+
+} // namespace
+
+// -------------------------------
+// Estado interno
+// -------------------------------
+struct AsyncEngine::State {
+    mutable std::mutex      m;
+    std::condition_variable cv; // solo se usa sin libcurl
+    std::deque<Pending>     queue;
+    std::vector<Timer>      timers; // heap (TimerLater)
+    std::uint64_t           timerSeq{0};
+    std::atomic<std::size_t> inFlight{0};
+    std::atomic<bool>       stop{false};
+    std::thread             io;
+
+#ifdef CC_USE_CURL
+    CURLM* multi{nullptr};
+    // Lo siguiente solo lo toca el hilo de I/O
+    std::vector<CURL*>                                  freeHandles;
+    std::unordered_map<CURL*, std::unique_ptr<Active>>  active;
+    std::size_t                                         cancellable{0};
+#endif
+
+    void wake() {
+#ifdef CC_USE_CURL
+        if (multi) curl_multi_wakeup(multi);
+#else
+        cv.notify_one();
+#endif
+    }
+};
+
+// -------------------------------
+// AsyncEngine
+// -------------------------------
+AsyncEngine& AsyncEngine::instance() {
+    // Igual que ConnectionPool: nunca se destruye para no carrerear con el hilo de I/O al salir.
+    static AsyncEngine* inst = new AsyncEngine();
+    return *inst;
+}
+
+AsyncEngine::AsyncEngine()
+    : state_(new State())
+{
+#ifdef CC_USE_CURL
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    state_->multi = curl_multi_init();
+    if (!state_->multi) {
+        CC_LOG_ERROR("[HTTP] curl_multi_init failed — async requests will fail");
+    } else {
+        // Peticiones HTTP/2 al mismo origen comparten conexión (streams concurrentes)
+        curl_multi_setopt(state_->multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    }
+#endif
+    state_->io = std::thread([this] { run(); });
+}
+
+AsyncEngine::~AsyncEngine() {
+    state_->stop.store(true);
+    state_->wake();
+    if (state_->io.joinable()) state_->io.join();
+#ifdef CC_USE_CURL
+    for (auto& [h, a] : state_->active) {
+        curl_multi_remove_handle(state_->multi, h);
+        curl_easy_cleanup(h);
+    }
+    for (auto* h : state_->freeHandles) curl_easy_cleanup(h);
+    if (state_->multi) curl_multi_cleanup(state_->multi);
+#endif
+    delete state_;
+}
+
+void AsyncEngine::submit(std::shared_ptr<const HttpRequest> req, Callback onDone) {
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        state_->queue.push_back(Pending{std::move(req), std::move(onDone)});
+        ++state_->inFlight;
+    }
+    state_->wake();
+}
+
+void AsyncEngine::schedule(Millis delay, Task fn) {
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        state_->timers.push_back(Timer{SteadyClock::now() + delay, state_->timerSeq++, std::move(fn)});
+        std::push_heap(state_->timers.begin(), state_->timers.end(), TimerLater{});
+    }
+    state_->wake();
+}
+
+std::size_t AsyncEngine::inFlight() const {
+    return state_->inFlight.load();
+}
+
+void AsyncEngine::run() {
+    auto& st = *state_;
+
+    while (!st.stop.load()) {
+        std::deque<Pending> batch;
+        std::vector<Task>   due;
+        SteadyClock::time_point nextTimer = SteadyClock::now() + kMaxPollWait;
+        {
+            std::lock_guard<std::mutex> lk(st.m);
+            batch.swap(st.queue);
+            const auto now = SteadyClock::now();
+            while (!st.timers.empty() && st.timers.front().when <= now) {
+                std::pop_heap(st.timers.begin(), st.timers.end(), TimerLater{});
+                due.push_back(std::move(st.timers.back().fn));
+                st.timers.pop_back();
+            }
+            if (!st.timers.empty()) nextTimer = std::min(nextTimer, st.timers.front().when);
+        }
+
+        // 1) Arrancar transferencias nuevas
+        for (auto& p : batch) {
+#ifdef CC_USE_CURL
+            CURL* h = nullptr;
+            if (!st.freeHandles.empty()) {
+                h = st.freeHandles.back();
+                st.freeHandles.pop_back();
+            } else {
+                h = curl_easy_init();
+            }
+            if (!h || !st.multi) {
+                if (h) curl_easy_cleanup(h);
+                --st.inFlight;
+                HttpResponse err;
+                err.statusCode = 0;
+                err.body = "curl_easy_init failed";
+                invoke_safely(p.onDone, std::move(err));
+                continue;
+            }
+            curl_easy_setopt(h, CURLOPT_NOSIGNAL, 1L);
+
+            auto act = std::make_unique<Active>();
+            act->req    = std::move(p.req);
+            act->onDone = std::move(p.onDone);
+            act->xfer.prepare(h, *act->req);
+            if (act->req->cancellable()) ++st.cancellable;
+            curl_multi_add_handle(st.multi, h);
+            st.active.emplace(h, std::move(act));
+#else
+            --st.inFlight;
+            HttpResponse err;
+            err.statusCode = 0;
+            err.body = "HttpClient: CC_USE_CURL no está definido o libcurl no está disponible.";
+            invoke_safely(p.onDone, std::move(err));
+#endif
+        }
+
+        // 2) Timers vencidos (p.ej. reintentos con backoff)
+        for (auto& fn : due) {
+            try {
+                fn();
+            } catch (const std::exception& e) {
+                CC_LOG_ERROR(std::string("[HTTP] async timer threw: ") + e.what());
+            } catch (...) {
+                CC_LOG_ERROR("[HTTP] async timer threw unknown exception");
+            }
+        }
+
+#ifdef CC_USE_CURL
+        // 3) Avanzar transferencias y recoger las terminadas
+        int running = 0;
+        curl_multi_perform(st.multi, &running);
+
+        int left = 0;
+        while (CURLMsg* msg = curl_multi_info_read(st.multi, &left)) {
+            if (msg->msg != CURLMSG_DONE) continue;
+            CURL* h = msg->easy_handle;
+            const CURLcode rc = msg->data.result;
+            curl_multi_remove_handle(st.multi, h);
+
+            auto it = st.active.find(h);
+            if (it == st.active.end()) {
+                curl_easy_cleanup(h);
+                continue;
+            }
+            std::unique_ptr<Active> act = std::move(it->second);
+            st.active.erase(it);
+            if (act->req->cancellable()) --st.cancellable;
+
+            HttpResponse resp = act->xfer.finish(h, rc);
+            if (rc == CURLE_OK && st.freeHandles.size() < kMaxFreeHandles) {
+                curl_easy_reset(h);
+                st.freeHandles.push_back(h);
+            } else {
+                curl_easy_cleanup(h);
+            }
+            --st.inFlight;
+            invoke_safely(act->onDone, std::move(resp));
+        }
+
+        // 4) Esperar actividad de sockets, un timer o un wakeup (submit/schedule)
+        long curlTimeout = -1;
+        curl_multi_timeout(st.multi, &curlTimeout);
+
+        auto waitMs = std::chrono::duration_cast<Millis>(nextTimer - SteadyClock::now()).count();
+        if (curlTimeout >= 0) waitMs = std::min<long long>(waitMs, curlTimeout);
+        // El callback de progreso (que detecta la cancelación) solo corre dentro de
+        // curl_multi_perform: despertamos seguido mientras haya transferencias cancelables.
+        if (st.cancellable > 0) waitMs = std::min<long long>(waitMs, kCancelPollWait.count());
+        {
+            std::lock_guard<std::mutex> lk(st.m);
+            if (!st.queue.empty()) waitMs = 0;
+        }
+        if (waitMs > 0) {
+            curl_multi_poll(st.multi, nullptr, 0, static_cast<int>(waitMs), nullptr);
+        }
+#else
+        std::unique_lock<std::mutex> lk(st.m);
+        st.cv.wait_until(lk, nextTimer, [&] { return st.stop.load() || !st.queue.empty(); });
+#endif
+    }
+}
+
+} // namespace cc::http
@@ -0,0 +1,53 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// async_engine.h — Motor HTTP asíncrono: un único hilo de I/O que maneja un curl_multi con
+// miles de transferencias concurrentes y una cola de timers (usada para el backoff de reintentos).
+// Los callbacks se ejecutan EN el hilo de I/O: deben ser cortos y no bloquear.
+#ifndef LIB_CODECOACH_ASYNC_ENGINE_H
+#define LIB_CODECOACH_ASYNC_ENGINE_H
+
+#include "http_client.h"
+#include "metrics/timer.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace cc::http {
+
+    class AsyncEngine {
+    public:
+        using Callback = std::function<void(HttpResponse)>;
+        using Task     = std::function<void()>;
+
+        // Instancia global; el hilo de I/O arranca en el primer uso.
+        static AsyncEngine& instance();
+
+        // Encola UN intento de la request (sin reintentos). `onDone` recibe la respuesta
+        // (statusCode 0 si hubo error de red/timeout).
+        void submit(std::shared_ptr<const HttpRequest> req, Callback onDone);
+
+        // Ejecuta `fn` en el hilo de I/O cuando pase `delay` (no bloquea a nadie mientras).
+        void schedule(cc::time::Millis delay, Task fn);
+
+        // Transferencias activas en el curl_multi + encoladas.
+        std::size_t inFlight() const;
+
+        ~AsyncEngine();
+        AsyncEngine(const AsyncEngine&) = delete;
+        AsyncEngine& operator=(const AsyncEngine&) = delete;
+
+        struct State;
+
+    private:
+        AsyncEngine();
+        void run(); // loop del hilo de I/O
+
+        State* state_;
+    };
+
+} // namespace cc::http
+
+#endif // LIB_CODECOACH_ASYNC_ENGINE_H
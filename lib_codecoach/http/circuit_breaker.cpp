@@ -0,0 +1,294 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// circuit_breaker.cpp — Breakers por origen sobre una ventana de buckets.
+
+#include "circuit_breaker.h"
+
+#include "config/config_manager.h"
+#include "logging/logger.h"
+#include "metrics/counters.h"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace cc::http {
+
+using cc::time::Millis;
+using cc::time::SteadyClock;
+
+namespace {
+
+// La ventana se divide en buckets: avanzar es O(1) y lo viejo caduca por bucket completo.
+constexpr int kBuckets = 10;
+
+struct Bucket {
+    std::int64_t  epoch{-1}; // índice absoluto del bucket (tiempo / ancho)
+    std::uint32_t calls{0};
+    std::uint32_t failures{0};
+    std::uint32_t slow{0};
+};
+
+struct Tally {
+    std::uint64_t calls{0};
+    std::uint64_t failures{0};
+    std::uint64_t slow{0};
+};
+
+struct Breaker {
+    BreakerState               state{BreakerState::Closed};
+    std::uint64_t              generation{0};
+    std::array<Bucket, kBuckets> buckets{};
+    SteadyClock::time_point    openedAt{};
+    int                        probesInFlight{0};
+    int                        probeSuccesses{0};
+    std::uint64_t              opened{0};
+    std::uint64_t              rejected{0};
+};
+
+bool is_failure(int status) {
+    // Mismo criterio que "el servicio está mal": red/timeout/deadline o 5xx.
+    // 4xx (incluido 429) es culpa del llamador o throttling y no abre el circuito.
+    return status == 0 || (status >= 500 && status < 600);
+}
+
+} // namespace
+
+// -------------------------------
+// Estado interno
+// -------------------------------
+struct CircuitBreakers::State {
+    mutable std::mutex m;
+    BreakerPolicy      policy{};
+    std::unordered_map<std::string, Breaker> breakers;
+
+    std::int64_t epoch_of(SteadyClock::time_point now) const {
+        const auto width = std::max<Millis::rep>(1, policy.window.count() / kBuckets);
+        const auto ms = std::chrono::duration_cast<Millis>(now.time_since_epoch()).count();
+        return ms / width;
+    }
+
+    Tally tally(const Breaker& b, std::int64_t epoch) const {
+        Tally t;
+        for (const auto& bk : b.buckets) {
+            if (bk.epoch > epoch - kBuckets) {
+                t.calls    += bk.calls;
+                t.failures += bk.failures;
+                t.slow     += bk.slow;
+            }
+        }
+        return t;
+    }
+
+    // Devuelve el mensaje a loguear (fuera del lock)
+    std::string transition(Breaker& b, const std::string& origin, BreakerState to,
+                           SteadyClock::time_point now, const std::string& why) {
+        const BreakerState from = b.state;
+        b.state = to;
+        ++b.generation;
+        b.probesInFlight = 0;
+        b.probeSuccesses = 0;
+        if (to == BreakerState::Open) {
+            b.openedAt = now;
+            ++b.opened;
+            cc::metrics::count("http.breaker.opened|" + origin);
+        } else if (to == BreakerState::Closed) {
+            b.buckets = {};
+        }
+        return std::string("[HTTP] circuit ") + origin + " " + to_string(from) + " -> " +
+               to_string(to) + (why.empty() ? "" : " (" + why + ")");
+    }
+};
+
+const char* to_string(BreakerState s) noexcept {
+    switch (s) {
+        case BreakerState::Closed:   return "closed";
+        case BreakerState::Open:     return "open";
+        case BreakerState::HalfOpen: return "half-open";
+    }
+    return "?";
+}
+
+// -------------------------------
+// CircuitBreakers
+// -------------------------------
+CircuitBreakers& CircuitBreakers::instance() {
+    // Nunca se destruye: el hilo de I/O del AsyncEngine puede registrar resultados al salir.
+    static CircuitBreakers* inst = new CircuitBreakers();
+    return *inst;
+}
+
+CircuitBreakers::CircuitBreakers()
+    : state_(new State())
+{
+    const auto& cfg = cc::config::get();
+    BreakerPolicy p;
+    p.failureRatePct = std::clamp(cfg.http.breakerFailurePct, 0, 100);
+    p.minCalls       = std::max(1, cfg.http.breakerMinCalls);
+    p.openFor        = Millis{std::max(1, cfg.http.breakerOpenMs)};
+    p.slowCallMs     = std::max(0, cfg.http.breakerSlowCallMs);
+    state_->policy   = p;
+}
+
+CircuitBreakers::~CircuitBreakers() {
+    delete state_;
+}
+
+void CircuitBreakers::configure(const BreakerPolicy& policy) {
+    std::lock_guard<std::mutex> lk(state_->m);
+    state_->policy = policy;
+    state_->policy.halfOpenProbes = std::max(1, policy.halfOpenProbes);
+    state_->policy.minCalls       = std::max(1, policy.minCalls);
+    state_->breakers.clear();
+}
+
+BreakerPolicy CircuitBreakers::policy() const {
+    std::lock_guard<std::mutex> lk(state_->m);
+    return state_->policy;
+}
+
+BreakerPermit CircuitBreakers::acquire(const std::string& origin) {
+    BreakerPermit permit;
+    std::string   logMsg;
+    bool          rejected = false;
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        auto& st = *state_;
+        if (st.policy.failureRatePct <= 0) return permit;
+
+        auto& b = st.breakers[origin];
+        const auto now = SteadyClock::now();
+        if (b.state == BreakerState::Open && now - b.openedAt >= st.policy.openFor) {
+            logMsg = st.transition(b, origin, BreakerState::HalfOpen, now, "probing");
+        }
+
+        switch (b.state) {
+            case BreakerState::Closed:
+                break;
+            case BreakerState::HalfOpen:
+                if (b.probesInFlight < st.policy.halfOpenProbes) {
+                    ++b.probesInFlight;
+                } else {
+                    rejected = true;
+                }
+                break;
+            case BreakerState::Open:
+                rejected = true;
+                break;
+        }
+        if (rejected) {
+            ++b.rejected;
+            permit.allowed = false;
+        }
+        permit.generation = b.generation;
+    }
+    if (!logMsg.empty()) CC_LOG_INFO(logMsg);
+    if (rejected) cc::metrics::count("http.breaker.rejected|" + origin);
+    return permit;
+}
+
+void CircuitBreakers::record(const std::string& origin, const BreakerPermit& permit,
+                             int status, Millis latency) {
+    if (!permit.allowed) return;
+
+    std::string logMsg;
+    bool        opened = false;
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        auto& st = *state_;
+        if (st.policy.failureRatePct <= 0) return;
+
+        auto it = st.breakers.find(origin);
+        if (it == st.breakers.end()) return;
+        Breaker& b = it->second;
+        if (b.generation != permit.generation) return; // resultado de un estado anterior
+
+        const bool cancelled = status == 499;
+        const bool failed    = is_failure(status);
+        const bool slow      = st.policy.slowCallMs > 0 && latency.count() >= st.policy.slowCallMs;
+        const auto now       = SteadyClock::now();
+
+        if (b.state == BreakerState::HalfOpen) {
+            if (b.probesInFlight > 0) --b.probesInFlight;
+            if (cancelled) return;
+            if (failed || slow) {
+                logMsg = st.transition(b, origin, BreakerState::Open, now,
+                                       failed ? "probe failed, status " + std::to_string(status)
+                                              : "probe slow, " + std::to_string(latency.count()) + " ms");
+                opened = true;
+            } else if (++b.probeSuccesses >= st.policy.halfOpenProbes) {
+                logMsg = st.transition(b, origin, BreakerState::Closed, now, "probes succeeded");
+            }
+        } else if (b.state == BreakerState::Closed && !cancelled) {
+            const auto epoch = st.epoch_of(now);
+            Bucket& bk = b.buckets[static_cast<std::size_t>(epoch % kBuckets)];
+            if (bk.epoch != epoch) bk = Bucket{epoch};
+            ++bk.calls;
+            if (failed) ++bk.failures;
+            if (slow)   ++bk.slow;
+
+            if (failed || slow) {
+                const Tally t = st.tally(b, epoch);
+                const bool tooManyFailures =
+                    t.failures * 100 >= static_cast<std::uint64_t>(st.policy.failureRatePct) * t.calls;
+                const bool tooManySlow = st.policy.slowCallMs > 0 &&
+                    t.slow * 100 >= static_cast<std::uint64_t>(st.policy.slowRatePct) * t.calls;
+                if (t.calls >= static_cast<std::uint64_t>(st.policy.minCalls) &&
+                    (tooManyFailures || tooManySlow)) {
+                    const auto pct = [&](std::uint64_t n) { return std::to_string(n * 100 / t.calls) + "%"; };
+                    logMsg = st.transition(b, origin, BreakerState::Open, now,
+                                           "errors " + pct(t.failures) + ", slow " + pct(t.slow) +
+                                           " of " + std::to_string(t.calls) + " calls");
+                    opened = true;
+                }
+            }
+        }
+    }
+    if (logMsg.empty()) return;
+    if (opened) {
+        CC_LOG_WARN(logMsg);
+    } else {
+        CC_LOG_INFO(logMsg);
+    }
+}
+
+BreakerState CircuitBreakers::state(const std::string& origin) const {
+    std::lock_guard<std::mutex> lk(state_->m);
+    auto it = state_->breakers.find(origin);
+    return it == state_->breakers.end() ? BreakerState::Closed : it->second.state;
+}
+
+std::vector<BreakerSnapshot> CircuitBreakers::snapshot() const {
+    std::vector<BreakerSnapshot> out;
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        const auto epoch = state_->epoch_of(SteadyClock::now());
+        out.reserve(state_->breakers.size());
+        for (const auto& [origin, b] : state_->breakers) {
+            const Tally t = state_->tally(b, epoch);
+            BreakerSnapshot s;
+            s.origin   = origin;
+            s.state    = b.state;
+            s.calls    = t.calls;
+            s.failures = t.failures;
+            s.slow     = t.slow;
+            s.opened   = b.opened;
+            s.rejected = b.rejected;
+            out.push_back(std::move(s));
+        }
+    }
+    std::sort(out.begin(), out.end(),
+              [](const BreakerSnapshot& a, const BreakerSnapshot& b) { return a.origin < b.origin; });
+    return out;
+}
+
+void CircuitBreakers::reset() {
+    std::lock_guard<std::mutex> lk(state_->m);
+    state_->breakers.clear();
+}
+
+} // namespace cc::http
@@ -0,0 +1,85 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// circuit_breaker.h — Circuit breaker por origen (closed / open / half-open) compartido por
+// todos los HttpClient del proceso. Se abre cuando, en una ventana deslizante, la tasa de
+// errores (red/timeout o 5xx) o de llamadas lentas supera el umbral; abierto, las llamadas
+// fallan al instante sin tocar la red. Pasado openFor deja salir unas pocas sondas
+// (half-open): si todas salen bien vuelve a closed, si una falla vuelve a open.
+#ifndef LIB_CODECOACH_CIRCUIT_BREAKER_H
+#define LIB_CODECOACH_CIRCUIT_BREAKER_H
+
+#include "metrics/timer.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cc::http {
+
+    enum class BreakerState { Closed, Open, HalfOpen };
+
+    const char* to_string(BreakerState s) noexcept; // "closed" | "open" | "half-open"
+
+    struct BreakerPolicy {
+        int failureRatePct{50};          // abrir con >= N% de fallos en la ventana; 0 => sin breaker
+        int slowCallMs{0};               // llamadas >= N ms cuentan como lentas; 0 => no se mide
+        int slowRatePct{80};             // abrir con >= N% de llamadas lentas
+        int minCalls{20};                // llamadas mínimas en la ventana antes de evaluar
+        int halfOpenProbes{3};           // sondas concurrentes (y éxitos necesarios) en half-open
+        cc::time::Millis window{10000};  // ventana deslizante de la tasa de errores
+        cc::time::Millis openFor{5000};  // tiempo en open antes de probar (half-open)
+    };
+
+    struct BreakerSnapshot {
+        std::string   origin;
+        BreakerState  state{BreakerState::Closed};
+        std::uint64_t calls{0};     // en la ventana actual
+        std::uint64_t failures{0};  // en la ventana actual
+        std::uint64_t slow{0};      // en la ventana actual
+        std::uint64_t opened{0};    // veces que pasó a open (acumulado)
+        std::uint64_t rejected{0};  // llamadas cortadas sin salir a la red (acumulado)
+    };
+
+    // Resultado de acquire(); se devuelve tal cual a record().
+    struct BreakerPermit {
+        bool          allowed{true};
+        std::uint64_t generation{0}; // descarta resultados de un estado anterior del breaker
+    };
+
+    class CircuitBreakers {
+    public:
+        // Instancia global; se configura desde cc::config::get().http en el primer uso.
+        static CircuitBreakers& instance();
+
+        void configure(const BreakerPolicy& policy); // también reinicia todos los orígenes
+        BreakerPolicy policy() const;
+
+        // ¿Puede salir una llamada a `origin`? allowed=false => fallar rápido.
+        BreakerPermit acquire(const std::string& origin);
+
+        // Resultado de una llamada admitida. status 499 (cancelada) no cuenta como fallo.
+        void record(const std::string& origin, const BreakerPermit& permit,
+                    int status, cc::time::Millis latency);
+
+        BreakerState state(const std::string& origin) const;
+        std::vector<BreakerSnapshot> snapshot() const; // ordenado por origen
+        void reset();
+
+        ~CircuitBreakers();
+        CircuitBreakers(const CircuitBreakers&) = delete;
+        CircuitBreakers& operator=(const CircuitBreakers&) = delete;
+
+        struct State;
+
+    private:
+        CircuitBreakers();
+
+        // PIMPL: mutex y ventanas por origen viven en el .cpp
+        State* state_;
+    };
+
+} // namespace cc::http
+
+#endif // LIB_CODECOACH_CIRCUIT_BREAKER_H
@@ -0,0 +1,44 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// compression.cpp — gzip con zlib (deflate con header gzip, windowBits 15 + 16).
+
+#include "compression.h"
+
+#ifdef CC_USE_ZLIB
+  #include <zlib.h>
+#endif
+
+namespace cc::http {
+
+#ifdef CC_USE_ZLIB
+std::optional<std::string> gzip_compress(std::string_view data, int level) {
+    z_stream zs{};
+    if (deflateInit2(&zs, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return std::nullopt;
+    }
+
+    std::string out;
+    out.resize(deflateBound(&zs, static_cast<uLong>(data.size())));
+
+    zs.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs.avail_in  = static_cast<uInt>(data.size());
+    zs.next_out  = reinterpret_cast<Bytef*>(out.data());
+    zs.avail_out = static_cast<uInt>(out.size());
+
+    const int rc = deflate(&zs, Z_FINISH);
+    const auto written = zs.total_out;
+    deflateEnd(&zs);
+
+    if (rc != Z_STREAM_END || written >= data.size()) return std::nullopt;
+    out.resize(written);
+    return out;
+}
+#else
+std::optional<std::string> gzip_compress(std::string_view, int) {
+    return std::nullopt;
+}
+#endif
+
+} // namespace cc::http
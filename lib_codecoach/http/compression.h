@@ -0,0 +1,22 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// compression.h — Compresión gzip de bodies de request (Content-Encoding: gzip).
+// La descompresión de respuestas la hace libcurl (CURLOPT_ACCEPT_ENCODING).
+// Sin CC_USE_ZLIB, gzip_compress() siempre devuelve std::nullopt (se envía sin comprimir).
+#ifndef LIB_CODECOACH_COMPRESSION_H
+#define LIB_CODECOACH_COMPRESSION_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace cc::http {
+
+    // Devuelve el body comprimido, o std::nullopt si falla o no reduce el tamaño.
+    std::optional<std::string> gzip_compress(std::string_view data, int level = 6);
+
+} // namespace cc::http
+
+#endif // LIB_CODECOACH_COMPRESSION_H
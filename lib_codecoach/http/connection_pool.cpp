@@ -0,0 +1,257 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// connection_pool.cpp — Implementación del pool de handles libcurl.
+
+#include "connection_pool.h"
+#include "url.h"
+
+#include "config/config_manager.h"
+#include "logging/logger.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef CC_USE_CURL
+  #include <curl/curl.h>
+#endif
+
+namespace cc::http {
+
+using cc::time::Millis;
+using cc::time::SteadyClock;
+
+// -------------------------------
+// Estado interno
+// -------------------------------
+struct ConnectionPool::State {
+    struct Idle {
+        NativeHandle            handle{nullptr};
+        SteadyClock::time_point since{};
+    };
+
+    mutable std::mutex m;
+    std::unordered_map<std::string, std::vector<Idle>> idle; // LIFO por origen
+    std::size_t maxIdlePerHost{8};
+    Millis      idleTimeout{60000};
+    PoolStats   stats{};
+
+#ifdef CC_USE_CURL
+    CURLSH*    share{nullptr};
+    std::mutex shareLocks[CURL_LOCK_DATA_LAST];
+#endif
+};
+
+#ifdef CC_USE_CURL
+static void share_lock(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    auto* st = static_cast<ConnectionPool::State*>(userptr);
+    st->shareLocks[data].lock();
+}
+
+static void share_unlock(CURL*, curl_lock_data data, void* userptr) {
+    auto* st = static_cast<ConnectionPool::State*>(userptr);
+    st->shareLocks[data].unlock();
+}
+
+static void destroy_handle(ConnectionPool::NativeHandle h) {
+    curl_easy_cleanup(static_cast<CURL*>(h));
+}
+#else
+static void destroy_handle(ConnectionPool::NativeHandle) {}
+#endif
+
+// -------------------------------
+// Lease
+// -------------------------------
+ConnectionPool::Lease::Lease(ConnectionPool* pool, std::string origin, NativeHandle h) noexcept
+    : pool_(pool), origin_(std::move(origin)), handle_(h) {}
+
+ConnectionPool::Lease::~Lease() {
+    release();
+}
+
+ConnectionPool::Lease::Lease(Lease&& o) noexcept
+    : pool_(std::exchange(o.pool_, nullptr)),
+      origin_(std::move(o.origin_)),
+      handle_(std::exchange(o.handle_, nullptr)),
+      reusable_(o.reusable_) {}
+
+ConnectionPool::Lease& ConnectionPool::Lease::operator=(Lease&& o) noexcept {
+    if (this != &o) {
+        release();
+        pool_     = std::exchange(o.pool_, nullptr);
+        origin_   = std::move(o.origin_);
+        handle_   = std::exchange(o.handle_, nullptr);
+        reusable_ = o.reusable_;
+    }
+    return *this;
+}
+
+void ConnectionPool::Lease::release() noexcept {
+    if (pool_ && handle_) {
+        pool_->release(origin_, handle_, reusable_);
+    }
+    pool_   = nullptr;
+    handle_ = nullptr;
+}
+
+// -------------------------------
+// ConnectionPool
+// -------------------------------
+ConnectionPool& ConnectionPool::instance() {
+    // Intencionalmente nunca se destruye: evita problemas de orden de destrucción
+    // estática con hilos que aún tengan handles prestados al salir del proceso.
+    static ConnectionPool* inst = new ConnectionPool();
+    return *inst;
+}
+
+ConnectionPool::ConnectionPool()
+    : state_(new State())
+{
+    const auto& cfg = cc::config::get();
+    state_->maxIdlePerHost = static_cast<std::size_t>(std::max(0, cfg.http.poolMaxIdlePerHost));
+    state_->idleTimeout    = Millis{std::max(1, cfg.http.poolIdleTimeoutMs)};
+
+#ifdef CC_USE_CURL
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    state_->share = curl_share_init();
+    if (state_->share) {
+        curl_share_setopt(state_->share, CURLSHOPT_LOCKFUNC,   &share_lock);
+        curl_share_setopt(state_->share, CURLSHOPT_UNLOCKFUNC, &share_unlock);
+        curl_share_setopt(state_->share, CURLSHOPT_USERDATA,   state_);
+        curl_share_setopt(state_->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(state_->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        // Las conexiones NO se comparten vía CURLSH: libcurl no soporta usar la caché de
+        // conexiones compartida desde hilos concurrentes. Cada handle del pool conserva
+        // su propia conexión viva, que es lo que reaprovechamos al reciclarlo.
+    } else {
+        CC_LOG_WARN("[HTTP] curl_share_init failed — pool without shared caches");
+    }
+#endif
+}
+
+ConnectionPool::~ConnectionPool() {
+    clear();
+#ifdef CC_USE_CURL
+    if (state_->share) curl_share_cleanup(state_->share);
+#endif
+    delete state_;
+}
+
+void ConnectionPool::configure(std::size_t maxIdlePerHost, Millis idleTimeout) {
+    std::vector<NativeHandle> drop;
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        state_->maxIdlePerHost = maxIdlePerHost;
+        state_->idleTimeout    = std::max(Millis{1}, idleTimeout);
+
+        for (auto& [origin, list] : state_->idle) {
+            while (list.size() > maxIdlePerHost) {
+                drop.push_back(list.front().handle);
+                list.erase(list.begin());
+                ++state_->stats.discarded;
+            }
+        }
+    }
+    for (auto h : drop) destroy_handle(h);
+}
+
+ConnectionPool::Lease ConnectionPool::acquire(const std::string& url) {
+#ifndef CC_USE_CURL
+    (void)url;
+    return Lease{};
+#else
+    std::string origin = origin_of(url);
+    NativeHandle h = nullptr;
+    std::vector<NativeHandle> expired;
+    long maxAgeSec = 1;
+
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        maxAgeSec = static_cast<long>(std::max<Millis::rep>(1, state_->idleTimeout.count() / 1000));
+
+        auto it = state_->idle.find(origin);
+        if (it != state_->idle.end()) {
+            auto& list = it->second;
+            // Los más viejos quedan al frente: purgamos los vencidos.
+            const auto now = SteadyClock::now();
+            auto firstFresh = std::find_if(list.begin(), list.end(), [&](const State::Idle& e) {
+                return now - e.since < state_->idleTimeout;
+            });
+            for (auto e = list.begin(); e != firstFresh; ++e) expired.push_back(e->handle);
+            state_->stats.discarded += static_cast<std::size_t>(firstFresh - list.begin());
+            list.erase(list.begin(), firstFresh);
+
+            if (!list.empty()) {
+                h = list.back().handle; // el más reciente: conexión más "caliente"
+                list.pop_back();
+                ++state_->stats.reused;
+            }
+        }
+        if (!h) ++state_->stats.created;
+    }
+
+    for (auto e : expired) destroy_handle(e);
+
+    CURL* curl = h ? static_cast<CURL*>(h) : curl_easy_init();
+    if (!curl) {
+        std::lock_guard<std::mutex> lk(state_->m);
+        --state_->stats.created;
+        return Lease{};
+    }
+
+    if (h) curl_easy_reset(curl); // conserva conexiones/caché, limpia opciones previas
+    if (state_->share) curl_easy_setopt(curl, CURLOPT_SHARE, state_->share);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_MAXAGE_CONN, maxAgeSec);
+
+    return Lease{this, std::move(origin), curl};
+#endif
+}
+
+void ConnectionPool::release(const std::string& origin, NativeHandle h, bool reusable) noexcept {
+    if (!h) return;
+    bool keep = false;
+    try {
+        std::lock_guard<std::mutex> lk(state_->m);
+        if (reusable && state_->maxIdlePerHost > 0) {
+            auto& list = state_->idle[origin];
+            if (list.size() < state_->maxIdlePerHost) {
+                list.push_back(State::Idle{h, SteadyClock::now()});
+                keep = true;
+            }
+        }
+        if (!keep) ++state_->stats.discarded;
+    } catch (...) {
+        keep = false;
+    }
+    if (!keep) destroy_handle(h);
+}
+
+void ConnectionPool::clear() {
+    std::vector<NativeHandle> drop;
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        for (auto& [origin, list] : state_->idle) {
+            for (auto& e : list) drop.push_back(e.handle);
+        }
+        state_->stats.discarded += drop.size();
+        state_->idle.clear();
+    }
+    for (auto h : drop) destroy_handle(h);
+}
+
+PoolStats ConnectionPool::stats() const {
+    std::lock_guard<std::mutex> lk(state_->m);
+    PoolStats s = state_->stats;
+    s.idle = 0;
+    for (const auto& [origin, list] : state_->idle) s.idle += list.size();
+    return s;
+}
+
+} // namespace cc::http
@@ -0,0 +1,87 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// connection_pool.h — Pool de handles libcurl reutilizables por origen (cada uno conserva su
+// conexión viva) + caché compartida de DNS y sesiones TLS vía CURLSH. Thread-safe; una
+// instancia por proceso.
+#ifndef LIB_CODECOACH_CONNECTION_POOL_H
+#define LIB_CODECOACH_CONNECTION_POOL_H
+
+#include "metrics/timer.h"
+
+#include <cstddef>
+#include <string>
+
+namespace cc::http {
+
+    struct PoolStats {
+        std::size_t created{0};   // handles creados con curl_easy_init
+        std::size_t reused{0};    // adquisiciones servidas desde el pool
+        std::size_t discarded{0}; // handles liberados (exceso o idle vencido)
+        std::size_t idle{0};      // handles ociosos en este momento
+    };
+
+    class ConnectionPool {
+    public:
+        // Handle nativo (CURL*), opaco para no exponer curl.h en headers públicos.
+        using NativeHandle = void*;
+
+        // RAII: devuelve el handle al pool al destruirse.
+        class Lease {
+        public:
+            Lease() noexcept = default;
+            Lease(ConnectionPool* pool, std::string origin, NativeHandle h) noexcept;
+            ~Lease();
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+            Lease(Lease&& o) noexcept;
+            Lease& operator=(Lease&& o) noexcept;
+
+            NativeHandle get() const noexcept { return handle_; }
+            explicit operator bool() const noexcept { return handle_ != nullptr; }
+
+            // Marca el handle como no reutilizable (p.ej. tras un error de transporte).
+            void discard() noexcept { reusable_ = false; }
+
+        private:
+            void release() noexcept;
+
+            ConnectionPool* pool_{nullptr};
+            std::string     origin_;
+            NativeHandle    handle_{nullptr};
+            bool            reusable_{true};
+        };
+
+        // Instancia global; se configura desde cc::config::get().http en el primer uso.
+        static ConnectionPool& instance();
+
+        // maxIdlePerHost = 0 => no se guardan handles (cada acquire crea uno nuevo,
+        // aunque sigue compartiendo DNS/TLS vía CURLSH).
+        void configure(std::size_t maxIdlePerHost, cc::time::Millis idleTimeout);
+
+        // Obtiene un handle listo para usar (reset + CURLSH aplicado) para la URL dada.
+        Lease acquire(const std::string& url);
+
+        // Libera todos los handles ociosos.
+        void clear();
+
+        PoolStats stats() const;
+
+        ~ConnectionPool();
+        ConnectionPool(const ConnectionPool&) = delete;
+        ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+        struct State;
+
+    private:
+        ConnectionPool();
+        void release(const std::string& origin, NativeHandle h, bool reusable) noexcept;
+
+        // PIMPL: mutex, CURLSH y mapas por origen viven en el .cpp
+        State* state_;
+    };
+
+} // namespace cc::http
+
+#endif // LIB_CODECOACH_CONNECTION_POOL_H
@@ -0,0 +1,331 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// curl_transfer.cpp — Implementación de CurlTransfer (callbacks y opciones libcurl).
+
+#include "curl_transfer.h"
+
+#ifdef CC_USE_CURL
+
+#include "adaptive_timeouts.h"
+#include "url.h"
+#include "metrics/counters.h"
+
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+namespace cc::http {
+
+// --- Callbacks para libcurl --- //
+static size_t write_callback(char* ptr, size_t size, size_t nmemb, void* userdata) {
+    return static_cast<CurlTransfer*>(userdata)->on_body(ptr, size * nmemb);
+}
+
+static size_t header_callback(char* buffer, size_t size, size_t nitems, void* userdata) {
+    size_t total = size * nitems;
+    return static_cast<CurlTransfer*>(userdata)->on_header(std::string_view(buffer, total)) ? total : 0;
+}
+
+// Progreso: devolver != 0 aborta la transferencia (CURLE_ABORTED_BY_CALLBACK)
+static int xferinfo_callback(void* userdata, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+    const auto* req = static_cast<const HttpRequest*>(userdata);
+    return req->is_cancelled() ? 1 : 0;
+}
+
+// libcurl 7.x no reutiliza bien una conexión abierta con prior knowledge ("Error in the
+// HTTP2 framing layer" desde el 2º request). Ahí usamos Upgrade: h2c, que cuesta un ida y
+// vuelta por conexión y después multiplexa igual. Se mira la versión en runtime (la .so
+// puede no coincidir con los headers).
+static bool prior_knowledge_reusable() {
+    static const bool ok = curl_version_info(CURLVERSION_NOW)->version_num >= 0x080000;
+    return ok;
+}
+
+HeaderList::~HeaderList() {
+    if (list) curl_slist_free_all(list);
+}
+
+std::shared_ptr<const HeaderList> build_header_list(
+    const HeaderMap& headers) {
+    if (headers.empty()) return nullptr;
+    auto out = std::make_shared<HeaderList>();
+    std::string line;
+    for (const auto& kv : headers) {
+        line.assign(kv.first).append(": ").append(kv.second);
+        out->list = curl_slist_append(out->list, line.c_str());
+    }
+    return out;
+}
+
+CurlTransfer::~CurlTransfer() {
+    if (hdrs_) curl_slist_free_all(hdrs_);
+}
+
+bool CurlTransfer::streaming() {
+    if (!sink_) return false;
+    if (!sinkDecided_) {
+        long code = 0;
+        curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &code);
+        toSink_      = code >= 200 && code < 300;
+        sinkDecided_ = true;
+    }
+    return toSink_;
+}
+
+std::size_t CurlTransfer::on_body(const char* data, std::size_t n) noexcept {
+    try {
+        if (streaming()) {
+            streamed_ += n;
+            if (!(*sink_)(std::string_view(data, n))) {
+                sinkAborted_ = true;
+                return 0; // => CURLE_WRITE_ERROR
+            }
+            return n;
+        }
+        body_.append(data, n);
+        return n;
+    } catch (...) {
+        error_ = std::current_exception();
+        return 0; // => CURLE_WRITE_ERROR; finish() la deja en HttpResponse::error
+    }
+}
+
+bool CurlTransfer::on_header(std::string_view line) noexcept {
+    try {
+        add_header(line);
+        return true;
+    } catch (...) {
+        error_ = std::current_exception();
+        return false;
+    }
+}
+
+void CurlTransfer::add_header(std::string_view line) {
+    // Cada respuesta (también las 1xx intermedias) empieza con su status line: solo
+    // cuentan los headers de la última
+    if (line.substr(0, 5) == "HTTP/") {
+        headers_.clear();
+        return;
+    }
+    auto pos = line.find(':');
+    if (pos == std::string_view::npos) return;
+
+    std::string_view k = line.substr(0, pos);
+    std::string_view v = line.substr(pos + 1);
+    while (!v.empty() && (v.front()==' ' || v.front()=='\t')) v.remove_prefix(1);
+    while (!v.empty() && (v.back()=='\r' || v.back()=='\n')) v.remove_suffix(1);
+    while (!k.empty() && (k.back()=='\r' || k.back()=='\n')) k.remove_suffix(1);
+    if (k.empty()) return;
+
+    // Content-Length conocido: reservar de una vez en vez de crecer por duplicación.
+    // Con Content-Encoding es el tamaño comprimido (cota inferior), igual sirve.
+    if (iequals_ascii(k, "content-length") && !streaming()) {
+        std::size_t len = 0;
+        for (char c : v) {
+            if (c < '0' || c > '9') { len = 0; break; }
+            len = len * 10 + static_cast<std::size_t>(c - '0');
+            if (len > kMaxReserve) break;
+        }
+        if (len > 0) body_.reserve(std::min(len, kMaxReserve));
+    }
+    // Una respuesta típica trae ~20 headers: una sola reserva para todos
+    if (headers_.empty()) headers_.reserve(kTypicalHeaders, kTypicalHeaderBytes);
+    headers_.combine(k, v);
+}
+
+void CurlTransfer::prepare(CURL* curl, const HttpRequest& req) {
+    curl_ = curl;
+    req_  = &req;
+    sink_ = req.sink ? &req.sink : nullptr;
+    if (req.endpoint.empty()) endpointOwned_ = endpoint_of(req.method, req.url);
+    endpoint_ = req.endpoint.empty() ? std::string_view(endpointOwned_) : std::string_view(req.endpoint);
+    reqWire_  = req.payload().size();
+    reqRaw_   = req.rawBodySize > 0 ? req.rawBodySize : reqWire_;
+
+    // POSTFIELDS no copia; nunca pasarle nullptr (libcurl lo interpreta como "leer por callback")
+    const std::string_view payload = req.payload();
+    const std::string_view body    = payload.data() ? payload : std::string_view("");
+
+    // URL
+    curl_easy_setopt(curl, CURLOPT_URL, req.url.c_str());
+
+    // Método HTTP
+    if (req.method == "GET") {
+        curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+    } else if (req.method == "POST") {
+        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.data());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE,
+                         static_cast<curl_off_t>(body.size()));
+    } else if (req.method == "PUT") {
+        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT");
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.data());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE,
+                         static_cast<curl_off_t>(body.size()));
+    } else if (req.method == "DELETE") {
+        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
+    } else if (req.method == "HEAD") {
+        curl_easy_setopt(curl, CURLOPT_NOBODY, 1L); // sin esto libcurl esperaría el body
+    } else {
+        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, req.method.c_str());
+    }
+
+    // Timeout
+    // CURLOPT_* son enumeradores (no macros): se detecta por versión (TIMEOUT_MS existe desde 7.16.2)
+#if LIBCURL_VERSION_NUM >= 0x071002
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(req.timeoutMs));
+    if (req.connectTimeoutMs > 0) {
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(req.connectTimeoutMs));
+    }
+#else
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, static_cast<long>((req.timeoutMs + 999) / 1000));
+    if (req.connectTimeoutMs > 0) {
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, static_cast<long>((req.connectTimeoutMs + 999) / 1000));
+    }
+#endif
+
+    // Versión HTTP. PIPEWAIT: preferir esperar a la conexión h2 ya abierta (y multiplexar)
+    // antes que abrir conexiones nuevas en paralelo.
+    switch (req.version) {
+        case cc::config::HttpVersion::Http1_1:
+            curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
+            break;
+        case cc::config::HttpVersion::Http2:
+            curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+            curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+            break;
+        case cc::config::HttpVersion::Http2PriorKnowledge:
+            curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, prior_knowledge_reusable()
+                                                         ? CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE
+                                                         : CURL_HTTP_VERSION_2_0);
+            curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+            break;
+    }
+
+    // Headers de request: la lista ya armada (compartida) o una propia de este intento
+    if (req.headerList) {
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, req.headerList->list);
+    } else {
+        std::string line;
+        for (const auto& kv : req.headers) {
+            line.assign(kv.first).append(": ").append(kv.second);
+            hdrs_ = curl_slist_append(hdrs_, line.c_str());
+        }
+        if (hdrs_) {
+            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, hdrs_);
+        }
+    }
+
+    // Respuestas comprimidas: "" => todas las codificaciones que soporte este libcurl
+    // (gzip/deflate y, según build, br/zstd). libcurl decodifica antes de write_callback.
+    curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+
+    // Callbacks de respuesta
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, this);
+
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, &header_callback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, this);
+
+    // Cancelación a mitad de transferencia
+    if (req.cancellable()) {
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, &xferinfo_callback);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &req);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    }
+}
+
+HttpResponse CurlTransfer::finish(CURL* curl, CURLcode rc) {
+    HttpResponse out;
+    long http_code = 0;
+    if (rc == CURLE_OK) {
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+        out.statusCode = static_cast<int>(http_code);
+        record_wire_bytes(curl);
+        record_latency(curl, false);
+        out.body       = std::move(body_);
+        out.headers    = std::move(headers_);
+    } else if (rc == CURLE_ABORTED_BY_CALLBACK) {
+        out.statusCode = 499; // "Client Closed Request"
+        out.body = "request cancelled";
+    } else if (rc == CURLE_WRITE_ERROR && error_) {
+        out.statusCode = 499;
+        out.body  = "request aborted: response callback threw";
+        out.error = error_;
+    } else if (rc == CURLE_WRITE_ERROR && sinkAborted_) {
+        out.statusCode = 499;
+        out.body = "request aborted by body sink";
+    } else {
+        if (rc == CURLE_OPERATION_TIMEDOUT) record_latency(curl, true);
+        out.statusCode = 0;
+        out.body = std::string("curl error: ") + curl_easy_strerror(rc);
+    }
+
+    // Desenganchar punteros a este objeto antes de que el handle se reutilice
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, nullptr);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, nullptr);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, nullptr);
+    return out;
+}
+
+// Contadores (etiqueta "|METHOD origin/path"):
+//   http.req_bytes_raw / http.req_bytes_wire    body enviado antes/después de Content-Encoding
+//   http.resp_bytes_raw / http.resp_bytes_wire  body recibido decodificado / tal como llegó
+//   http.bytes_saved                            suma de ambos ahorros
+void CurlTransfer::record_wire_bytes(CURL* curl) const {
+    curl_off_t down = 0;
+    curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &down);
+    const auto respRaw  = static_cast<std::int64_t>(body_.size() + streamed_);
+    const auto respWire = static_cast<std::int64_t>(down);
+    const auto reqRaw   = static_cast<std::int64_t>(reqRaw_);
+    const auto reqWire  = static_cast<std::int64_t>(reqWire_);
+
+    auto& c = cc::metrics::Counters::instance();
+    std::string key;
+    key.reserve(24 + endpoint_.size());
+    auto add = [&](const char* name, std::int64_t v) {
+        key.assign(name).append(1, '|').append(endpoint_);
+        c.add(key, v);
+    };
+    add("http.req_bytes_raw",   reqRaw);
+    add("http.req_bytes_wire",  reqWire);
+    add("http.resp_bytes_raw",  respRaw);
+    add("http.resp_bytes_wire", respWire);
+    add("http.bytes_saved",     (reqRaw - reqWire) + (respRaw - respWire));
+}
+
+// Transferencias completas y timeouts. Un timeout no dice cuánto habría tardado, pero sí que
+// tardó al menos eso: se registra como muestra censurada en el valor del timeout. Si no, con
+// la latencia subiendo por encima del timeout aprendido ningún intento dejaría muestras y el
+// timeout seguiría corto hasta que se vacíe la ventana. Solo cuenta el timeout propio del
+// cliente (no uno explícito del llamador ni el recortado por un deadline). Los bodies en
+// streaming y los HEAD (p.ej. prewarm) no representan la duración de una llamada normal.
+void CurlTransfer::record_latency(CURL* curl, bool timedOut) const {
+    if (!req_ || (timedOut && !req_->timeoutIsSample)) return;
+    auto& lat = EndpointLatencies::instance();
+    const std::string origin = req_->origin.empty() ? origin_of(req_->url) : req_->origin;
+
+    // Conexión nueva (no reutilizada): hasta el fin del handshake TLS, o del TCP en http://
+    long connects = 0;
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &connects);
+    if (connects > 0) {
+        curl_off_t connectUs = 0;
+        curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &connectUs);
+        if (connectUs == 0) curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connectUs);
+        if (connectUs > 0) lat.record_connect(origin, cc::time::Micros{connectUs});
+    }
+
+    if (sink_ || req_->method == "HEAD") return;
+    curl_off_t totalUs = 0;
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &totalUs);
+    lat.record_response(std::string(endpoint_), origin, cc::time::Micros{totalUs});
+    if (timedOut) cc::metrics::count("http.timeout.sampled|" + std::string(endpoint_));
+}
+
+} // namespace cc::http
+
+#endif // CC_USE_CURL
@@ -0,0 +1,94 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// curl_transfer.h — (interno) Configuración de un CURL* a partir de un HttpRequest y armado del
+// HttpResponse. Compartido por el camino síncrono (HttpClient) y el motor curl_multi (AsyncEngine).
+// Solo debe incluirse desde .cpp de la librería compilados con CC_USE_CURL.
+#ifndef LIB_CODECOACH_CURL_TRANSFER_H
+#define LIB_CODECOACH_CURL_TRANSFER_H
+
+#ifdef CC_USE_CURL
+
+#include "http_client.h"
+
+#include <curl/curl.h>
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace cc::http {
+
+    // Lista de headers de libcurl compartible (inmutable una vez armada)
+    struct HeaderList {
+        curl_slist* list{nullptr};
+
+        HeaderList() = default;
+        ~HeaderList();
+        HeaderList(const HeaderList&) = delete;
+        HeaderList& operator=(const HeaderList&) = delete;
+    };
+
+    // nullptr si no hay headers
+    std::shared_ptr<const HeaderList> build_header_list(
+        const HeaderMap& headers);
+
+    // Buffers de una transferencia en curso. Debe vivir (sin moverse) hasta finish().
+    class CurlTransfer {
+    public:
+        CurlTransfer() = default;
+        ~CurlTransfer();
+        CurlTransfer(const CurlTransfer&) = delete;
+        CurlTransfer& operator=(const CurlTransfer&) = delete;
+
+        // Aplica método, URL, body, timeout, headers y callbacks. `req` debe sobrevivir
+        // a la transferencia (CURLOPT_POSTFIELDS no copia el body).
+        void prepare(CURL* curl, const HttpRequest& req);
+
+        // Construye la respuesta y desengancha del handle los punteros a este objeto.
+        // Acumula bytes crudos/en el cable por endpoint en cc::metrics (ver record_wire_bytes)
+        // y la latencia total/de conexión en EndpointLatencies (ver record_latency).
+        HttpResponse finish(CURL* curl, CURLcode rc);
+
+        // Llamados desde los callbacks de libcurl. No lanzan: una excepción (del BodySink o
+        // de memoria) no puede cruzar el C de libcurl; se guarda, se aborta la transferencia
+        // y finish() la deja en HttpResponse::error.
+        std::size_t on_body(const char* data, std::size_t n) noexcept;
+        bool        on_header(std::string_view line) noexcept; // false => abortar
+
+    private:
+        static constexpr std::size_t kMaxReserve = 256u * 1024 * 1024; // tope del pre-reserve
+        static constexpr std::size_t kTypicalHeaders     = 24;
+        static constexpr std::size_t kTypicalHeaderBytes = 768;
+
+        bool streaming(); // ¿el body va al sink? (solo respuestas 2xx)
+        void add_header(std::string_view line);
+        void record_wire_bytes(CURL* curl) const;
+        void record_latency(CURL* curl, bool timedOut) const;
+
+        CURL*                                        curl_{nullptr};
+        const HttpRequest*                           req_{nullptr};
+        const BodySink*                              sink_{nullptr};
+        bool                                         sinkDecided_{false};
+        bool                                         toSink_{false};
+        bool                                         sinkAborted_{false};
+        std::size_t                                  streamed_{0};
+        std::exception_ptr                           error_;
+
+        std::string                                  endpointOwned_; // si el request no trae etiqueta
+        std::string_view                             endpoint_;
+        std::size_t                                  reqRaw_{0};
+        std::size_t                                  reqWire_{0};
+        std::string                                  body_;
+        HeaderMap                                    headers_;
+        curl_slist*                                  hdrs_{nullptr};
+    };
+
+} // namespace cc::http
+
+#endif // CC_USE_CURL
+
+#endif // LIB_CODECOACH_CURL_TRANSFER_H
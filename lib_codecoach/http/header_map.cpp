@@ -0,0 +1,194 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// header_map.cpp — Arena + índice de headers comunes.
+
+#include "header_map.h"
+
+#include <algorithm>
+
+namespace cc::http {
+
+namespace {
+
+// Orden fijo: la posición es el índice en HeaderMap::index_
+constexpr std::array<std::string_view, HeaderMap::kKnownHeaders> kKnown = {
+    "content-type",  "content-length", "content-encoding", "transfer-encoding",
+    "cache-control", "etag",           "last-modified",    "expires",
+    "date",          "age",            "vary",             "retry-after",
+    "location",      "connection",     "authorization",    "accept",
+    "accept-encoding", "if-none-match", "if-modified-since", "user-agent",
+    "server",        "set-cookie",     "x-circuit-breaker", "x-request-id",
+};
+
+inline char lower_ascii(char c) noexcept {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Tabla por longitud: solo se comparan los nombres comunes del mismo largo
+constexpr std::size_t kMaxKnownLen = 17;
+
+struct KnownByLength {
+    std::array<std::array<std::int8_t, 4>, kMaxKnownLen + 1> ids{};
+
+    constexpr KnownByLength() {
+        for (auto& row : ids) row = {-1, -1, -1, -1};
+        for (std::size_t i = 0; i < kKnown.size(); ++i) {
+            auto& row = ids[kKnown[i].size()];
+            std::size_t j = 0;
+            while (row[j] >= 0) ++j;
+            row[j] = static_cast<std::int8_t>(i);
+        }
+    }
+};
+
+constexpr KnownByLength kByLength{};
+
+int known_id(std::string_view name) noexcept {
+    if (name.size() > kMaxKnownLen) return -1;
+    for (const std::int8_t id : kByLength.ids[name.size()]) {
+        if (id < 0) break;
+        if (iequals_ascii(kKnown[static_cast<std::size_t>(id)], name)) return id;
+    }
+    return -1;
+}
+
+constexpr int kSetCookie = 21; // posición de "set-cookie" en kKnown
+static_assert(kKnown[kSetCookie] == "set-cookie");
+
+constexpr std::size_t kMaxIndexed = 0xFFFE; // index_ guarda entrada + 1 en 16 bits
+
+} // namespace
+
+bool iequals_ascii(std::string_view a, std::string_view b) noexcept {
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (lower_ascii(a[i]) != lower_ascii(b[i])) return false;
+    }
+    return true;
+}
+
+HeaderMap::HeaderMap(std::initializer_list<value_type> init) {
+    std::size_t bytes = 0;
+    for (const auto& [k, v] : init) bytes += k.size() + v.size();
+    reserve(init.size(), bytes);
+    for (const auto& [k, v] : init) set(k, v);
+}
+
+void HeaderMap::add(std::string_view name, std::string_view value) {
+    add(name, value, known_id(name));
+}
+
+void HeaderMap::add(std::string_view name, std::string_view value, int known) {
+    Entry e;
+    e.off      = static_cast<std::uint32_t>(arena_.size());
+    e.nameLen  = static_cast<std::uint32_t>(name.size());
+    e.valueLen = static_cast<std::uint32_t>(value.size());
+    e.known    = known;
+    arena_.append(name).append(value);
+    entries_.push_back(e);
+    if (e.known >= 0 && entries_.size() <= kMaxIndexed) {
+        index_[static_cast<std::size_t>(e.known)] = static_cast<std::uint16_t>(entries_.size());
+    }
+}
+
+void HeaderMap::set(std::string_view name, std::string_view value) {
+    // Lo habitual es que no esté: add() directo, sin recorrer ni reindexar
+    const int known = known_id(name);
+    if (find(name, known)) erase(name);
+    add(name, value, known);
+}
+
+void HeaderMap::combine(std::string_view name, std::string_view value) {
+    const int known = known_id(name);
+    const auto i = known == kSetCookie ? std::nullopt : find(name, known);
+    if (!i) {
+        add(name, value, known);
+        return;
+    }
+    // Nombre y valor van contiguos: la entrada pasa a apuntar a una copia unida al final
+    // de la arena (la anterior queda sin uso hasta clear(), como con erase())
+    Entry& e = entries_[*i];
+    std::string joined;
+    joined.reserve(e.nameLen + e.valueLen + 2 + value.size());
+    joined.append(arena_, e.off, e.nameLen + e.valueLen).append(", ").append(value);
+    e.off      = static_cast<std::uint32_t>(arena_.size());
+    e.valueLen = static_cast<std::uint32_t>(joined.size() - e.nameLen);
+    arena_.append(joined);
+}
+
+bool HeaderMap::parse_line(std::string_view line) {
+    const auto colon = line.find(':');
+    if (colon == std::string_view::npos || colon == 0) return false; // status line / línea vacía
+
+    std::string_view k = line.substr(0, colon);
+    std::string_view v = line.substr(colon + 1);
+    while (!k.empty() && (k.back() == ' ' || k.back() == '\t')) k.remove_suffix(1);
+    while (!v.empty() && (v.front() == ' ' || v.front() == '\t')) v.remove_prefix(1);
+    while (!v.empty() && (v.back() == '\r' || v.back() == '\n' || v.back() == ' ' || v.back() == '\t')) {
+        v.remove_suffix(1);
+    }
+    if (k.empty()) return false;
+    combine(k, v);
+    return true;
+}
+
+std::optional<std::size_t> HeaderMap::find(std::string_view name, int known) const noexcept {
+    if (known >= 0 && entries_.size() <= kMaxIndexed) {
+        const std::uint16_t slot = index_[static_cast<std::size_t>(known)];
+        if (slot == 0) return std::nullopt;
+        return static_cast<std::size_t>(slot - 1);
+    }
+    // Desde el final: con duplicados gana el último
+    for (std::size_t i = entries_.size(); i-- > 0;) {
+        const Entry& e = entries_[i];
+        if (e.nameLen == name.size() &&
+            iequals_ascii(std::string_view(arena_).substr(e.off, e.nameLen), name)) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string_view> HeaderMap::get(std::string_view name) const noexcept {
+    const auto i = find(name, known_id(name));
+    if (!i) return std::nullopt;
+    return at(*i).second;
+}
+
+bool HeaderMap::erase(std::string_view name) {
+    const auto before = entries_.size();
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                  [&](const Entry& e) {
+                                      return e.nameLen == name.size() &&
+                                             iequals_ascii(std::string_view(arena_).substr(e.off, e.nameLen), name);
+                                  }),
+                   entries_.end());
+    if (entries_.size() == before) return false;
+    reindex(); // los bytes quedan en la arena hasta clear()
+    return true;
+}
+
+void HeaderMap::clear() noexcept {
+    arena_.clear();
+    entries_.clear();
+    index_.fill(0);
+}
+
+void HeaderMap::reserve(std::size_t entries, std::size_t bytes) {
+    entries_.reserve(entries);
+    arena_.reserve(bytes);
+}
+
+void HeaderMap::reindex() noexcept {
+    index_.fill(0);
+    const std::size_t n = std::min(entries_.size(), kMaxIndexed);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (entries_[i].known >= 0) {
+            index_[static_cast<std::size_t>(entries_[i].known)] = static_cast<std::uint16_t>(i + 1);
+        }
+    }
+}
+
+} // namespace cc::http
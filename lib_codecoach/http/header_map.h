@@ -0,0 +1,109 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// header_map.h — Headers HTTP case-insensitive en un solo buffer: nombres y valores van
+// contiguos en una arena (std::string) y cada entrada guarda offsets, así una respuesta de
+// 20 headers cuesta 2 asignaciones en vez de ~40. Los headers comunes (Content-Type, ETag,
+// Cache-Control, Retry-After, ...) se buscan en O(1) por un índice fijo; el resto, con un
+// recorrido lineal (pocos headers). Se usa en requests y respuestas (HttpRequest/HttpResponse).
+#ifndef LIB_CODECOACH_HEADER_MAP_H
+#define LIB_CODECOACH_HEADER_MAP_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cc::http {
+
+    class HeaderMap {
+        struct Entry {
+            std::uint32_t off{0};     // nombre en [off, off + nameLen), valor a continuación
+            std::uint32_t nameLen{0};
+            std::uint32_t valueLen{0};
+            std::int32_t  known{-1};  // índice en la tabla de headers comunes (-1 => otro)
+        };
+
+    public:
+        using value_type = std::pair<std::string_view, std::string_view>;
+
+        // Headers con índice O(1)
+        static constexpr std::size_t kKnownHeaders = 24;
+
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = HeaderMap::value_type;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = value_type;
+
+            const_iterator() = default;
+            value_type operator*() const { return map_->at(i_); }
+            const_iterator& operator++() { ++i_; return *this; }
+            const_iterator operator++(int) { auto t = *this; ++i_; return t; }
+            bool operator==(const const_iterator& o) const { return i_ == o.i_; }
+            bool operator!=(const const_iterator& o) const { return i_ != o.i_; }
+
+        private:
+            friend class HeaderMap;
+            const_iterator(const HeaderMap* m, std::size_t i) : map_(m), i_(i) {}
+
+            const HeaderMap* map_{nullptr};
+            std::size_t      i_{0};
+        };
+
+        HeaderMap() = default;
+        HeaderMap(std::initializer_list<value_type> init);
+
+        // Reemplaza (case-insensitive) todas las apariciones de `name`.
+        void set(std::string_view name, std::string_view value);
+        // Agrega sin buscar; con duplicados get() devuelve el último.
+        void add(std::string_view name, std::string_view value);
+        // Campo repetido de un mensaje: si ya está, une los valores con ", " (RFC 9110 §5.3).
+        // Set-Cookie no admite esa unión y va como entrada aparte (get() da la última).
+        void combine(std::string_view name, std::string_view value);
+        // Línea cruda "Name: value\r\n" de una respuesta (como la entrega libcurl). Ignora la
+        // status line y la línea vacía; un header repetido se une con combine(). false => ignorada.
+        bool parse_line(std::string_view line);
+
+        std::optional<std::string_view> get(std::string_view name) const noexcept;
+        bool contains(std::string_view name) const noexcept { return get(name).has_value(); }
+        bool erase(std::string_view name); // todas las apariciones; false si no había
+
+        std::size_t size() const noexcept { return entries_.size(); }
+        bool        empty() const noexcept { return entries_.empty(); }
+        void        clear() noexcept;
+        void        reserve(std::size_t entries, std::size_t bytes);
+        std::size_t bytes() const noexcept { return arena_.size(); } // nombres + valores (incluye pisados)
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, entries_.size()); }
+
+    private:
+        value_type at(std::size_t i) const noexcept {
+            const Entry& e = entries_[i];
+            return {std::string_view(arena_).substr(e.off, e.nameLen),
+                    std::string_view(arena_).substr(e.off + e.nameLen, e.valueLen)};
+        }
+        std::optional<std::size_t> find(std::string_view name, int known) const noexcept;
+        void add(std::string_view name, std::string_view value, int known);
+        void reindex() noexcept;
+
+        std::string        arena_;
+        std::vector<Entry> entries_;
+        std::array<std::uint16_t, kKnownHeaders> index_{}; // entrada + 1 (0 => no está)
+    };
+
+    // ¿`a` y `b` son iguales sin distinguir mayúsculas (ASCII)?
+    bool iequals_ascii(std::string_view a, std::string_view b) noexcept;
+
+} // namespace cc::http
+
+#endif // LIB_CODECOACH_HEADER_MAP_H
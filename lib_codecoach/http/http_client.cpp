@@ -3,19 +3,35 @@
 //
 
 #include "http_client.h"
+#include "async_engine.h"
+#include "circuit_breaker.h"
+#include "compression.h"
+#include "connection_pool.h"
+#include "rate_limiter.h"
+#include "retry_budget.h"
+#include "single_flight.h"
+#include "url.h"
 
 #include "logging/logger.h"
+#include "metrics/counters.h"
 #include "metrics/timer.h"
 #include "config/config_manager.h"
 
 #include <sstream>
+#include <exception>
 #include <stdexcept>
 #include <algorithm>
-#include <unordered_map>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <cctype>
 #include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #ifdef CC_USE_CURL
+  #include "curl_transfer.h"
   #include <curl/curl.h>
 #endif
 
@@ -26,6 +42,10 @@ using cc::logging::Level;
 using cc::time::Millis;
 using cc::time::Backoff;
 using cc::time::BackoffPolicy;
+using cc::time::Micros;
+using cc::time::SteadyClock;
+using cc::time::CancellationSource;
+using cc::metrics::LatencyTracker;
 
 // ---------------------
 // Utilidades internas
@@ -36,31 +56,6 @@ static std::string method_upper(std::string m) {
     return m;
 }
 
-#ifdef CC_USE_CURL
-// --- Callbacks para libcurl --- //
-static size_t write_callback(char* ptr, size_t size, size_t nmemb, void* userdata) {
-    auto* s = static_cast<std::string*>(userdata);
-    s->append(ptr, size * nmemb);
-    return size * nmemb;
-}
-
-static size_t header_callback(char* buffer, size_t size, size_t nitems, void* userdata) {
-    size_t total = size * nitems;
-    auto* map = static_cast<std::unordered_map<std::string, std::string>*>(userdata);
-    std::string line(buffer, total);
-    auto pos = line.find(':');
-    if (pos != std::string::npos) {
-        std::string k = line.substr(0, pos);
-        std::string v = line.substr(pos + 1);
-        while (!v.empty() && (v.front()==' ' || v.front()=='\t')) v.erase(v.begin());
-        while (!v.empty() && (v.back()=='\r' || v.back()=='\n')) v.pop_back();
-        while (!k.empty() && (k.back()=='\r' || k.back()=='\n')) k.pop_back();
-        if (!k.empty()) (*map)[k] = v;
-    }
-    return total;
-}
-#endif // CC_USE_CURL
-
 static bool is_retryable_status(int code) {
     // 5xx + 429 + 0 (error de red/timeout)
     return (code >= 500 && code < 600) || code == 429 || code == 0;
@@ -71,13 +66,271 @@ static std::string short_url(std::string_view url) {
     return std::string(url.substr(0, 256)) + "...";
 }
 
+static BackoffPolicy make_retry_policy(int retries, cc::config::RetryBackoff shape, Millis maxRetryAfter) {
+    BackoffPolicy pol;
+    pol.base         = Millis{200};
+    pol.factor       = 2.0;
+    pol.max_delay    = Millis{3000};
+    pol.jitter_pct   = 0.20;
+    pol.max_attempts = std::max(1, retries + 1); // intentos totales
+    pol.mode         = shape == cc::config::RetryBackoff::Decorrelated ? cc::time::BackoffMode::DecorrelatedJitter
+                                                                      : cc::time::BackoffMode::Exponential;
+    pol.honor_server_delay = maxRetryAfter.count() > 0;
+    pol.max_server_delay   = maxRetryAfter;
+    return pol;
+}
+
+// Delay del próximo reintento: el Retry-After del servidor manda sobre el backoff propio.
+// nullopt => el servidor pidió esperar más de lo que conviene (no se reintenta).
+static std::optional<Millis> next_retry_delay(Backoff& backoff, const HttpResponse& last) {
+    const auto hint = retry_after_of(last);
+    if (hint && backoff.server_delay_too_long(*hint)) {
+        CC_LOG_WARN(std::string("[HTTP] not retrying: Retry-After ") + std::to_string(hint->count()) +
+                    " ms exceeds the retry limit");
+        return std::nullopt;
+    }
+    return backoff.next_delay(hint);
+}
+
+static void log_retry(int status, int attempt, int maxAttempts, Millis delay) {
+    CC_LOG_WARN(std::string("[HTTP] failed (status=") + std::to_string(status) +
+                ") attempt " + std::to_string(attempt) + "/" + std::to_string(maxAttempts) +
+                " — retry in " + std::to_string(delay.count()) + " ms");
+}
+
+static HttpResponse circuit_open_response(const std::string& origin) {
+    HttpResponse r;
+    r.statusCode = 503;
+    r.body = "circuit breaker open for " + origin;
+    r.headers.set("X-Circuit-Breaker", "open");
+    return r;
+}
+
+static HttpResponse cancelled_response() {
+    HttpResponse r;
+    r.statusCode = 499;
+    r.body = "request cancelled";
+    return r;
+}
+
+static HttpResponse deadline_response() {
+    HttpResponse r;
+    r.statusCode = 0;
+    r.body = "deadline exceeded";
+    return r;
+}
+
+// Con deadline, el timeout del intento se recorta a lo que queda del presupuesto.
+// nullptr => el deadline ya venció.
+static std::shared_ptr<const HttpRequest> fit_to_deadline(const std::shared_ptr<const HttpRequest>& req,
+                                                          const RequestControl& ctl) {
+    if (!ctl.deadline) return req;
+    const auto remaining = ctl.deadline->remaining();
+    if (remaining.count() <= 0) return nullptr;
+    if (remaining.count() >= req->timeoutMs) return req;
+    auto shrunk = std::make_shared<HttpRequest>(*req);
+    shrunk->timeoutMs = static_cast<int>(remaining.count());
+    shrunk->timeoutIsSample = false; // vencer el deadline no dice nada de la latencia del origen
+    return shrunk;
+}
+
+// El intento recortado por fit_to_deadline se quedó sin tiempo porque venció el deadline
+// del llamador, no porque el origen fallara: para el breaker y el limitador es una
+// cancelación (499), no un fallo ni una señal de sobrecarga. El timeout recortado se
+// redondea hacia abajo y curl lo vence con resolución de ms: puede volver un poco antes
+// de que el deadline llegue a 0.
+static constexpr Millis kDeadlineSlack{10};
+
+static bool cut_by_deadline(bool shortened, const HttpResponse& resp, const RequestControl& ctl) {
+    return shortened && resp.statusCode == 0 && ctl.deadline && ctl.deadline->remaining() <= kDeadlineSlack;
+}
+
+static bool is_idempotent_read(const std::string& method) {
+    return method == "GET" || method == "HEAD";
+}
+
+static bool carries_credentials(const HeaderMap& headers) {
+    return get_header_ci(headers, "Authorization") || get_header_ci(headers, "Proxy-Authorization") ||
+           get_header_ci(headers, "Cookie");
+}
+
+// Requests que no pasan por la caché: el llamador pide datos de origen, manda sus propios
+// validadores o credenciales (la caché se comparte entre clientes). Las credenciales se miran
+// en los headers efectivos: también en los default del cliente (p.ej. el Bearer de OpenAIClient).
+static bool bypasses_cache(const HeaderMap& headers, const HeaderMap& defaults) {
+    if (auto cc = get_header_ci(headers, "Cache-Control")) {
+        if (cc->find("no-cache") != std::string::npos || cc->find("no-store") != std::string::npos) return true;
+    }
+    return carries_credentials(headers) || carries_credentials(defaults) ||
+           get_header_ci(headers, "If-None-Match") || get_header_ci(headers, "If-Modified-Since");
+}
+
+// Headers del GET a enviar: los del llamador + validadores de la entrada vencida
+static HeaderMap conditional_headers(
+    const HeaderMap& headers, const ResponseCache::Lookup& hit) {
+    auto out = headers;
+    if (!hit.etag.empty())         out.set("If-None-Match", hit.etag);
+    if (!hit.lastModified.empty()) out.set("If-Modified-Since", hit.lastModified);
+    return out;
+}
+
+static HttpResponse cache_hit_response(ResponseCache::Lookup& hit) {
+    cc::metrics::count("http.cache.hit");
+    cc::metrics::count("http.cache.bytes_saved", static_cast<std::int64_t>(hit.response.body.size()));
+    return std::move(hit.response);
+}
+
+// Respuesta de red de un GET cacheable: 304 => body guardado; 200 => se guarda
+static HttpResponse finish_cached_get(ResponseCache& cache, const std::string& url,
+                                      std::optional<ResponseCache::Lookup>& hit, HttpResponse resp) {
+    if (resp.statusCode == 304 && hit) {
+        cc::metrics::count("http.cache.revalidated");
+        cc::metrics::count("http.cache.bytes_saved", static_cast<std::int64_t>(hit->response.body.size()));
+        // Si la entrada se desalojó mientras tanto, la copia de la búsqueda sigue siendo válida
+        if (auto fresh = cache.revalidated(url, resp)) return std::move(*fresh);
+        return std::move(hit->response);
+    }
+    cc::metrics::count("http.cache.miss");
+    if (resp.isSuccess() && cache.store(url, resp)) cc::metrics::count("http.cache.stored");
+    return resp;
+}
+
+// Cada cuánto revisa su cancelación/deadline quien espera un vuelo compartido
+static constexpr Millis kFlightPoll{50};
+
+static Micros micros_since(SteadyClock::time_point t0) {
+    return std::chrono::duration_cast<Micros>(SteadyClock::now() - t0);
+}
+
+// ---------------------
+// Hedging: carrera entre el intento original y una copia lanzada tras `delay`
+// ---------------------
+namespace {
+
+using HedgeCallback = std::function<void(HttpResponse)>;
+
+struct HedgeRace {
+    std::mutex                   m;
+    bool                         decided{false};
+    int                          inFlight{1};
+    std::optional<HttpResponse>  firstFailure; // fallo de uno mientras el otro sigue en vuelo
+    CancellationSource           abandon[2];   // [0] original, [1] hedge
+    SteadyClock::time_point      started[2]{};
+    std::string                  origin;
+    LimiterSlot                  hedgeSlot{};  // turno propio de la copia (el original trae el suyo)
+    std::shared_ptr<LatencyTracker> latency;
+    HedgeCallback                onDone;
+};
+
+std::shared_ptr<const HttpRequest> racer(const HttpRequest& req, const CancellationSource& abandon) {
+    auto copy = std::make_shared<HttpRequest>(req);
+    copy->abandon = abandon.token();
+    if (copy->bodyRef.data()) {
+        // El perdedor puede seguir en vuelo un momento tras volver al llamador: body propio
+        copy->body    = std::string(copy->bodyRef);
+        copy->bodyRef = {};
+    }
+    return copy;
+}
+
+void hedge_settle(const std::shared_ptr<HedgeRace>& race, int who, HttpResponse resp) {
+    // La copia devuelve su turno con su resultado (el abandono llega como 499: no ajusta AIMD)
+    if (who == 1) RateLimiters::instance().release(race->origin, race->hedgeSlot, resp);
+
+    HttpResponse result;
+    {
+        std::lock_guard<std::mutex> lk(race->m);
+        --race->inFlight;
+        if (race->decided) return; // perdedor ya abortado
+        if (!resp.isSuccess() && race->inFlight > 0) {
+            // El otro sigue en vuelo y todavía puede responder bien
+            if (!race->firstFailure) race->firstFailure = std::move(resp);
+            return;
+        }
+        race->decided = true;
+        if (resp.isSuccess()) {
+            if (race->latency) race->latency->record(micros_since(race->started[who]));
+            if (who == 1) cc::metrics::count("http.hedge.won");
+            result = std::move(resp);
+        } else {
+            result = race->firstFailure ? std::move(*race->firstFailure) : std::move(resp);
+        }
+        if (race->inFlight > 0) race->abandon[1 - who].cancel();
+    }
+    race->onDone(std::move(result));
+}
+
+// Lanza `req` y, si no terminó tras `delay`, una copia; onDone recibe la primera respuesta
+// exitosa (o el fallo si ambos fallan). Corre en el hilo de I/O del AsyncEngine.
+void submit_hedged(const HttpRequest& req, Millis delay,
+                   std::shared_ptr<LatencyTracker> latency, HedgeCallback onDone) {
+    auto race = std::make_shared<HedgeRace>();
+    race->latency = std::move(latency);
+    race->onDone  = std::move(onDone);
+    race->origin  = req.origin;
+
+    auto primary = racer(req, race->abandon[0]);
+    auto hedge   = racer(req, race->abandon[1]);
+    auto& engine = AsyncEngine::instance();
+
+    race->started[0] = SteadyClock::now();
+    engine.submit(std::move(primary), [race](HttpResponse r) { hedge_settle(race, 0, std::move(r)); });
+
+    engine.schedule(delay, [race, hedge = std::move(hedge)]() mutable {
+        {
+            std::lock_guard<std::mutex> lk(race->m);
+            if (race->decided || race->firstFailure) return; // ya respondió (o falló: se reintenta)
+        }
+        // La copia es carga extra para el origen: sale solo si su cuota tiene turno libre
+        auto& limiters = RateLimiters::instance();
+        const auto slot = limiters.try_acquire(race->origin);
+        if (!slot) {
+            cc::metrics::count("http.hedge.throttled");
+            return;
+        }
+        if (!RetryBudget::instance().try_withdraw()) {
+            limiters.release(race->origin, *slot);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lk(race->m);
+            if (race->decided) {
+                limiters.release(race->origin, *slot);
+                return;
+            }
+            ++race->inFlight;
+            race->started[1] = SteadyClock::now();
+            race->hedgeSlot  = *slot;
+        }
+        cc::metrics::count("http.hedge.fired");
+        CC_LOG_DEBUG(std::string("[HTTP] hedging ") + hedge->method + " " + short_url(hedge->url));
+        AsyncEngine::instance().submit(std::move(hedge),
+                                       [race](HttpResponse r) { hedge_settle(race, 1, std::move(r)); });
+    });
+}
+
+} // namespace
+
 // ---------------------
 // HttpClient — público
 // ---------------------
-HttpClient::HttpClient() {
+HttpClient::HttpClient()
+    : latency_(std::make_shared<LatencyTracker>())
+{
     const auto& cfg = cc::config::get();
     timeoutMs_ = cfg.http.timeoutMs;
     retries_   = std::max(0, cfg.http.retries);
+    usePool_   = cfg.http.poolMaxIdlePerHost > 0;
+    version_   = cfg.http.version;
+    compressMinBytes_ = static_cast<std::size_t>(std::max(0, cfg.http.compressMinBytes));
+    backoff_   = cfg.http.backoff;
+    maxRetryAfter_ = Millis{std::max(0, cfg.http.retryAfterMaxMs)};
+    if (cfg.http.adaptiveTimeouts) {
+        AdaptiveTimeoutPolicy at;
+        at.multiplier = cfg.http.adaptiveTimeoutMultiplier;
+        at.floor      = Millis{cfg.http.adaptiveTimeoutFloorMs};
+        adaptive_     = at;
+    }
 }
 
 void HttpClient::setTimeout(int ms) {
@@ -88,12 +341,66 @@ void HttpClient::setRetries(int n) {
     retries_ = std::max(0, n);
 }
 
+void HttpClient::setBackoff(cc::config::RetryBackoff shape, Millis maxRetryAfter) {
+    backoff_       = shape;
+    maxRetryAfter_ = std::max(Millis{0}, maxRetryAfter);
+}
+
+void HttpClient::setPooling(bool enabled) {
+    usePool_ = enabled;
+}
+
+void HttpClient::setHttpVersion(cc::config::HttpVersion v) {
+    version_ = v;
+}
+
+void HttpClient::setRequestCompression(std::size_t minBytes) {
+    compressMinBytes_ = minBytes;
+}
+
+void HttpClient::setHedging(std::optional<HedgePolicy> policy) {
+    hedge_ = policy;
+}
+
+void HttpClient::setResponseCache(std::shared_ptr<ResponseCache> cache) {
+    cache_ = std::move(cache);
+}
+
+void HttpClient::setSingleFlight(bool enabled) {
+    singleFlight_ = enabled;
+}
+
+void HttpClient::setAdaptiveTimeouts(std::optional<AdaptiveTimeoutPolicy> policy) {
+    adaptive_ = policy;
+}
+
+bool HttpClient::tracks_latency(const HttpRequest& req) const noexcept {
+    return is_idempotent_read(req.method) && !req.sink;
+}
+
+std::optional<Millis> HttpClient::hedge_delay(const HttpRequest& req) const {
+    if (!hedge_ || !tracks_latency(req)) return std::nullopt;
+    const auto q = latency_->quantile(hedge_->percentile, hedge_->minSamples);
+    if (!q) return std::nullopt;
+    const Millis delay = std::max(std::chrono::ceil<Millis>(*q), hedge_->minDelay);
+    if (delay.count() >= req.timeoutMs) return std::nullopt; // el hedge nunca llegaría a salir
+    return delay;
+}
+
 void HttpClient::setDefaultHeader(const std::string& key, const std::string& value) {
-    defaultHeaders_[key] = value;
+    defaultHeaders_.set(key, value);
+    rebuild_header_list();
 }
 
 void HttpClient::clearDefaultHeader(const std::string& key) {
     defaultHeaders_.erase(key);
+    rebuild_header_list();
+}
+
+void HttpClient::rebuild_header_list() {
+#ifdef CC_USE_CURL
+    defaultHeaderList_ = build_header_list(defaultHeaders_);
+#endif
 }
 
 HttpResponse HttpClient::get(const std::string& url)  { return request("GET", url); }
@@ -106,147 +413,660 @@ HttpResponse HttpClient::put(const std::string& url, const std::string& body)  {
 // ---------------------
 HttpResponse HttpClient::request(const std::string& method,
                                  const std::string& url,
-                                 const std::string& body,
-                                 const std::unordered_map<std::string, std::string>& headers,
-                                 std::optional<int> timeoutMs)
+                                 RequestBody body,
+                                 const HeaderMap& headers,
+                                 std::optional<int> timeoutMs,
+                                 const RequestControl& ctl)
 {
-    const std::string m = method_upper(method);
-    const int tmo = timeoutMs.has_value() ? std::max(1, *timeoutMs) : timeoutMs_;
+    if (singleFlight_ && body.view().empty() && is_idempotent_read(method_upper(method))) {
+        return coalesced(method_upper(method), url, headers, timeoutMs, ctl);
+    }
+    if (cache_ && method_upper(method) == "GET" && !bypasses_cache(headers, defaultHeaders_)) {
+        return cached_get(url, headers, timeoutMs, ctl);
+    }
 
-    BackoffPolicy pol;
-    pol.base         = Millis{200};
-    pol.factor       = 2.0;
-    pol.max_delay    = Millis{3000};
-    pol.jitter_pct   = 0.20;
-    pol.max_attempts = std::max(1, retries_ + 1); // intentos totales
+    // Se arma una vez (merge de headers, compresión) y se reenvía igual en cada intento
+    auto req = make_request(method, url, std::move(body), headers, timeoutMs);
+    req->cancel = ctl.cancel;
+    HttpResponse resp = send_with_retries(req, nullptr, ctl);
+    if (cache_ && resp.isSuccess() && !is_idempotent_read(req->method)) cache_->erase(url);
+    return resp;
+}
+
+HttpResponse HttpClient::cached_get(const std::string& url,
+                                    const HeaderMap& headers,
+                                    std::optional<int> timeoutMs,
+                                    const RequestControl& ctl)
+{
+    auto hit = cache_->lookup(url);
+    if (hit && hit->fresh) return cache_hit_response(*hit);
+
+    auto req = make_request("GET", url, {}, hit ? conditional_headers(headers, *hit) : headers, timeoutMs);
+    req->cancel = ctl.cancel;
+    return finish_cached_get(*cache_, url, hit, send_with_retries(req, nullptr, ctl));
+}
+
+// ---------------------
+// Single-flight
+// ---------------------
+std::string HttpClient::flight_key(const std::string& method, const std::string& url,
+                                   const HeaderMap& headers) const
+{
+    // Headers efectivos, ordenados y con nombre en minúsculas: mismo request => misma clave
+    std::map<std::string, std::string_view> merged;
+    auto add = [&merged](std::string_view k, std::string_view v) {
+        std::string lk(k);
+        std::transform(lk.begin(), lk.end(), lk.begin(), [](unsigned char c) { return std::tolower(c); });
+        merged[std::move(lk)] = v;
+    };
+    for (const auto& kv : defaultHeaders_) add(kv.first, kv.second);
+    for (const auto& kv : headers) add(kv.first, kv.second);
+
+    std::string key;
+    key.reserve(method.size() + url.size() + 64);
+    key.append(method).append(1, ' ').append(url);
+    for (const auto& [k, v] : merged) key.append(1, '\n').append(k).append(1, ':').append(v);
+    return key;
+}
+
+void HttpClient::launch_flight(const std::string& key, std::uint64_t flight, cc::time::CancellationToken abandon,
+                               const std::string& method, const std::string& url,
+                               const HeaderMap& headers,
+                               std::optional<int> timeoutMs)
+{
+    // La transferencia no lleva la cancelación de ningún llamador: solo se aborta si todos
+    // los que esperan se fueron (abandon)
+    RequestControl shared;
+    shared.cancel = std::move(abandon);
+    start_async(method, url, {}, headers, timeoutMs,
+                [key, flight](HttpResponse resp) { SingleFlight::instance().complete(key, flight, resp); },
+                std::move(shared));
+}
+
+HttpResponse HttpClient::coalesced(const std::string& method, const std::string& url,
+                                   const HeaderMap& headers,
+                                   std::optional<int> timeoutMs, const RequestControl& ctl)
+{
+    auto& flights = SingleFlight::instance();
+    const std::string key = flight_key(method, url, headers);
+    auto done   = std::make_shared<std::promise<HttpResponse>>();
+    auto result = done->get_future();
+    const auto ticket = flights.join(key, [done](const HttpResponse& r) { done->set_value(r); });
+    if (ticket.leader) launch_flight(key, ticket.flight, ticket.abandon, method, url, headers, timeoutMs);
 
+    if (!ctl.cancel.can_be_cancelled() && !ctl.deadline) return result.get();
+
+    while (result.wait_for(ctl.deadline ? std::min(kFlightPoll, ctl.deadline->remaining()) : kFlightPoll)
+           != std::future_status::ready) {
+        if (ctl.cancel.is_cancelled()) {
+            flights.leave(key, ticket);
+            return cancelled_response();
+        }
+        if (ctl.deadline && ctl.deadline->expired()) {
+            flights.leave(key, ticket);
+            return deadline_response();
+        }
+    }
+    return result.get();
+}
+
+PreparedRequest HttpClient::prepare(const std::string& method,
+                                    const std::string& url,
+                                    RequestBody body,
+                                    const HeaderMap& headers,
+                                    std::optional<int> timeoutMs) const
+{
+    // Sobrevive al llamador: el body pasa a ser propio y los headers quedan armados
+    auto req = make_request(method, url, RequestBody(std::move(body).take()), headers, timeoutMs);
+#ifdef CC_USE_CURL
+    if (!req->headerList) {
+        req->headerList = build_header_list(req->headers);
+        req->headers.clear();
+    }
+#endif
+    return PreparedRequest(std::move(req));
+}
+
+HttpResponse HttpClient::send(const PreparedRequest& req, const RequestControl& ctl) {
+    if (!req.valid()) {
+        HttpResponse out;
+        out.statusCode = 0;
+        out.body = "HttpClient::send: empty PreparedRequest";
+        return out;
+    }
+    if (!ctl.cancel.can_be_cancelled()) return send_with_retries(req.req_, nullptr, ctl);
+
+    // El request preparado es inmutable: copia superficial con el token del llamador
+    auto withCancel = std::make_shared<HttpRequest>(*req.req_);
+    withCancel->cancel = ctl.cancel;
+    return send_with_retries(withCancel, nullptr, ctl);
+}
+
+HttpResponse HttpClient::requestStreaming(const std::string& method,
+                                          const std::string& url,
+                                          RequestBody body,
+                                          const HeaderMap& headers,
+                                          BodySink sink,
+                                          std::optional<int> timeoutMs,
+                                          const RequestControl& ctl)
+{
+    auto req = make_request(method, url, std::move(body), headers, timeoutMs);
+    req->cancel = ctl.cancel;
+    if (!timeoutMs) req->timeoutMs = timeoutMs_; // la duración de un stream no se aprende
+
+    // Una vez entregados bytes al sink no se reintenta: el llamador vería datos duplicados
+    bool delivered = false;
+    req->sink = [&delivered, &sink](std::string_view chunk) {
+        delivered = true;
+        return sink(chunk);
+    };
+    return send_with_retries(req, &delivered, ctl);
+}
+
+HttpResponse HttpClient::send_with_retries(const std::shared_ptr<const HttpRequest>& reqPtr,
+                                           const bool* noRetry, const RequestControl& ctl) {
+    const HttpRequest& req = *reqPtr;
+    BackoffPolicy pol = make_retry_policy(retries_, backoff_, maxRetryAfter_);
     Backoff backoff(pol);
+    auto& breakers = CircuitBreakers::instance();
+    auto& limiters = RateLimiters::instance();
+    RetryBudget::instance().deposit();
 
     HttpResponse last;
     for (int attempt = 1; attempt <= pol.max_attempts; ++attempt) {
-        HttpRequest req;
-        req.method    = m;
-        req.url       = url;
-        req.body      = body;
-        req.timeoutMs = tmo;
-        req.headers   = defaultHeaders_;
-        for (const auto& kv : headers) req.headers[kv.first] = kv.second;
+        if (ctl.cancel.is_cancelled()) return cancelled_response();
+
+        // Turno del origen (tasa/concurrencia); la espera cuenta contra el deadline
+        const auto slot = limiters.acquire(req.origin, ctl.cancel, ctl.deadline);
+        if (!slot) return ctl.cancel.is_cancelled() ? cancelled_response() : deadline_response();
+
+        const auto attemptReq = fit_to_deadline(reqPtr, ctl);
+        if (!attemptReq) {
+            limiters.release(req.origin, *slot);
+            return deadline_response();
+        }
+
+        // Circuito abierto: fallar ya (también corta los reintentos pendientes)
+        const BreakerPermit permit = breakers.acquire(req.origin);
+        if (!permit.allowed) {
+            limiters.release(req.origin, *slot);
+            CC_LOG_DEBUG(std::string("[HTTP] circuit open, fast-fail ") + req.method + " " + short_url(req.url));
+            return circuit_open_response(req.origin);
+        }
 
-        CC_LOG_DEBUG(std::string("[HTTP] ") + m + " " + short_url(url));
-        if (!body.empty() && (m == "POST" || m == "PUT")) {
-            CC_LOG_TRACE(std::string("[HTTP] body bytes = ") + std::to_string(body.size()));
+        CC_LOG_DEBUG(std::string("[HTTP] ") + req.method + " " + short_url(req.url));
+        // payload(): con bodyRef (body prestado) req.body está vacío
+        if (!req.payload().empty() && (req.method == "POST" || req.method == "PUT")) {
+            CC_LOG_TRACE(std::string("[HTTP] body bytes = ") + std::to_string(req.payload().size()));
         }
 
-        last = do_request_once(req);
+        const auto t0 = SteadyClock::now();
+        if (const auto hedgeDelay = hedge_delay(*attemptReq)) {
+            last = do_hedged_once(attemptReq, *hedgeDelay); // registra la latencia del ganador
+        } else {
+            last = do_request_once(attemptReq);
+            if (last.isSuccess() && tracks_latency(req)) latency_->record(micros_since(t0));
+        }
+        const bool cut = cut_by_deadline(attemptReq != reqPtr, last, ctl);
+        breakers.record(req.origin, permit, cut ? 499 : last.statusCode,
+                        std::chrono::duration_cast<Millis>(SteadyClock::now() - t0));
+        if (cut) {
+            limiters.release(req.origin, *slot);
+            return deadline_response();
+        }
+        limiters.release(req.origin, *slot, last);
+        // Lo que lanzó el BodySink del llamador vuelve a su hilo, ya liberado el turno
+        if (last.error) std::rethrow_exception(last.error);
 
         if (last.isSuccess()) {
             CC_LOG_DEBUG(std::string("[HTTP] response ") + std::to_string(last.statusCode));
             return last;
         }
 
-        const bool retryable = is_retryable_status(last.statusCode);
+        const bool retryable = is_retryable_status(last.statusCode) && !(noRetry && *noRetry) &&
+                               !ctl.cancel.is_cancelled();
         if (!retryable || attempt == pol.max_attempts) {
-            if (!retryable) {
+            if (!retryable && last.statusCode != 499 && last.statusCode != 304) {
                 CC_LOG_WARN(std::string("[HTTP] non-retryable status ") + std::to_string(last.statusCode));
             }
             return last;
         }
 
-        const auto delay = backoff.next_delay();
-        CC_LOG_WARN(std::string("[HTTP] failed (status=") + std::to_string(last.statusCode) +
-                    ") attempt " + std::to_string(attempt) + "/" + std::to_string(pol.max_attempts) +
-                    " — retry in " + std::to_string(delay.count()) + " ms");
-        cc::time::sleep_for(delay);
+        const auto next = next_retry_delay(backoff, last);
+        if (!next) return last;
+        const auto delay = *next;
+        if (ctl.deadline && ctl.deadline->remaining() <= delay) {
+            CC_LOG_WARN("[HTTP] not retrying: remaining deadline shorter than backoff");
+            return last;
+        }
+        if (!RetryBudget::instance().try_withdraw()) return last;
+
+        log_retry(last.statusCode, attempt, pol.max_attempts, delay);
+        if (!cc::time::sleep_for(delay, &ctl.cancel)) return cancelled_response();
     }
     return last;
 }
 
+// ---------------------
+// requestAsync() — reintentos sobre timers del AsyncEngine
+// ---------------------
+namespace {
+
+struct AsyncCall {
+    std::shared_ptr<const HttpRequest> req;
+    BackoffPolicy                      pol;
+    Backoff                            backoff;
+    int                                attempt{1};
+    RequestControl                     ctl;
+    HttpClient::ResponseCallback       onDone;
+    std::shared_ptr<LatencyTracker>    latency;     // solo si el request es GET/HEAD
+    std::optional<Millis>              hedgeDelay;
+
+    AsyncCall(std::shared_ptr<const HttpRequest> r, BackoffPolicy p, RequestControl c,
+              HttpClient::ResponseCallback cb)
+        : req(std::move(r)),
+          pol(p), backoff(p), ctl(std::move(c)), onDone(std::move(cb)) {}
+
+    void finish(HttpResponse resp) {
+        if (onDone) onDone(std::move(resp));
+    }
+};
+
+void on_attempt_done(const std::shared_ptr<AsyncCall>& call, const BreakerPermit& permit,
+                     const LimiterSlot& slot, SteadyClock::time_point t0, bool shortened,
+                     HttpResponse resp);
+void run_attempt(const std::shared_ptr<AsyncCall>& call, const LimiterSlot& slot);
+
+void start_attempt(const std::shared_ptr<AsyncCall>& call) {
+    if (call->ctl.cancel.is_cancelled()) {
+        call->finish(cancelled_response());
+        return;
+    }
+    // Sin turno libre se espera en la cola del origen (timers del loop, no el hilo)
+    RateLimiters::instance().acquire_async(call->req->origin,
+                                           [call](LimiterSlot slot) { run_attempt(call, slot); });
+}
+
+void run_attempt(const std::shared_ptr<AsyncCall>& call, const LimiterSlot& slot) {
+    auto& limiters = RateLimiters::instance();
+    if (call->ctl.cancel.is_cancelled()) {
+        limiters.release(call->req->origin, slot);
+        call->finish(cancelled_response());
+        return;
+    }
+
+    std::shared_ptr<const HttpRequest> attemptReq = fit_to_deadline(call->req, call->ctl);
+    if (!attemptReq) {
+        limiters.release(call->req->origin, slot);
+        call->finish(deadline_response());
+        return;
+    }
+
+    const BreakerPermit permit = CircuitBreakers::instance().acquire(call->req->origin);
+    if (!permit.allowed) {
+        limiters.release(call->req->origin, slot);
+        call->finish(circuit_open_response(call->req->origin));
+        return;
+    }
+
+    const auto t0 = SteadyClock::now();
+    const bool shortened = attemptReq != call->req;
+    auto onAttemptDone = [call, permit, slot, t0, shortened](HttpResponse resp) {
+        on_attempt_done(call, permit, slot, t0, shortened, std::move(resp));
+    };
+    if (call->hedgeDelay) {
+        submit_hedged(*attemptReq, *call->hedgeDelay, call->latency, std::move(onAttemptDone));
+    } else {
+        AsyncEngine::instance().submit(std::move(attemptReq), std::move(onAttemptDone));
+    }
+}
+
+void on_attempt_done(const std::shared_ptr<AsyncCall>& call, const BreakerPermit& permit,
+                     const LimiterSlot& slot, SteadyClock::time_point t0, bool shortened,
+                     HttpResponse resp) {
+    const bool cut = cut_by_deadline(shortened, resp, call->ctl);
+    CircuitBreakers::instance().record(call->req->origin, permit, cut ? 499 : resp.statusCode,
+                                       std::chrono::duration_cast<Millis>(SteadyClock::now() - t0));
+    if (cut) {
+        RateLimiters::instance().release(call->req->origin, slot);
+        call->finish(deadline_response());
+        return;
+    }
+    RateLimiters::instance().release(call->req->origin, slot, resp);
+    if (resp.isSuccess()) {
+        // Con hedging la latencia (del ganador) ya la registró la carrera
+        if (call->latency && !call->hedgeDelay) call->latency->record(micros_since(t0));
+        CC_LOG_DEBUG(std::string("[HTTP] async response ") + std::to_string(resp.statusCode));
+        call->finish(std::move(resp));
+        return;
+    }
+
+    const bool retryable = is_retryable_status(resp.statusCode) && !call->ctl.cancel.is_cancelled();
+    if (!retryable || call->attempt >= call->pol.max_attempts) {
+        if (!retryable && resp.statusCode != 499 && resp.statusCode != 304) {
+            CC_LOG_WARN(std::string("[HTTP] non-retryable status ") + std::to_string(resp.statusCode));
+        }
+        call->finish(std::move(resp));
+        return;
+    }
+
+    const auto next = next_retry_delay(call->backoff, resp);
+    if (!next) {
+        call->finish(std::move(resp));
+        return;
+    }
+    const auto delay = *next;
+    if (call->ctl.deadline && call->ctl.deadline->remaining() <= delay) {
+        CC_LOG_WARN("[HTTP] not retrying: remaining deadline shorter than backoff");
+        call->finish(std::move(resp));
+        return;
+    }
+    if (!RetryBudget::instance().try_withdraw()) {
+        call->finish(std::move(resp));
+        return;
+    }
+    log_retry(resp.statusCode, call->attempt, call->pol.max_attempts, delay);
+    ++call->attempt;
+    AsyncEngine::instance().schedule(delay, [call] { start_attempt(call); });
+}
+
+} // namespace
+
+void HttpClient::requestAsync(const std::string& method,
+                              const std::string& url,
+                              std::string body,
+                              const HeaderMap& headers,
+                              std::optional<int> timeoutMs,
+                              ResponseCallback onDone,
+                              RequestControl ctl)
+{
+    // Un callback no puede "irse" del vuelo a mitad de camino: con cancelación o deadline
+    // propios la llamada hace su propia transferencia
+    const std::string m = method_upper(method);
+    if (singleFlight_ && body.empty() && is_idempotent_read(m) &&
+        !ctl.cancel.can_be_cancelled() && !ctl.deadline) {
+        const std::string key = flight_key(m, url, headers);
+        const auto ticket = SingleFlight::instance().join(
+            key, [cb = std::move(onDone)](const HttpResponse& r) { cb(r); });
+        if (ticket.leader) launch_flight(key, ticket.flight, ticket.abandon, m, url, headers, timeoutMs);
+        return;
+    }
+    start_async(m, url, std::move(body), headers, timeoutMs, std::move(onDone), std::move(ctl));
+}
+
+void HttpClient::start_async(const std::string& method,
+                             const std::string& url,
+                             std::string body,
+                             const HeaderMap& headers,
+                             std::optional<int> timeoutMs,
+                             ResponseCallback onDone,
+                             RequestControl ctl)
+{
+    HeaderMap condHeaders;
+    const auto* sendHeaders = &headers;
+    if (cache_) {
+        const std::string m = method_upper(method);
+        if (m == "GET" && !bypasses_cache(headers, defaultHeaders_)) {
+            auto hit = cache_->lookup(url);
+            if (hit && hit->fresh) {
+                // Igual que una respuesta de red: el callback corre en el hilo de I/O
+                AsyncEngine::instance().schedule(Millis{0},
+                    [cb = std::move(onDone), resp = cache_hit_response(*hit)]() mutable { cb(std::move(resp)); });
+                return;
+            }
+            if (hit) {
+                condHeaders = conditional_headers(headers, *hit);
+                sendHeaders = &condHeaders;
+            }
+            onDone = [cache = cache_, url, hit = std::move(hit), cb = std::move(onDone)](HttpResponse r) mutable {
+                cb(finish_cached_get(*cache, url, hit, std::move(r)));
+            };
+        } else if (!is_idempotent_read(m)) {
+            onDone = [cache = cache_, url, cb = std::move(onDone)](HttpResponse r) {
+                if (r.isSuccess()) cache->erase(url);
+                cb(std::move(r));
+            };
+        }
+    }
+
+    // El request vive más que esta llamada: body propio
+    auto req = make_request(method, url, RequestBody(std::move(body)), *sendHeaders, timeoutMs);
+    req->cancel = ctl.cancel;
+    CC_LOG_DEBUG(std::string("[HTTP] async ") + req->method + " " + short_url(url));
+
+    auto call = std::make_shared<AsyncCall>(std::move(req), make_retry_policy(retries_, backoff_, maxRetryAfter_),
+                                            std::move(ctl), std::move(onDone));
+    if (tracks_latency(*call->req)) {
+        call->latency    = latency_;
+        call->hedgeDelay = hedge_delay(*call->req);
+    }
+    RetryBudget::instance().deposit();
+    start_attempt(call);
+}
+
+std::future<HttpResponse> HttpClient::requestAsync(const std::string& method,
+                                                   const std::string& url,
+                                                   const std::string& body,
+                                                   const HeaderMap& headers,
+                                                   std::optional<int> timeoutMs)
+{
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    auto future  = promise->get_future();
+    requestAsync(method, url, body, headers, timeoutMs, [promise](HttpResponse resp) {
+        promise->set_value(std::move(resp));
+    });
+    return future;
+}
+
+std::shared_ptr<HttpRequest> HttpClient::make_request(const std::string& method,
+                                                      const std::string& url,
+                                                      RequestBody body,
+                                                      const HeaderMap& headers,
+                                                      std::optional<int> timeoutMs) const
+{
+    auto req = std::make_shared<HttpRequest>();
+    req->method    = method_upper(method);
+    req->url       = url;
+    req->timeoutMs = timeoutMs.has_value() ? std::max(1, *timeoutMs) : timeoutMs_;
+    req->version   = version_;
+    req->endpoint  = endpoint_of(req->method, req->url);
+    req->origin    = origin_of(req->url);
+    req->timeoutIsSample = !timeoutMs.has_value();
+    if (!timeoutMs && adaptive_) {
+        const auto learned = EndpointLatencies::instance().timeouts(*adaptive_, req->endpoint, req->origin,
+                                                                    timeoutMs_);
+        req->timeoutMs        = learned.totalMs;
+        req->connectTimeoutMs = learned.connectMs;
+    }
+    if (body.owns()) {
+        req->body = std::move(body).take();
+    } else {
+        req->bodyRef = body.view();
+    }
+
+    // gzip del body si supera el umbral (y el llamador no lo codificó ya)
+    const bool compress = compressMinBytes_ > 0 && req->payload().size() >= compressMinBytes_ &&
+                          !get_header_ci(defaultHeaders_, "Content-Encoding") &&
+                          !get_header_ci(headers, "Content-Encoding");
+    std::optional<std::string> gz = compress ? gzip_compress(req->payload()) : std::nullopt;
+
+    // Sin headers propios ni compresión: lista de headers por defecto ya armada (sin copias)
+    if (headers.empty() && !gz && defaultHeaderList_) {
+        req->headerList = defaultHeaderList_;
+    } else {
+        req->headers = defaultHeaders_;
+        for (const auto& [k, v] : headers) req->headers.set(k, v);
+    }
+
+    if (gz) {
+        CC_LOG_TRACE(std::string("[HTTP] gzip body ") + std::to_string(req->payload().size()) +
+                     " -> " + std::to_string(gz->size()) + " bytes");
+        req->rawBodySize = req->payload().size();
+        req->body        = std::move(*gz);
+        req->bodyRef     = {};
+        req->headers.set("Content-Encoding", "gzip");
+    }
+    return req;
+}
+
+// ---------------------
+// do_hedged_once() — siempre vía AsyncEngine: hay que esperar a dos transferencias a la vez
+// ---------------------
+HttpResponse HttpClient::do_hedged_once(const std::shared_ptr<const HttpRequest>& reqPtr, Millis delay) {
+    std::promise<HttpResponse> done;
+    auto fut = done.get_future();
+    submit_hedged(*reqPtr, delay, latency_, [&done](HttpResponse r) { done.set_value(std::move(r)); });
+    return fut.get();
+}
+
 // ---------------------
 // do_request_once()
 // ---------------------
-HttpResponse HttpClient::do_request_once(const HttpRequest& req) {
+HttpResponse HttpClient::do_request_once(const std::shared_ptr<const HttpRequest>& reqPtr) {
 #ifndef CC_USE_CURL
     // Modo “sin libcurl”: devolvemos un error explícito de red.
+    (void)reqPtr;
     HttpResponse out;
     out.statusCode = 0;
     out.body = "HttpClient: CC_USE_CURL no está definido o libcurl no está disponible.";
     return out;
 #else
+    const HttpRequest& req = *reqPtr;
     HttpResponse out;
 
-    CURL* curl = curl_easy_init();
+    // HTTP/2: el intento va al curl_multi compartido para multiplexar sobre la conexión
+    // que ya tenga abierta el origen (un easy handle suelto no puede compartir streams).
+    // Cancelable: también, porque el loop revisa el token cada 50 ms mientras que
+    // curl_easy_perform solo llama al callback de progreso ~1 vez/s con la conexión quieta.
+    if (req.version != cc::config::HttpVersion::Http1_1 || req.cancellable()) {
+        std::promise<HttpResponse> done;
+        auto fut = done.get_future();
+        AsyncEngine::instance().submit(reqPtr,
+                                       [&done](HttpResponse r) { done.set_value(std::move(r)); });
+        return fut.get();
+    }
+
+    // Con pool: handle reutilizado (conexión viva + caché DNS/TLS compartida).
+    // Sin pool: handle nuevo por intento, como antes.
+    ConnectionPool::Lease lease;
+    CURL* curl = nullptr;
+    if (usePool_) {
+        lease = ConnectionPool::instance().acquire(req.url);
+        curl  = static_cast<CURL*>(lease.get());
+    } else {
+        curl = curl_easy_init();
+    }
     if (!curl) {
         out.statusCode = 0;
         out.body = "curl_easy_init failed";
         return out;
     }
 
-    // URL
-    curl_easy_setopt(curl, CURLOPT_URL, req.url.c_str());
-
-    // Método HTTP
-    if (req.method == "GET") {
-        curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
-    } else if (req.method == "POST") {
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, req.body.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE,
-                         static_cast<long>(req.body.size()));
-    } else if (req.method == "PUT") {
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT");
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, req.body.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE,
-                         static_cast<long>(req.body.size()));
-    } else if (req.method == "DELETE") {
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
-    } else {
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, req.method.c_str());
+    CurlTransfer xfer;
+    xfer.prepare(curl, req);
+
+    // Ejecutar
+    CURLcode rc = curl_easy_perform(curl);
+    out = xfer.finish(curl, rc);
+    if (rc != CURLE_OK) {
+        lease.discard(); // no reciclar un handle tras error de transporte
     }
 
-    // Timeout
-#if defined(CURLOPT_TIMEOUT_MS)
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, req.timeoutMs);
-#else
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, (req.timeoutMs + 999) / 1000);
+    if (!usePool_) curl_easy_cleanup(curl);
+    return out;
+#endif // CC_USE_CURL
+}
+
+// ---------------------
+// prewarm()
+// ---------------------
+#ifdef CC_USE_CURL
+// HEAD por un handle del pool; al devolver el lease la conexión queda ociosa en el pool
+static bool warm_pooled(const HttpRequest& req, ConnectionPool::Lease lease) {
+    auto* curl = static_cast<CURL*>(lease.get());
+    if (!curl) return false;
+    CurlTransfer xfer;
+    xfer.prepare(curl, req);
+    const CURLcode rc = curl_easy_perform(curl);
+    const HttpResponse r = xfer.finish(curl, rc);
+    if (rc != CURLE_OK) lease.discard();
+    return r.statusCode != 0;
+}
 #endif
 
-    // Headers de request
-    struct curl_slist* hdrs = nullptr;
-    for (const auto& kv : req.headers) {
-        std::string line = kv.first + ": " + kv.second;
-        hdrs = curl_slist_append(hdrs, line.c_str());
-    }
-    if (hdrs) {
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, hdrs);
+std::future<std::size_t> HttpClient::prewarm(const std::vector<std::string>& urls, int connectionsPerOrigin) {
+    std::promise<std::size_t> done;
+    auto fut = done.get_future();
+
+    std::vector<std::string> origins;
+    for (const auto& u : urls) {
+        if (u.empty()) continue;
+        std::string o = origin_of(u);
+        if (std::find(origins.begin(), origins.end(), o) == origins.end()) origins.push_back(std::move(o));
     }
 
-    // Callbacks de respuesta
-    std::string response_body;
-    std::unordered_map<std::string, std::string> resp_headers;
+#ifndef CC_USE_CURL
+    (void)connectionsPerOrigin;
+    done.set_value(0);
+#else
+    const auto& cfg      = cc::config::get();
+    const auto  version  = cfg.http.version;
+    const int   timeout  = cfg.http.timeoutMs;
+    const int   perOrigin = std::max(1, connectionsPerOrigin);
 
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_body);
+    std::thread([origins = std::move(origins), version, timeout, perOrigin, done = std::move(done)]() mutable {
+        const auto sw = cc::time::Stopwatch::start_new();
+        std::vector<std::pair<std::size_t, std::future<bool>>> pending;
 
-    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, &header_callback);
-    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &resp_headers);
+        for (std::size_t i = 0; i < origins.size(); ++i) {
+            auto req       = std::make_shared<HttpRequest>();
+            req->method    = "HEAD";
+            req->url       = origins[i] + "/";
+            req->timeoutMs = timeout;
+            req->version   = version;
+            req->origin    = origins[i];
+            req->endpoint  = "PREWARM " + origins[i];
 
-    // Ejecutar
-    CURLcode rc = curl_easy_perform(curl);
-    long http_code = 0;
-    if (rc == CURLE_OK) {
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-        out.statusCode = static_cast<int>(http_code);
-        out.body       = std::move(response_body);
-        out.headers    = std::move(resp_headers);
-    } else {
-        out.statusCode = 0;
-        out.body = std::string("curl error: ") + curl_easy_strerror(rc);
-    }
+            // request() síncrono en HTTP/1.1 usa el pool: un handle (y conexión) por slot.
+            // Los leases se piden todos antes de usarlos para que no se repita el mismo handle.
+            if (version == cc::config::HttpVersion::Http1_1) {
+                std::vector<ConnectionPool::Lease> leases;
+                for (int k = 0; k < perOrigin; ++k) leases.push_back(ConnectionPool::instance().acquire(req->url));
+                for (auto& l : leases) {
+                    pending.emplace_back(i, std::async(std::launch::async, [req, l = std::move(l)]() mutable {
+                        return warm_pooled(*req, std::move(l));
+                    }));
+                }
+            }
 
-    if (hdrs) curl_slist_free_all(hdrs);
-    curl_easy_cleanup(curl);
-    return out;
-#endif // CC_USE_CURL
+            // requestAsync(), llamadas cancelables y HTTP/2 van por el curl_multi; con h2 todo
+            // se multiplexa en una conexión, así que alcanza con una.
+            const int viaMulti = version == cc::config::HttpVersion::Http1_1 ? perOrigin : 1;
+            for (int k = 0; k < viaMulti; ++k) {
+                auto p = std::make_shared<std::promise<bool>>();
+                pending.emplace_back(i, p->get_future());
+                AsyncEngine::instance().submit(req, [p](HttpResponse r) { p->set_value(r.statusCode != 0); });
+            }
+        }
+
+        std::vector<int> opened(origins.size(), 0);
+        for (auto& [i, f] : pending) opened[i] += f.get() ? 1 : 0;
+
+        std::size_t ready = 0;
+        for (std::size_t i = 0; i < origins.size(); ++i) {
+            cc::metrics::count("http.prewarm.connections|" + origins[i], opened[i]);
+            if (opened[i] > 0) {
+                ++ready;
+            } else {
+                CC_LOG_WARN("[HTTP] prewarm failed for " + origins[i]);
+            }
+        }
+        CC_LOG_INFO("[HTTP] prewarm: " + std::to_string(ready) + "/" + std::to_string(origins.size()) +
+                    " origins ready in " + std::to_string(sw.elapsed().count()) + " ms");
+        done.set_value(ready);
+    }).detach();
+#endif
+    return fut;
 }
 
 } // namespace cc::http
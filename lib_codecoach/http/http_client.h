@@ -15,29 +15,158 @@
 #define LIB_CODECOACH_HTTP_CLIENT_H
 
 #include "http_response.h"  // <<<<<<  centralizamos aquí la definición de HttpResponse
+#include "adaptive_timeouts.h"
+#include "response_cache.h"
+#include "config/config_manager.h"
+#include "metrics/latency_tracker.h"
+#include "metrics/timer.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
 #include <string>
 #include <string_view>
-#include <unordered_map>
 #include <optional>
+#include <vector>
 
 namespace cc::http {
 
+    // Recibe el body de una respuesta 2xx por trozos, a medida que llega.
+    // Devolver false aborta la transferencia (la respuesta queda con status 499). Si lanza, la
+    // transferencia se aborta igual y requestStreaming() relanza la excepción en el llamador.
+    using BodySink = std::function<bool(std::string_view chunk)>;
+
+    // (interno) Lista de headers ya armada para libcurl; inmutable y compartible entre
+    // requests e intentos. Solo se define en los .cpp compilados con CC_USE_CURL.
+    struct HeaderList;
+
     struct HttpRequest {
         std::string method; // "GET", "POST", "PUT", "DELETE"
         std::string url;
         std::string body;
-        std::unordered_map<std::string, std::string> headers;
+        std::string_view bodyRef{}; // body prestado (sin copia); si tiene datos se envía en vez de body
+        HeaderMap headers;
         int timeoutMs{5000};
+        int connectTimeoutMs{0}; // DNS + TCP + TLS; 0 => el default de libcurl
+        cc::time::CancellationToken cancel{}; // aborta la transferencia en curso (status 499)
+        cc::time::CancellationToken abandon{}; // interno: intento que perdió una carrera de hedging
+        cc::config::HttpVersion version{cc::config::HttpVersion::Http1_1};
+        std::size_t rawBodySize{0}; // tamaño del body antes de Content-Encoding (0 => sin comprimir)
+        BodySink sink{};            // si está, el body 2xx va aquí en vez de a HttpResponse::body
+        std::string endpoint;       // etiqueta de métricas "METHOD origin/path" (vacío => se calcula)
+        std::string origin;         // scheme://host:port (clave del circuit breaker)
+        bool timeoutIsSample{false}; // un timeout cuenta como muestra de latencia (timeout propio del cliente)
+        std::shared_ptr<const HeaderList> headerList{}; // si está, se envía en vez de `headers`
+
+        std::string_view payload() const noexcept {
+            return bodyRef.data() ? bodyRef : std::string_view(body);
+        }
+        bool cancellable() const noexcept {
+            return cancel.can_be_cancelled() || abandon.can_be_cancelled();
+        }
+        bool is_cancelled() const noexcept {
+            return cancel.is_cancelled() || abandon.is_cancelled();
+        }
+    };
+
+    // Body para request()/prepare() sin copias: toma posesión de un std::string&& o
+    // referencia el buffer del llamador (std::string, string_view, literal), que debe
+    // seguir vivo hasta que request() retorne.
+    class RequestBody {
+    public:
+        RequestBody() noexcept = default;
+        RequestBody(std::string&& s) noexcept : owned_(std::move(s)), owns_(true) {}
+        RequestBody(const std::string& s) noexcept : view_(s) {}
+        RequestBody(std::string_view s) noexcept : view_(s) {}
+        RequestBody(const char* s) noexcept : view_(s) {}
+
+        bool             owns() const noexcept { return owns_; }
+        std::string_view view() const noexcept { return owns_ ? std::string_view(owned_) : view_; }
+        std::string      take() && { return owns_ ? std::move(owned_) : std::string(view_); }
+
+    private:
+        std::string      owned_;
+        std::string_view view_{};
+        bool             owns_{false};
     };
 
+    // Request armado una sola vez (headers fusionados y lista de libcurl construida, body
+    // propio y ya comprimido) que se puede reenviar con HttpClient::send() sin volver a
+    // asignar memoria. Copiarlo es barato (comparte el request inmutable).
+    class PreparedRequest {
+    public:
+        PreparedRequest() noexcept = default;
+        bool valid() const noexcept { return static_cast<bool>(req_); }
+        const HttpRequest& request() const noexcept { return *req_; }
+
+    private:
+        friend class HttpClient;
+        explicit PreparedRequest(std::shared_ptr<const HttpRequest> r) noexcept : req_(std::move(r)) {}
+
+        std::shared_ptr<const HttpRequest> req_;
+    };
+
+    // Control de una llamada completa (todos sus intentos): cancelación cooperativa y
+    // deadline absoluto. Los timeouts por intento se recortan al tiempo restante.
+    struct RequestControl {
+        cc::time::CancellationToken       cancel{};
+        std::optional<cc::time::Deadline> deadline{};
+    };
+
+    // Hedging de peticiones idempotentes (GET/HEAD): si un intento no respondió tras el
+    // percentil `percentile` de la latencia observada por el cliente, sale un segundo request
+    // igual y gana el primero que responda bien; el otro se aborta. Cada hedge gasta del
+    // RetryBudget, así con el servicio degradado no se duplica la carga, y ocupa su propio
+    // turno del RateLimiters del origen: sin turno libre no sale.
+    struct HedgePolicy {
+        double           percentile{0.95};
+        std::uint64_t    minSamples{20};  // sin estas muestras en la ventana no se hedgea
+        cc::time::Millis minDelay{5};     // piso del delay (latencias ínfimas no duplican todo)
+    };
+
+    // Reintentos y fast-fail: cada llamada nueva deposita en el RetryBudget global y cada
+    // reintento gasta de él; si el circuit breaker del origen está abierto la llamada falla
+    // al instante con 503 y el header "X-Circuit-Breaker: open", sin salir a la red.
+    // Cada intento espera además su turno en el RateLimiters del origen (tasa, concurrencia
+    // AIMD, pausas por Retry-After); la espera cuenta contra el deadline de `ctl`.
     class HttpClient {
     public:
+        // Callback de requestAsync; se ejecuta en el hilo de I/O del AsyncEngine (no bloquear).
+        using ResponseCallback = std::function<void(HttpResponse)>;
+
         HttpClient();
 
         // Config
         void setTimeout(int ms);
         void setRetries(int n);
+        // Forma del backoff entre reintentos y Retry-After máximo que se respeta (429/503
+        // con Retry-After esperan lo pedido; si piden más que maxRetryAfter no se reintenta).
+        // maxRetryAfter = 0 => se ignora Retry-After.
+        void setBackoff(cc::config::RetryBackoff shape, cc::time::Millis maxRetryAfter);
+        void setPooling(bool enabled); // reutilizar handles/conexiones vía ConnectionPool
+        // Con HTTP/2 también request() pasa por el AsyncEngine: todas las peticiones
+        // concurrentes a un origen comparten una conexión multiplexada.
+        void setHttpVersion(cc::config::HttpVersion v);
+        // Comprimir con gzip los bodies >= minBytes (Content-Encoding: gzip). 0 => nunca.
+        // Las respuestas siempre se piden comprimidas (Accept-Encoding) y se decodifican solas.
+        void setRequestCompression(std::size_t minBytes);
+        // nullopt => sin hedging (default). Ver HedgePolicy.
+        void setHedging(std::optional<HedgePolicy> policy);
+        // Caché de respuestas GET 200 (clave = URL); nullptr => sin caché (default). Un GET
+        // fresco no sale a la red; uno vencido con ETag/Last-Modified se revalida (304).
+        // PUT/POST/DELETE exitosos a una URL invalidan su entrada. Métricas: http.cache.*
+        void setResponseCache(std::shared_ptr<ResponseCache> cache);
+        // GET/HEAD idénticos (URL + headers efectivos) concurrentes comparten una sola
+        // transferencia, también entre clientes distintos; todos reciben la misma respuesta.
+        // Cada llamador conserva su propia cancelación/deadline. Métricas: http.singleflight.*
+        void setSingleFlight(bool enabled);
+        // Timeouts aprendidos (ver EndpointLatencies): en las llamadas sin timeout explícito,
+        // total y conexión salen del pN observado del endpoint, acotados por la política; el
+        // techo por defecto es setTimeout(), así que solo acortan. nullopt => timeout fijo.
+        // En streaming solo se aplica el de conexión.
+        void setAdaptiveTimeouts(std::optional<AdaptiveTimeoutPolicy> policy);
         void setDefaultHeader(const std::string& key, const std::string& value);
         void clearDefaultHeader(const std::string& key);
 
@@ -47,19 +176,114 @@ namespace cc::http {
         HttpResponse post(const std::string& url, const std::string& body);
         HttpResponse put (const std::string& url, const std::string& body);
 
-        // General
+        // General. El body no se copia (ver RequestBody); se arma una vez para todos los intentos.
+        // `ctl` aborta la transferencia en curso al cancelar (499) y acota todos los intentos
+        // al deadline: cada timeout se recorta a lo que queda y no se reintenta si el backoff
+        // no entra en el presupuesto (status 0, "deadline exceeded").
         HttpResponse request(const std::string& method,
                              const std::string& url,
-                             const std::string& body = "",
-                             const std::unordered_map<std::string, std::string>& headers = {},
-                             std::optional<int> timeoutMs = std::nullopt);
+                             RequestBody body = {},
+                             const HeaderMap& headers = {},
+                             std::optional<int> timeoutMs = std::nullopt,
+                             const RequestControl& ctl = {});
+
+        // Armar una vez, enviar muchas (mismos reintentos/backoff que request()).
+        PreparedRequest prepare(const std::string& method,
+                                const std::string& url,
+                                RequestBody body = {},
+                                const HeaderMap& headers = {},
+                                std::optional<int> timeoutMs = std::nullopt) const;
+        HttpResponse send(const PreparedRequest& req, const RequestControl& ctl = {});
+
+        // Streaming: el body de una respuesta 2xx se entrega a `sink` por trozos (sin
+        // acumularlo) y HttpResponse::body queda vacío; respuestas no-2xx se devuelven
+        // completas en body. Solo se reintenta si aún no se entregó ningún byte al sink.
+        HttpResponse requestStreaming(const std::string& method,
+                                      const std::string& url,
+                                      RequestBody body,
+                                      const HeaderMap& headers,
+                                      BodySink sink,
+                                      std::optional<int> timeoutMs = std::nullopt,
+                                      const RequestControl& ctl = {});
+
+        // Asíncrono (curl_multi, un hilo de I/O compartido). Mismos reintentos/backoff que
+        // request(), pero esperando en timers del loop en vez de dormir el hilo llamador.
+        // El body se toma por valor: pasarlo con std::move evita la copia. Con single-flight
+        // solo se coalescen las llamadas sin cancelación ni deadline en `ctl`.
+        void requestAsync(const std::string& method,
+                          const std::string& url,
+                          std::string body,
+                          const HeaderMap& headers,
+                          std::optional<int> timeoutMs,
+                          ResponseCallback onDone,
+                          RequestControl ctl = {});
+
+        std::future<HttpResponse> requestAsync(const std::string& method,
+                                               const std::string& url,
+                                               const std::string& body = "",
+                                               const HeaderMap& headers = {},
+                                               std::optional<int> timeoutMs = std::nullopt);
+
+        // Latencias de los GET/HEAD exitosos de este cliente (y sus copias); de acá sale el
+        // delay de hedging.
+        const cc::metrics::LatencyTracker& latency() const noexcept { return *latency_; }
+
+        // Arranque: abre en segundo plano `connectionsPerOrigin` conexiones (DNS + TCP + TLS y
+        // un HEAD al origen) hacia cada URL, tanto en el ConnectionPool como en el curl_multi
+        // del AsyncEngine, para que la primera llamada real no pague el handshake. No bloquea;
+        // el future da cuántos orígenes respondieron (los errores solo se loguean).
+        static std::future<std::size_t> prewarm(const std::vector<std::string>& urls,
+                                                int connectionsPerOrigin = 1);
 
     private:
-        HttpResponse do_request_once(const HttpRequest& req); // 1 intento (sin retries)
+        std::shared_ptr<HttpRequest> make_request(const std::string& method,
+                                                  const std::string& url,
+                                                  RequestBody body,
+                                                  const HeaderMap& headers,
+                                                  std::optional<int> timeoutMs) const;
+        void rebuild_header_list(); // tras cambiar defaultHeaders_
+
+        // Reintenta con backoff dentro de ctl; no reintenta si *noRetry pasa a true (p.ej.
+        // streaming ya iniciado)
+        HttpResponse send_with_retries(const std::shared_ptr<const HttpRequest>& req,
+                                       const bool* noRetry, const RequestControl& ctl);
+        HttpResponse do_request_once(const std::shared_ptr<const HttpRequest>& req); // 1 intento
+        HttpResponse do_hedged_once(const std::shared_ptr<const HttpRequest>& req, cc::time::Millis delay);
+        std::optional<cc::time::Millis> hedge_delay(const HttpRequest& req) const; // nullopt => no hedgear
+        bool tracks_latency(const HttpRequest& req) const noexcept;
+        // GET a través de cache_ (lookup, request condicional, guardado)
+        HttpResponse cached_get(const std::string& url,
+                                const HeaderMap& headers,
+                                std::optional<int> timeoutMs, const RequestControl& ctl);
+        // requestAsync() sin single-flight (caché, reintentos, hedging)
+        void start_async(const std::string& method, const std::string& url, std::string body,
+                         const HeaderMap& headers,
+                         std::optional<int> timeoutMs, ResponseCallback onDone, RequestControl ctl);
+        // Single-flight: clave del vuelo y arranque de la transferencia compartida
+        std::string flight_key(const std::string& method, const std::string& url,
+                               const HeaderMap& headers) const;
+        void launch_flight(const std::string& key, std::uint64_t flight, cc::time::CancellationToken abandon,
+                           const std::string& method, const std::string& url,
+                           const HeaderMap& headers,
+                           std::optional<int> timeoutMs);
+        HttpResponse coalesced(const std::string& method, const std::string& url,
+                               const HeaderMap& headers,
+                               std::optional<int> timeoutMs, const RequestControl& ctl);
 
         int timeoutMs_{5000};
         int retries_{1}; // reintentos adicionales (además del intento inicial)
-        std::unordered_map<std::string, std::string> defaultHeaders_;
+        cc::config::RetryBackoff backoff_{cc::config::RetryBackoff::Decorrelated};
+        cc::time::Millis maxRetryAfter_{30000};
+        bool usePool_{true};
+        cc::config::HttpVersion version_{cc::config::HttpVersion::Http1_1};
+        std::size_t compressMinBytes_{0};
+        std::optional<HedgePolicy> hedge_;
+        std::optional<AdaptiveTimeoutPolicy> adaptive_;
+        std::shared_ptr<cc::metrics::LatencyTracker> latency_;
+        std::shared_ptr<ResponseCache> cache_;
+        bool singleFlight_{false};
+        HeaderMap defaultHeaders_;
+        std::shared_ptr<const HeaderList> defaultHeaderList_; // defaultHeaders_ ya armados
     };
 
 } // namespace cc::http
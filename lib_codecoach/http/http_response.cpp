@@ -47,33 +47,18 @@ const char* reason_phrase(int status) noexcept {
     }
 }
 
-static inline char to_lower(unsigned char c) { return static_cast<char>(std::tolower(c)); }
-
 std::optional<std::string> get_header_ci(
-    const std::unordered_map<std::string, std::string>& headers,
+    const HeaderMap& headers,
     std::string_view key)
 {
-    // Intento rápido: exacto
-    if (auto it = headers.find(std::string(key)); it != headers.end())
-        return it->second;
-
-    // Búsqueda CI mediante escaneo
-    std::string key_lc;
-    key_lc.resize(key.size());
-    std::transform(key.begin(), key.end(), key_lc.begin(), to_lower);
-
-    for (const auto& kv : headers) {
-        std::string k = kv.first;
-        std::transform(k.begin(), k.end(), k.begin(), to_lower);
-        if (k == key_lc) return kv.second;
-    }
+    if (auto v = headers.get(key)) return std::string(*v);
     return std::nullopt;
 }
 
 std::string summarize(
     int status,
     std::string_view body,
-    const std::unordered_map<std::string, std::string>& headers,
+    const HeaderMap& headers,
     std::size_t maxBody)
 {
     std::ostringstream oss;
@@ -6,18 +6,23 @@
 #ifndef LIB_CODECOACH_HTTP_RESPONSE_H
 #define LIB_CODECOACH_HTTP_RESPONSE_H
 
+#include "header_map.h"
+
 #include <string>
 #include <string_view>
-#include <unordered_map>
 #include <optional>
 #include <cstddef> // size_t
+#include <exception>
 
 namespace cc::http {
 
     struct HttpResponse {
         int statusCode{0};
         std::string body;
-        std::unordered_map<std::string, std::string> headers;
+        HeaderMap headers;
+        // Lo que lanzó un callback del llamador (BodySink) a mitad de transferencia: la
+        // transferencia se aborta con 499 y request()/requestStreaming()/http_request lo relanzan
+        std::exception_ptr error{};
 
         bool isSuccess() const noexcept { return statusCode >= 200 && statusCode < 300; }
     };
@@ -33,15 +38,16 @@ namespace cc::http {
     inline bool is_network_error(int s) noexcept { return s == 0; } // timeout / fallo de red
 
     // Obtiene un header (case-insensitive). Devuelve nullopt si no existe.
+    // (Sin copia: HeaderMap::get devuelve un string_view.)
     std::optional<std::string> get_header_ci(
-        const std::unordered_map<std::string, std::string>& headers,
+        const HeaderMap& headers,
         std::string_view key);
 
     // Resumen legible (status + reason + algunos headers + body truncado a maxBody bytes).
     std::string summarize(
         int status,
         std::string_view body,
-        const std::unordered_map<std::string, std::string>& headers,
+        const HeaderMap& headers,
         std::size_t maxBody = 512);
 
     // Overload conveniente para HttpResponse
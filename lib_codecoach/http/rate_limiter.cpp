@@ -0,0 +1,419 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// rate_limiter.cpp — Token bucket + semáforo AIMD por origen.
+
+#include "rate_limiter.h"
+#include "async_engine.h"
+#include "url.h"
+
+#include "config/config_manager.h"
+#include "logging/logger.h"
+#include "metrics/counters.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#ifdef CC_USE_CURL
+  #include <curl/curl.h>
+#endif
+
+namespace cc::http {
+
+using cc::time::Millis;
+using cc::time::SteadyClock;
+using cc::time::CancellationToken;
+using cc::time::Deadline;
+
+namespace {
+
+// Cada cuánto revisa cancelación/deadline un llamador síncrono que espera turno
+constexpr Millis kWaitPoll{50};
+
+using Granted = std::function<void(LimiterSlot)>;
+
+struct Limiter {
+    LimiterPolicy           policy{};
+    bool                    custom{false};  // configurado por origen (no sigue a los defaults)
+    double                  tokens{0};
+    SteadyClock::time_point refilledAt{};
+    double                  limit{0};       // concurrencia actual; 0 => sin límite
+    int                     inFlight{0};
+    SteadyClock::time_point pausedUntil{};
+    SteadyClock::time_point lastDecrease{};
+    std::deque<Granted>     waiters;        // acquire_async esperando un turno libre
+    std::uint64_t           throttled{0};
+    std::uint64_t           decreased{0};
+};
+
+// Resultado de intentar tomar turno: concedido, esperar un tiempo (tasa/pausa) o esperar a
+// que alguien devuelva el suyo (wait == nullopt)
+struct Attempt {
+    bool                  granted{false};
+    std::optional<Millis> wait{};
+};
+
+double bucket_capacity(const LimiterPolicy& p) {
+    return p.burst > 0 ? static_cast<double>(p.burst) : std::max(1.0, p.qps);
+}
+
+void init(Limiter& l, const LimiterPolicy& p, SteadyClock::time_point now) {
+    l.policy       = p;
+    l.tokens       = bucket_capacity(p);
+    l.refilledAt   = now;
+    l.limit        = p.maxInFlight > 0 ? static_cast<double>(p.maxInFlight) : 0.0;
+    l.pausedUntil  = {};
+    l.lastDecrease = {};
+}
+
+bool same_policy(const LimiterPolicy& a, const LimiterPolicy& b) {
+    return a.qps == b.qps && a.burst == b.burst && a.maxInFlight == b.maxInFlight &&
+           a.adaptive == b.adaptive && a.minInFlight == b.minInFlight && a.decrease == b.decrease &&
+           a.maxPause == b.maxPause;
+}
+
+// Cambio de política sobre un limitador en uso: conserva lo aprendido (límite AIMD, tokens
+// del bucket, pausa por Retry-After) dentro de los nuevos topes en vez de empezar de cero.
+void retune(Limiter& l, const LimiterPolicy& p, SteadyClock::time_point now) {
+    const LimiterPolicy old = l.policy;
+    l.policy = p;
+
+    if (p.qps <= 0 || old.qps <= 0) {
+        l.tokens     = bucket_capacity(p); // sin tasa previa los tokens no significan nada
+        l.refilledAt = now;
+    } else {
+        l.tokens = std::min(l.tokens, bucket_capacity(p));
+    }
+
+    if (p.maxInFlight <= 0) {
+        l.limit = 0.0;
+    } else if (l.limit <= 0 || !p.adaptive) {
+        l.limit = static_cast<double>(p.maxInFlight);
+    } else {
+        l.limit = std::clamp(l.limit, static_cast<double>(std::max(1, p.minInFlight)),
+                             static_cast<double>(p.maxInFlight));
+    }
+}
+
+Attempt try_take(Limiter& l, SteadyClock::time_point now) {
+    if (now < l.pausedUntil) {
+        return {false, std::chrono::ceil<Millis>(l.pausedUntil - now)};
+    }
+    if (l.limit > 0 && l.inFlight >= static_cast<int>(l.limit)) {
+        return {false, std::nullopt};
+    }
+    if (l.policy.qps > 0) {
+        const double elapsed = std::chrono::duration<double>(now - l.refilledAt).count();
+        l.tokens     = std::min(bucket_capacity(l.policy), l.tokens + elapsed * l.policy.qps);
+        l.refilledAt = now;
+        if (l.tokens < 1.0) {
+            const double secs = (1.0 - l.tokens) / l.policy.qps;
+            return {false, Millis{std::max<Millis::rep>(1, static_cast<Millis::rep>(std::ceil(secs * 1000.0)))}};
+        }
+        l.tokens -= 1.0;
+    }
+    ++l.inFlight;
+    return {true, std::nullopt};
+}
+
+bool overloaded(int status, bool hasRetryAfter) {
+    // 429 y 5xx (y red/timeout) dicen "menos carga"; 499 fue nuestra propia cancelación
+    return hasRetryAfter || status == 429 || status == 0 || (status >= 500 && status < 600);
+}
+
+} // namespace
+
+// -------------------------------
+// Retry-After
+// -------------------------------
+std::optional<Millis> retry_after_of(const HttpResponse& resp) {
+    auto v = get_header_ci(resp.headers, "Retry-After");
+    if (!v) return std::nullopt;
+    std::string s = *v;
+    s.erase(0, s.find_first_not_of(" \t"));
+    s.erase(s.find_last_not_of(" \t\r\n") + 1);
+    if (s.empty()) return std::nullopt;
+
+    if (std::all_of(s.begin(), s.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        const long long secs = s.size() > 9 ? 999999999LL : std::stoll(s); // lo absurdo lo topa maxPause
+        return Millis{secs * 1000};
+    }
+#ifdef CC_USE_CURL
+    const time_t when = curl_getdate(s.c_str(), nullptr);
+    if (when < 0) return std::nullopt;
+    const auto secs = static_cast<Millis::rep>(when - std::time(nullptr));
+    return Millis{std::max<Millis::rep>(0, secs) * 1000};
+#else
+    return std::nullopt;
+#endif
+}
+
+// -------------------------------
+// Estado interno
+// -------------------------------
+struct RateLimiters::State {
+    mutable std::mutex      m;
+    std::condition_variable cv;
+    LimiterPolicy           defaults{};
+    std::unordered_map<std::string, Limiter> limiters; // los nodos no se borran (referencias estables)
+
+    Limiter& get_locked(const std::string& origin, SteadyClock::time_point now) {
+        auto [it, created] = limiters.try_emplace(origin);
+        if (created) init(it->second, defaults, now);
+        return it->second;
+    }
+
+    // Las colas async se reintentan en el hilo de I/O (fuera del lock del llamador)
+    void wake_async_locked(Limiter& l, const std::string& origin, std::size_t n);
+
+    void acquire_async(const std::string& origin, Granted granted, bool requeued);
+};
+
+void RateLimiters::State::wake_async_locked(Limiter& l, const std::string& origin, std::size_t n) {
+    for (; n > 0 && !l.waiters.empty(); --n) {
+        AsyncEngine::instance().schedule(Millis{0}, [this, origin, g = std::move(l.waiters.front())]() mutable {
+            acquire_async(origin, std::move(g), true);
+        });
+        l.waiters.pop_front();
+    }
+}
+
+void RateLimiters::State::acquire_async(const std::string& origin, Granted granted, bool requeued) {
+    std::unique_lock<std::mutex> lk(m);
+    const auto now = SteadyClock::now();
+    Limiter& l = get_locked(origin, now);
+    const Attempt a = try_take(l, now);
+    if (a.granted) {
+        lk.unlock();
+        granted(LimiterSlot{now});
+        return;
+    }
+    if (!requeued) {
+        ++l.throttled;
+        cc::metrics::count("http.limiter.throttled|" + origin);
+    }
+    if (!a.wait) {
+        // Los que ya esperaban van primero
+        if (requeued) l.waiters.push_front(std::move(granted));
+        else          l.waiters.push_back(std::move(granted));
+        return;
+    }
+    lk.unlock();
+    AsyncEngine::instance().schedule(*a.wait, [this, origin, g = std::move(granted)]() mutable {
+        acquire_async(origin, std::move(g), true);
+    });
+}
+
+// -------------------------------
+// RateLimiters
+// -------------------------------
+RateLimiters& RateLimiters::instance() {
+    // Nunca se destruye: el hilo de I/O del AsyncEngine puede devolver turnos al salir.
+    static RateLimiters* inst = new RateLimiters();
+    return *inst;
+}
+
+RateLimiters::RateLimiters()
+    : state_(new State())
+{
+    const auto& cfg = cc::config::get();
+    LimiterPolicy p;
+    p.qps         = static_cast<double>(std::max(0, cfg.http.rateLimitQps));
+    p.burst       = std::max(0, cfg.http.rateLimitBurst);
+    p.maxInFlight = std::max(0, cfg.http.maxInFlight);
+    p.adaptive    = cfg.http.adaptiveConcurrency;
+    state_->defaults = p;
+}
+
+RateLimiters::~RateLimiters() {
+    delete state_;
+}
+
+void RateLimiters::configure(const LimiterPolicy& defaults) {
+    std::lock_guard<std::mutex> lk(state_->m);
+    state_->defaults = defaults;
+    const auto now = SteadyClock::now();
+    for (auto& [origin, l] : state_->limiters) {
+        if (l.custom || same_policy(l.policy, defaults)) continue;
+        retune(l, defaults, now);
+        state_->wake_async_locked(l, origin, l.waiters.size());
+    }
+    state_->cv.notify_all();
+}
+
+// Cada cliente de un servicio con cuota la vuelve a aplicar al construirse
+// (apply_service_quota): con la misma política no se toca nada.
+void RateLimiters::configure(const std::string& origin, const LimiterPolicy& policy) {
+    std::lock_guard<std::mutex> lk(state_->m);
+    const auto now = SteadyClock::now();
+    auto [it, created] = state_->limiters.try_emplace(origin);
+    Limiter& l = it->second;
+    const bool unchanged = !created && same_policy(l.policy, policy);
+    l.custom = true;
+    if (unchanged) return;
+    if (created) init(l, policy, now);
+    else         retune(l, policy, now);
+    state_->wake_async_locked(l, origin, l.waiters.size());
+    state_->cv.notify_all();
+}
+
+LimiterPolicy RateLimiters::policy(const std::string& origin) const {
+    std::lock_guard<std::mutex> lk(state_->m);
+    auto it = state_->limiters.find(origin);
+    return it != state_->limiters.end() ? it->second.policy : state_->defaults;
+}
+
+std::optional<LimiterSlot> RateLimiters::acquire(const std::string& origin,
+                                                 const CancellationToken& cancel,
+                                                 const std::optional<Deadline>& deadline) {
+    std::unique_lock<std::mutex> lk(state_->m);
+    bool waited = false;
+    for (;;) {
+        const auto now = SteadyClock::now();
+        Limiter& l = state_->get_locked(origin, now);
+        const Attempt a = try_take(l, now);
+        if (a.granted) return LimiterSlot{now};
+
+        if (!waited) {
+            waited = true;
+            ++l.throttled;
+            cc::metrics::count("http.limiter.throttled|" + origin);
+        }
+        if (cancel.is_cancelled() || (deadline && deadline->expired())) return std::nullopt;
+
+        Millis wait = std::min(a.wait.value_or(kWaitPoll), kWaitPoll);
+        if (deadline) wait = std::min(wait, std::max(Millis{1}, deadline->remaining()));
+        state_->cv.wait_for(lk, wait);
+    }
+}
+
+std::optional<LimiterSlot> RateLimiters::try_acquire(const std::string& origin) {
+    std::lock_guard<std::mutex> lk(state_->m);
+    const auto now = SteadyClock::now();
+    Limiter& l = state_->get_locked(origin, now);
+    // Con llamadores esperando turno, un intento opcional no se les adelanta
+    if (!l.waiters.empty() || !try_take(l, now).granted) return std::nullopt;
+    return LimiterSlot{now};
+}
+
+void RateLimiters::acquire_async(const std::string& origin, std::function<void(LimiterSlot)> granted) {
+    state_->acquire_async(origin, std::move(granted), false);
+}
+
+void RateLimiters::release(const std::string& origin, const LimiterSlot& slot, const HttpResponse& resp) {
+    const auto retryAfter = (resp.statusCode == 429 || resp.statusCode >= 500) ? retry_after_of(resp)
+                                                                              : std::nullopt;
+    std::string note;
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        const auto now = SteadyClock::now();
+        Limiter& l = state_->get_locked(origin, now);
+        l.inFlight = std::max(0, l.inFlight - 1);
+
+        // Solo un origen con límites pausa a todos: sin ellos cada llamada ya respeta su
+        // Retry-After al reintentar (HttpClient)
+        const bool limited = l.policy.qps > 0 || l.policy.maxInFlight > 0;
+        if (retryAfter && limited) {
+            const auto pause = std::min(*retryAfter, l.policy.maxPause);
+            if (now + pause > l.pausedUntil) {
+                l.pausedUntil = now + pause;
+                note = "[HTTP] " + origin + " asked to back off (Retry-After " + std::to_string(pause.count()) + " ms)";
+            }
+        }
+
+        const auto& p = l.policy;
+        if (p.adaptive && l.limit > 0 && resp.statusCode != 499) {
+            if (overloaded(resp.statusCode, retryAfter.has_value())) {
+                // Un recorte por "ronda": lo que salió antes del último recorte ya se contó
+                if (slot.since >= l.lastDecrease) {
+                    const double before = l.limit;
+                    l.limit = std::max(static_cast<double>(std::max(1, p.minInFlight)), l.limit * p.decrease);
+                    l.lastDecrease = now;
+                    ++l.decreased;
+                    cc::metrics::count("http.limiter.decreased|" + origin);
+                    if (note.empty() && static_cast<int>(before) != static_cast<int>(l.limit)) {
+                        note = "[HTTP] " + origin + " concurrency " + std::to_string(static_cast<int>(before)) +
+                               " -> " + std::to_string(static_cast<int>(l.limit)) +
+                               " (status " + std::to_string(resp.statusCode) + ")";
+                    }
+                }
+            } else if (resp.statusCode >= 200 && resp.statusCode < 500) {
+                // +1 por ventana completa de éxitos
+                l.limit = std::min(static_cast<double>(p.maxInFlight), l.limit + 1.0 / l.limit);
+            }
+        }
+
+        const int room = l.limit > 0 ? static_cast<int>(l.limit) - l.inFlight : 1;
+        state_->wake_async_locked(l, origin, static_cast<std::size_t>(std::max(1, room)));
+    }
+    state_->cv.notify_all();
+    if (!note.empty()) CC_LOG_INFO(note);
+}
+
+void RateLimiters::release(const std::string& origin, const LimiterSlot&) {
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        Limiter& l = state_->get_locked(origin, SteadyClock::now());
+        l.inFlight = std::max(0, l.inFlight - 1);
+        state_->wake_async_locked(l, origin, 1);
+    }
+    state_->cv.notify_all();
+}
+
+std::vector<LimiterSnapshot> RateLimiters::snapshot() const {
+    std::vector<LimiterSnapshot> out;
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        const auto now = SteadyClock::now();
+        out.reserve(state_->limiters.size());
+        for (const auto& [origin, l] : state_->limiters) {
+            LimiterSnapshot s;
+            s.origin    = origin;
+            s.limit     = l.limit;
+            s.inFlight  = l.inFlight;
+            s.tokens    = l.tokens;
+            s.throttled = l.throttled;
+            s.decreased = l.decreased;
+            s.pausedFor = now < l.pausedUntil ? std::chrono::ceil<Millis>(l.pausedUntil - now) : Millis{0};
+            out.push_back(std::move(s));
+        }
+    }
+    std::sort(out.begin(), out.end(),
+              [](const LimiterSnapshot& a, const LimiterSnapshot& b) { return a.origin < b.origin; });
+    return out;
+}
+
+void RateLimiters::reset() {
+    std::lock_guard<std::mutex> lk(state_->m);
+    const auto now = SteadyClock::now();
+    for (auto& [origin, l] : state_->limiters) {
+        init(l, l.custom ? l.policy : state_->defaults, now);
+        l.throttled = 0;
+        l.decreased = 0;
+        state_->wake_async_locked(l, origin, l.waiters.size());
+    }
+    state_->cv.notify_all();
+}
+
+void apply_service_quota(const std::string& baseUrl, int qps, int maxInFlight) {
+    if (qps <= 0 && maxInFlight <= 0) return;
+    auto& limiters = RateLimiters::instance();
+    const std::string origin = origin_of(baseUrl);
+    LimiterPolicy p = limiters.policy(origin);
+    if (qps > 0) {
+        p.qps   = static_cast<double>(qps);
+        p.burst = 0;
+    }
+    if (maxInFlight > 0) p.maxInFlight = maxInFlight;
+    limiters.configure(origin, p);
+}
+
+} // namespace cc::http
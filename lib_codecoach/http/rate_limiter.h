@@ -0,0 +1,100 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// rate_limiter.h — Límite de tasa (token bucket) y de concurrencia (requests en vuelo) por
+// origen, compartido por todos los HttpClient del proceso. Cada intento pide turno antes de
+// salir a la red y lo devuelve con su resultado. En modo adaptativo (AIMD) el límite de
+// concurrencia baja a la mitad ante 429/5xx/Retry-After y sube de a ~1 por ventana de
+// éxitos; si el origen tiene límites, un Retry-After además lo pausa hasta esa fecha.
+#ifndef LIB_CODECOACH_RATE_LIMITER_H
+#define LIB_CODECOACH_RATE_LIMITER_H
+
+#include "http_response.h"
+#include "metrics/timer.h"
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace cc::http {
+
+    struct LimiterPolicy {
+        double qps{0};                    // tasa sostenida; 0 => sin límite de tasa
+        int    burst{0};                  // capacidad del bucket; 0 => max(1, qps)
+        int    maxInFlight{0};            // requests simultáneos; 0 => sin límite
+        bool   adaptive{false};           // AIMD entre minInFlight y maxInFlight (requiere maxInFlight)
+        int    minInFlight{1};
+        double decrease{0.5};             // factor multiplicativo al recibir 429/5xx
+        cc::time::Millis maxPause{60000}; // Retry-After más largo que se respeta
+    };
+
+    struct LimiterSnapshot {
+        std::string      origin;
+        double           limit{0};     // límite de concurrencia actual (0 => sin límite)
+        int              inFlight{0};
+        double           tokens{0};
+        std::uint64_t    throttled{0}; // llamadas que tuvieron que esperar (acumulado)
+        std::uint64_t    decreased{0}; // recortes AIMD (acumulado)
+        cc::time::Millis pausedFor{0}; // resto de la pausa por Retry-After
+    };
+
+    // Turno concedido; se devuelve tal cual a release().
+    struct LimiterSlot {
+        cc::time::SteadyClock::time_point since{};
+    };
+
+    // Retry-After en segundos o como fecha HTTP; nullopt si no hay (o no se entiende).
+    std::optional<cc::time::Millis> retry_after_of(const HttpResponse& resp);
+
+    // Cuota propia de un servicio (p.ej. analizador, LLM): qps/maxInFlight > 0 pisan la
+    // política general para el origen de `baseUrl`. Con ambos en 0 no hace nada.
+    void apply_service_quota(const std::string& baseUrl, int qps, int maxInFlight);
+
+    class RateLimiters {
+    public:
+        // Instancia global; la política por defecto sale de cc::config::get().http.
+        static RateLimiters& instance();
+
+        void configure(const LimiterPolicy& defaults);                        // orígenes sin política propia
+        void configure(const std::string& origin, const LimiterPolicy& policy); // p.ej. un servicio con cuota
+        LimiterPolicy policy(const std::string& origin) const;
+
+        // Bloquea hasta tener turno. nullopt => se canceló o venció el deadline esperando.
+        std::optional<LimiterSlot> acquire(const std::string& origin,
+                                           const cc::time::CancellationToken& cancel,
+                                           const std::optional<cc::time::Deadline>& deadline);
+
+        // Solo si hay turno ya, sin esperar ni encolarse (intentos opcionales, p.ej. el hedge).
+        std::optional<LimiterSlot> try_acquire(const std::string& origin);
+
+        // Sin bloquear: `granted` corre cuando hay turno (en el hilo llamador si lo hay ya,
+        // si no en el hilo de I/O del AsyncEngine).
+        void acquire_async(const std::string& origin, std::function<void(LimiterSlot)> granted);
+
+        // Devuelve el turno con el resultado del intento (ajusta AIMD y pausas por Retry-After).
+        void release(const std::string& origin, const LimiterSlot& slot, const HttpResponse& resp);
+        // El intento no llegó a salir (breaker abierto, deadline, cancelación): no ajusta nada.
+        void release(const std::string& origin, const LimiterSlot& slot);
+
+        std::vector<LimiterSnapshot> snapshot() const; // ordenado por origen
+        void reset();
+
+        ~RateLimiters();
+        RateLimiters(const RateLimiters&) = delete;
+        RateLimiters& operator=(const RateLimiters&) = delete;
+
+        struct State;
+
+    private:
+        RateLimiters();
+
+        // PIMPL: buckets, semáforos y colas de espera viven en el .cpp
+        State* state_;
+    };
+
+} // namespace cc::http
+
+#endif // LIB_CODECOACH_RATE_LIMITER_H
@@ -0,0 +1,403 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// response_cache.cpp — LRU con presupuesto de bytes + capa en disco (un archivo por URL).
+
+#include "response_cache.h"
+
+#include "config/config_manager.h"
+#include "logging/logger.h"
+#include "metrics/counters.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#ifdef CC_USE_CURL
+  #include <curl/curl.h>
+#endif
+
+namespace cc::http {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::string_view kDiskMagic = "CCCACHE1";
+
+using Headers = HeaderMap;
+
+struct Entry {
+    int          status{200};
+    std::string  body;
+    Headers      headers;
+    std::int64_t expiresAtMs{0}; // epoch (system_clock); <= now => hay que revalidar
+};
+
+std::int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string lower(std::string_view s) {
+    std::string out(s);
+    std::transform(out.begin(), out.end(), out.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return out;
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+// HTTP-date -> ms epoch (vía libcurl); nullopt si no parsea
+std::optional<std::int64_t> parse_http_date(const std::string& s) {
+#ifdef CC_USE_CURL
+    const time_t t = curl_getdate(s.c_str(), nullptr);
+    if (t < 0) return std::nullopt;
+    return static_cast<std::int64_t>(t) * 1000;
+#else
+    (void)s;
+    return std::nullopt;
+#endif
+}
+
+struct Freshness {
+    bool         storable{true};
+    std::int64_t expiresAtMs{0};
+};
+
+Freshness freshness_of(const Headers& headers, std::int64_t nowMs) {
+    Freshness f;
+    std::optional<std::int64_t> lifetimeMs;
+
+    if (auto cc = get_header_ci(headers, "Cache-Control")) {
+        std::string_view rest(*cc);
+        while (!rest.empty()) {
+            const auto comma = rest.find(',');
+            const std::string dir = lower(trim(rest.substr(0, comma)));
+            rest = comma == std::string_view::npos ? std::string_view{} : rest.substr(comma + 1);
+
+            if (dir == "no-store") {
+                f.storable = false;
+            } else if (dir == "no-cache") {
+                lifetimeMs = 0; // se guarda, pero siempre se revalida
+            } else if (dir.rfind("max-age=", 0) == 0 && !lifetimeMs) {
+                try {
+                    lifetimeMs = std::max<std::int64_t>(0, std::stoll(dir.substr(8))) * 1000;
+                } catch (const std::exception&) {
+                    lifetimeMs = 0;
+                }
+            }
+        }
+    }
+
+    if (!lifetimeMs) {
+        if (auto exp = get_header_ci(headers, "Expires")) {
+            const auto expires = parse_http_date(*exp);
+            const auto dateHdr = get_header_ci(headers, "Date");
+            const auto date    = dateHdr ? parse_http_date(*dateHdr) : std::nullopt;
+            // Expires inválido (p.ej. "0") => ya vencido
+            lifetimeMs = expires ? std::max<std::int64_t>(0, *expires - date.value_or(nowMs)) : 0;
+        }
+    }
+
+    // Vary (salvo Accept-Encoding, que libcurl resuelve) haría depender la respuesta de
+    // headers del request que no forman parte de la clave: no se guarda.
+    if (auto vary = get_header_ci(headers, "Vary")) {
+        if (lower(trim(*vary)) != "accept-encoding") f.storable = false;
+    }
+
+    std::int64_t ageMs = 0;
+    if (auto age = get_header_ci(headers, "Age")) {
+        try { ageMs = std::max<std::int64_t>(0, std::stoll(*age)) * 1000; } catch (const std::exception&) {}
+    }
+    // Sin max-age/Expires no inventamos frescura heurística: se revalida siempre
+    f.expiresAtMs = nowMs + lifetimeMs.value_or(0) - ageMs;
+    return f;
+}
+
+std::size_t cost_of(const std::string& key, const Entry& e) {
+    std::size_t n = key.size() + e.body.size() + 64;
+    for (const auto& [k, v] : e.headers) n += k.size() + v.size() + 16;
+    return n;
+}
+
+// FNV-1a 64: nombre de archivo estable por clave
+std::string file_name_of(const std::string& key) {
+    std::uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%016llx.cce", static_cast<unsigned long long>(h));
+    return buf;
+}
+
+bool has_newline(std::string_view s) {
+    return s.find('\n') != std::string_view::npos || s.find('\r') != std::string_view::npos;
+}
+
+} // namespace
+
+// -------------------------------
+// Estado interno
+// -------------------------------
+struct ResponseCache::State {
+    struct Node {
+        Entry                            entry;
+        std::size_t                      bytes{0};
+        std::list<std::string>::iterator pos;
+    };
+
+    mutable std::mutex                     m;
+    ResponseCacheOptions                   opts;
+    std::list<std::string>                 lru; // frente = más reciente
+    std::unordered_map<std::string, Node>  map;
+    std::size_t                            bytes{0};
+    std::size_t                            evicted{0};
+
+    void touch(Node& n) { lru.splice(lru.begin(), lru, n.pos); }
+
+    void put(const std::string& key, Entry e) {
+        const std::size_t cost = cost_of(key, e);
+        if (cost > opts.maxBytes) {
+            remove(key);
+            return; // no entra ni sola
+        }
+        if (auto it = map.find(key); it != map.end()) {
+            bytes -= it->second.bytes;
+            it->second.entry = std::move(e);
+            it->second.bytes = cost;
+            bytes += cost;
+            touch(it->second);
+        } else {
+            lru.push_front(key);
+            Node n;
+            n.entry = std::move(e);
+            n.bytes = cost;
+            n.pos   = lru.begin();
+            map.emplace(key, std::move(n));
+            bytes += cost;
+        }
+        while (bytes > opts.maxBytes && !lru.empty()) {
+            const std::string victim = lru.back(); // remove() destruye el nodo de la lista
+            remove(victim);
+            ++evicted;
+            cc::metrics::count("http.cache.evicted");
+        }
+    }
+
+    void remove(const std::string& key) {
+        auto it = map.find(key);
+        if (it == map.end()) return;
+        bytes -= it->second.bytes;
+        lru.erase(it->second.pos);
+        map.erase(it);
+    }
+
+    // --- Disco: un archivo por clave; se escribe a .tmp y se renombra (atómico) ---
+    fs::path path_of(const std::string& key) const { return fs::path(opts.diskDir) / file_name_of(key); }
+
+    void write_disk(const std::string& key, const Entry& e) const {
+        if (opts.diskDir.empty() || has_newline(key)) return;
+        std::error_code ec;
+        fs::create_directories(opts.diskDir, ec);
+        const fs::path final = path_of(key);
+        const fs::path tmp   = final.string() + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out) return;
+            out << kDiskMagic << '\n' << key << '\n' << e.expiresAtMs << '\n' << e.status << '\n';
+            std::size_t n = 0;
+            for (const auto& [k, v] : e.headers) n += !has_newline(k) && !has_newline(v);
+            out << n << '\n';
+            for (const auto& [k, v] : e.headers) {
+                if (!has_newline(k) && !has_newline(v)) out << k << '\n' << v << '\n';
+            }
+            out << e.body.size() << '\n';
+            out.write(e.body.data(), static_cast<std::streamsize>(e.body.size()));
+            if (!out) {
+                out.close();
+                fs::remove(tmp, ec);
+                return;
+            }
+        }
+        fs::rename(tmp, final, ec);
+        if (ec) {
+            CC_LOG_WARN("[HTTP] cache: failed to write " + final.string() + ": " + ec.message());
+            fs::remove(tmp, ec);
+        }
+    }
+
+    std::optional<Entry> read_disk(const std::string& key) const {
+        if (opts.diskDir.empty()) return std::nullopt;
+        std::ifstream in(path_of(key), std::ios::binary);
+        if (!in) return std::nullopt;
+
+        std::string line;
+        if (!std::getline(in, line) || line != kDiskMagic) return std::nullopt;
+        if (!std::getline(in, line) || line != key) return std::nullopt; // colisión de hash
+        Entry e;
+        std::size_t nHeaders = 0, bodySize = 0;
+        if (!(in >> e.expiresAtMs >> e.status >> nHeaders)) return std::nullopt;
+        in.ignore(1);
+        for (std::size_t i = 0; i < nHeaders; ++i) {
+            std::string k, v;
+            if (!std::getline(in, k) || !std::getline(in, v)) return std::nullopt;
+            e.headers.add(k, v);
+        }
+        if (!(in >> bodySize)) return std::nullopt;
+        in.ignore(1);
+        e.body.resize(bodySize);
+        if (!in.read(e.body.data(), static_cast<std::streamsize>(bodySize))) return std::nullopt;
+        return e;
+    }
+
+    void erase_disk(const std::string& key) const {
+        if (opts.diskDir.empty()) return;
+        std::error_code ec;
+        fs::remove(path_of(key), ec);
+    }
+};
+
+// -------------------------------
+// ResponseCache
+// -------------------------------
+ResponseCache::ResponseCache(ResponseCacheOptions opts)
+    : state_(new State())
+{
+    state_->opts = std::move(opts);
+}
+
+ResponseCache::~ResponseCache() {
+    delete state_;
+}
+
+std::shared_ptr<ResponseCache> ResponseCache::shared() {
+    static const std::shared_ptr<ResponseCache> inst = [] {
+        const auto& cfg = cc::config::get();
+        if (cfg.http.cacheMaxBytes <= 0) return std::shared_ptr<ResponseCache>{};
+        ResponseCacheOptions o;
+        o.maxBytes = static_cast<std::size_t>(cfg.http.cacheMaxBytes);
+        o.diskDir  = cfg.http.cacheDir;
+        return std::make_shared<ResponseCache>(std::move(o));
+    }();
+    return inst;
+}
+
+std::optional<ResponseCache::Lookup> ResponseCache::lookup(const std::string& key) {
+    std::lock_guard<std::mutex> lk(state_->m);
+    auto& st = *state_;
+
+    const Entry* e = nullptr;
+    if (auto it = st.map.find(key); it != st.map.end()) {
+        st.touch(it->second);
+        e = &it->second.entry;
+    } else if (auto disk = st.read_disk(key)) {
+        st.put(key, std::move(*disk));
+        if (auto again = st.map.find(key); again != st.map.end()) e = &again->second.entry;
+    }
+    if (!e) return std::nullopt;
+
+    Lookup out;
+    out.response.statusCode = e->status;
+    out.response.body       = e->body;
+    out.response.headers    = e->headers;
+    out.fresh               = e->expiresAtMs > now_ms();
+    out.etag                = get_header_ci(e->headers, "ETag").value_or("");
+    out.lastModified        = get_header_ci(e->headers, "Last-Modified").value_or("");
+    return out;
+}
+
+bool ResponseCache::store(const std::string& key, const HttpResponse& resp) {
+    if (resp.statusCode != 200) return false;
+    const Freshness f = freshness_of(resp.headers, now_ms());
+    if (!f.storable) {
+        erase(key);
+        return false;
+    }
+
+    Entry e;
+    e.status      = resp.statusCode;
+    e.body        = resp.body;
+    e.headers     = resp.headers;
+    e.expiresAtMs = f.expiresAtMs;
+
+    std::lock_guard<std::mutex> lk(state_->m);
+    state_->write_disk(key, e);
+    state_->put(key, std::move(e));
+    return true;
+}
+
+std::optional<HttpResponse> ResponseCache::revalidated(const std::string& key, const HttpResponse& notModified) {
+    std::lock_guard<std::mutex> lk(state_->m);
+    auto& st = *state_;
+    auto it = st.map.find(key);
+    if (it == st.map.end()) return std::nullopt;
+
+    Entry& e = it->second.entry;
+    // El 304 trae los metadatos vigentes (RFC 9111 §4.3.4); el body sigue siendo el guardado
+    for (const auto& [k, v] : notModified.headers) {
+        if (iequals_ascii(k, "content-length") || iequals_ascii(k, "content-encoding") ||
+            iequals_ascii(k, "transfer-encoding")) {
+            continue;
+        }
+        e.headers.set(k, v);
+    }
+    e.expiresAtMs = freshness_of(e.headers, now_ms()).expiresAtMs;
+    st.bytes -= it->second.bytes;
+    it->second.bytes = cost_of(key, e);
+    st.bytes += it->second.bytes;
+    st.touch(it->second);
+    st.write_disk(key, e);
+
+    HttpResponse out;
+    out.statusCode = e.status;
+    out.body       = e.body;
+    out.headers    = e.headers;
+    return out;
+}
+
+void ResponseCache::erase(const std::string& key) {
+    std::lock_guard<std::mutex> lk(state_->m);
+    state_->remove(key);
+    state_->erase_disk(key);
+}
+
+void ResponseCache::clear() {
+    std::lock_guard<std::mutex> lk(state_->m);
+    state_->map.clear();
+    state_->lru.clear();
+    state_->bytes = 0;
+    if (!state_->opts.diskDir.empty()) {
+        std::error_code ec;
+        for (const auto& f : fs::directory_iterator(state_->opts.diskDir, ec)) {
+            if (f.path().extension() == ".cce") fs::remove(f.path(), ec);
+        }
+    }
+}
+
+ResponseCacheStats ResponseCache::stats() const {
+    std::lock_guard<std::mutex> lk(state_->m);
+    ResponseCacheStats s;
+    s.entries = state_->map.size();
+    s.bytes   = state_->bytes;
+    s.evicted = state_->evicted;
+    return s;
+}
+
+} // namespace cc::http
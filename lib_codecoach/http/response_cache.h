@@ -0,0 +1,76 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// response_cache.h — Caché HTTP privada (RFC 9111, subconjunto) para respuestas GET 200:
+// LRU en memoria con presupuesto de bytes + capa opcional en disco (sobrevive al proceso).
+// Respeta Cache-Control (no-store, no-cache, max-age), Age, Expires/Date y guarda ETag /
+// Last-Modified para revalidar con If-None-Match / If-Modified-Since. Thread-safe; la
+// comparten los HttpClient que la activan (HttpClient::setResponseCache).
+#ifndef LIB_CODECOACH_RESPONSE_CACHE_H
+#define LIB_CODECOACH_RESPONSE_CACHE_H
+
+#include "http_response.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace cc::http {
+
+    struct ResponseCacheOptions {
+        std::size_t maxBytes{8 * 1024 * 1024}; // presupuesto en memoria (body + headers)
+        std::string diskDir;                   // vacío => solo memoria
+    };
+
+    struct ResponseCacheStats {
+        std::size_t entries{0};
+        std::size_t bytes{0};
+        std::size_t evicted{0}; // acumulado
+    };
+
+    class ResponseCache {
+    public:
+        explicit ResponseCache(ResponseCacheOptions opts = {});
+        ~ResponseCache();
+        ResponseCache(const ResponseCache&) = delete;
+        ResponseCache& operator=(const ResponseCache&) = delete;
+
+        // Instancia del proceso, configurada desde cc::config::get().http en el primer uso.
+        // nullptr si la caché está desactivada (httpCacheMaxBytes = 0).
+        static std::shared_ptr<ResponseCache> shared();
+
+        struct Lookup {
+            HttpResponse response;     // copia de la respuesta guardada
+            bool         fresh{false}; // false => revalidar antes de usar
+            std::string  etag;         // validadores ("" si no hay)
+            std::string  lastModified;
+        };
+
+        // Busca en memoria y, si no está, en disco (y la sube a memoria).
+        std::optional<Lookup> lookup(const std::string& key);
+
+        // Guarda una respuesta 200 si sus headers lo permiten. Devuelve false si no se guardó.
+        bool store(const std::string& key, const HttpResponse& resp);
+
+        // Tras un 304: actualiza frescura/validadores con los headers nuevos y devuelve la
+        // respuesta guardada (status 200). nullopt si la entrada ya no existe.
+        std::optional<HttpResponse> revalidated(const std::string& key, const HttpResponse& notModified);
+
+        void erase(const std::string& key); // p.ej. tras un PUT/POST/DELETE exitoso a la URL
+        void clear();                       // memoria y disco
+
+        ResponseCacheStats stats() const;
+
+        struct State;
+
+    private:
+        // PIMPL: LRU, mapa e I/O de disco viven en el .cpp
+        State* state_;
+    };
+
+} // namespace cc::http
+
+#endif // LIB_CODECOACH_RESPONSE_CACHE_H
@@ -0,0 +1,124 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// retry_budget.cpp — Token bucket del presupuesto de reintentos.
+
+#include "retry_budget.h"
+
+#include "config/config_manager.h"
+#include "logging/logger.h"
+#include "metrics/counters.h"
+#include "metrics/timer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+namespace cc::http {
+
+using cc::time::SteadyClock;
+
+namespace {
+
+// El bucket guarda como mucho 10 s del piso: tras un rato sano no se acumula un
+// "crédito" de reintentos capaz de generar una ráfaga grande.
+constexpr double kBurstSeconds = 10.0;
+constexpr double kMinCapacity  = 10.0;
+
+double capacity_of(const RetryBudgetPolicy& p) {
+    return std::max(kMinCapacity, kBurstSeconds * p.minPerSec);
+}
+
+} // namespace
+
+struct RetryBudget::State {
+    mutable std::mutex      m;
+    RetryBudgetPolicy       policy{};
+    double                  tokens{0};
+    SteadyClock::time_point lastRefill{SteadyClock::now()};
+    std::uint64_t           granted{0};
+    std::uint64_t           denied{0};
+    bool                    exhaustedLogged{false}; // un warning por racha, no por llamada
+
+    // Piso de minPerSec tokens/s, acreditado de forma perezosa
+    void refill(SteadyClock::time_point now) {
+        const double secs = std::chrono::duration<double>(now - lastRefill).count();
+        lastRefill = now;
+        tokens = std::min(capacity_of(policy), tokens + secs * policy.minPerSec);
+    }
+};
+
+RetryBudget& RetryBudget::instance() {
+    // Como el resto de singletons HTTP: nunca se destruye (el hilo de I/O puede usarlo al salir).
+    static RetryBudget* inst = new RetryBudget();
+    return *inst;
+}
+
+RetryBudget::RetryBudget()
+    : state_(new State())
+{
+    const auto& cfg = cc::config::get();
+    RetryBudgetPolicy p;
+    p.ratioPct  = std::clamp(cfg.http.retryBudgetPct, 0, 100);
+    p.minPerSec = std::max(0, cfg.http.retryBudgetMinPerSec);
+    configure(p);
+}
+
+RetryBudget::~RetryBudget() {
+    delete state_;
+}
+
+void RetryBudget::configure(const RetryBudgetPolicy& policy) {
+    std::lock_guard<std::mutex> lk(state_->m);
+    state_->policy     = policy;
+    state_->tokens     = capacity_of(policy);
+    state_->lastRefill = SteadyClock::now();
+    state_->exhaustedLogged = false;
+}
+
+RetryBudgetPolicy RetryBudget::policy() const {
+    std::lock_guard<std::mutex> lk(state_->m);
+    return state_->policy;
+}
+
+void RetryBudget::deposit() {
+    std::lock_guard<std::mutex> lk(state_->m);
+    auto& st = *state_;
+    st.tokens = std::min(capacity_of(st.policy), st.tokens + st.policy.ratioPct / 100.0);
+}
+
+bool RetryBudget::try_withdraw() {
+    bool logExhausted = false;
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        auto& st = *state_;
+        st.refill(SteadyClock::now());
+        if (st.tokens >= 1.0) {
+            st.tokens -= 1.0;
+            ++st.granted;
+            st.exhaustedLogged = false;
+            return true;
+        }
+        ++st.denied;
+        logExhausted = !st.exhaustedLogged;
+        st.exhaustedLogged = true;
+    }
+    cc::metrics::count("http.retry_budget.denied");
+    if (logExhausted) {
+        CC_LOG_WARN("[HTTP] retry budget exhausted — failing without retry until it refills");
+    }
+    return false;
+}
+
+RetryBudgetSnapshot RetryBudget::snapshot() const {
+    std::lock_guard<std::mutex> lk(state_->m);
+    state_->refill(SteadyClock::now());
+    RetryBudgetSnapshot s;
+    s.tokens  = state_->tokens;
+    s.granted = state_->granted;
+    s.denied  = state_->denied;
+    return s;
+}
+
+} // namespace cc::http
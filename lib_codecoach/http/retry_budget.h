@@ -0,0 +1,54 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// retry_budget.h — Presupuesto de reintentos global (token bucket) compartido por todos los
+// HttpClient. Cada llamada nueva deposita ratioPct/100 tokens y cada reintento gasta uno,
+// más un piso de minPerSec reintentos por segundo para el tráfico bajo. Con el servicio
+// caído los reintentos quedan acotados a ~ratioPct% de la carga en vez de multiplicarla.
+#ifndef LIB_CODECOACH_RETRY_BUDGET_H
+#define LIB_CODECOACH_RETRY_BUDGET_H
+
+#include <cstdint>
+
+namespace cc::http {
+
+    struct RetryBudgetPolicy {
+        int ratioPct{20};  // tokens por llamada nueva (en % de un reintento)
+        int minPerSec{5};  // reintentos por segundo permitidos siempre
+    };
+
+    struct RetryBudgetSnapshot {
+        double        tokens{0};   // reintentos disponibles ahora
+        std::uint64_t granted{0};  // reintentos permitidos (acumulado)
+        std::uint64_t denied{0};   // reintentos negados por falta de presupuesto (acumulado)
+    };
+
+    class RetryBudget {
+    public:
+        // Instancia global; se configura desde cc::config::get().http en el primer uso.
+        static RetryBudget& instance();
+
+        void configure(const RetryBudgetPolicy& policy); // también rellena el bucket
+        RetryBudgetPolicy policy() const;
+
+        void deposit();      // una llamada nueva (primer intento)
+        bool try_withdraw(); // true => se puede reintentar
+
+        RetryBudgetSnapshot snapshot() const;
+
+        ~RetryBudget();
+        RetryBudget(const RetryBudget&) = delete;
+        RetryBudget& operator=(const RetryBudget&) = delete;
+
+        struct State;
+
+    private:
+        RetryBudget();
+
+        State* state_;
+    };
+
+} // namespace cc::http
+
+#endif // LIB_CODECOACH_RETRY_BUDGET_H
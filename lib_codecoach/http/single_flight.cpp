@@ -0,0 +1,97 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// single_flight.cpp — Registro de vuelos por clave.
+
+#include "single_flight.h"
+
+#include "metrics/counters.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cc::http {
+
+using cc::time::CancellationSource;
+
+struct SingleFlight::State {
+    struct Flight {
+        std::uint64_t                                   id{0};
+        std::vector<std::pair<std::uint64_t, Waiter>>   waiters;
+        CancellationSource                              abandon;
+    };
+
+    mutable std::mutex                      m;
+    std::unordered_map<std::string, Flight> flights;
+    std::uint64_t                           nextId{1};
+};
+
+SingleFlight& SingleFlight::instance() {
+    // Nunca se destruye: el hilo de I/O puede completar vuelos durante la salida.
+    static SingleFlight* inst = new SingleFlight();
+    return *inst;
+}
+
+SingleFlight::SingleFlight() : state_(new State()) {}
+
+SingleFlight::~SingleFlight() {
+    delete state_;
+}
+
+SingleFlight::Ticket SingleFlight::join(const std::string& key, Waiter w) {
+    Ticket t;
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        auto& st = *state_;
+        auto [it, created] = st.flights.try_emplace(key);
+        auto& f = it->second;
+        if (created) f.id = st.nextId++;
+        t.leader  = created;
+        t.flight  = f.id;
+        t.waiter  = st.nextId++;
+        t.abandon = f.abandon.token();
+        f.waiters.emplace_back(t.waiter, std::move(w));
+    }
+    cc::metrics::count(t.leader ? "http.singleflight.leader" : "http.singleflight.shared");
+    return t;
+}
+
+void SingleFlight::leave(const std::string& key, const Ticket& t) {
+    std::lock_guard<std::mutex> lk(state_->m);
+    auto it = state_->flights.find(key);
+    if (it == state_->flights.end() || it->second.id != t.flight) return;
+
+    auto& ws = it->second.waiters;
+    ws.erase(std::remove_if(ws.begin(), ws.end(), [&](const auto& p) { return p.first == t.waiter; }),
+             ws.end());
+    if (ws.empty()) {
+        // Nadie espera: se aborta la transferencia y el próximo join arranca un vuelo nuevo
+        it->second.abandon.cancel();
+        state_->flights.erase(it);
+    }
+}
+
+void SingleFlight::complete(const std::string& key, std::uint64_t flight, const HttpResponse& resp) {
+    std::vector<std::pair<std::uint64_t, Waiter>> waiters;
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        auto it = state_->flights.find(key);
+        if (it == state_->flights.end() || it->second.id != flight) return; // vuelo abandonado
+        waiters = std::move(it->second.waiters);
+        state_->flights.erase(it);
+    }
+    for (auto& [id, w] : waiters) {
+        if (w) w(resp);
+    }
+}
+
+std::size_t SingleFlight::inFlight() const {
+    std::lock_guard<std::mutex> lk(state_->m);
+    return state_->flights.size();
+}
+
+} // namespace cc::http
@@ -0,0 +1,61 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// single_flight.h — Coalescencia de requests idénticos en vuelo: el primero (líder) hace la
+// transferencia y todos los que llegan mientras tanto reciben una copia de la misma
+// HttpResponse. Compartido por todos los HttpClient del proceso (clave = método + URL +
+// headers efectivos). La transferencia se abandona solo si todos los que esperan se van.
+#ifndef LIB_CODECOACH_SINGLE_FLIGHT_H
+#define LIB_CODECOACH_SINGLE_FLIGHT_H
+
+#include "http_response.h"
+#include "metrics/timer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace cc::http {
+
+    class SingleFlight {
+    public:
+        using Waiter = std::function<void(const HttpResponse&)>;
+
+        struct Ticket {
+            bool                        leader{false};  // true => el llamador lanza la transferencia
+            std::uint64_t               flight{0};
+            std::uint64_t               waiter{0};
+            cc::time::CancellationToken abandon{};      // se dispara si no queda nadie esperando
+        };
+
+        static SingleFlight& instance();
+
+        // Se suma al vuelo de `key` (o lo crea). `w` se llama una vez, fuera de locks, con
+        // la respuesta del vuelo.
+        Ticket join(const std::string& key, Waiter w);
+
+        // El que espera se va (cancelación/deadline propios): su Waiter ya no se llama.
+        void leave(const std::string& key, const Ticket& t);
+
+        // El líder entrega la respuesta a todos los que siguen esperando.
+        void complete(const std::string& key, std::uint64_t flight, const HttpResponse& resp);
+
+        std::size_t inFlight() const;
+
+        ~SingleFlight();
+        SingleFlight(const SingleFlight&) = delete;
+        SingleFlight& operator=(const SingleFlight&) = delete;
+
+        struct State;
+
+    private:
+        SingleFlight();
+
+        State* state_;
+    };
+
+} // namespace cc::http
+
+#endif // LIB_CODECOACH_SINGLE_FLIGHT_H
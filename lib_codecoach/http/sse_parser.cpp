@@ -0,0 +1,95 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// sse_parser.cpp — Líneas y campos según la spec de EventSource (WHATWG HTML §9.2).
+
+#include "sse_parser.h"
+
+namespace cc::http {
+
+bool SseParser::feed(std::string_view chunk) {
+    if (stopped_) return false;
+
+    std::size_t pos = 0;
+    if (skipLf_ && !chunk.empty()) {
+        if (chunk.front() == '\n') pos = 1;
+        skipLf_ = false;
+    }
+
+    while (pos < chunk.size() && !stopped_) {
+        const auto eol = chunk.find_first_of("\r\n", pos);
+        if (eol == std::string_view::npos) {
+            partial_.append(chunk.substr(pos));
+            break;
+        }
+
+        // Sin resto pendiente la línea se usa directo desde el trozo (sin copiar)
+        if (partial_.empty()) {
+            on_line(chunk.substr(pos, eol - pos));
+        } else {
+            partial_.append(chunk.substr(pos, eol - pos));
+            on_line(partial_);
+            partial_.clear();
+        }
+
+        pos = eol + 1;
+        if (chunk[eol] == '\r') {
+            if (pos < chunk.size()) {
+                if (chunk[pos] == '\n') ++pos;
+            } else {
+                skipLf_ = true; // el '\n' puede llegar en el próximo trozo
+            }
+        }
+    }
+    return !stopped_;
+}
+
+bool SseParser::finish() {
+    if (stopped_) return false;
+    if (!partial_.empty()) {
+        on_line(partial_);
+        partial_.clear();
+    }
+    dispatch();
+    return !stopped_;
+}
+
+void SseParser::on_line(std::string_view line) {
+    if (line.empty()) {
+        dispatch();
+        return;
+    }
+    if (line.front() == ':') return; // comentario / keep-alive
+
+    std::string_view field = line;
+    std::string_view value;
+    if (const auto colon = line.find(':'); colon != std::string_view::npos) {
+        field = line.substr(0, colon);
+        value = line.substr(colon + 1);
+        if (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+    }
+
+    if (field == "data") {
+        if (hasData_) current_.data.push_back('\n');
+        current_.data.append(value);
+        hasData_ = true;
+    } else if (field == "event") {
+        current_.event.assign(value);
+    } else if (field == "id") {
+        current_.id.assign(value);
+    }
+    // "retry" y campos desconocidos: se ignoran
+}
+
+void SseParser::dispatch() {
+    if (hasData_) {
+        ++events_;
+        if (!onEvent_(current_)) stopped_ = true;
+    }
+    current_.event.clear();
+    current_.data.clear();
+    hasData_ = false;
+}
+
+} // namespace cc::http
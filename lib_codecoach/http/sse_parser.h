@@ -0,0 +1,52 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// sse_parser.h — Parser incremental de text/event-stream (Server-Sent Events). Recibe el body
+// en trozos arbitrarios (tal como llegan a un BodySink: una línea o un \r\n pueden quedar
+// partidos entre trozos) y entrega cada evento completo apenas termina su línea vacía.
+#ifndef LIB_CODECOACH_SSE_PARSER_H
+#define LIB_CODECOACH_SSE_PARSER_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace cc::http {
+
+    struct SseEvent {
+        std::string event; // campo "event" ("" => "message")
+        std::string data;  // líneas "data" unidas con '\n'
+        std::string id;
+    };
+
+    class SseParser {
+    public:
+        // Devolver false detiene el parseo (feed() devuelve false desde ahí en adelante).
+        using Handler = std::function<bool(const SseEvent&)>;
+
+        explicit SseParser(Handler onEvent) : onEvent_(std::move(onEvent)) {}
+
+        // Procesa un trozo del body. false => el handler pidió cortar.
+        bool feed(std::string_view chunk);
+        // Fin del stream: despacha el último evento si no llegó su línea vacía.
+        bool finish();
+
+        std::size_t events() const noexcept { return events_; }
+
+    private:
+        void on_line(std::string_view line);
+        void dispatch();
+
+        Handler     onEvent_;
+        std::string partial_;      // línea incompleta del trozo anterior
+        SseEvent    current_;
+        bool        hasData_{false};
+        bool        skipLf_{false}; // el trozo anterior terminó en '\r' (posible \r\n partido)
+        bool        stopped_{false};
+        std::size_t events_{0};
+    };
+
+} // namespace cc::http
+
+#endif // LIB_CODECOACH_SSE_PARSER_H
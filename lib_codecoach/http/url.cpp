@@ -0,0 +1,90 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// url.cpp — Implementación de origin_of / path_of / endpoint_of.
+
+#include "url.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace cc::http {
+
+static std::string lower(std::string_view s) {
+    std::string out(s);
+    std::transform(out.begin(), out.end(), out.begin(),
+                   [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
+    return out;
+}
+
+std::string origin_of(std::string_view url) {
+    const auto sep = url.find("://");
+    if (sep == std::string_view::npos) {
+        return std::string(url.substr(0, url.find('/')));
+    }
+
+    const std::string scheme = lower(url.substr(0, sep));
+    std::string_view rest = url.substr(sep + 3);
+    rest = rest.substr(0, rest.find_first_of("/?#"));
+
+    // Quitar credenciales "user:pass@"
+    if (auto at = rest.rfind('@'); at != std::string_view::npos) {
+        rest = rest.substr(at + 1);
+    }
+
+    // Puerto explícito (cuidando IPv6 "[::1]:8080")
+    const auto close = rest.rfind(']');
+    const auto colon = rest.rfind(':');
+    const bool has_port = colon != std::string_view::npos &&
+                          (close == std::string_view::npos || colon > close);
+
+    std::string host = lower(has_port ? rest.substr(0, colon) : rest);
+    std::string port = has_port ? std::string(rest.substr(colon + 1))
+                                : (scheme == "https" ? "443" : "80");
+
+    return scheme + "://" + host + ":" + port;
+}
+
+std::string path_of(std::string_view url) {
+    const auto sep = url.find("://");
+    std::string_view rest = sep == std::string_view::npos ? url : url.substr(sep + 3);
+    const auto slash = rest.find('/');
+    if (slash == std::string_view::npos) return "/";
+    rest = rest.substr(slash);
+    rest = rest.substr(0, rest.find_first_of("?#"));
+    return std::string(rest);
+}
+
+// Segmento que identifica un recurso (id numérico, "s42", UUID, hash) y no una ruta: con
+// algún dígito, salvo la versión de la API ("v1"); o largo (tokens opacos)
+static bool is_id_segment(std::string_view seg) {
+    if (seg.size() >= 24) return true;
+    const bool hasDigit = std::any_of(seg.begin(), seg.end(),
+                                      [](unsigned char c) { return std::isdigit(c); });
+    if (!hasDigit) return false;
+    const bool version = seg.size() >= 2 && (seg[0] == 'v' || seg[0] == 'V') &&
+                         std::all_of(seg.begin() + 1, seg.end(),
+                                     [](unsigned char c) { return std::isdigit(c); });
+    return !version;
+}
+
+std::string endpoint_of(std::string_view method, std::string_view url) {
+    std::string out(method);
+    out += ' ';
+    out += origin_of(url);
+
+    const std::string path = path_of(url);
+    std::string_view rest(path);
+    while (!rest.empty()) {
+        rest.remove_prefix(1); // '/'
+        const auto end = rest.find('/');
+        const std::string_view seg = rest.substr(0, end);
+        out += '/';
+        out += is_id_segment(seg) ? std::string_view("{id}") : seg;
+        rest = end == std::string_view::npos ? std::string_view{} : rest.substr(end);
+    }
+    return out;
+}
+
+} // namespace cc::http
@@ -0,0 +1,30 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// url.h — Utilidades mínimas sobre URLs (origen scheme://host:port, path) para el pool de
+// conexiones y las métricas por endpoint.
+#ifndef LIB_CODECOACH_URL_H
+#define LIB_CODECOACH_URL_H
+
+#include <string>
+#include <string_view>
+
+namespace cc::http {
+
+    // "https://api.x.com/v1/a?b" -> "https://api.x.com:443"
+    // Normaliza a minúsculas scheme/host y agrega el puerto por defecto si falta.
+    // Si la URL no tiene scheme, devuelve la cadena hasta el primer '/' tal cual.
+    std::string origin_of(std::string_view url);
+
+    // "https://api.x.com/v1/a?b#c" -> "/v1/a"  ("/" si no hay path)
+    std::string path_of(std::string_view url);
+
+    // Etiqueta estable para métricas por endpoint: "POST https://api.x.com:443/v1/a". Los
+    // segmentos con pinta de id (con dígitos, salvo "v1"; o muy largos) pasan a "{id}":
+    // "GET .../results/s42" -> "GET .../results/{id}", así las etiquetas no crecen sin tope.
+    std::string endpoint_of(std::string_view method, std::string_view url);
+
+} // namespace cc::http
+
+#endif // LIB_CODECOACH_URL_H
@@ -0,0 +1,84 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// counters.cpp — Implementación del registro de contadores.
+
+#include "counters.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace cc::metrics {
+
+namespace {
+
+struct NameHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view s) const noexcept {
+        return std::hash<std::string_view>{}(s);
+    }
+};
+
+} // namespace
+
+struct Counters::State {
+    mutable std::shared_mutex m;
+    // unique_ptr: la dirección del atómico no cambia al rehashear
+    std::unordered_map<std::string, std::unique_ptr<std::atomic<std::int64_t>>,
+                       NameHash, std::equal_to<>> values;
+};
+
+Counters& Counters::instance() {
+    // Nunca se destruye: puede haber hilos (I/O, executor) contando durante la salida.
+    static Counters* inst = new Counters();
+    return *inst;
+}
+
+Counters::Counters() : state_(new State()) {}
+
+Counters::~Counters() {
+    delete state_;
+}
+
+void Counters::add(std::string_view name, std::int64_t delta) {
+    {
+        std::shared_lock<std::shared_mutex> lk(state_->m);
+        auto it = state_->values.find(name);
+        if (it != state_->values.end()) {
+            it->second->fetch_add(delta, std::memory_order_relaxed);
+            return;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lk(state_->m);
+    auto& slot = state_->values[std::string(name)];
+    if (!slot) slot = std::make_unique<std::atomic<std::int64_t>>(0);
+    slot->fetch_add(delta, std::memory_order_relaxed);
+}
+
+std::int64_t Counters::value(std::string_view name) const {
+    std::shared_lock<std::shared_mutex> lk(state_->m);
+    auto it = state_->values.find(name);
+    return it == state_->values.end() ? 0 : it->second->load(std::memory_order_relaxed);
+}
+
+std::map<std::string, std::int64_t> Counters::snapshot(std::string_view prefix) const {
+    std::map<std::string, std::int64_t> out;
+    std::shared_lock<std::shared_mutex> lk(state_->m);
+    for (const auto& [name, v] : state_->values) {
+        if (name.compare(0, prefix.size(), prefix) == 0) {
+            out.emplace(name, v->load(std::memory_order_relaxed));
+        }
+    }
+    return out;
+}
+
+void Counters::reset() {
+    std::shared_lock<std::shared_mutex> lk(state_->m);
+    for (auto& [name, v] : state_->values) v->store(0, std::memory_order_relaxed);
+}
+
+} // namespace cc::metrics
@@ -0,0 +1,48 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// counters.h — Registro global de contadores con nombre (monotónicos o acumuladores de bytes).
+// Pensado para métricas baratas en caminos calientes: add() es un fetch_add atómico una vez
+// resuelto el contador. Convención de nombres: "<área>.<métrica>" o "<área>.<métrica>|<etiqueta>".
+#ifndef LIB_CODECOACH_COUNTERS_H
+#define LIB_CODECOACH_COUNTERS_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace cc::metrics {
+
+    class Counters {
+    public:
+        static Counters& instance();
+
+        void add(std::string_view name, std::int64_t delta = 1);
+        std::int64_t value(std::string_view name) const; // 0 si no existe
+
+        // Copia ordenada de los contadores cuyo nombre empieza con `prefix`.
+        std::map<std::string, std::int64_t> snapshot(std::string_view prefix = {}) const;
+
+        void reset(); // pone todo a 0 (tests/benchmarks)
+
+        struct State;
+
+    private:
+        Counters();
+        ~Counters();
+        Counters(const Counters&) = delete;
+        Counters& operator=(const Counters&) = delete;
+
+        State* state_;
+    };
+
+    // Atajo: cc::metrics::count("http.retries");
+    inline void count(std::string_view name, std::int64_t delta = 1) {
+        Counters::instance().add(name, delta);
+    }
+
+} // namespace cc::metrics
+
+#endif // LIB_CODECOACH_COUNTERS_H
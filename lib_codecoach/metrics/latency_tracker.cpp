@@ -0,0 +1,100 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// latency_tracker.cpp — Histograma log-lineal con ventana de dos mitades.
+
+#include "latency_tracker.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace cc::metrics {
+
+using cc::time::Micros;
+using cc::time::Millis;
+using cc::time::SteadyClock;
+
+namespace {
+
+// [0, 8) lineal; luego 8 sub-buckets por potencia de 2
+int bucket_of(std::uint64_t us) {
+    if (us < static_cast<std::uint64_t>(LatencyTracker::kSubBuckets)) return static_cast<int>(us);
+    const int msb    = std::bit_width(us) - 1; // >= 3
+    const int octave = msb - 2;
+    const int sub    = static_cast<int>((us >> (msb - 3)) & 7u);
+    return std::min(octave * LatencyTracker::kSubBuckets + sub, LatencyTracker::kBuckets - 1);
+}
+
+// Mayor valor que cae en el bucket
+std::uint64_t upper_bound_of(int idx) {
+    if (idx < LatencyTracker::kSubBuckets) return static_cast<std::uint64_t>(idx);
+    const int octave = idx / LatencyTracker::kSubBuckets;
+    const int sub    = idx % LatencyTracker::kSubBuckets;
+    const int shift  = octave - 1; // msb - 3
+    return ((static_cast<std::uint64_t>(8 + sub + 1)) << shift) - 1;
+}
+
+} // namespace
+
+LatencyTracker::LatencyTracker(Millis window)
+    : half_(std::max<Millis::rep>(1, window.count() / 2)),
+      currentSince_(SteadyClock::now()) {}
+
+void LatencyTracker::rotate_locked(SteadyClock::time_point now) const {
+    if (now - currentSince_ < half_) return;
+    if (now - currentSince_ >= 2 * half_) {
+        // Nada reciente: las dos mitades caducaron
+        previous_.fill(0);
+        previousCount_ = 0;
+    } else {
+        previous_      = current_;
+        previousCount_ = currentCount_;
+    }
+    current_.fill(0);
+    currentCount_ = 0;
+    currentSince_ = now;
+}
+
+void LatencyTracker::record(Micros latency) {
+    const auto us = static_cast<std::uint64_t>(std::max<Micros::rep>(0, latency.count()));
+    std::lock_guard<std::mutex> lk(m_);
+    rotate_locked(SteadyClock::now());
+    ++current_[static_cast<std::size_t>(bucket_of(us))];
+    ++currentCount_;
+}
+
+std::optional<Micros> LatencyTracker::quantile(double q, std::uint64_t minSamples) const {
+    std::lock_guard<std::mutex> lk(m_);
+    rotate_locked(SteadyClock::now());
+    const std::uint64_t total = currentCount_ + previousCount_;
+    if (total == 0 || total < minSamples) return std::nullopt;
+
+    q = std::clamp(q, 0.0, 1.0);
+    const auto target = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(total))));
+    std::uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += current_[static_cast<std::size_t>(i)] + previous_[static_cast<std::size_t>(i)];
+        if (seen >= target) return Micros{static_cast<Micros::rep>(upper_bound_of(i))};
+    }
+    return Micros{static_cast<Micros::rep>(upper_bound_of(kBuckets - 1))};
+}
+
+std::uint64_t LatencyTracker::count() const {
+    std::lock_guard<std::mutex> lk(m_);
+    rotate_locked(SteadyClock::now());
+    return currentCount_ + previousCount_;
+}
+
+void LatencyTracker::reset() {
+    std::lock_guard<std::mutex> lk(m_);
+    current_.fill(0);
+    previous_.fill(0);
+    currentCount_  = 0;
+    previousCount_ = 0;
+    currentSince_  = SteadyClock::now();
+}
+
+} // namespace cc::metrics
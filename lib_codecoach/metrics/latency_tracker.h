@@ -0,0 +1,54 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// latency_tracker.h — Histograma de latencias sobre una ventana deslizante, para estimar
+// percentiles en línea (p.ej. el delay de hedging del HttpClient). Buckets log-lineales
+// (8 por potencia de 2, error relativo <= 12.5%) en microsegundos; la ventana son dos
+// mitades que rotan, así lo viejo caduca sin guardar muestras individuales. Thread-safe.
+#ifndef LIB_CODECOACH_LATENCY_TRACKER_H
+#define LIB_CODECOACH_LATENCY_TRACKER_H
+
+#include "timer.h"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace cc::metrics {
+
+    class LatencyTracker {
+    public:
+        explicit LatencyTracker(cc::time::Millis window = cc::time::Millis{60000});
+
+        void record(cc::time::Micros latency);
+
+        // Percentil q en [0, 1] (cota superior del bucket). nullopt con menos de
+        // minSamples muestras en la ventana.
+        std::optional<cc::time::Micros> quantile(double q, std::uint64_t minSamples = 1) const;
+
+        std::uint64_t count() const; // muestras en la ventana
+        void reset();
+
+        static constexpr int kSubBuckets = 8;
+        static constexpr int kOctaves    = 40; // hasta ~2^40 us (12 días)
+        static constexpr int kBuckets    = kSubBuckets * kOctaves;
+
+    private:
+        using Histogram = std::array<std::uint32_t, kBuckets>;
+
+        void rotate_locked(cc::time::SteadyClock::time_point now) const;
+
+        mutable std::mutex m_;
+        cc::time::Millis half_;
+        mutable cc::time::SteadyClock::time_point currentSince_;
+        mutable Histogram current_{};
+        mutable Histogram previous_{};
+        mutable std::uint64_t currentCount_{0};
+        mutable std::uint64_t previousCount_{0};
+    };
+
+} // namespace cc::metrics
+
+#endif // LIB_CODECOACH_LATENCY_TRACKER_H
@@ -5,6 +5,7 @@
 // timer.cpp
 #include "timer.h"
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cmath>
@@ -103,45 +104,69 @@ int Backoff::attempt() const noexcept {
     return next_attempt_;
 }
 
+double Backoff::uniform01() noexcept {
+    // RNG simple: xorshift-like con splitmix64
+    rng_state_ = splitmix64(rng_state_);
+    return (rng_state_ >> 11) * (1.0 / 9007199254740992.0); // 53 bits -> [0,1)
+}
+
 Millis Backoff::next_delay() noexcept {
+    return next_delay(std::nullopt);
+}
+
+Millis Backoff::next_delay(std::optional<Millis> server_delay) noexcept {
     // Si superamos max_attempts, devolvemos max_delay (la capa superior decidirá abortar).
     const int k = (next_attempt_ <= 0 ? 1 : next_attempt_);
     if (pol_.max_attempts > 0 && k > pol_.max_attempts) {
         return pol_.max_delay;
     }
 
-    // Exponencial: base * factor^(k-1)
     const double base_ms = static_cast<double>(pol_.base.count());
-    double raw_ms = base_ms * std::pow(pol_.factor <= 1.0 ? 1.0 : pol_.factor, static_cast<double>(k - 1));
-
-    // Clamp al máximo
-    const double max_ms = static_cast<double>(pol_.max_delay.count());
-    if (raw_ms > max_ms) raw_ms = max_ms;
-
-    // Jitter uniforme en ±jitter_pct
-    double jittered_ms = raw_ms;
-    if (pol_.jitter_pct > 0.0) {
-        // RNG simple: xorshift-like con splitmix64
-        rng_state_ = splitmix64(rng_state_);
-        // Mapear a [0,1)
-        const double u01 = (rng_state_ >> 11) * (1.0 / 9007199254740992.0); // 53 bits -> [0,1)
-        const double span = pol_.jitter_pct;
-        const double jitter = (u01 * 2.0 - 1.0) * span; // [-span, +span]
-        jittered_ms = raw_ms * (1.0 + jitter);
-        if (jittered_ms < 0.0)    jittered_ms = 0.0;
-        if (jittered_ms > max_ms) jittered_ms = max_ms;
+    const double max_ms  = static_cast<double>(pol_.max_delay.count());
+    double delay_ms = 0.0;
+
+    if (server_delay && pol_.honor_server_delay) {
+        // Lo pidió el servidor: no antes; jitter solo hacia arriba
+        const double hint_ms = std::min(static_cast<double>(std::max<Millis::rep>(0, server_delay->count())),
+                                        static_cast<double>(pol_.max_server_delay.count()));
+        delay_ms = hint_ms * (1.0 + (pol_.jitter_pct > 0.0 ? uniform01() * pol_.jitter_pct : 0.0));
+    } else if (pol_.mode == BackoffMode::DecorrelatedJitter) {
+        // min(cap, U(base, 3 * anterior)); el primero en [base, 3 * base]
+        const double prev = prev_ms_ > 0.0 ? prev_ms_ : base_ms;
+        const double hi   = std::max(base_ms, prev * 3.0);
+        delay_ms = std::min(max_ms, base_ms + uniform01() * (hi - base_ms));
+    } else {
+        // Exponencial: base * factor^(k-1), clamp al máximo
+        double raw_ms = base_ms * std::pow(pol_.factor <= 1.0 ? 1.0 : pol_.factor, static_cast<double>(k - 1));
+        if (raw_ms > max_ms) raw_ms = max_ms;
+
+        // Jitter uniforme en ±jitter_pct
+        delay_ms = raw_ms;
+        if (pol_.jitter_pct > 0.0) {
+            const double span = pol_.jitter_pct;
+            const double jitter = (uniform01() * 2.0 - 1.0) * span; // [-span, +span]
+            delay_ms = raw_ms * (1.0 + jitter);
+            if (delay_ms < 0.0)    delay_ms = 0.0;
+            if (delay_ms > max_ms) delay_ms = max_ms;
+        }
     }
+    prev_ms_ = delay_ms;
 
     // Avanzar contador
     ++next_attempt_;
 
     // Convertir a Millis
-    const auto ms = static_cast<long long>(std::llround(jittered_ms));
+    const auto ms = static_cast<long long>(std::llround(delay_ms));
     return Millis{ms};
 }
 
+bool Backoff::server_delay_too_long(Millis server_delay) const noexcept {
+    return pol_.honor_server_delay && server_delay > pol_.max_server_delay;
+}
+
 void Backoff::reset() noexcept {
     next_attempt_ = 1;
+    prev_ms_      = 0.0;
 }
 
 // -------------------------------
@@ -149,13 +174,39 @@ void Backoff::reset() noexcept {
 // -------------------------------
 struct CancellationSource::State {
     std::atomic<bool> cancelled{false};
+    std::atomic<long> refs{1};
     std::mutex        m;
     std::condition_variable cv;
 };
 
+static void* retain_state(void* impl) noexcept {
+    if (impl) static_cast<CancellationSource::State*>(impl)->refs.fetch_add(1, std::memory_order_relaxed);
+    return impl;
+}
+
+static void release_state(void* impl) noexcept {
+    auto* s = static_cast<CancellationSource::State*>(impl);
+    if (s && s->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete s;
+}
+
 CancellationSource::CancellationSource()
     : state_(new State()) {}
 
+CancellationSource::CancellationSource(const CancellationSource& o) noexcept
+    : state_(static_cast<State*>(retain_state(o.state_))) {}
+
+CancellationSource& CancellationSource::operator=(const CancellationSource& o) noexcept {
+    if (state_ != o.state_) {
+        release_state(state_);
+        state_ = static_cast<State*>(retain_state(o.state_));
+    }
+    return *this;
+}
+
+CancellationSource::~CancellationSource() {
+    release_state(state_);
+}
+
 void CancellationSource::cancel() noexcept {
     if (!state_) return;
     state_->cancelled.store(true, std::memory_order_relaxed);
@@ -164,7 +215,39 @@ void CancellationSource::cancel() noexcept {
 }
 
 CancellationToken CancellationSource::token() const noexcept {
-    return CancellationToken{state_};
+    return CancellationToken{static_cast<void*>(state_)};
+}
+
+CancellationToken::CancellationToken(void* impl) noexcept
+    : impl_(retain_state(impl)) {}
+
+CancellationToken::CancellationToken(const CancellationToken& o) noexcept
+    : impl_(retain_state(o.impl_)) {}
+
+CancellationToken::CancellationToken(CancellationToken&& o) noexcept
+    : impl_(o.impl_) {
+    o.impl_ = nullptr;
+}
+
+CancellationToken& CancellationToken::operator=(const CancellationToken& o) noexcept {
+    if (impl_ != o.impl_) {
+        release_state(impl_);
+        impl_ = retain_state(o.impl_);
+    }
+    return *this;
+}
+
+CancellationToken& CancellationToken::operator=(CancellationToken&& o) noexcept {
+    if (this != &o) {
+        release_state(impl_);
+        impl_   = o.impl_;
+        o.impl_ = nullptr;
+    }
+    return *this;
+}
+
+CancellationToken::~CancellationToken() {
+    release_state(impl_);
 }
 
 bool CancellationToken::is_cancelled() const noexcept {
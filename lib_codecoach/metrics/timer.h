@@ -8,6 +8,7 @@
 #define LIB_CODECOACH_TIMER_H
 
 #include <chrono>
+#include <optional>
 #include <cstdint>
 
 namespace cc::time {
@@ -51,13 +52,24 @@ private:
 };
 
 
-// Backoff exponencial con jitter
+// Backoff con jitter
+enum class BackoffMode {
+    Exponential,        // base * factor^(k-1), ±jitter_pct
+    DecorrelatedJitter  // uniforme en [base, 3 * delay anterior] (menos reintentos sincronizados)
+};
+
 struct BackoffPolicy {
     Millis base{100};      // primer delay
     double factor{2.0};    // multiplicador exponencial (> 1.0)
     Millis max_delay{5000};
     double jitter_pct{0.2}; // 0.2 => ±20%
     int    max_attempts{5}; // límite de intentos (≥ 1)
+    BackoffMode mode{BackoffMode::Exponential};
+    // Delay indicado por el servidor (Retry-After): si viene, manda sobre el calculado
+    // (más hasta +jitter_pct para no volver todos juntos). Por encima de max_server_delay
+    // no conviene esperar: server_delay_too_long() lo dice.
+    bool   honor_server_delay{true};
+    Millis max_server_delay{30000};
 };
 
 class Backoff {
@@ -66,13 +78,19 @@ public:
 
     // attempt() es el índice del PRÓXIMO intento (1-based)
     int    attempt() const noexcept;
-    Millis next_delay() noexcept; // aplica exponencial + jitter; avanza contador
+    Millis next_delay() noexcept; // según el modo (+ jitter); avanza contador
+    // Igual, pero con el delay que pidió el servidor (nullopt => como next_delay()).
+    Millis next_delay(std::optional<Millis> server_delay) noexcept;
+    bool   server_delay_too_long(Millis server_delay) const noexcept;
     void   reset() noexcept;
 
 private:
+    double uniform01() noexcept; // [0, 1)
+
     BackoffPolicy          pol_{};
     std::uint64_t          rng_state_{0};
     int                    next_attempt_{1}; // 1-based
+    double                 prev_ms_{0};      // último delay (DecorrelatedJitter)
 };
 
 
@@ -81,11 +99,20 @@ private:
 class CancellationToken {
 public:
     CancellationToken() noexcept = default;
-    explicit CancellationToken(void* impl) noexcept : impl_(impl) {}
+    // Tokens y fuentes comparten el estado con conteo de referencias: un token puede
+    // sobrevivir a su CancellationSource (p.ej. guardado en un request en vuelo).
+    CancellationToken(const CancellationToken& o) noexcept;
+    CancellationToken(CancellationToken&& o) noexcept;
+    CancellationToken& operator=(const CancellationToken& o) noexcept;
+    CancellationToken& operator=(CancellationToken&& o) noexcept;
+    ~CancellationToken();
 
     bool is_cancelled() const noexcept;
+    bool can_be_cancelled() const noexcept { return impl_ != nullptr; } // false => token vacío
 
 private:
+    explicit CancellationToken(void* impl) noexcept; // toma una referencia (solo CancellationSource)
+
     void* impl_{nullptr}; // puntero opaco a estado compartido
     friend class CancellationSource;
 
@@ -96,6 +123,10 @@ private:
 class CancellationSource {
 public:
     CancellationSource();
+    CancellationSource(const CancellationSource& o) noexcept; // comparte el mismo estado
+    CancellationSource& operator=(const CancellationSource& o) noexcept;
+    ~CancellationSource();
+
     void cancel() noexcept;
     CancellationToken token() const noexcept;
 
@@ -5,13 +5,16 @@
 //
 
 #include "prompts/coach_prompts.h"
+#include "prompts/tokenizer.h"
 
 #include "contracts/eval_dto.h"
 #include "contracts/problem_dto.h"
 
 #include <algorithm>
 #include <cctype>
+#include <numeric>
 #include <sstream>
+#include <stdexcept>
 
 namespace cc::prompts {
 
@@ -129,6 +132,94 @@ std::string language_from_problem_tags(const std::vector<std::string>& tags,
     return std::string{fallback};
 }
 
+static bool is_utf8_continuation(char c) {
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+std::string truncate_middle_tokens(std::string_view s, std::size_t maxTokens, const Tokenizer& tok) {
+    std::vector<std::size_t> ends;
+    tok.token_ends(s, ends);
+    if (ends.size() <= maxTokens) {
+        return std::string{s};
+    }
+    if (maxTokens == 0) {
+        return {};
+    }
+
+    static constexpr std::string_view kMarker = "\xE2\x80\xA6"; // "…", ~1 token
+
+    // En el corte el texto se re-tokeniza distinto: si se pasa, se achica y se reintenta
+    std::size_t keep = maxTokens - 1;
+    std::string out;
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        const std::size_t front = keep / 2;
+        const std::size_t back  = keep - front;
+
+        std::size_t cut1 = front > 0 ? ends[front - 1] : 0;
+        std::size_t cut2 = back > 0 ? ends[ends.size() - back - 1] : s.size();
+        while (cut1 > 0 && is_utf8_continuation(s[cut1])) --cut1;
+        while (cut2 < s.size() && is_utf8_continuation(s[cut2])) ++cut2;
+
+        out.assign(s.substr(0, cut1));
+        out.append(kMarker);
+        out.append(s.substr(cut2));
+
+        const std::size_t got = tok.count(out);
+        if (got <= maxTokens || keep == 0) {
+            break;
+        }
+        keep -= std::min(keep, got - maxTokens);
+    }
+    return out;
+}
+
+std::size_t fit_to_token_budget(std::vector<PromptSection>& sections,
+                                std::size_t budget,
+                                const Tokenizer& tok)
+{
+    const std::size_t n = sections.size();
+    std::vector<std::size_t> need(n);
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        need[i] = tok.count(sections[i].text);
+        total += need[i];
+    }
+    if (total <= budget) {
+        return total;
+    }
+
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return sections[a].priority > sections[b].priority;
+    });
+
+    // 1. Pisos, 2. el resto de mayor a menor prioridad
+    std::vector<std::size_t> alloc(n, 0);
+    std::size_t left = budget;
+    for (std::size_t i : order) {
+        const std::size_t give = std::min({need[i], sections[i].minTokens, left});
+        alloc[i] += give;
+        left     -= give;
+    }
+    for (std::size_t i : order) {
+        const std::size_t give = std::min(need[i] - alloc[i], left);
+        alloc[i] += give;
+        left     -= give;
+    }
+
+    total = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (alloc[i] >= need[i]) {
+            total += need[i];
+            continue;
+        }
+        sections[i].text = truncate_middle_tokens(sections[i].text, alloc[i], tok);
+        total += tok.count(sections[i].text);
+    }
+    return total;
+}
+
 // -------------------------------------------------
 // Helpers internos para armar secciones del prompt
 // -------------------------------------------------
@@ -200,6 +291,50 @@ static std::string build_code_section(const std::string& code,
     return oss.str();
 }
 
+// Encabezado + secciones, cada una seguida de "\n\n". Con limits.maxPromptTokens las
+// secciones se recortan para que system + contexto + `tail` entren en el presupuesto
+// (tokens del modelo).
+static std::string assemble_context(const std::string& system,
+                                    const std::string& head,
+                                    std::vector<PromptSection> sections,
+                                    std::string_view tail,
+                                    std::string_view model,
+                                    const RenderLimits& limits)
+{
+    if (limits.maxPromptTokens > 0) {
+        const Tokenizer& tok = tokenizer_for(model);
+        // + separadores "\n\n" y ~4 tokens de formato por mensaje del chat
+        const std::size_t fixed = tok.count(system) + tok.count(head) + tok.count(tail) +
+                                  sections.size() + 8;
+        const std::size_t budget = limits.maxPromptTokens > fixed ? limits.maxPromptTokens - fixed : 0;
+        fit_to_token_budget(sections, budget, tok);
+    }
+
+    std::string u = head;
+    for (const auto& section : sections) {
+        if (section.text.empty()) continue;
+        u += section.text;
+        u += "\n\n";
+    }
+    return u;
+}
+
+// Mensaje user = encabezado + secciones + tarea
+static std::string assemble_user(const std::string& system,
+                                 const std::string& head,
+                                 std::vector<PromptSection> sections,
+                                 const std::string& task,
+                                 std::string_view model,
+                                 const RenderLimits& limits)
+{
+    return assemble_context(system, head, std::move(sections), task, model, limits) + task;
+}
+
+// Prioridades y pisos (tokens) de las secciones recortables
+static PromptSection problem_section(std::string text) { return {std::move(text), 1, 128}; }
+static PromptSection eval_section(std::string text, int priority) { return {std::move(text), priority, 192}; }
+static PromptSection code_section(std::string text, int priority) { return {std::move(text), priority, 384}; }
+
 // -------------------------------------------------
 // Constructores de Prompt (API pública)
 // -------------------------------------------------
@@ -218,7 +353,6 @@ Prompt make_analyze_prompt(const std::string& code,
     p.temperature = 0.2;
 
     std::string lang = language_from_problem_tags(problem.tags, language);
-    (void)model; // por ahora no se usa dentro del prompt
 
     // Mensaje system
     p.system =
@@ -227,20 +361,20 @@ Prompt make_analyze_prompt(const std::string& code,
         "y generas un diagnóstico técnico y pedagógico. "
         "Responde siempre en español neutro, claro y conciso.";
 
-    // Mensaje user
-    std::ostringstream u;
-    u << "Lenguaje objetivo: " << lang << "\n\n";
-    u << build_problem_section(problem, limits) << "\n\n";
-    u << build_eval_section(eval, limits)       << "\n\n";
-    u << build_code_section(code, limits)       << "\n\n";
-
-    u << "Tarea:\n"
-      << "1. Explica brevemente qué intenta resolver el problema.\n"
-      << "2. Analiza el enfoque del estudiante (complejidad temporal y espacial aproximada).\n"
-      << "3. Señala los errores lógicos o de implementación que explican los fallos.\n"
-      << "4. Propón una estrategia mejor (sin dar el código completo) y su complejidad.\n";
-
-    p.user = u.str();
+    // Mensaje user: ante falta de espacio se recorta primero el enunciado, después la
+    // ejecución; el código del estudiante es lo último
+    const std::string task =
+        "Tarea:\n"
+        "1. Explica brevemente qué intenta resolver el problema.\n"
+        "2. Analiza el enfoque del estudiante (complejidad temporal y espacial aproximada).\n"
+        "3. Señala los errores lógicos o de implementación que explican los fallos.\n"
+        "4. Propón una estrategia mejor (sin dar el código completo) y su complejidad.\n";
+
+    p.user = assemble_user(p.system, "Lenguaje objetivo: " + lang + "\n\n",
+                           {problem_section(build_problem_section(problem, limits)),
+                            eval_section(build_eval_section(eval, limits), 2),
+                            code_section(build_code_section(code, limits), 3)},
+                           task, model, limits);
     return p;
 }
 
@@ -258,24 +392,22 @@ Prompt make_hints_prompt(const std::string& code,
     p.temperature = 0.3;
 
     std::string lang = language_from_problem_tags(problem.tags, language);
-    (void)model;
 
     p.system =
         "Eres un tutor de programación. Tu objetivo es dar pistas graduales "
         "para que el estudiante corrija su solución sin revelar directamente la respuesta. "
         "Responde siempre en español, usando un tono amigable y motivador.";
 
-    std::ostringstream u;
-    u << "Lenguaje objetivo: " << lang << "\n\n";
-    u << build_problem_section(problem, limits) << "\n\n";
-    u << build_eval_section(eval, limits)       << "\n\n";
-    u << build_code_section(code, limits)       << "\n\n";
+    const std::string task =
+        "Tarea:\n"
+        "Genera como máximo 3 pistas (de menor a mayor detalle) para ayudar al estudiante a mejorar su solución.\n"
+        "No des el código completo; enfócate en ideas, casos borde y errores típicos.\n";
 
-    u << "Tarea:\n"
-      << "Genera como máximo 3 pistas (de menor a mayor detalle) para ayudar al estudiante a mejorar su solución.\n"
-      << "No des el código completo; enfócate en ideas, casos borde y errores típicos.\n";
-
-    p.user = u.str();
+    p.user = assemble_user(p.system, "Lenguaje objetivo: " + lang + "\n\n",
+                           {problem_section(build_problem_section(problem, limits)),
+                            eval_section(build_eval_section(eval, limits), 2),
+                            code_section(build_code_section(code, limits), 3)},
+                           task, model, limits);
     return p;
 }
 
@@ -292,24 +424,170 @@ Prompt make_explain_failure_prompt(const std::string& code,
     p.temperature = 0.2;
 
     std::string lang = std::string{language};
-    (void)model;
 
     p.system =
         "Eres un asistente que explica por qué una solución de programación falla en ciertas pruebas. "
         "Debes ser muy claro y concreto, usando ejemplos basados en los casos de prueba fallidos.";
 
-    std::ostringstream u;
-    u << "Lenguaje objetivo: " << lang << "\n\n";
-    u << build_eval_section(eval, limits) << "\n\n";
-    u << build_code_section(code, limits) << "\n\n";
+    const std::string task =
+        "Tarea:\n"
+        "1. Explica qué patrón o error principal provoca que algunos casos fallen.\n"
+        "2. Menciona un caso concreto de entrada/salida donde falle y por qué.\n"
+        "3. Da una sugerencia breve para corregir el problema.\n";
+
+    // Acá los casos fallidos son el centro de la explicación: se recortan después del código
+    p.user = assemble_user(p.system, "Lenguaje objetivo: " + lang + "\n\n",
+                           {eval_section(build_eval_section(eval, limits), 3),
+                            code_section(build_code_section(code, limits), 2)},
+                           task, model, limits);
+    return p;
+}
+
+// -------------------------------------------------
+// Prompts del coach con prefijo compartido
+// -------------------------------------------------
 
-    u << "Tarea:\n"
-      << "1. Explica qué patrón o error principal provoca que algunos casos fallen.\n"
-      << "2. Menciona un caso concreto de entrada/salida donde falle y por qué.\n"
-      << "3. Da una sugerencia breve para corregir el problema.\n";
+static const char* kCoachSystem =
+    "Eres un asistente experto en algoritmos y estructuras de datos y un tutor de programación. "
+    "Trabajas sobre código enviado por estudiantes, junto con el problema y los resultados de las "
+    "pruebas. Responde siempre en español neutro, claro y conciso.";
+
+static const std::string& coach_task_text(CoachTask task) {
+    static const std::string analyze =
+        "Tarea:\n"
+        "1. Explica brevemente qué intenta resolver el problema.\n"
+        "2. Analiza el enfoque del estudiante (complejidad temporal y espacial aproximada).\n"
+        "3. Señala los errores lógicos o de implementación que explican los fallos.\n"
+        "4. Propón una estrategia mejor (sin dar el código completo) y su complejidad.\n";
+    static const std::string hints =
+        "Tarea:\n"
+        "Genera como máximo 3 pistas (de menor a mayor detalle) para ayudar al estudiante a mejorar su solución.\n"
+        "No des el código completo; enfócate en ideas, casos borde y errores típicos. "
+        "Usa un tono amigable y motivador.\n";
+    static const std::string explain =
+        "Tarea:\n"
+        "1. Explica qué patrón o error principal provoca que algunos casos fallen.\n"
+        "2. Menciona un caso concreto de entrada/salida donde falle y por qué.\n"
+        "3. Da una sugerencia breve para corregir el problema.\n";
+    switch (task) {
+        case CoachTask::Analyze:        return analyze;
+        case CoachTask::Hints:          return hints;
+        case CoachTask::ExplainFailure: return explain;
+    }
+    return analyze;
+}
 
+Prompt make_coach_prompt(CoachTask task,
+                         const std::string& code,
+                         const cc::contracts::RunResult& eval,
+                         const cc::contracts::ProblemDetail& problem,
+                         std::string_view language,
+                         std::string_view model,
+                         const RenderLimits& limits)
+{
+    Prompt p;
+    p.locale      = kDefaultLocale;
+    p.temperature = 0.2; // igual en las tres: si no, no se pueden unir en una llamada
+    switch (task) {
+        case CoachTask::Analyze:        p.version = kVersionCoachAnalyze; p.maxTokens = 800; break;
+        case CoachTask::Hints:          p.version = kVersionCoachHints;   p.maxTokens = 600; break;
+        case CoachTask::ExplainFailure: p.version = kVersionCoachExplain; p.maxTokens = 500; break;
+    }
+    p.system = kCoachSystem;
+
+    // El presupuesto reserva la instrucción más larga: el contexto sale igual para las tres
+    std::string_view longest;
+    for (CoachTask t : {CoachTask::Analyze, CoachTask::Hints, CoachTask::ExplainFailure}) {
+        if (coach_task_text(t).size() > longest.size()) longest = coach_task_text(t);
+    }
+
+    const std::string lang = language_from_problem_tags(problem.tags, language);
+    const std::string context =
+        assemble_context(p.system, "Lenguaje objetivo: " + lang + "\n\n",
+                         {problem_section(build_problem_section(problem, limits)),
+                          eval_section(build_eval_section(eval, limits), 2),
+                          code_section(build_code_section(code, limits), 3)},
+                         longest, model, limits);
+
+    p.user         = context + coach_task_text(task);
+    p.sharedPrefix = context.size();
+    return p;
+}
+
+static constexpr std::string_view kAnswerMarker = "### RESPUESTA ";
+
+Prompt make_multi_task_prompt(const std::vector<Prompt>& tasks)
+{
+    if (tasks.empty()) {
+        throw std::invalid_argument("make_multi_task_prompt: no tasks");
+    }
+    const Prompt& first = tasks.front();
+    const std::string_view prefix = std::string_view(first.user).substr(0, first.sharedPrefix);
+    for (const auto& t : tasks) {
+        if (t.sharedPrefix != first.sharedPrefix || t.system != first.system ||
+            t.temperature != first.temperature || t.user.compare(0, prefix.size(), prefix) != 0) {
+            throw std::invalid_argument("make_multi_task_prompt: tasks do not share system and prefix");
+        }
+    }
+
+    Prompt p;
+    p.system       = first.system;
+    p.temperature  = first.temperature;
+    p.locale       = first.locale;
+    p.sharedPrefix = first.sharedPrefix;
+    p.maxTokens    = 0;
+
+    std::ostringstream u;
+    u << prefix
+      << "Resuelve las siguientes " << tasks.size() << " tareas sobre la misma entrega. "
+      << "Empieza cada respuesta con una línea que diga solo \"" << kAnswerMarker << "k\" "
+      << "(k = número de tarea) y no escribas nada fuera de esas secciones.\n\n";
+    for (std::size_t k = 0; k < tasks.size(); ++k) {
+        u << "### TAREA " << (k + 1) << "\n" << std::string_view(tasks[k].user).substr(prefix.size()) << "\n";
+        p.maxTokens += tasks[k].maxTokens;
+        p.version   += (k ? "+" : "multi:") + tasks[k].version;
+    }
     p.user = u.str();
     return p;
 }
 
+std::optional<std::vector<std::string>> split_multi_task_response(std::string_view text, std::size_t tasks)
+{
+    // Inicio de la línea de cada marcador y comienzo de su contenido. Todo marcador corta la
+    // sección anterior, también los repetidos o fuera de rango (que se descartan)
+    std::vector<std::pair<std::size_t, std::size_t>> at(tasks, {std::string_view::npos, 0});
+    std::vector<std::size_t> starts;
+    std::size_t pos = 0;
+    while ((pos = text.find(kAnswerMarker, pos)) != std::string_view::npos) {
+        std::size_t k = 0;
+        std::size_t i = pos + kAnswerMarker.size();
+        while (i < text.size() && k <= tasks && std::isdigit(static_cast<unsigned char>(text[i]))) {
+            k = k * 10 + static_cast<std::size_t>(text[i] - '0');
+            ++i;
+        }
+        const std::size_t eol = text.find('\n', i);
+        if (k >= 1 && k <= tasks && at[k - 1].first == std::string_view::npos) {
+            at[k - 1] = {pos, eol == std::string_view::npos ? text.size() : eol + 1};
+        }
+        starts.push_back(pos);
+        pos = i;
+    }
+
+    for (const auto& [line, body] : at) {
+        if (line == std::string_view::npos) return std::nullopt;
+    }
+
+    std::vector<std::string> out;
+    out.reserve(tasks);
+    for (const auto& [line, body] : at) {
+        const auto next = std::upper_bound(starts.begin(), starts.end(), line);
+        const std::size_t end = next == starts.end() ? text.size() : *next;
+        std::string_view part = text.substr(body, end - body);
+        while (!part.empty() && std::isspace(static_cast<unsigned char>(part.back()))) part.remove_suffix(1);
+        while (!part.empty() && std::isspace(static_cast<unsigned char>(part.front()))) part.remove_prefix(1);
+        out.emplace_back(part);
+    }
+    return out;
+}
+
 } // namespace cc::prompts
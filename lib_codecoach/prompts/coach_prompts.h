@@ -23,6 +23,8 @@ namespace contracts {
 
 namespace prompts {
 
+class Tokenizer;
+
 struct Prompt {
     std::string system;      // Mensaje "system"
     std::string user;        // Mensaje "user"
@@ -30,6 +32,9 @@ struct Prompt {
     double      temperature{0.2};
     std::string version;     // p.ej. "analyze/v1"
     std::string locale;      // p.ej. "es-CR"
+    // Bytes iniciales de `user` idénticos en todos los prompts de la misma entrega (contexto
+    // antes de la tarea); 0 => el prompt no comparte prefijo. Lo usa BatchingLLMClient.
+    std::size_t sharedPrefix{0};
 };
 
 struct RenderLimits {
@@ -39,6 +44,16 @@ struct RenderLimits {
     std::size_t maxCasesJsonChars   = 6000;
     std::size_t maxStatementChars   = 2000;
     std::size_t maxTitleChars       = 120;
+    // > 0: tope en tokens de system + user. Los topes en caracteres siguen acotando cada
+    // campo; después fit_to_token_budget recorta problema/eval/código por prioridad.
+    std::size_t maxPromptTokens     = 0;
+};
+
+// Bloque del mensaje user que se puede recortar para entrar en el presupuesto
+struct PromptSection {
+    std::string text;
+    int         priority{0};  // mayor => se recorta después
+    std::size_t minTokens{0}; // piso reservado antes de repartir el resto
 };
 
 constexpr const char* kVersionAnalyze = "analyze/v1";
@@ -46,6 +61,17 @@ constexpr const char* kVersionHints   = "hints/v1";
 constexpr const char* kVersionExplain = "explain/v1";
 constexpr const char* kDefaultLocale  = "es-CR";
 
+constexpr const char* kVersionCoachAnalyze = "coach-analyze/v1";
+constexpr const char* kVersionCoachHints   = "coach-hints/v1";
+constexpr const char* kVersionCoachExplain = "coach-explain/v1";
+
+// Tareas del coach sobre una misma entrega
+enum class CoachTask {
+    Analyze,
+    Hints,
+    ExplainFailure
+};
+
 // --- Utilidades ---
 std::string sanitize_for_llm(std::string_view s);                 // limpia control chars, normaliza espacios
 std::string truncate_middle(std::string_view s, std::size_t max); // "inicio…fin"
@@ -53,6 +79,16 @@ std::string cases_to_compact_json(const cc::contracts::RunResult& eval, std::siz
 std::string language_from_problem_tags(const std::vector<std::string>& tags,
                                        std::string_view fallback = "cpp");
 
+// Como truncate_middle, pero en tokens; nunca parte un carácter UTF-8.
+std::string truncate_middle_tokens(std::string_view s, std::size_t maxTokens, const Tokenizer& tok);
+
+// Si las secciones suman más de `budget` tokens: primero se reservan los pisos (por
+// prioridad), el resto se reparte de mayor a menor prioridad (empates: en orden) y cada
+// sección que no entra se recorta al medio. Devuelve los tokens resultantes.
+std::size_t fit_to_token_budget(std::vector<PromptSection>& sections,
+                                std::size_t budget,
+                                const Tokenizer& tok);
+
 // --- Constructores de prompts ---
 Prompt make_analyze_prompt(const std::string& code,
                            const cc::contracts::RunResult& eval,
@@ -74,6 +110,28 @@ Prompt make_explain_failure_prompt(const std::string& code,
                                    std::string_view model = "gpt-4-turbo",
                                    const RenderLimits& limits = {});
 
+// --- Prompts del coach con prefijo compartido ---
+// Mismo system, misma temperatura y el mismo contexto (problema, ejecución, código, en ese
+// orden y con el mismo recorte) al principio de `user` para las tres tareas; solo cambian
+// las instrucciones finales. Así el proveedor reutiliza el prefijo cacheado entre las
+// llamadas de una entrega y make_multi_task_prompt las puede unir en una sola.
+Prompt make_coach_prompt(CoachTask task,
+                         const std::string& code,
+                         const cc::contracts::RunResult& eval,
+                         const cc::contracts::ProblemDetail& problem,
+                         std::string_view language = "cpp",
+                         std::string_view model = "gpt-4-turbo",
+                         const RenderLimits& limits = {});
+
+// Une prompts con el mismo system, temperatura y prefijo compartido en uno solo que pide
+// cada respuesta bajo "### RESPUESTA k" (k desde 1). maxTokens = suma de las partes.
+// Lanza std::invalid_argument si las partes no comparten system/prefijo.
+Prompt make_multi_task_prompt(const std::vector<Prompt>& tasks);
+
+// Separa la respuesta de make_multi_task_prompt por número de sección (en cualquier orden);
+// nullopt si falta alguna. Secciones repetidas o de más se descartan sin mezclarse con otras.
+std::optional<std::vector<std::string>> split_multi_task_response(std::string_view text, std::size_t tasks);
+
 } // namespace prompts
 } // namespace cc
 
@@ -0,0 +1,502 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// tokenizer.cpp — Pre-tokenización por tabla de clases + BPE por rank (mismo algoritmo que
+// tiktoken: se fusiona siempre el par adyacente con menor rank hasta que no quede ninguno
+// en el vocabulario). Las piezas que ya son un token (la mayoría de las palabras) salen con
+// una sola búsqueda en la tabla hash.
+
+#include "tokenizer.h"
+
+#include "config/config_manager.h"
+#include "errors/exceptions.h"
+#include "logging/logger.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace cc::prompts {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// -------------------------------
+// Pre-tokenización
+// -------------------------------
+enum : std::uint8_t {
+    kLetter  = 1,
+    kDigit   = 2,
+    kSpace   = 4,
+    kNewline = 8, // \r y \n (también kSpace)
+    kOther   = 16,
+    kUpper   = 32, // letras que o200k acepta como mayúscula (A-Z y los bytes >= 0x80)
+    kLower   = 64  // ídem minúscula (a-z y los bytes >= 0x80)
+};
+
+constexpr std::array<std::uint8_t, 256> make_classes() {
+    std::array<std::uint8_t, 256> t{};
+    for (int c = 0; c < 256; ++c) {
+        if (c >= 'A' && c <= 'Z') t[c] = kLetter | kUpper;
+        else if (c >= 'a' && c <= 'z') t[c] = kLetter | kLower;
+        else if (c >= 0x80) t[c] = kLetter | kUpper | kLower; // sin caso: como \p{Lo}
+        else if (c >= '0' && c <= '9') t[c] = kDigit;
+        else if (c == ' ' || c == '\t' || c == '\v' || c == '\f') t[c] = kSpace;
+        else if (c == '\r' || c == '\n') t[c] = kSpace | kNewline;
+        else t[c] = kOther;
+    }
+    return t;
+}
+
+constexpr std::array<std::uint8_t, 256> kClass = make_classes();
+
+inline std::uint8_t cls(char c) { return kClass[static_cast<unsigned char>(c)]; }
+
+inline std::size_t run_of(std::string_view s, std::size_t i, std::uint8_t mask) {
+    while (i < s.size() && (cls(s[i]) & mask)) ++i;
+    return i;
+}
+
+inline char lower_ascii(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : c; }
+
+// Largo de una contracción ('s 't 're 've 'm 'll 'd) en `i`, 0 si no hay
+std::size_t contraction_at(std::string_view s, std::size_t i) {
+    if (s[i] != '\'' || i + 1 >= s.size()) return 0;
+    const char a = lower_ascii(s[i + 1]);
+    if (a == 's' || a == 't' || a == 'm' || a == 'd') return 2;
+    if (i + 2 >= s.size()) return 0;
+    const char b = lower_ascii(s[i + 2]);
+    if ((a == 'r' && b == 'e') || (a == 'v' && b == 'e') || (a == 'l' && b == 'l')) return 3;
+    return 0;
+}
+
+// Espacios: hasta el último salto de línea de la corrida; si no hay, la corrida menos el
+// último espacio (que se pega a la pieza siguiente). \s*[\r\n]+ | \s+(?!\S) | \s+
+std::size_t space_end(std::string_view s, std::size_t i) {
+    const std::size_t end = run_of(s, i, kSpace);
+    for (std::size_t k = end; k > i; --k) {
+        if (cls(s[k - 1]) & kNewline) return k;
+    }
+    if (end == s.size() || end - i == 1) return end;
+    return end - 1;
+}
+
+// Equivalente a  's|'t|'re|'ve|'m|'ll|'d | [^\r\n\p{L}\p{N}]?\p{L}+ | \p{N}{1,3}
+//              | ' '?[^\s\p{L}\p{N}]+[\r\n]* | \s*[\r\n]+ | \s+(?!\S) | \s+
+template <class Fn>
+void pretokenize_cl100k(std::string_view s, Fn&& fn) {
+    const std::size_t n = s.size();
+    std::size_t i = 0;
+    while (i < n) {
+        const std::uint8_t c = cls(s[i]);
+        std::size_t j;
+
+        if (const std::size_t len = contraction_at(s, i)) {
+            j = i + len;
+        } else if (c & kLetter) {
+            j = run_of(s, i + 1, kLetter);
+        } else if (!(c & (kDigit | kNewline)) && i + 1 < n && (cls(s[i + 1]) & kLetter)) {
+            j = run_of(s, i + 2, kLetter); // espacio o signo pegado a la palabra
+        } else if (c & kDigit) {
+            j = i + 1;
+            while (j < n && j < i + 3 && (cls(s[j]) & kDigit)) ++j;
+        } else if ((c & kOther) || (s[i] == ' ' && i + 1 < n && (cls(s[i + 1]) & kOther))) {
+            j = run_of(s, s[i] == ' ' ? i + 1 : i, kOther);
+            j = run_of(s, j, kNewline);
+        } else {
+            j = space_end(s, i);
+        }
+
+        fn(s.substr(i, j - i));
+        i = j;
+    }
+}
+
+// Equivalente al patrón de o200k: palabras partidas por caso (mayúsculas y luego minúsculas,
+// "CamelCase" => "Camel" "Case") con la contracción pegada al final, y la puntuación se
+// lleva también las '/' que siguen a sus saltos de línea:
+//   [^\r\n\p{L}\p{N}]?[Lu]*[Ll]+('s|'t|...)? | [^\r\n\p{L}\p{N}]?[Lu]+[Ll]*('s|'t|...)?
+//   | \p{N}{1,3} | ' '?[^\s\p{L}\p{N}]+[\r\n/]* | \s*[\r\n]+ | \s+(?!\S) | \s+
+// (las dos primeras juntas terminan donde termina la corrida de minúsculas que sigue a la de
+// mayúsculas, con o sin backtracking)
+template <class Fn>
+void pretokenize_o200k(std::string_view s, Fn&& fn) {
+    const std::size_t n = s.size();
+    std::size_t i = 0;
+    while (i < n) {
+        const std::uint8_t c = cls(s[i]);
+        std::size_t j;
+
+        std::size_t w = i; // primera letra de la palabra (tras el signo o espacio pegado)
+        if (!(c & (kLetter | kDigit | kNewline)) && i + 1 < n && (cls(s[i + 1]) & kLetter)) w = i + 1;
+
+        if (cls(s[w]) & kLetter) {
+            j = run_of(s, run_of(s, w, kUpper), kLower);
+            if (j < n) j += contraction_at(s, j);
+        } else if (c & kDigit) {
+            j = i + 1;
+            while (j < n && j < i + 3 && (cls(s[j]) & kDigit)) ++j;
+        } else if ((c & kOther) || (s[i] == ' ' && i + 1 < n && (cls(s[i + 1]) & kOther))) {
+            j = run_of(s, s[i] == ' ' ? i + 1 : i, kOther);
+            while (j < n && (s[j] == '\r' || s[j] == '\n' || s[j] == '/')) ++j;
+        } else {
+            j = space_end(s, i);
+        }
+
+        fn(s.substr(i, j - i));
+        i = j;
+    }
+}
+
+template <class Fn>
+void pretokenize(Pretokenizer split, std::string_view s, Fn&& fn) {
+    if (split == Pretokenizer::O200k) pretokenize_o200k(s, std::forward<Fn>(fn));
+    else                              pretokenize_cl100k(s, std::forward<Fn>(fn));
+}
+
+// -------------------------------
+// Estimador
+// -------------------------------
+class ApproxTokenizer final : public Tokenizer {
+public:
+    // ~1 token cada 5 bytes de cada pieza: las palabras comunes son un token, los
+    // identificadores largos y el texto con tildes (2 bytes por letra) suman más
+    static constexpr std::size_t kBytesPerToken = 5;
+
+    void token_ends(std::string_view text, std::vector<std::size_t>& ends) const override {
+        std::size_t base = 0;
+        pretokenize_cl100k(text, [&](std::string_view piece) {
+            for (std::size_t k = kBytesPerToken; k < piece.size(); k += kBytesPerToken) ends.push_back(base + k);
+            base += piece.size();
+            ends.push_back(base);
+        });
+    }
+
+    std::size_t count(std::string_view text) const override {
+        std::size_t n = 0;
+        pretokenize_cl100k(text, [&](std::string_view piece) {
+            n += (piece.size() + kBytesPerToken - 1) / kBytesPerToken;
+        });
+        return n;
+    }
+
+    bool exact() const override { return false; }
+
+    const std::string& name() const override {
+        static const std::string n = "approx";
+        return n;
+    }
+};
+
+// -------------------------------
+// Vocabulario
+// -------------------------------
+constexpr std::uint32_t kNoRank = std::numeric_limits<std::uint32_t>::max();
+constexpr std::uint32_t kMaxRank = 1u << 26;
+
+inline std::uint64_t hash_bytes(std::string_view s) {
+    std::uint64_t h = 0x9E3779B97F4A7C15ull ^ s.size();
+    std::size_t i = 0;
+    for (; i + 8 <= s.size(); i += 8) {
+        std::uint64_t w;
+        std::memcpy(&w, s.data() + i, 8);
+        h = (h ^ w) * 0xff51afd7ed558ccdull;
+        h ^= h >> 32;
+    }
+    std::uint64_t w = 0;
+    if (i < s.size()) std::memcpy(&w, s.data() + i, s.size() - i);
+    h = (h ^ w) * 0xc4ceb9fe1a85ec53ull;
+    return h ^ (h >> 29);
+}
+
+std::optional<std::string> base64_decode(std::string_view in) {
+    static constexpr auto table = [] {
+        std::array<std::int8_t, 256> t{};
+        t.fill(-1);
+        const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int k = 0; k < 64; ++k) t[static_cast<unsigned char>(alphabet[k])] = static_cast<std::int8_t>(k);
+        return t;
+    }();
+
+    while (!in.empty() && in.back() == '=') in.remove_suffix(1);
+    std::string out;
+    out.reserve(in.size() * 3 / 4);
+    std::uint32_t acc = 0;
+    int bits = 0;
+    for (char c : in) {
+        const int v = table[static_cast<unsigned char>(c)];
+        if (v < 0) return std::nullopt;
+        acc = (acc << 6) | static_cast<std::uint32_t>(v);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<char>((acc >> bits) & 0xFF));
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+std::size_t Tokenizer::count(std::string_view text) const {
+    std::vector<std::size_t> ends;
+    token_ends(text, ends);
+    return ends.size();
+}
+
+void for_each_pretoken(std::string_view text, const std::function<void(std::string_view)>& fn,
+                       Pretokenizer split) {
+    pretokenize(split, text, fn);
+}
+
+const Tokenizer& approx_tokenizer() {
+    static const ApproxTokenizer inst;
+    return inst;
+}
+
+// -------------------------------
+// Estado interno
+// -------------------------------
+struct BpeTokenizer::State {
+    struct Tok {
+        std::uint32_t off;
+        std::uint32_t len;
+        std::uint32_t rank;
+    };
+
+    std::string                name;
+    Pretokenizer               split{Pretokenizer::Cl100k};
+    std::string                arena;  // bytes de todos los tokens, contiguos
+    std::vector<Tok>           toks;
+    std::vector<std::uint32_t> table;  // direccionamiento abierto: índice en toks o kNoRank
+    std::size_t                mask{0};
+    std::vector<std::uint32_t> byRank; // rank -> índice en toks (decode)
+
+    std::string_view bytes_of(const Tok& t) const { return std::string_view(arena).substr(t.off, t.len); }
+
+    std::uint32_t rank_of(std::string_view piece) const {
+        for (std::size_t i = hash_bytes(piece) & mask;; i = (i + 1) & mask) {
+            const std::uint32_t idx = table[i];
+            if (idx == kNoRank) return kNoRank;
+            if (bytes_of(toks[idx]) == piece) return toks[idx].rank;
+        }
+    }
+
+    bool insert(std::string_view bytes, std::uint32_t rank) {
+        std::size_t i = hash_bytes(bytes) & mask;
+        for (; table[i] != kNoRank; i = (i + 1) & mask) {
+            if (bytes_of(toks[table[i]]) == bytes) return false; // duplicado: vale el primero
+        }
+        table[i] = static_cast<std::uint32_t>(toks.size());
+        toks.push_back({static_cast<std::uint32_t>(arena.size()), static_cast<std::uint32_t>(bytes.size()), rank});
+        arena.append(bytes);
+        return true;
+    }
+
+    // Llama a emit(rank, fin del token dentro de la pieza) por cada token de `piece`
+    template <class Emit>
+    void bpe(std::string_view piece, Emit&& emit) const {
+        if (const std::uint32_t r = rank_of(piece); r != kNoRank) {
+            emit(r, piece.size());
+            return;
+        }
+
+        // (inicio de la parte, rank del par que empieza en ella)
+        thread_local std::vector<std::pair<std::size_t, std::uint32_t>> parts;
+        parts.clear();
+        auto pair_rank = [&](std::size_t i) {
+            return i + 2 < parts.size()
+                ? rank_of(piece.substr(parts[i].first, parts[i + 2].first - parts[i].first))
+                : kNoRank;
+        };
+        for (std::size_t i = 0; i <= piece.size(); ++i) parts.emplace_back(i, kNoRank);
+        for (std::size_t i = 0; i + 2 < parts.size(); ++i) parts[i].second = pair_rank(i);
+
+        while (true) {
+            std::size_t best = parts.size();
+            std::uint32_t bestRank = kNoRank;
+            for (std::size_t i = 0; i + 1 < parts.size(); ++i) {
+                if (parts[i].second < bestRank) {
+                    bestRank = parts[i].second;
+                    best = i;
+                }
+            }
+            if (bestRank == kNoRank) break;
+
+            // Fusionar best con best+1: cambian los pares que empiezan en best-1 y en best
+            parts.erase(parts.begin() + static_cast<std::ptrdiff_t>(best) + 1);
+            parts[best].second = pair_rank(best);
+            if (best > 0) parts[best - 1].second = pair_rank(best - 1);
+        }
+
+        for (std::size_t i = 0; i + 1 < parts.size(); ++i) {
+            emit(rank_of(piece.substr(parts[i].first, parts[i + 1].first - parts[i].first)), parts[i + 1].first);
+        }
+    }
+};
+
+// -------------------------------
+// BpeTokenizer
+// -------------------------------
+BpeTokenizer::BpeTokenizer()
+    : state_(new State())
+{
+}
+
+BpeTokenizer::~BpeTokenizer() {
+    delete state_;
+}
+
+std::shared_ptr<BpeTokenizer> BpeTokenizer::load(const std::string& path, std::string name) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw cc::errors::ConfigError("Cannot open tokenizer vocabulary: " + path);
+
+    std::vector<std::pair<std::string, std::uint32_t>> entries;
+    std::string line;
+    std::size_t lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        const auto sp = line.find(' ');
+        std::optional<std::string> bytes;
+        unsigned long rank = kMaxRank;
+        if (sp != std::string::npos) {
+            bytes = base64_decode(std::string_view(line).substr(0, sp));
+            try { rank = std::stoul(line.substr(sp + 1)); } catch (const std::exception&) {}
+        }
+        if (!bytes || bytes->empty() || rank >= kMaxRank) {
+            throw cc::errors::ConfigError("Invalid tokenizer vocabulary line " + std::to_string(lineNo) +
+                                          " in " + path);
+        }
+        entries.emplace_back(std::move(*bytes), static_cast<std::uint32_t>(rank));
+    }
+
+    std::shared_ptr<BpeTokenizer> tok(new BpeTokenizer());
+    State& st = *tok->state_;
+    st.name  = name.empty() ? fs::path(path).stem().string() : std::move(name);
+    st.split = pretokenizer_for(st.name);
+
+    std::size_t cap = 16;
+    while (cap < entries.size() * 2) cap <<= 1;
+    st.table.assign(cap, kNoRank);
+    st.mask = cap - 1;
+    st.toks.reserve(entries.size());
+
+    std::uint32_t maxRank = 0;
+    for (const auto& [bytes, rank] : entries) {
+        if (st.insert(bytes, rank)) maxRank = std::max(maxRank, rank);
+    }
+    st.byRank.assign(static_cast<std::size_t>(maxRank) + 1, kNoRank);
+    for (std::size_t i = 0; i < st.toks.size(); ++i) st.byRank[st.toks[i].rank] = static_cast<std::uint32_t>(i);
+
+    // BPE a nivel de bytes: cualquier texto tiene que poder partirse en bytes sueltos
+    for (int b = 0; b < 256; ++b) {
+        const char c = static_cast<char>(b);
+        if (st.rank_of(std::string_view(&c, 1)) == kNoRank) {
+            throw cc::errors::ConfigError("Tokenizer vocabulary " + path + " lacks single-byte token " +
+                                          std::to_string(b));
+        }
+    }
+    return tok;
+}
+
+std::vector<std::uint32_t> BpeTokenizer::encode(std::string_view text) const {
+    std::vector<std::uint32_t> out;
+    out.reserve(text.size() / 3);
+    pretokenize(state_->split, text, [&](std::string_view piece) {
+        state_->bpe(piece, [&](std::uint32_t rank, std::size_t) { out.push_back(rank); });
+    });
+    return out;
+}
+
+std::string BpeTokenizer::decode(const std::vector<std::uint32_t>& tokens) const {
+    std::string out;
+    for (std::uint32_t r : tokens) {
+        if (r < state_->byRank.size() && state_->byRank[r] != kNoRank) {
+            out.append(state_->bytes_of(state_->toks[state_->byRank[r]]));
+        }
+    }
+    return out;
+}
+
+void BpeTokenizer::token_ends(std::string_view text, std::vector<std::size_t>& ends) const {
+    std::size_t base = 0;
+    pretokenize(state_->split, text, [&](std::string_view piece) {
+        state_->bpe(piece, [&](std::uint32_t, std::size_t end) { ends.push_back(base + end); });
+        base += piece.size();
+    });
+}
+
+std::size_t BpeTokenizer::count(std::string_view text) const {
+    std::size_t n = 0;
+    pretokenize(state_->split, text, [&](std::string_view piece) {
+        state_->bpe(piece, [&](std::uint32_t, std::size_t) { ++n; });
+    });
+    return n;
+}
+
+const std::string& BpeTokenizer::name() const {
+    return state_->name;
+}
+
+Pretokenizer BpeTokenizer::pretokenizer() const {
+    return state_->split;
+}
+
+std::size_t BpeTokenizer::vocab_size() const {
+    return state_->toks.size();
+}
+
+// -------------------------------
+// Tokenizer por modelo
+// -------------------------------
+Pretokenizer pretokenizer_for(std::string_view encoding) {
+    return encoding.substr(0, 5) == "o200k" ? Pretokenizer::O200k : Pretokenizer::Cl100k;
+}
+
+static std::string encoding_for(std::string_view model) {
+    for (std::string_view prefix : {"gpt-4o", "gpt-4.1", "gpt-5", "o1", "o3", "o4"}) {
+        if (model.substr(0, prefix.size()) == prefix) return "o200k_base";
+    }
+    return "cl100k_base"; // gpt-4, gpt-3.5-turbo y compatibles
+}
+
+const Tokenizer& tokenizer_for(std::string_view model) {
+    struct Registry {
+        std::mutex m;
+        std::unordered_map<std::string, std::shared_ptr<const Tokenizer>> byEncoding; // nullptr => estimador
+    };
+    static Registry* reg = new Registry(); // vive hasta el final del proceso
+
+    const std::string encoding = encoding_for(model);
+    std::lock_guard<std::mutex> lk(reg->m);
+    if (auto it = reg->byEncoding.find(encoding); it != reg->byEncoding.end()) {
+        return it->second ? *it->second : approx_tokenizer();
+    }
+
+    std::shared_ptr<const Tokenizer> tok;
+    const std::string& dir = cc::config::get().llm.tokenizerDir;
+    if (!dir.empty()) {
+        const fs::path path = fs::path(dir) / (encoding + ".tiktoken");
+        try {
+            tok = BpeTokenizer::load(path.string(), encoding);
+        } catch (const std::exception& e) {
+            CC_LOG_WARN(std::string("[Prompts] ") + e.what() + "; estimating token counts");
+        }
+    }
+    reg->byEncoding.emplace(encoding, tok);
+    return tok ? *tok : approx_tokenizer();
+}
+
+} // namespace cc::prompts
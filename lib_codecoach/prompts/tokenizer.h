@@ -0,0 +1,95 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// tokenizer.h — Conteo de tokens local para presupuestar prompts sin llamar a la API.
+// BpeTokenizer implementa BPE a nivel de bytes con el vocabulario de un archivo .tiktoken
+// (el formato de los encodings cl100k_base / o200k_base de OpenAI): una pre-tokenización
+// equivalente al patrón de cl100k hecha con una tabla de clases de byte (sin regex, sin
+// copias) y luego merges por rank dentro de cada pieza. Sin vocabulario disponible,
+// tokenizer_for() devuelve un estimador con la misma pre-tokenización.
+#ifndef LIB_CODECOACH_TOKENIZER_H
+#define LIB_CODECOACH_TOKENIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cc::prompts {
+
+    // Reglas de pre-tokenización de cada familia de encodings
+    enum class Pretokenizer { Cl100k, O200k };
+
+    class Tokenizer {
+    public:
+        virtual ~Tokenizer() = default;
+
+        // Offset (exclusivo, en bytes) donde termina cada token de `text`, en orden.
+        // Se agregan al final de `ends`.
+        virtual void token_ends(std::string_view text, std::vector<std::size_t>& ends) const = 0;
+
+        virtual std::size_t count(std::string_view text) const;
+
+        // false => los conteos son una estimación (no hay vocabulario cargado)
+        virtual bool exact() const = 0;
+
+        virtual const std::string& name() const = 0;
+    };
+
+    class BpeTokenizer : public Tokenizer {
+    public:
+        // Una línea por token: "<bytes en base64> <rank>". Deben estar los 256 bytes sueltos.
+        // La pre-tokenización sale del nombre (ver pretokenizer_for).
+        // Lanza cc::errors::ConfigError si el archivo no existe o no tiene ese formato.
+        static std::shared_ptr<BpeTokenizer> load(const std::string& path, std::string name = "");
+
+        ~BpeTokenizer() override;
+        BpeTokenizer(const BpeTokenizer&) = delete;
+        BpeTokenizer& operator=(const BpeTokenizer&) = delete;
+
+        std::vector<std::uint32_t> encode(std::string_view text) const;
+        std::string decode(const std::vector<std::uint32_t>& tokens) const; // ranks desconocidos se omiten
+
+        void token_ends(std::string_view text, std::vector<std::size_t>& ends) const override;
+        std::size_t count(std::string_view text) const override;
+        bool exact() const override { return true; }
+        const std::string& name() const override;
+
+        std::size_t vocab_size() const;
+        Pretokenizer pretokenizer() const;
+
+        struct State;
+
+    private:
+        BpeTokenizer();
+
+        // PIMPL: tabla hash de tokens y merges viven en el .cpp
+        State* state_;
+    };
+
+    // Piezas de la pre-tokenización (contracciones, palabras con su espacio previo, números de
+    // hasta 3 dígitos, puntuación, saltos de línea), en orden y sin huecos. O200k además corta
+    // las palabras por caso ("CamelCase" => "Camel" "Case") y pega las '/' tras la puntuación.
+    // Los bytes >= 0x80 (UTF-8 no ASCII) cuentan como letras sin caso, así que el corte es
+    // exacto para texto ASCII y aproximado para el resto.
+    void for_each_pretoken(std::string_view text, const std::function<void(std::string_view)>& fn,
+                           Pretokenizer split = Pretokenizer::Cl100k);
+
+    // "o200k_base" y similares => O200k; el resto => Cl100k
+    Pretokenizer pretokenizer_for(std::string_view encoding);
+
+    // Tokenizer del modelo ("gpt-4o" => o200k_base, el resto => cl100k_base): el vocabulario
+    // <llm.tokenizerDir>/<encoding>.tiktoken si existe; si no, el estimador. Se carga una vez
+    // por encoding y vive hasta el final del proceso.
+    const Tokenizer& tokenizer_for(std::string_view model);
+
+    // Estimador sin vocabulario (~5 bytes por token dentro de cada pieza).
+    const Tokenizer& approx_tokenizer();
+
+} // namespace cc::prompts
+
+#endif // LIB_CODECOACH_TOKENIZER_H
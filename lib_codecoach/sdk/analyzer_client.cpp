@@ -2,6 +2,8 @@
 //
 
 #include "analyzer_client.h"
+#include "async/http_awaitable.h"
+#include "http/rate_limiter.h"
 #include "logging/logger.h"
 
 #include <exception>
@@ -21,6 +23,10 @@ AnalyzerClient::AnalyzerClient(const std::string& baseUrl)
 {
     httpClient_.setTimeout(60000); // 60s para análisis
     httpClient_.setDefaultHeader("Content-Type", "application/json");
+
+    // El analizador tiene cuota de QPS/concurrencia: se respeta del lado cliente
+    const auto& http = cc::config::get().http;
+    http::apply_service_quota(baseUrl_, http.analyzerQps, http.analyzerMaxInFlight);
 }
 
 static json runresult_to_json(const RunResult& r) {
@@ -78,45 +84,83 @@ static CoachFeedback feedback_from_json(const json& j) {
     return f;
 }
 
+static CoachFeedback analyze_fallback() {
+    CoachFeedback fallback;
+    fallback.nextStep = "No se pudo obtener feedback del analizador.";
+    fallback.commonMistake.clear();
+    return fallback;
+}
+
+static std::string make_analyze_body(const std::string& code,
+                                     const RunResult&   evalResult,
+                                     const std::string& problemId) {
+    json body;
+    body["code"]      = code;
+    body["problemId"] = problemId;
+    body["eval"]      = runresult_to_json(evalResult);
+    return body.dump();
+}
+
+// Interpreta la respuesta de POST /analyze (común a analyze y analyzeAsync)
+static CoachFeedback handle_analyze_response(const http::HttpResponse& response) {
+    if (!response.isSuccess()) {
+        logging::Logger::error("Analyzer service error: HTTP "
+                               + std::to_string(response.statusCode));
+        return analyze_fallback();
+    }
+
+    auto j  = json::parse(response.body);
+    auto fb = feedback_from_json(j);
+
+    logging::Logger::info("Analyzer feedback received");
+    return fb;
+}
+
 cc::contracts::CoachFeedback AnalyzerClient::analyze(
     const std::string& code,
     const RunResult&   evalResult,
-    const std::string& problemId
+    const std::string& problemId,
+    const http::RequestControl& ctl
 ) {
     const std::string url = baseUrl_ + "/analyze";
 
     logging::Logger::info("Calling analyzer service for problem: " + problemId);
 
-    CoachFeedback fallback;
-    fallback.nextStep = "No se pudo obtener feedback del analizador.";
-    fallback.commonMistake.clear();
-
     try {
-        json body;
-        body["code"]      = code;
-        body["problemId"] = problemId;
-        body["eval"]      = runresult_to_json(evalResult);
-
-        std::string jsonBody = body.dump();
-        auto response        = httpClient_.post(url, jsonBody);
-
-        if (!response.isSuccess()) {
-            logging::Logger::error("Analyzer service error: HTTP "
-                                   + std::to_string(response.statusCode));
-            return fallback;
-        }
-
-        auto j  = json::parse(response.body);
-        auto fb = feedback_from_json(j);
-
-        logging::Logger::info("Analyzer feedback received");
-        return fb;
+        std::string jsonBody = make_analyze_body(code, evalResult, problemId);
+        auto response        = httpClient_.request("POST", url, jsonBody, {}, std::nullopt, ctl);
+        return handle_analyze_response(response);
 
     } catch (const std::exception& e) {
         logging::Logger::error("Exception in AnalyzerClient::analyze: "
                                + std::string(e.what()));
-        return fallback;
+        return analyze_fallback();
     }
 }
 
+cc::async::Task<CoachFeedback> AnalyzerClient::analyzeAsync(
+    std::string          code,
+    RunResult            evalResult,
+    std::string          problemId,
+    http::RequestControl ctl
+) {
+    const std::string url = baseUrl_ + "/analyze";
+
+    logging::Logger::info("Calling analyzer service (async) for problem: " + problemId);
+
+    std::string error;
+    try {
+        std::string jsonBody = make_analyze_body(code, evalResult, problemId);
+        auto response = co_await cc::async::http_request(httpClient_, "POST", url,
+                                                         std::move(jsonBody), {}, std::move(ctl));
+        co_return handle_analyze_response(response);
+
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+
+    logging::Logger::error("Exception in AnalyzerClient::analyzeAsync: " + error);
+    co_return analyze_fallback();
+}
+
 } // namespace cc::sdk
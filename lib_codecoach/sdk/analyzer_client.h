@@ -4,6 +4,7 @@
 #ifndef LIB_CODECOACH_ANALYZER_CLIENT_H
 #define LIB_CODECOACH_ANALYZER_CLIENT_H
 
+#include "async/task.h"
 #include "contracts/analyzer_dto.h"
 #include "contracts/eval_dto.h"
 #include "contracts/problem_dto.h"
@@ -25,7 +26,16 @@ namespace cc::sdk {
         cc::contracts::CoachFeedback analyze(
             const std::string&              code,
             const cc::contracts::RunResult& evalResult,
-            const std::string&              problemId
+            const std::string&              problemId,
+            const http::RequestControl&     ctl = {}
+        );
+
+        // Variante co_await-able (el AnalyzerClient debe sobrevivir a la Task)
+        cc::async::Task<cc::contracts::CoachFeedback> analyzeAsync(
+            std::string              code,
+            cc::contracts::RunResult evalResult,
+            std::string              problemId,
+            http::RequestControl     ctl = {}
         );
     };
 
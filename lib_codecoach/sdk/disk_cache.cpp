@@ -0,0 +1,385 @@
+//
+// Created by andres on 5/10/25.
+//
+
+#include "disk_cache.h"
+
+#include "logging/logger.h"
+#include "metrics/counters.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace cc::sdk {
+
+namespace fs = std::filesystem;
+
+struct DiskCacheTier::Header {
+    char          magic[8];
+    std::uint32_t slots;      // potencia de 2
+    std::uint32_t used;
+    std::uint64_t dataBytes;  // bytes válidos del .dat (lo que sigue es basura de un crash)
+    std::uint8_t  pad[40];
+};
+
+struct DiskCacheTier::Slot {
+    std::uint8_t  key[32];
+    std::uint64_t offset;     // 0 => libre (el archivo de datos empieza con el magic)
+    std::int64_t  createdMs;
+    std::uint32_t length;     // bytes del registro
+    std::uint32_t meta[2];
+    std::uint32_t pad;
+};
+
+static_assert(sizeof(DiskCacheTier::Slot) == 64, "layout del índice en disco");
+
+namespace {
+
+constexpr std::size_t kRecordHeader = sizeof(DiskCacheKey) + sizeof(std::uint32_t);
+
+std::size_t slot_of(const DiskCacheKey& k, std::uint32_t slots) {
+    std::size_t h;
+    std::memcpy(&h, k.data(), sizeof(h)); // las claves ya son hashes uniformes
+    return h & (slots - 1);
+}
+
+void magic_of(const DiskCacheFormat& f, const char* kind, char out[8]) {
+    out[0] = 'C';
+    out[1] = 'C';
+    std::memcpy(out + 2, f.tag, 3);
+    std::memcpy(out + 5, kind, 3);
+}
+
+// ~1 slot cada `avg` bytes de datos
+std::uint32_t slots_for(std::size_t maxBytes, std::size_t avg) {
+    const std::size_t want = std::clamp<std::size_t>(maxBytes / std::max<std::size_t>(1, avg),
+                                                     1024, std::size_t{1} << 20);
+    std::uint32_t n = 1024;
+    while (n < want) n <<= 1;
+    return n;
+}
+
+#ifndef _WIN32
+bool write_all(int fd, std::string_view data, std::uint64_t offset) {
+    while (!data.empty()) {
+        const ssize_t n = ::pwrite(fd, data.data(), data.size(), static_cast<off_t>(offset));
+        if (n <= 0) return false;
+        data.remove_prefix(static_cast<std::size_t>(n));
+        offset += static_cast<std::uint64_t>(n);
+    }
+    return true;
+}
+#endif
+
+} // namespace
+
+static_assert(sizeof(DiskCacheTier::Header) == 64, "layout del índice en disco");
+
+DiskCacheTier::DiskCacheTier(DiskCacheFormat format) : format_(std::move(format)) {}
+
+DiskCacheTier::~DiskCacheTier() { close(); }
+
+DiskCacheTier::Header* DiskCacheTier::header() const { return static_cast<Header*>(map_); }
+
+DiskCacheTier::Slot* DiskCacheTier::slots() const {
+    return reinterpret_cast<Slot*>(static_cast<char*>(map_) + sizeof(Header));
+}
+
+std::size_t DiskCacheTier::entries() const { return enabled() ? header()->used : 0; }
+
+std::size_t DiskCacheTier::bytes() const { return enabled() ? header()->dataBytes : 0; }
+
+void DiskCacheTier::clear() {
+    if (enabled()) reset();
+}
+
+// Slot con la clave o el primer libre de su secuencia de sondeo; nullptr si la tabla está llena
+DiskCacheTier::Slot* DiskCacheTier::find(const DiskCacheKey& key) const {
+    const std::uint32_t n = header()->slots;
+    std::size_t i = slot_of(key, n);
+    for (std::uint32_t probes = 0; probes < n; ++probes, i = (i + 1) & (n - 1)) {
+        Slot& s = slots()[i];
+        if (s.offset == 0 || std::memcmp(s.key, key.data(), key.size()) == 0) return &s;
+    }
+    return nullptr;
+}
+
+bool DiskCacheTier::open(const std::string& dir, std::size_t maxBytes) {
+#ifdef _WIN32
+    (void)dir;
+    (void)maxBytes;
+    CC_LOG_WARN(format_.logTag + ": disk tier not supported on this platform, memory only");
+    return false;
+#else
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    idxPath_  = fs::path(dir) / (format_.stem + ".idx");
+    datPath_  = fs::path(dir) / (format_.stem + ".dat");
+    maxBytes_ = maxBytes;
+    if (!open_files()) {
+        CC_LOG_WARN(format_.logTag + ": cannot open " + idxPath_.string() + ", memory only");
+        close();
+        return false;
+    }
+    return true;
+#endif
+}
+
+std::optional<DiskCacheRecord> DiskCacheTier::get(const DiskCacheKey& key, std::int64_t nowMs, std::int64_t ttlMs) {
+    if (!enabled()) return std::nullopt;
+    const Slot* s = find(key);
+    if (!s || s->offset == 0) return std::nullopt;
+    if (ttlMs > 0 && s->createdMs + ttlMs <= nowMs) return std::nullopt;
+
+    DiskCacheRecord r;
+    r.createdMs = s->createdMs;
+    r.meta[0]   = s->meta[0];
+    r.meta[1]   = s->meta[1];
+    if (!read_record(*s, key, r.value)) return std::nullopt;
+    return r;
+}
+
+void DiskCacheTier::put(const DiskCacheKey& key, const DiskCacheRecord& r, std::int64_t nowMs, std::int64_t ttlMs) {
+#ifdef _WIN32
+    (void)key;
+    (void)r;
+    (void)nowMs;
+    (void)ttlMs;
+#else
+    if (!enabled()) return;
+    const std::size_t len = kRecordHeader + r.value.size();
+    if (len > maxBytes_ / 2 || len > UINT32_MAX) return; // no entra ni sola
+
+    if (header()->dataBytes + len > maxBytes_ || (header()->used + 1) * 4 > header()->slots * 3) {
+        compact(nowMs, ttlMs);
+        if (!enabled()) return;
+    }
+
+    std::string rec(kRecordHeader, '\0');
+    std::memcpy(rec.data(), key.data(), key.size());
+    const auto valueLen = static_cast<std::uint32_t>(r.value.size());
+    std::memcpy(rec.data() + key.size(), &valueLen, sizeof(valueLen));
+    rec += r.value;
+
+    // Primero el registro, después el índice: un crash entre ambos deja basura al final
+    // del .dat (se trunca al abrir), nunca un slot que apunte a datos inexistentes.
+    const std::uint64_t offset = header()->dataBytes;
+    if (!write_all(datFd_, rec, offset)) {
+        CC_LOG_WARN(format_.logTag + ": failed to append to " + datPath_.string());
+        return;
+    }
+
+    Slot* s = find(key);
+    if (!s) return; // tabla llena (no pasa: se compacta antes del 75%)
+    if (s->offset == 0) {
+        std::memcpy(s->key, key.data(), key.size());
+        ++header()->used;
+    }
+    s->offset    = offset;
+    s->length    = static_cast<std::uint32_t>(len);
+    s->createdMs = r.createdMs;
+    s->meta[0]   = r.meta[0];
+    s->meta[1]   = r.meta[1];
+    header()->dataBytes = offset + len;
+#endif
+}
+
+#ifdef _WIN32
+bool DiskCacheTier::open_files() { return false; }
+bool DiskCacheTier::map_index(std::size_t) { return false; }
+void DiskCacheTier::unmap() {}
+void DiskCacheTier::close() {}
+bool DiskCacheTier::reset() { return false; }
+bool DiskCacheTier::read_record(const Slot&, const DiskCacheKey&, std::string&) const { return false; }
+void DiskCacheTier::compact(std::int64_t, std::int64_t) {}
+#else
+bool DiskCacheTier::open_files() {
+    idxFd_ = ::open(idxPath_.c_str(), O_RDWR | O_CREAT, 0644);
+    datFd_ = ::open(datPath_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (idxFd_ < 0 || datFd_ < 0) return false;
+
+    struct stat idxSt{}, datSt{};
+    if (::fstat(idxFd_, &idxSt) != 0 || ::fstat(datFd_, &datSt) != 0) return false;
+
+    char idxMagic[8], datMagic[8];
+    magic_of(format_, "IX1", idxMagic);
+    magic_of(format_, "DT1", datMagic);
+
+    // Índice existente: se respeta su tamaño de tabla aunque la config haya cambiado
+    Header h{};
+    bool valid = idxSt.st_size >= static_cast<off_t>(sizeof(h)) &&
+                 ::pread(idxFd_, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h)) &&
+                 std::memcmp(h.magic, idxMagic, sizeof(idxMagic)) == 0 &&
+                 h.slots >= 2 && (h.slots & (h.slots - 1)) == 0 &&
+                 idxSt.st_size == static_cast<off_t>(sizeof(Header) + std::size_t{h.slots} * sizeof(Slot)) &&
+                 h.dataBytes >= sizeof(datMagic) &&
+                 static_cast<std::uint64_t>(datSt.st_size) >= h.dataBytes;
+    if (valid) {
+        char magic[sizeof(datMagic)];
+        valid = ::pread(datFd_, magic, sizeof(magic), 0) == static_cast<ssize_t>(sizeof(magic)) &&
+                std::memcmp(magic, datMagic, sizeof(datMagic)) == 0;
+    }
+    if (!valid) return reset();
+
+    if (!map_index(idxSt.st_size)) return false;
+    if (static_cast<std::uint64_t>(datSt.st_size) > h.dataBytes) {
+        (void)::ftruncate(datFd_, static_cast<off_t>(h.dataBytes)); // append a medias de un crash
+    }
+    return true;
+}
+
+bool DiskCacheTier::map_index(std::size_t bytes) {
+    void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, idxFd_, 0);
+    if (p == MAP_FAILED) return false;
+    map_      = p;
+    mapBytes_ = bytes;
+    return true;
+}
+
+void DiskCacheTier::unmap() {
+    if (map_) ::munmap(map_, mapBytes_);
+    map_      = nullptr;
+    mapBytes_ = 0;
+}
+
+void DiskCacheTier::close() {
+    unmap();
+    if (idxFd_ >= 0) ::close(idxFd_);
+    if (datFd_ >= 0) ::close(datFd_);
+    idxFd_ = datFd_ = -1;
+}
+
+// Índice vacío (archivo disperso: los slots en cero no ocupan disco) y datos solo con el magic
+bool DiskCacheTier::reset() {
+    const std::uint32_t n = map_ ? header()->slots : slots_for(maxBytes_, format_.avgRecord);
+    unmap();
+    char idxMagic[8], datMagic[8];
+    magic_of(format_, "IX1", idxMagic);
+    magic_of(format_, "DT1", datMagic);
+
+    const std::size_t bytes = sizeof(Header) + std::size_t{n} * sizeof(Slot);
+    if (::ftruncate(idxFd_, 0) != 0 || ::ftruncate(idxFd_, static_cast<off_t>(bytes)) != 0) return false;
+    if (::ftruncate(datFd_, 0) != 0 ||
+        !write_all(datFd_, std::string_view(datMagic, sizeof(datMagic)), 0)) {
+        return false;
+    }
+    if (!map_index(bytes)) return false;
+    std::memcpy(header()->magic, idxMagic, sizeof(idxMagic));
+    header()->slots     = n;
+    header()->used      = 0;
+    header()->dataBytes = sizeof(datMagic);
+    return true;
+}
+
+bool DiskCacheTier::read_record(const Slot& s, const DiskCacheKey& key, std::string& value) const {
+    if (s.length < kRecordHeader || s.offset + s.length > header()->dataBytes) return false;
+    std::string rec(s.length, '\0');
+    if (::pread(datFd_, rec.data(), rec.size(), static_cast<off_t>(s.offset)) != static_cast<ssize_t>(rec.size())) {
+        return false;
+    }
+    std::uint32_t valueLen = 0;
+    std::memcpy(&valueLen, rec.data() + key.size(), sizeof(valueLen));
+    if (std::memcmp(rec.data(), key.data(), key.size()) != 0 || kRecordHeader + valueLen != rec.size()) {
+        return false; // índice y datos desincronizados (p.ej. crash a mitad de una compactación)
+    }
+    value.assign(rec, kRecordHeader, valueLen);
+    return true;
+}
+
+// Reescribe los registros vigentes, de más nuevo a más viejo, hasta la mitad del tope de
+// bytes y de slots; el resto (vencidos, reemplazados, los más viejos) se descarta.
+void DiskCacheTier::compact(std::int64_t nowMs, std::int64_t ttlMs) {
+    const std::uint32_t n = header()->slots;
+    std::vector<Slot> live;
+    live.reserve(header()->used);
+    for (std::uint32_t i = 0; i < n; ++i) {
+        const Slot& s = slots()[i];
+        if (s.offset == 0) continue;
+        if (ttlMs > 0 && s.createdMs + ttlMs <= nowMs) continue;
+        live.push_back(s);
+    }
+    std::sort(live.begin(), live.end(), [](const Slot& a, const Slot& b) { return a.createdMs > b.createdMs; });
+
+    char idxMagic[8], datMagic[8];
+    magic_of(format_, "IX1", idxMagic);
+    magic_of(format_, "DT1", datMagic);
+
+    const fs::path datTmp = datPath_.string() + ".tmp";
+    const fs::path idxTmp = idxPath_.string() + ".tmp";
+    const int out = ::open(datTmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        CC_LOG_WARN(format_.logTag + ": compaction failed, clearing " + datPath_.string());
+        reset();
+        return;
+    }
+
+    std::vector<char> index(sizeof(Header) + std::size_t{n} * sizeof(Slot), 0);
+    auto* h     = reinterpret_cast<Header*>(index.data());
+    auto* table = reinterpret_cast<Slot*>(index.data() + sizeof(Header));
+    std::memcpy(h->magic, idxMagic, sizeof(idxMagic));
+    h->slots = n;
+
+    bool ok = write_all(out, std::string_view(datMagic, sizeof(datMagic)), 0);
+    std::uint64_t written = sizeof(datMagic);
+    std::string rec;
+    for (const Slot& s : live) {
+        if (!ok) break;
+        if (written + s.length > maxBytes_ / 2 || (h->used + 1) * 2 > n) break;
+        if (s.offset + s.length > header()->dataBytes) continue;
+        rec.resize(s.length);
+        if (::pread(datFd_, rec.data(), rec.size(), static_cast<off_t>(s.offset)) != static_cast<ssize_t>(rec.size()) ||
+            std::memcmp(rec.data(), s.key, sizeof(s.key)) != 0) {
+            continue;
+        }
+        ok = write_all(out, rec, written);
+
+        DiskCacheKey key;
+        std::memcpy(key.data(), s.key, key.size());
+        std::size_t i = slot_of(key, n);
+        while (table[i].offset != 0) i = (i + 1) & (n - 1);
+        table[i]        = s;
+        table[i].offset = written;
+        ++h->used;
+        written += s.length;
+    }
+    h->dataBytes = written;
+    ::close(out);
+
+    std::error_code ec;
+    if (ok) {
+        const int idxOut = ::open(idxTmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ok = idxOut >= 0 && write_all(idxOut, std::string_view(index.data(), index.size()), 0);
+        if (idxOut >= 0) ::close(idxOut);
+    }
+    if (!ok) {
+        fs::remove(datTmp, ec);
+        fs::remove(idxTmp, ec);
+        CC_LOG_WARN(format_.logTag + ": compaction failed, clearing " + datPath_.string());
+        reset();
+        return;
+    }
+
+    close();
+    fs::rename(datTmp, datPath_, ec);
+    if (!ec) fs::rename(idxTmp, idxPath_, ec);
+    if (ec || !open_files()) {
+        CC_LOG_WARN(format_.logTag + ": cannot reopen " + idxPath_.string() + " after compaction, memory only");
+        close();
+        return;
+    }
+    ++compactions_;
+    cc::metrics::count(format_.metric);
+}
+#endif
+
+} // namespace cc::sdk
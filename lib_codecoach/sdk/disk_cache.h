@@ -0,0 +1,97 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// disk_cache.h — Capa en disco de las cachés direccionadas por contenido (LlmResponseCache,
+// EvalResultCache). Dos archivos por caché:
+//   <dir>/<stem>.idx  tabla hash (sondeo lineal) de slots de 64 bytes, mapeada con mmap
+//   <dir>/<stem>.dat  registros [clave 32][largo u32][valor] que solo se agregan al final
+// Un lookup es una búsqueda en la tabla mapeada + un pread. Reemplazar una clave deja el
+// registro viejo como basura; al llegar al tope de bytes (o al 75% de slots) se compacta:
+// se reescriben los registros vigentes más nuevos hasta la mitad del tope.
+// No es thread-safe (el dueño la usa bajo su mutex) y un directorio lo usa un solo proceso.
+#ifndef LIB_CODECOACH_DISK_CACHE_H
+#define LIB_CODECOACH_DISK_CACHE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace cc::sdk {
+
+    // Claves más cortas (p.ej. 128 bits) van al principio y el resto en cero
+    using DiskCacheKey = std::array<std::uint8_t, 32>;
+
+    struct DiskCacheRecord {
+        std::string   value;
+        std::int64_t  createdMs{0};  // epoch (system_clock); decide vencimiento y compactación
+        std::uint32_t meta[2]{};     // metadatos fijos del dueño (p.ej. tokens y latencia)
+    };
+
+    // Identidad de los archivos: dos cachés en el mismo directorio no se pisan y un archivo de
+    // otra caché (u otra versión del formato) se descarta al abrir.
+    struct DiskCacheFormat {
+        std::string stem;         // "llm_cache" => llm_cache.idx / llm_cache.dat
+        char        tag[3];       // va en los magic: "CC" + tag + "IX1" / "DT1"
+        std::string logTag;       // prefijo de los logs, p.ej. "[LLM] cache"
+        std::string metric;       // contador de compactaciones, p.ej. "llm.cache.compactions"
+        std::size_t avgRecord{2048}; // dimensiona la tabla: ~1 slot cada `avgRecord` bytes
+    };
+
+    class DiskCacheTier {
+    public:
+        explicit DiskCacheTier(DiskCacheFormat format);
+        ~DiskCacheTier();
+        DiskCacheTier(const DiskCacheTier&) = delete;
+        DiskCacheTier& operator=(const DiskCacheTier&) = delete;
+
+        // false => sin capa en disco (se loguea el motivo); el dueño sigue solo en memoria
+        bool open(const std::string& dir, std::size_t maxBytes);
+
+        bool enabled() const { return map_ != nullptr; }
+
+        // ttlMs <= 0 => no vence
+        std::optional<DiskCacheRecord> get(const DiskCacheKey& key, std::int64_t nowMs, std::int64_t ttlMs);
+
+        void put(const DiskCacheKey& key, const DiskCacheRecord& rec, std::int64_t nowMs, std::int64_t ttlMs);
+
+        void clear();
+
+        std::size_t entries() const;
+        std::size_t bytes() const;
+        std::size_t compactions() const { return compactions_; }
+
+        // Layout del índice en disco (definido en el .cpp)
+        struct Header;
+        struct Slot;
+
+    private:
+        Header* header() const;
+        Slot* slots() const;
+        Slot* find(const DiskCacheKey& key) const;
+
+        bool open_files();
+        bool map_index(std::size_t bytes);
+        void unmap();
+        void close();
+        bool reset();
+        bool read_record(const Slot& s, const DiskCacheKey& key, std::string& value) const;
+        void compact(std::int64_t nowMs, std::int64_t ttlMs);
+
+        DiskCacheFormat       format_;
+        std::filesystem::path idxPath_;
+        std::filesystem::path datPath_;
+        std::size_t           maxBytes_{0};
+        int                   idxFd_{-1};
+        int                   datFd_{-1};
+        void*                 map_{nullptr};
+        std::size_t           mapBytes_{0};
+        std::size_t           compactions_{0};
+    };
+
+} // namespace cc::sdk
+
+#endif // LIB_CODECOACH_DISK_CACHE_H
@@ -0,0 +1,465 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// eval_cache.cpp — MurmurHash3 x64 128 de la clave, LRU en memoria, versiones del set de tests
+// por problema y capa en disco (disk_cache.h: <dir>/eval_cache.idx + <dir>/eval_cache.dat).
+// Las versiones también se guardan en el disco, como registros con clave propia, para que al
+// reabrir el proceso las claves sigan apuntando a lo ya evaluado.
+
+#include "eval_cache.h"
+#include "disk_cache.h"
+
+#include "config/config_manager.h"
+#include "metrics/counters.h"
+
+#include <cctype>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace cc::sdk {
+
+namespace {
+
+// Cambia si cambia la forma de la clave: invalida todo lo guardado
+constexpr std::string_view kKeySchema     = "cc-eval-cache/1";
+constexpr std::string_view kVersionSchema = "cc-eval-version/1";
+
+std::int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool expired(const EvalCacheEntry& e, std::int64_t nowMs, std::int64_t ttlMs) {
+    return ttlMs > 0 && e.createdMs + ttlMs <= nowMs;
+}
+
+// -------------------------------
+// MurmurHash3 x64 128 (Austin Appleby, dominio público)
+// -------------------------------
+std::uint64_t rotl(std::uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+std::uint64_t fmix(std::uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+EvalCacheKey murmur3_128(std::string_view data, std::uint64_t seed) {
+    constexpr std::uint64_t c1 = 0x87c37b91114253d5ULL;
+    constexpr std::uint64_t c2 = 0x4cf5ad432745937fULL;
+    const auto* p = reinterpret_cast<const std::uint8_t*>(data.data());
+    const std::size_t len    = data.size();
+    const std::size_t blocks = len / 16;
+
+    std::uint64_t h1 = seed, h2 = seed;
+    for (std::size_t i = 0; i < blocks; ++i) {
+        std::uint64_t k1, k2;
+        std::memcpy(&k1, p + 16 * i, 8);
+        std::memcpy(&k2, p + 16 * i + 8, 8);
+
+        k1 *= c1; k1 = rotl(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rotl(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+        k2 *= c2; k2 = rotl(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rotl(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const std::uint8_t* tail = p + blocks * 16;
+    std::uint64_t k1 = 0, k2 = 0;
+    switch (len & 15) {
+        case 15: k2 ^= std::uint64_t{tail[14]} << 48; [[fallthrough]];
+        case 14: k2 ^= std::uint64_t{tail[13]} << 40; [[fallthrough]];
+        case 13: k2 ^= std::uint64_t{tail[12]} << 32; [[fallthrough]];
+        case 12: k2 ^= std::uint64_t{tail[11]} << 24; [[fallthrough]];
+        case 11: k2 ^= std::uint64_t{tail[10]} << 16; [[fallthrough]];
+        case 10: k2 ^= std::uint64_t{tail[9]} << 8;   [[fallthrough]];
+        case 9:  k2 ^= std::uint64_t{tail[8]};
+                 k2 *= c2; k2 = rotl(k2, 33); k2 *= c1; h2 ^= k2;
+                 [[fallthrough]];
+        case 8:  k1 ^= std::uint64_t{tail[7]} << 56;  [[fallthrough]];
+        case 7:  k1 ^= std::uint64_t{tail[6]} << 48;  [[fallthrough]];
+        case 6:  k1 ^= std::uint64_t{tail[5]} << 40;  [[fallthrough]];
+        case 5:  k1 ^= std::uint64_t{tail[4]} << 32;  [[fallthrough]];
+        case 4:  k1 ^= std::uint64_t{tail[3]} << 24;  [[fallthrough]];
+        case 3:  k1 ^= std::uint64_t{tail[2]} << 16;  [[fallthrough]];
+        case 2:  k1 ^= std::uint64_t{tail[1]} << 8;   [[fallthrough]];
+        case 1:  k1 ^= std::uint64_t{tail[0]};
+                 k1 *= c1; k1 = rotl(k1, 31); k1 *= c2; h1 ^= k1;
+                 break;
+        default: break;
+    }
+
+    h1 ^= len; h2 ^= len;
+    h1 += h2;  h2 += h1;
+    h1 = fmix(h1);
+    h2 = fmix(h2);
+    h1 += h2;  h2 += h1;
+
+    EvalCacheKey out{};
+    std::memcpy(out.data(), &h1, 8);
+    std::memcpy(out.data() + 8, &h2, 8);
+    return out;
+}
+
+// Campos con largo delante: ("ab","c") y ("a","bc") no colisionan
+class KeyBuilder {
+public:
+    KeyBuilder& field(std::string_view s) {
+        const auto n = static_cast<std::uint64_t>(s.size());
+        buf_.append(reinterpret_cast<const char*>(&n), sizeof(n));
+        buf_.append(s);
+        return *this;
+    }
+
+    EvalCacheKey digest() const { return murmur3_128(buf_, 0x6363657661ULL); }
+
+private:
+    std::string buf_;
+};
+
+struct KeyHash {
+    std::size_t operator()(const EvalCacheKey& k) const noexcept {
+        std::size_t h;
+        std::memcpy(&h, k.data(), sizeof(h)); // ya es uniforme
+        return h;
+    }
+};
+
+DiskCacheKey disk_key(const EvalCacheKey& k) {
+    DiskCacheKey d{};
+    std::memcpy(d.data(), k.data(), k.size());
+    return d;
+}
+
+EvalCacheKey version_key(const std::string& problemId) {
+    return KeyBuilder().field(kVersionSchema).field(problemId).digest();
+}
+
+std::size_t cost_of(const EvalCacheEntry& e) {
+    return e.result.size() + sizeof(EvalCacheKey) + 64;
+}
+
+// Un RunResult con todos sus casos ronda los pocos KB
+DiskCacheFormat disk_format() {
+    return {"eval_cache", {'E', 'V', 'L'}, "[Eval] cache", "eval.cache.compactions", 4096};
+}
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+} // namespace
+
+// -------------------------------
+// Estado interno
+// -------------------------------
+struct EvalResultCache::State {
+    struct Version {
+        std::string                           id;
+        std::chrono::steady_clock::time_point changedAt{}; // {} si vino de disco
+    };
+
+    struct Node {
+        EvalCacheEntry                    entry;
+        std::size_t                       bytes{0};
+        std::list<EvalCacheKey>::iterator pos;
+    };
+
+    mutable std::mutex                                   m;
+    EvalCacheOptions                                     opts;
+    std::list<EvalCacheKey>                              lru; // frente = más reciente
+    std::unordered_map<EvalCacheKey, Node, KeyHash>      map;
+    std::size_t                                          bytes{0};
+    std::unordered_map<std::string, Version>             versions; // problemId -> set de tests
+    DiskCacheTier                                        disk{disk_format()};
+    EvalCacheStats                                       counts;
+
+    std::int64_t ttl_ms() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(opts.ttl).count();
+    }
+
+    void touch(Node& n) { lru.splice(lru.begin(), lru, n.pos); }
+
+    void put(const EvalCacheKey& key, EvalCacheEntry e) {
+        const std::size_t cost = cost_of(e);
+        if (cost > opts.maxBytes) {
+            remove(key);
+            return;
+        }
+        if (auto it = map.find(key); it != map.end()) {
+            bytes -= it->second.bytes;
+            it->second.entry = std::move(e);
+            it->second.bytes = cost;
+            bytes += cost;
+            touch(it->second);
+        } else {
+            lru.push_front(key);
+            Node n;
+            n.entry = std::move(e);
+            n.bytes = cost;
+            n.pos   = lru.begin();
+            map.emplace(key, std::move(n));
+            bytes += cost;
+        }
+        while (bytes > opts.maxBytes && !lru.empty()) {
+            const EvalCacheKey victim = lru.back();
+            remove(victim);
+            ++counts.evicted;
+            cc::metrics::count("eval.cache.evicted");
+        }
+    }
+
+    void remove(const EvalCacheKey& key) {
+        auto it = map.find(key);
+        if (it == map.end()) return;
+        bytes -= it->second.bytes;
+        lru.erase(it->second.pos);
+        map.erase(it);
+    }
+
+    // Memoria y, si no está, disco (las versiones no vencen por TTL)
+    Version& version_of(const std::string& problemId) {
+        if (auto it = versions.find(problemId); it != versions.end()) return it->second;
+        Version v;
+        if (auto rec = disk.get(disk_key(version_key(problemId)), now_ms(), 0)) v.id = std::move(rec->value);
+        return versions.emplace(problemId, std::move(v)).first->second;
+    }
+
+    // true si cambió
+    bool set_version(const std::string& problemId, const std::string& version) {
+        Version& v = version_of(problemId);
+        if (v.id == version) return false;
+        const bool hadVersion = !v.id.empty();
+        v.id        = version;
+        v.changedAt = std::chrono::steady_clock::now();
+
+        DiskCacheRecord rec;
+        rec.value     = version;
+        rec.createdMs = now_ms();
+        disk.put(disk_key(version_key(problemId)), rec, rec.createdMs, ttl_ms());
+
+        // La primera versión conocida no invalida nada: lo guardado sin versión usa otra clave
+        if (hadVersion) {
+            ++counts.invalidations;
+            cc::metrics::count("eval.cache.invalidated");
+        }
+        return true;
+    }
+
+    // Memoria y disco
+    void store(const EvalCacheKey& key, EvalCacheEntry e) {
+        const std::int64_t now = now_ms();
+        e.createdMs = now;
+
+        DiskCacheRecord rec;
+        rec.value     = e.result;
+        rec.createdMs = now;
+        rec.meta[0]   = e.judgeMs;
+        disk.put(disk_key(key), rec, now, ttl_ms());
+        put(key, std::move(e));
+    }
+};
+
+// -------------------------------
+// EvalResultCache
+// -------------------------------
+EvalResultCache::EvalResultCache(EvalCacheOptions opts)
+    : state_(new State())
+{
+    state_->opts = std::move(opts);
+    if (!state_->opts.diskDir.empty() && state_->opts.diskMaxBytes > 0) {
+        state_->disk.open(state_->opts.diskDir, state_->opts.diskMaxBytes);
+    }
+}
+
+EvalResultCache::~EvalResultCache() {
+    delete state_;
+}
+
+std::shared_ptr<EvalResultCache> EvalResultCache::shared() {
+    static const std::shared_ptr<EvalResultCache> inst = [] {
+        const auto& cfg = cc::config::get();
+        if (cfg.eval.cacheMaxBytes <= 0) return std::shared_ptr<EvalResultCache>{};
+        EvalCacheOptions o;
+        o.maxBytes        = static_cast<std::size_t>(cfg.eval.cacheMaxBytes);
+        o.ttl             = std::chrono::seconds(cfg.eval.cacheTtlSec);
+        o.diskDir         = cfg.eval.cacheDir;
+        o.diskMaxBytes    = static_cast<std::size_t>(cfg.eval.cacheDiskMaxBytes);
+        o.normalizeSource = cfg.eval.cacheNormalize;
+        return std::make_shared<EvalResultCache>(std::move(o));
+    }();
+    return inst;
+}
+
+std::string EvalResultCache::normalize_source(std::string_view code) {
+    std::string out;
+    out.reserve(code.size());
+    bool pendingSpace = false; // corrida de espacios dentro de la línea
+
+    const auto emit = [&](char c) {
+        if (pendingSpace && !out.empty() && out.back() != '\n') out.push_back(' ');
+        pendingSpace = false;
+        out.push_back(c);
+    };
+    const auto newline = [&] {
+        pendingSpace = false;
+        if (!out.empty() && out.back() != '\n') out.push_back('\n'); // sin líneas vacías
+    };
+
+    for (std::size_t i = 0; i < code.size(); ++i) {
+        const char c = code[i];
+        const char next = i + 1 < code.size() ? code[i + 1] : '\0';
+
+        if (c == '/' && next == '/') {
+            while (i < code.size() && code[i] != '\n') ++i;
+            newline();
+        } else if (c == '/' && next == '*') {
+            const auto end = code.find("*/", i + 2);
+            i = end == std::string_view::npos ? code.size() : end + 1;
+            pendingSpace = true; // en C un comentario equivale a un espacio
+        } else if (c == '"' || (c == '\'' && (out.empty() || !std::isalnum(static_cast<unsigned char>(out.back()))))) {
+            // String o char literal tal cual (el ' tras un dígito es un separador de C++14)
+            emit(c);
+            for (++i; i < code.size(); ++i) {
+                out.push_back(code[i]);
+                if (code[i] == '\\' && i + 1 < code.size()) {
+                    out.push_back(code[++i]);
+                } else if (code[i] == c || code[i] == '\n') {
+                    break;
+                }
+            }
+        } else if (c == '\n') {
+            newline();
+        } else if (is_space(c)) {
+            pendingSpace = true;
+        } else {
+            emit(c);
+        }
+    }
+    while (!out.empty() && out.back() == '\n') out.pop_back();
+    return out;
+}
+
+EvalCacheKey EvalResultCache::key_of(const cc::contracts::RunRequest& request,
+                                     std::string_view testSetVersion,
+                                     bool normalize) {
+    KeyBuilder k;
+    k.field(kKeySchema)
+     .field(request.problemId)
+     .field(testSetVersion)
+     .field(normalize ? "normalized" : "raw")
+     .field(normalize ? normalize_source(request.code) : request.code)
+     .field(request.stdin)
+     .field(request.failFast ? "failFast" : "all"); // con failFast el resultado trae menos casos
+    return k.digest();
+}
+
+EvalCacheKey EvalResultCache::key_for(const cc::contracts::RunRequest& request) const {
+    std::string version;
+    {
+        std::lock_guard<std::mutex> lk(state_->m);
+        version = state_->version_of(request.problemId).id;
+    }
+    return key_of(request, version, state_->opts.normalizeSource);
+}
+
+std::optional<EvalCacheEntry> EvalResultCache::lookup(const EvalCacheKey& key) {
+    std::lock_guard<std::mutex> lk(state_->m);
+    auto& st = *state_;
+    const std::int64_t now = now_ms();
+
+    std::optional<EvalCacheEntry> hit;
+    if (auto it = st.map.find(key); it != st.map.end()) {
+        if (!expired(it->second.entry, now, st.ttl_ms())) {
+            st.touch(it->second);
+            hit = it->second.entry;
+            cc::metrics::count("eval.cache.hit|memory");
+        } else {
+            st.remove(key); // el disco tiene la misma fecha: también vencida
+        }
+    } else if (auto rec = st.disk.get(disk_key(key), now, st.ttl_ms())) {
+        EvalCacheEntry e;
+        e.result    = std::move(rec->value);
+        e.judgeMs   = rec->meta[0];
+        e.createdMs = rec->createdMs;
+        st.put(key, e);
+        hit = std::move(e);
+        ++st.counts.diskHits;
+        cc::metrics::count("eval.cache.hit|disk");
+    }
+
+    if (!hit) {
+        ++st.counts.misses;
+        cc::metrics::count("eval.cache.miss");
+        return std::nullopt;
+    }
+    ++st.counts.hits;
+    st.counts.savedJudgeMs += hit->judgeMs;
+    cc::metrics::count("eval.cache.saved_ms", hit->judgeMs);
+    return hit;
+}
+
+void EvalResultCache::store(const EvalCacheKey& key, EvalCacheEntry entry) {
+    std::lock_guard<std::mutex> lk(state_->m);
+    state_->store(key, std::move(entry));
+}
+
+bool EvalResultCache::storeVerdict(const cc::contracts::RunRequest& request,
+                                   const std::string& judgedVersion,
+                                   EvalCacheEntry entry,
+                                   std::chrono::steady_clock::time_point sentAt) {
+    std::lock_guard<std::mutex> lk(state_->m);
+    auto& st = *state_;
+    const State::Version& current = st.version_of(request.problemId);
+
+    // La versión cambió mientras el envío estaba en el juez: si no lo evaluó con la nueva,
+    // es un resultado tardío y no debe volver a poner la vieja ni quedar memoizado
+    if (current.changedAt > sentAt && (judgedVersion.empty() || judgedVersion != current.id)) {
+        ++st.counts.stale;
+        cc::metrics::count("eval.cache.stale");
+        return false;
+    }
+    // El juez informa con qué casos evaluó: si cambiaron, lo memoizado antes ya no vale
+    if (!judgedVersion.empty()) st.set_version(request.problemId, judgedVersion);
+
+    st.store(key_of(request, current.id, st.opts.normalizeSource), std::move(entry));
+    return true;
+}
+
+std::string EvalResultCache::testSetVersion(const std::string& problemId) const {
+    std::lock_guard<std::mutex> lk(state_->m);
+    return state_->version_of(problemId).id;
+}
+
+bool EvalResultCache::setTestSetVersion(const std::string& problemId, const std::string& version) {
+    std::lock_guard<std::mutex> lk(state_->m);
+    return state_->set_version(problemId, version);
+}
+
+void EvalResultCache::clear() {
+    std::lock_guard<std::mutex> lk(state_->m);
+    state_->map.clear();
+    state_->lru.clear();
+    state_->bytes = 0;
+    state_->versions.clear();
+    state_->disk.clear();
+}
+
+EvalCacheStats EvalResultCache::stats() const {
+    std::lock_guard<std::mutex> lk(state_->m);
+    EvalCacheStats s = state_->counts;
+    s.entries     = state_->map.size();
+    s.bytes       = state_->bytes;
+    s.diskEntries = state_->disk.entries();
+    s.diskBytes   = state_->disk.bytes();
+    s.compactions = state_->disk.compactions();
+    return s;
+}
+
+} // namespace cc::sdk
@@ -0,0 +1,126 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// eval_cache.h — Memoización de evaluaciones direccionada por contenido: el mismo
+// (problemId, código, stdin, failFast) contra el mismo set de tests da el mismo RunResult,
+// así que los alumnos que reenvían código sin cambios y los graders que re-evalúan el
+// historial no vuelven a ocupar al juez. La clave es un hash de 128 bits (MurmurHash3 x64)
+// del request, opcionalmente con el código normalizado (sin espacios de más ni comentarios).
+// Dos capas como LlmResponseCache: LRU en memoria y, opcional, disco (disk_cache.h).
+//
+// Invalidación: la clave incluye la versión del set de tests del problema. La caché recuerda
+// la última versión vista por problema (la informan ProblemsClient al traer el problema, el
+// juez en RunResult::testSetVersion o el caller con setTestSetVersion); al cambiar, lo
+// guardado con la versión anterior deja de encontrarse y sale por LRU / compactación. Un
+// veredicto que llega después de un cambio, evaluado con otra versión, se descarta sin
+// volver atrás (storeVerdict). Sin versiones, solo vence por TTL.
+//
+// EvalClient la consulta antes de ir al juez (EvalClient::setResultCache) y reporta aciertos
+// y tiempo de juez ahorrado en cc::metrics ("eval.cache.*"). Thread-safe.
+#ifndef LIB_CODECOACH_EVAL_CACHE_H
+#define LIB_CODECOACH_EVAL_CACHE_H
+
+#include "contracts/eval_dto.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace cc::sdk {
+
+    using EvalCacheKey = std::array<std::uint8_t, 16>; // MurmurHash3 x64 128
+
+    struct EvalCacheOptions {
+        std::size_t          maxBytes{16 * 1024 * 1024};
+        std::chrono::seconds ttl{std::chrono::hours(24 * 30)}; // 0 => no vence
+        std::string          diskDir;                          // vacío => solo memoria
+        std::size_t          diskMaxBytes{256 * 1024 * 1024};
+        bool                 normalizeSource{false};           // ver normalize_source()
+    };
+
+    struct EvalCacheEntry {
+        std::string   result;        // RunResult serializado (lo arma EvalClient)
+        std::uint32_t judgeMs{0};    // lo que tardó la evaluación original, de punta a punta
+        std::int64_t  createdMs{0};  // epoch (system_clock); lo pone store()
+    };
+
+    struct EvalCacheStats {
+        std::size_t   entries{0};        // en memoria
+        std::size_t   bytes{0};
+        std::size_t   diskEntries{0};    // incluye las versiones de tests por problema
+        std::size_t   diskBytes{0};
+        std::size_t   hits{0};           // acumulados desde la construcción
+        std::size_t   diskHits{0};
+        std::size_t   misses{0};
+        std::size_t   evicted{0};
+        std::size_t   compactions{0};
+        std::size_t   invalidations{0};  // cambios de versión del set de tests
+        std::size_t   stale{0};          // veredictos tardíos descartados (storeVerdict)
+        std::uint64_t savedJudgeMs{0};   // suma de judgeMs de los aciertos
+
+        double hit_ratio() const {
+            return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+        }
+    };
+
+    class EvalResultCache {
+    public:
+        explicit EvalResultCache(EvalCacheOptions opts = {});
+        ~EvalResultCache();
+        EvalResultCache(const EvalResultCache&) = delete;
+        EvalResultCache& operator=(const EvalResultCache&) = delete;
+
+        // Instancia del proceso, configurada desde cc::config::get().eval en el primer uso.
+        // nullptr si la memoización está desactivada (eval.cacheMaxBytes = 0, el default).
+        static std::shared_ptr<EvalResultCache> shared();
+
+        static EvalCacheKey key_of(const cc::contracts::RunRequest& request,
+                                   std::string_view testSetVersion,
+                                   bool normalize);
+
+        // Clave con la versión vigente del problema y la normalización de las opciones
+        EvalCacheKey key_for(const cc::contracts::RunRequest& request) const;
+
+        // Código sin comentarios // y /* */, sin espacios al inicio/fin de línea, con las
+        // corridas de espacios colapsadas y sin líneas vacías; strings y chars intactos.
+        // Pensado para lenguajes tipo C: en Python `//` es división y la indentación importa.
+        // Solo alimenta la clave: al juez siempre va el código original.
+        static std::string normalize_source(std::string_view code);
+
+        std::optional<EvalCacheEntry> lookup(const EvalCacheKey& key);
+
+        void store(const EvalCacheKey& key, EvalCacheEntry entry);
+
+        // Veredicto del juez para `request`, enviado en `sentAt` y evaluado con `judgedVersion`
+        // ("" si el juez no la informa). Adopta esa versión y guarda bajo la clave vigente,
+        // salvo que la versión del problema haya cambiado después de `sentAt` y el juez no
+        // haya usado la nueva: ese resultado tardío se descarta. false si se descartó.
+        bool storeVerdict(const cc::contracts::RunRequest& request, const std::string& judgedVersion,
+                          EvalCacheEntry entry, std::chrono::steady_clock::time_point sentAt);
+
+        // "" si no se conoce
+        std::string testSetVersion(const std::string& problemId) const;
+
+        // true si cambió (invalida lo memoizado del problema con la versión anterior)
+        bool setTestSetVersion(const std::string& problemId, const std::string& version);
+
+        void clear(); // memoria, disco y versiones
+
+        EvalCacheStats stats() const;
+
+        struct State;
+
+    private:
+        // PIMPL: LRU, versiones y capa en disco viven en el .cpp
+        State* state_;
+    };
+
+} // namespace cc::sdk
+
+#endif // LIB_CODECOACH_EVAL_CACHE_H
@@ -1,9 +1,16 @@
 
 #include "eval_client.h"
+#include "async/http_awaitable.h"
+#include "http/rate_limiter.h"
 #include "logging/logger.h"
+#include "metrics/counters.h"
 
+#include <algorithm>
+#include <atomic>
 #include <exception>
+#include <mutex>
 #include <nlohmann/json.hpp>
+#include <thread>
 
 namespace cc::sdk {
 
@@ -17,6 +24,26 @@ EvalClient::EvalClient(const std::string& baseUrl)
 {
     httpClient_.setTimeout(30000); // 30 segundos para evaluación
     httpClient_.setDefaultHeader("Content-Type", "application/json");
+
+    // Hedging opcional (CODECOACH_HTTP_HEDGE_PERCENTILE): solo getResult() (GET) se hedgea;
+    // submit() es POST y nunca se duplica
+    if (const int p = cc::config::get().http.hedgePercentile; p > 0) {
+        http::HedgePolicy hedge;
+        hedge.percentile = p / 100.0;
+        httpClient_.setHedging(hedge);
+    }
+
+    pollClient_.setDefaultHeader("Content-Type", "application/json");
+    pollClient_.setAdaptiveTimeouts(std::nullopt);
+    setPollPolicy(poll_);
+
+    cache_ = EvalResultCache::shared();
+}
+
+void EvalClient::setPollPolicy(const EvalPollPolicy& policy) {
+    poll_ = policy;
+    // El GET retenido no debe cortarse por timeout antes de que el servicio conteste
+    pollClient_.setTimeout(static_cast<int>(std::max<cc::time::Millis::rep>(0, poll_.longPoll.count())) + 10000);
 }
 
 static json to_json(const RunRequest& req) {
@@ -24,85 +51,344 @@ static json to_json(const RunRequest& req) {
     j["code"]      = req.code;
     j["problemId"] = req.problemId;
     j["stdin"]     = req.stdin;
+    if (req.failFast) j["failFast"] = true;
     return j;
 }
 
+static RunCaseResult case_from_json(const json& cj) {
+    RunCaseResult c;
+    c.input    = cj.value("input",    std::string{});
+    c.output   = cj.value("output",   std::string{});
+    c.expected = cj.value("expected", std::string{});
+    c.passed   = cj.value("passed",   false);
+    c.timeMs   = cj.value("timeMs",   0);
+    c.memoryKB = cj.value("memoryKB", 0);
+    return c;
+}
+
+// Campos globales (todo menos `cases`)
+static void summary_from_json(const json& j, RunResult& result) {
+    result.passed       = j.value("passed", false);
+    result.timeMs       = j.value("timeMs", 0);
+    result.memoryKB     = j.value("memoryKB", 0);
+    result.exitCode     = j.value("exitCode", 0);
+    result.stdout       = j.value("stdout", std::string{});
+    result.stderr       = j.value("stderr", std::string{});
+    result.stoppedEarly = j.value("stoppedEarly", false);
+    result.testSetVersion = j.value("testSetVersion", std::string{});
+}
+
 static RunResult runresult_from_json(const json& j) {
     RunResult result;
-
-    result.passed   = j.value("passed", false);
-    result.timeMs   = j.value("timeMs", 0);
-    result.memoryKB = j.value("memoryKB", 0);
-    result.exitCode = j.value("exitCode", 0);
-    result.stdout   = j.value("stdout", std::string{});
-    result.stderr   = j.value("stderr", std::string{});
+    summary_from_json(j, result);
 
     if (j.contains("cases") && j["cases"].is_array()) {
         for (const auto& cj : j["cases"]) {
-            RunCaseResult c;
-            c.input    = cj.value("input",    std::string{});
-            c.output   = cj.value("output",   std::string{});
-            c.expected = cj.value("expected", std::string{});
-            c.passed   = cj.value("passed",   false);
-            c.timeMs   = cj.value("timeMs",   0);
-            c.memoryKB = cj.value("memoryKB", 0);
-            result.cases.push_back(std::move(c));
+            result.cases.push_back(case_from_json(cj));
         }
     }
 
     return result;
 }
 
-RunResult EvalClient::submit(const RunRequest& request) {
-    const std::string url = baseUrl_ + "/evaluate";
+// Inversa de runresult_from_json (para la caché)
+static json runresult_to_json(const RunResult& r) {
+    json j;
+    j["passed"]   = r.passed;
+    j["timeMs"]   = r.timeMs;
+    j["memoryKB"] = r.memoryKB;
+    j["exitCode"] = r.exitCode;
+    j["stdout"]   = r.stdout;
+    j["stderr"]   = r.stderr;
+    if (r.stoppedEarly) j["stoppedEarly"] = true;
+    if (!r.testSetVersion.empty()) j["testSetVersion"] = r.testSetVersion;
+    j["cases"] = json::array();
+    for (const auto& c : r.cases) {
+        j["cases"].push_back({{"input", c.input}, {"output", c.output}, {"expected", c.expected},
+                              {"passed", c.passed}, {"timeMs", c.timeMs}, {"memoryKB", c.memoryKB}});
+    }
+    return j;
+}
 
-    logging::Logger::info("Submitting code for evaluation");
+static bool interrupted(const http::RequestControl& ctl) {
+    return ctl.cancel.is_cancelled() || (ctl.deadline && ctl.deadline->expired());
+}
 
+static RunResult submit_fallback() {
     RunResult fallback;
     fallback.passed   = false;
     fallback.timeMs   = 0;
     fallback.memoryKB = 0;
     fallback.exitCode = -1;
+    return fallback;
+}
+
+// Interpreta la respuesta de POST /evaluate (común a submit y submitAsync)
+static RunResult handle_submit_response(const http::HttpResponse& response) {
+    RunResult fallback = submit_fallback();
+
+    if (!response.isSuccess()) {
+        logging::Logger::error(
+            "Evaluation failed: HTTP " + std::to_string(response.statusCode)
+        );
+        fallback.stderr =
+            "Evaluation service error: HTTP " + std::to_string(response.statusCode);
+        return fallback;
+    }
+
+    auto responseJson = json::parse(response.body);
+    auto result       = runresult_from_json(responseJson);
+
+    logging::Logger::info("Code evaluated successfully");
+    return result;
+}
+
+// -------------------------------------------------
+// Memoización (eval_cache.h)
+// -------------------------------------------------
+
+std::optional<RunResult> EvalClient::cached(const RunRequest& request) const {
+    if (!cache_) return std::nullopt;
+    auto hit = cache_->lookup(cache_->key_for(request));
+    if (!hit) return std::nullopt;
+    const auto j = json::parse(hit->result, nullptr, false);
+    if (j.is_discarded()) return std::nullopt;
+    logging::Logger::info("Evaluation served from cache");
+    return runresult_from_json(j);
+}
+
+void EvalClient::remember(const RunRequest& request, const RunResult& result,
+                          cc::time::SteadyClock::time_point t0) const {
+    // exitCode -1 es un error del cliente o del servicio, no un veredicto del juez
+    if (!cache_ || result.exitCode == -1) return;
+
+    EvalCacheEntry e;
+    e.result  = runresult_to_json(result).dump();
+    e.judgeMs = static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        cc::time::SteadyClock::now() - t0).count());
+    if (!cache_->storeVerdict(request, result.testSetVersion, std::move(e), t0)) {
+        logging::Logger::info("Discarding evaluation judged against an outdated test set");
+    }
+}
+
+RunResult EvalClient::submit(const RunRequest& request, const http::RequestControl& ctl) {
+    if (auto hit = cached(request)) return std::move(*hit);
+
+    const auto t0 = cc::time::SteadyClock::now();
+    RunResult result = evaluate(request, ctl);
+    if (!interrupted(ctl)) remember(request, result, t0);
+    return result;
+}
+
+RunResult EvalClient::evaluate(const RunRequest& request, const http::RequestControl& ctl) {
+    const std::string url = baseUrl_ + "/evaluate";
+
+    logging::Logger::info("Submitting code for evaluation");
 
     try {
         json requestBody = to_json(request);
         std::string jsonBody = requestBody.dump();
 
-        auto response = httpClient_.post(url, jsonBody);
+        auto response = httpClient_.request("POST", url, jsonBody, {}, std::nullopt, ctl);
+        return handle_submit_response(response);
+
+    } catch (const std::exception& e) {
+        logging::Logger::error(
+            "Exception in EvalClient::submit: " + std::string(e.what())
+        );
+        RunResult fallback = submit_fallback();
+        fallback.stderr = "Exception: " + std::string(e.what());
+        return fallback;
+    }
+}
+
+// -------------------------------------------------
+// Resultados por caso (NDJSON)
+// -------------------------------------------------
+//   {"type":"case","index":0,"input":"...","output":"...","expected":"...","passed":true,"timeMs":3}
+//   ...
+//   {"type":"summary","passed":false,"timeMs":120,"exitCode":0,"stoppedEarly":true}
+
+namespace {
+
+// Arma las líneas del feed con los trozos que entrega el sink y pasa cada objeto JSON a
+// `onObject`; si devuelve false se deja de leer (el sink corta la transferencia).
+class NdjsonReader {
+public:
+    using ObjectFn = std::function<bool(const json&)>;
+
+    explicit NdjsonReader(ObjectFn onObject) : onObject_(std::move(onObject)) {}
+
+    bool feed(std::string_view chunk) {
+        buf_.append(chunk);
+        std::size_t start = 0;
+        for (std::size_t nl; (nl = buf_.find('\n', start)) != std::string::npos; start = nl + 1) {
+            if (!line(std::string_view(buf_).substr(start, nl - start))) {
+                buf_.clear();
+                return false;
+            }
+        }
+        buf_.erase(0, start);
+        return true;
+    }
+
+    // Última línea sin '\n'
+    void finish() {
+        if (!buf_.empty()) line(buf_);
+        buf_.clear();
+    }
+
+    bool stopped() const { return stopped_; }
+
+private:
+    bool line(std::string_view text) {
+        while (!text.empty() && (text.back() == '\r' || text.back() == ' ')) text.remove_suffix(1);
+        if (text.empty()) return true;
+
+        const auto j = json::parse(text, nullptr, false);
+        if (j.is_discarded() || !j.is_object()) {
+            logging::Logger::warn("Ignoring malformed evaluation stream line");
+            return true;
+        }
+        if (!onObject_(j)) {
+            stopped_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    ObjectFn    onObject_;
+    std::string buf_;
+    bool        stopped_{false};
+};
+
+bool streaming_unsupported(const http::HttpResponse& response) {
+    return response.statusCode == 404 || response.statusCode == 405 || response.statusCode == 415;
+}
+
+} // namespace
+
+RunResult EvalClient::submitStreaming(const RunRequest& request, CaseCallback onCase, const http::RequestControl& ctl) {
+    const std::string url = baseUrl_ + "/evaluate/stream";
+
+    if (auto hit = cached(request)) {
+        for (std::size_t i = 0; i < hit->cases.size(); ++i) {
+            if (onCase && !onCase(i, hit->cases[i])) break;
+        }
+        return std::move(*hit);
+    }
+
+    logging::Logger::info("Submitting code for evaluation (streaming)");
+
+    const auto t0 = cc::time::SteadyClock::now();
+    try {
+        RunResult result;
+        bool summary = false;
+        NdjsonReader feed([&](const json& j) {
+            const std::string type = j.value("type", std::string{});
+            if (type == "case") {
+                result.cases.push_back(case_from_json(j));
+                cc::metrics::count("eval.stream.cases");
+                return !onCase || onCase(result.cases.size() - 1, result.cases.back());
+            }
+            if (type == "summary") {
+                summary_from_json(j, result);
+                summary = true;
+            }
+            return true;
+        });
+        auto response = httpClient_.requestStreaming(
+            "POST", url, to_json(request).dump(),
+            {{"Accept", "application/x-ndjson"}},
+            [&feed](std::string_view chunk) { return feed.feed(chunk); },
+            std::nullopt, ctl);
+
+        if (feed.stopped()) {
+            // Al cortar la conexión el servicio deja de evaluar; lo visto no alcanza para aprobar
+            cc::metrics::count("eval.stream.stopped_by_caller");
+            result.passed       = false;
+            result.stoppedEarly = true;
+            return result;
+        }
+
+        if (streaming_unsupported(response)) {
+            logging::Logger::info("Evaluation streaming not supported (HTTP " +
+                                  std::to_string(response.statusCode) + "), falling back to /evaluate");
+            RunResult full = submit(request, ctl);
+            for (std::size_t i = 0; i < full.cases.size(); ++i) {
+                if (onCase && !onCase(i, full.cases[i])) break;
+            }
+            return full;
+        }
 
         if (!response.isSuccess()) {
-            logging::Logger::error(
-                "Evaluation failed: HTTP " + std::to_string(response.statusCode)
-            );
-            fallback.stderr =
-                "Evaluation service error: HTTP " + std::to_string(response.statusCode);
-            return fallback;
+            return handle_submit_response(response);
         }
 
-        auto responseJson = json::parse(response.body);
-        auto result       = runresult_from_json(responseJson);
+        feed.finish();
+        if (!summary) {
+            logging::Logger::error("Evaluation stream ended without a summary");
+            result.passed       = false;
+            result.exitCode     = -1;
+            result.stoppedEarly = true;
+            result.stderr       = "Evaluation stream ended before the summary";
+            return result;
+        }
 
-        logging::Logger::info("Code evaluated successfully");
+        if (result.stoppedEarly) cc::metrics::count("eval.stream.fail_fast");
+        if (!interrupted(ctl)) remember(request, result, t0);
+        logging::Logger::info("Code evaluated successfully (" + std::to_string(result.cases.size()) + " cases streamed)");
         return result;
 
     } catch (const std::exception& e) {
-        logging::Logger::error(
-            "Exception in EvalClient::submit: " + std::string(e.what())
-        );
+        logging::Logger::error("Exception in EvalClient::submitStreaming: " + std::string(e.what()));
+        RunResult fallback = submit_fallback();
         fallback.stderr = "Exception: " + std::string(e.what());
         return fallback;
     }
 }
 
+cc::async::Task<RunResult> EvalClient::submitAsync(RunRequest request, http::RequestControl ctl) {
+    const std::string url = baseUrl_ + "/evaluate";
+
+    if (auto hit = cached(request)) co_return std::move(*hit);
+
+    logging::Logger::info("Submitting code for evaluation (async)");
+
+    const auto t0 = cc::time::SteadyClock::now();
+    std::string error;
+    try {
+        std::string jsonBody = to_json(request).dump();
+
+        auto response = co_await cc::async::http_request(httpClient_, "POST", url,
+                                                         std::move(jsonBody), {}, ctl);
+        RunResult result = handle_submit_response(response);
+        if (!interrupted(ctl)) remember(request, result, t0);
+        co_return result;
+
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+
+    logging::Logger::error("Exception in EvalClient::submitAsync: " + error);
+    RunResult fallback = submit_fallback();
+    fallback.stderr = "Exception: " + error;
+    co_return fallback;
+}
+
 std::optional<RunResult>
-EvalClient::getResult(const std::string& submissionId) {
+EvalClient::getResult(const std::string& submissionId, const http::RequestControl& ctl) {
     const std::string url = baseUrl_ + "/results/" + submissionId;
 
     logging::Logger::debug("Fetching evaluation result: " + submissionId);
 
     try {
-        auto response = httpClient_.get(url);
+        auto response = httpClient_.request("GET", url, {}, {}, std::nullopt, ctl);
 
+        if (response.statusCode == 202 || response.statusCode == 204) {
+            logging::Logger::debug("Result still pending: " + submissionId);
+            return std::nullopt;
+        }
         if (!response.isSuccess()) {
             logging::Logger::warn("Result not found or error: HTTP "
                                   + std::to_string(response.statusCode));
@@ -123,4 +409,274 @@ EvalClient::getResult(const std::string& submissionId) {
     }
 }
 
+// -------------------------------------------------
+// Modo cola (submit-and-poll)
+// -------------------------------------------------
+
+static RunResult poll_failure(const std::string& why) {
+    RunResult fallback = submit_fallback();
+    fallback.stderr = why;
+    return fallback;
+}
+
+// 202 {"submissionId": "..."} (o 200/201 con el mismo campo)
+static std::optional<std::string> handle_enqueue_response(const http::HttpResponse& response) {
+    if (!response.isSuccess()) {
+        logging::Logger::error("Enqueue failed: HTTP " + std::to_string(response.statusCode));
+        return std::nullopt;
+    }
+    const auto j = json::parse(response.body, nullptr, false);
+    if (j.is_discarded() || !j.contains("submissionId") || !j["submissionId"].is_string()) {
+        logging::Logger::error("Enqueue failed: response without submissionId");
+        return std::nullopt;
+    }
+    cc::metrics::count("eval.queue.enqueued");
+    return j["submissionId"].get<std::string>();
+}
+
+std::optional<std::string> EvalClient::enqueue(const RunRequest& request, const http::RequestControl& ctl) {
+    try {
+        auto response = httpClient_.request("POST", baseUrl_ + "/submissions", to_json(request).dump(),
+                                            {}, std::nullopt, ctl);
+        return handle_enqueue_response(response);
+    } catch (const std::exception& e) {
+        logging::Logger::error("Exception in EvalClient::enqueue: " + std::string(e.what()));
+        return std::nullopt;
+    }
+}
+
+cc::async::Task<std::optional<std::string>> EvalClient::enqueueAsync(RunRequest request, http::RequestControl ctl) {
+    std::string error;
+    try {
+        auto response = co_await cc::async::http_request(httpClient_, "POST", baseUrl_ + "/submissions",
+                                                         to_json(request).dump(), {}, std::move(ctl));
+        co_return handle_enqueue_response(response);
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    logging::Logger::error("Exception in EvalClient::enqueueAsync: " + error);
+    co_return std::nullopt;
+}
+
+cc::async::Task<RunResult> EvalClient::awaitResult(std::string submissionId, http::RequestControl ctl) {
+    using cc::time::Millis;
+
+    const std::string base = baseUrl_ + "/results/" + submissionId;
+    cc::time::Backoff backoff(poll_.backoff);
+    int errors = 0; // fallos transitorios seguidos
+
+    while (true) {
+        if (interrupted(ctl)) {
+            cc::metrics::count("eval.queue.abandoned");
+            co_return poll_failure("Cancelled while waiting for evaluation " + submissionId);
+        }
+
+        Millis wait = poll_.longPoll;
+        if (ctl.deadline) wait = std::min(wait, ctl.deadline->remaining());
+        const std::string url = wait.count() > 0 ? base + "?waitMs=" + std::to_string(wait.count()) : base;
+
+        const auto t0 = cc::time::SteadyClock::now();
+        http::HttpResponse response;
+        std::string error;
+        try {
+            response = co_await cc::async::http_request(pollClient_, "GET", url, {}, {}, ctl);
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        if (!error.empty()) {
+            logging::Logger::error("Exception in EvalClient::awaitResult: " + error);
+            co_return poll_failure("Exception: " + error);
+        }
+        cc::metrics::count("eval.queue.polls");
+
+        if (response.statusCode == 200) {
+            const auto j = json::parse(response.body, nullptr, false);
+            if (j.is_discarded()) co_return poll_failure("Malformed evaluation result for " + submissionId);
+            cc::metrics::count("eval.queue.completed");
+            co_return runresult_from_json(j);
+        }
+
+        const bool pending = response.statusCode == 202 || response.statusCode == 204;
+        const bool transient = response.statusCode == 0 || response.statusCode == 408 ||
+                               response.statusCode == 429 || response.statusCode >= 500;
+        if (!pending && !transient) {
+            logging::Logger::warn("Evaluation " + submissionId + " failed: HTTP " +
+                                  std::to_string(response.statusCode));
+            co_return poll_failure("Evaluation service error: HTTP " + std::to_string(response.statusCode));
+        }
+        errors = pending ? 0 : errors + 1;
+        if (poll_.maxTransientErrors > 0 && errors >= poll_.maxTransientErrors) {
+            cc::metrics::count("eval.queue.gave_up");
+            logging::Logger::warn("Giving up on evaluation " + submissionId + " after " +
+                                  std::to_string(errors) + " failed polls (last HTTP " +
+                                  std::to_string(response.statusCode) + ")");
+            co_return poll_failure("Evaluation service unavailable: HTTP " + std::to_string(response.statusCode));
+        }
+
+        // El servicio retuvo el GET (long-poll real): se vuelve a preguntar ya mismo. Si
+        // contestó antes de tiempo o con error, se espera según el backoff.
+        const auto held = std::chrono::duration_cast<Millis>(cc::time::SteadyClock::now() - t0);
+        if (pending && wait.count() > 0 && held * 2 >= wait) {
+            backoff.reset();
+            continue;
+        }
+        // La espera tampoco pasa del deadline y se corta al cancelar (lo resuelve el while)
+        Millis delay = backoff.next_delay(http::retry_after_of(response));
+        if (ctl.deadline) delay = std::min(delay, ctl.deadline->remaining());
+        co_await cc::async::sleep_for(delay, ctl.cancel);
+    }
+}
+
+cc::async::Task<RunResult> EvalClient::submitQueuedAsync(RunRequest request, http::RequestControl ctl) {
+    if (auto hit = cached(request)) co_return std::move(*hit);
+
+    const auto t0 = cc::time::SteadyClock::now();
+    auto id = co_await enqueueAsync(request, ctl);
+    if (!id) {
+        co_return poll_failure("Evaluation service did not accept the submission");
+    }
+    RunResult result = co_await awaitResult(std::move(*id), ctl);
+    if (!interrupted(ctl)) remember(request, result, t0);
+    co_return result;
+}
+
+// -------------------------------------------------
+// Lotes
+// -------------------------------------------------
+//   POST /evaluate/batch {"submissions": [RunRequest...]}
+//   {"type":"result","index":3,"result":{...RunResult}}   (en orden de finalización)
+//   {"type":"done"}
+
+std::vector<RunResult> EvalClient::submitBatch(std::span<const RunRequest> requests,
+                                               BatchCallback onResult,
+                                               const EvalBatchOptions& options,
+                                               const http::RequestControl& ctl) {
+    const std::size_t n         = requests.size();
+    const std::size_t batchSize = std::max<std::size_t>(1, options.batchSize);
+
+    std::vector<RunResult> results(n);
+    std::vector<char>      delivered(n, 0);
+    std::mutex             m;          // results/delivered y el callback
+    std::atomic<bool>      stopped{false};
+    std::atomic<bool>      unsupported{false};
+    std::atomic<std::size_t> nextBatch{0};
+    std::exception_ptr     callbackError; // lo que tiró onResult; se relanza tras los join
+
+    // false => el caller cortó (o ya había cortado). El callback corre en los workers: si
+    // tira, se corta el lote en vez de dejar escapar la excepción de un std::thread
+    auto deliver = [&](std::size_t i, RunResult r) {
+        std::lock_guard<std::mutex> lk(m);
+        if (stopped.load() || delivered[i]) return !stopped.load();
+        results[i]   = std::move(r);
+        delivered[i] = 1;
+        try {
+            if (onResult && !onResult(i, results[i])) stopped.store(true);
+        } catch (...) {
+            callbackError = std::current_exception();
+            stopped.store(true);
+        }
+        return !stopped.load();
+    };
+
+    // Lo memoizado se entrega antes de abrir lotes; solo el resto va al juez
+    std::vector<std::size_t> pending;
+    pending.reserve(n);
+    for (std::size_t i = 0; i < n && !stopped.load(); ++i) {
+        if (auto hit = cached(requests[i])) {
+            deliver(i, std::move(*hit));
+        } else {
+            pending.push_back(i);
+        }
+    }
+    const std::size_t batches = (pending.size() + batchSize - 1) / batchSize;
+
+    logging::Logger::info("Submitting " + std::to_string(pending.size()) + " evaluations in " +
+                          std::to_string(batches) + " batch(es)" +
+                          (pending.size() < n ? " (" + std::to_string(n - pending.size()) + " cached)" : ""));
+
+    // Un lote por request (posiciones [first, first + count) de `pending`); lo que no llegue
+    // lo reintenta el worker
+    auto run_batch = [&](std::size_t first, std::size_t count) {
+        json body;
+        body["submissions"] = json::array();
+        for (std::size_t k = 0; k < count; ++k) body["submissions"].push_back(to_json(requests[pending[first + k]]));
+
+        const auto t0 = cc::time::SteadyClock::now();
+        NdjsonReader feed([&](const json& j) {
+            if (j.value("type", std::string{}) != "result") return true;
+            const std::size_t k = j.value("index", count);
+            if (k >= count || !j.contains("result") || !j["result"].is_object()) return true;
+            const std::size_t i = pending[first + k];
+            RunResult r = runresult_from_json(j["result"]);
+            remember(requests[i], r, t0);
+            return deliver(i, std::move(r));
+        });
+
+        cc::metrics::count("eval.batch.requests");
+        const auto response = httpClient_.requestStreaming(
+            "POST", baseUrl_ + "/evaluate/batch", body.dump(),
+            {{"Accept", "application/x-ndjson"}},
+            [&feed](std::string_view chunk) { return feed.feed(chunk); },
+            static_cast<int>(options.timeout.count()), ctl);
+
+        if (feed.stopped()) return;
+        if (streaming_unsupported(response)) {
+            logging::Logger::info("Batch evaluation not supported (HTTP " + std::to_string(response.statusCode) +
+                                  "), submitting one by one");
+            unsupported.store(true);
+            return;
+        }
+        if (!response.isSuccess()) {
+            logging::Logger::warn("Batch evaluation failed: HTTP " + std::to_string(response.statusCode));
+            return;
+        }
+        feed.finish();
+    };
+
+    auto worker = [&] {
+        for (std::size_t b; (b = nextBatch++) < batches;) {
+            if (stopped.load() || interrupted(ctl)) return;
+            const std::size_t first = b * batchSize;
+            const std::size_t count = std::min(batchSize, pending.size() - first);
+
+            if (!unsupported.load()) {
+                try {
+                    run_batch(first, count);
+                } catch (const std::exception& e) {
+                    logging::Logger::error("Exception in EvalClient::submitBatch: " + std::string(e.what()));
+                }
+            }
+            // Lo que el lote no devolvió sale por separado
+            for (std::size_t k = 0; k < count; ++k) {
+                if (stopped.load() || interrupted(ctl)) return;
+                const std::size_t i = pending[first + k];
+                bool missing;
+                {
+                    std::lock_guard<std::mutex> lk(m);
+                    missing = !delivered[i];
+                }
+                if (!missing) continue;
+                cc::metrics::count("eval.batch.fallback");
+                const auto t0 = cc::time::SteadyClock::now();
+                RunResult r = evaluate(requests[i], ctl);
+                if (!interrupted(ctl)) remember(requests[i], r, t0);
+                if (!deliver(i, std::move(r))) return;
+            }
+        }
+    };
+
+    const std::size_t threads = std::min(std::max<std::size_t>(1, options.maxInFlight), batches);
+    std::vector<std::thread> pool;
+    for (std::size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+    if (callbackError) std::rethrow_exception(callbackError);
+
+    cc::metrics::count("eval.batch.submissions", static_cast<std::int64_t>(n));
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!delivered[i]) results[i] = poll_failure("Not evaluated: batch stopped before this submission");
+    }
+    return results;
+}
+
 } // namespace cc::sdk
@@ -1,27 +1,138 @@
 #ifndef LIB_CODECOACH_EVAL_CLIENT_H
 #define LIB_CODECOACH_EVAL_CLIENT_H
 
+#include "async/task.h"
 #include "contracts/eval_dto.h"
+#include "eval_cache.h"
 #include "http/http_client.h"
+#include "metrics/timer.h"
 
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
 #include <string>
 #include <optional>
+#include <vector>
 
 namespace cc::sdk {
 
+    // Espera del resultado en modo cola: cada GET puede quedar retenido hasta `longPoll` en el
+    // servicio; si vuelve pendiente antes de tiempo (el servicio no hace long-poll) o con error,
+    // la próxima consulta espera según `backoff` (o el Retry-After que mande el servicio).
+    struct EvalPollPolicy {
+        cc::time::Millis        longPoll{20000}; // 0 => polling corto, solo backoff
+        cc::time::BackoffPolicy backoff{
+            .base         = cc::time::Millis{50},
+            .max_delay    = cc::time::Millis{2000},
+            .max_attempts = 0, // sin límite: el deadline de `ctl` corta la espera
+            .mode         = cc::time::BackoffMode::DecorrelatedJitter,
+        };
+        // Consultas fallidas seguidas (red, 408, 429, 5xx) antes de abandonar; las respuestas
+        // "pendiente" (202/204) no cuentan. Sin deadline es lo que evita esperar para siempre
+        // con el servicio caído. 0 => sin límite.
+        int maxTransientErrors{8};
+    };
+
+    // Lotes de submitBatch(): `maxInFlight` requests de `batchSize` envíos abiertos a la vez.
+    struct EvalBatchOptions {
+        std::size_t      batchSize{64};
+        std::size_t      maxInFlight{4};
+        cc::time::Millis timeout{300000}; // por request de lote (el juez evalúa todo el lote)
+    };
+
     class EvalClient {
     private:
         http::HttpClient httpClient_;
+        http::HttpClient pollClient_; // long-polls: sin hedging ni timeouts aprendidos
         std::string      baseUrl_;
+        EvalPollPolicy   poll_;
+        std::shared_ptr<EvalResultCache> cache_;
+
+        // POST /evaluate sin pasar por la caché
+        cc::contracts::RunResult evaluate(const cc::contracts::RunRequest& request,
+                                          const http::RequestControl& ctl);
+        std::optional<cc::contracts::RunResult> cached(const cc::contracts::RunRequest& request) const;
+        void remember(const cc::contracts::RunRequest& request, const cc::contracts::RunResult& result,
+                      cc::time::SteadyClock::time_point t0) const;
 
     public:
         explicit EvalClient(const std::string& baseUrl);
 
         // Enviar código para resultado
-        cc::contracts::RunResult submit(const cc::contracts::RunRequest& request);
+        // Cancelar `ctl` aborta la evaluación en vuelo; el deadline acota todos los reintentos.
+        cc::contracts::RunResult submit(const cc::contracts::RunRequest& request,
+                                        const http::RequestControl& ctl = {});
+
+        // Recibe cada caso apenas el juez lo termina (índice en orden de evaluación).
+        // Devolver false deja de leer y corta la evaluación en el servicio.
+        using CaseCallback = std::function<bool(std::size_t index, const cc::contracts::RunCaseResult&)>;
+
+        // Como submit(), pero consumiendo POST /evaluate/stream (NDJSON: una línea por caso
+        // y una línea final de resumen) para que la GUI y los autograders vean los casos a
+        // medida que salen. Con request.failFast el juez se detiene en el primer fallo.
+        // Si el servicio no tiene el endpoint, cae a submit() y entrega los casos al final.
+        cc::contracts::RunResult submitStreaming(const cc::contracts::RunRequest& request,
+                                                 CaseCallback onCase,
+                                                 const http::RequestControl& ctl = {});
+
+        // Recibe cada resultado del lote apenas termina (índice en `requests`). Se llama de a
+        // uno; mientras corre no se leen más resultados (el servicio queda frenado por TCP).
+        // Devolver false corta los lotes en curso y no envía los que faltan.
+        using BatchCallback = std::function<bool(std::size_t index, const cc::contracts::RunResult&)>;
+
+        // Muchos envíos en pocos requests: POST /evaluate/batch con hasta `batchSize` envíos
+        // responde NDJSON con un resultado por línea en orden de finalización. Los que el lote
+        // no devolvió (corte, error) se reintentan con submit(); si el servicio no tiene el
+        // endpoint, todo va por submit() con la misma concurrencia. Resultados en el orden de
+        // `requests`; los no evaluados (corte del caller o de `ctl`) quedan con exitCode -1.
+        // `onResult` corre en hilos del lote (serializado); si tira, el lote se corta y la
+        // excepción se relanza acá, después de esperar a todos los hilos.
+        std::vector<cc::contracts::RunResult> submitBatch(std::span<const cc::contracts::RunRequest> requests,
+                                                          BatchCallback onResult = {},
+                                                          const EvalBatchOptions& options = {},
+                                                          const http::RequestControl& ctl = {});
+
+        // Variante co_await-able: no ocupa un hilo mientras el juez evalúa.
+        // El EvalClient debe sobrevivir hasta que la Task termine.
+        cc::async::Task<cc::contracts::RunResult> submitAsync(cc::contracts::RunRequest request,
+                                                              http::RequestControl ctl = {});
+
+        // Obtener resultado (nullopt si no existe o sigue pendiente)
+        std::optional<cc::contracts::RunResult> getResult(const std::string& submissionId,
+                                                          const http::RequestControl& ctl = {});
+
+        // --- Modo cola (submit-and-poll) ---
+        // POST /submissions encola la evaluación y responde 202 {"submissionId": "..."} sin
+        // esperar al juez; GET /results/{id}?waitMs=N devuelve 200 con el RunResult o 202 si
+        // sigue pendiente. Así un solo hilo sigue miles de evaluaciones en curso.
+
+        // Id de la evaluación encolada; nullopt si el servicio no la aceptó.
+        std::optional<std::string> enqueue(const cc::contracts::RunRequest& request,
+                                           const http::RequestControl& ctl = {});
+
+        cc::async::Task<std::optional<std::string>> enqueueAsync(cc::contracts::RunRequest request,
+                                                                 http::RequestControl ctl = {});
+
+        // Long-poll hasta que el resultado esté listo, sin ocupar un hilo entre consultas.
+        // Cancelación o deadline de `ctl` cortan la espera (RunResult de error, exitCode -1).
+        cc::async::Task<cc::contracts::RunResult> awaitResult(std::string submissionId,
+                                                              http::RequestControl ctl = {});
+
+        // enqueueAsync + awaitResult: el mismo resultado que submitAsync sin retener una
+        // conexión mientras el juez evalúa.
+        cc::async::Task<cc::contracts::RunResult> submitQueuedAsync(cc::contracts::RunRequest request,
+                                                                    http::RequestControl ctl = {});
+
+        void setPollPolicy(const EvalPollPolicy& policy);
 
-        // Obtener resultado
-        std::optional<cc::contracts::RunResult> getResult(const std::string& submissionId);
+        // Memoización de resultados (eval_cache.h): submit, submitAsync, submitStreaming,
+        // submitBatch y submitQueuedAsync responden desde la caché sin ir al juez y guardan
+        // los veredictos que obtienen (nunca errores del cliente o del servicio, exitCode -1).
+        // Por defecto EvalResultCache::shared(), desactivada salvo que la config la active;
+        // nullptr la apaga.
+        void setResultCache(std::shared_ptr<EvalResultCache> cache) { cache_ = std::move(cache); }
+        const std::shared_ptr<EvalResultCache>& resultCache() const { return cache_; }
     };
 
 } // namespace cc::sdk
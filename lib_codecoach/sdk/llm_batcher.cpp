@@ -0,0 +1,311 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// llm_batcher.cpp — Ventana de batching: el primer prompt abre el batch y espera `window`
+// (o hasta maxBatch prompts); quien lo cierra arma el plan bajo el lock. Plan = trabajos por
+// (system, temperatura, prefijo compartido), cada uno con sus tareas distintas y las copias
+// idénticas de cada tarea. El primer prompt de cada trabajo lo ejecuta en su propio hilo y
+// reparte los resultados; los demás esperan. Si la llamada combinada se cancela o su respuesta
+// no se puede separar, cada prompt queda en Fallback y llama al cliente interno por su cuenta.
+
+#include "llm_batcher.h"
+
+#include "config/config_manager.h"
+#include "logging/logger.h"
+#include "metrics/counters.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <utility>
+
+namespace cc::sdk {
+
+namespace {
+
+    enum class SlotState { Pending, Done, Fallback };
+
+    struct Job;
+
+    struct Slot {
+        prompts::Prompt      prompt; // copia: el caller puede irse si lo cancelan
+        SlotState            state{SlotState::Pending};
+        std::string          text;
+        std::shared_ptr<Job> job;
+    };
+
+    // tasks[i] = prompts idénticos; tasks[i][0] es el representante. tasks[0][0] ejecuta.
+    struct Job {
+        std::vector<std::vector<std::shared_ptr<Slot>>> tasks;
+    };
+
+    struct Batch {
+        std::vector<std::shared_ptr<Slot>>    slots;
+        std::chrono::steady_clock::time_point closeAt;
+        bool                                  closed{false};
+    };
+
+    constexpr auto kPollInterval = std::chrono::milliseconds(5);
+
+    bool interrupted(const http::RequestControl& ctl) {
+        return ctl.cancel.is_cancelled() || (ctl.deadline && ctl.deadline->expired());
+    }
+
+    bool batchable(const prompts::Prompt& p) {
+        return p.sharedPrefix > 0 && p.sharedPrefix <= p.user.size();
+    }
+
+    bool same_prefix(const prompts::Prompt& a, const prompts::Prompt& b) {
+        return a.sharedPrefix == b.sharedPrefix && a.temperature == b.temperature && a.system == b.system &&
+               a.user.compare(0, a.sharedPrefix, b.user, 0, b.sharedPrefix) == 0;
+    }
+
+    bool same_task(const prompts::Prompt& a, const prompts::Prompt& b) {
+        return a.maxTokens == b.maxTokens && a.temperature == b.temperature &&
+               a.version == b.version && a.system == b.system && a.user == b.user;
+    }
+
+} // namespace
+
+LlmBatchOptions LlmBatchOptions::from_config() {
+    const auto& cfg = cc::config::get();
+    LlmBatchOptions o;
+    o.window   = std::chrono::milliseconds(cfg.llm.batchWindowMs);
+    o.maxBatch = static_cast<std::size_t>(cfg.llm.batchMax);
+    return o;
+}
+
+struct BatchingLLMClient::State {
+    LlmBatchOptions         opts;
+    std::mutex              m;
+    std::condition_variable cv;
+    std::shared_ptr<Batch>  open; // batch que todavía acepta prompts
+    LlmBatchStats           stats;
+
+    void bump(std::size_t LlmBatchStats::* field, const char* metric, std::size_t n = 1) {
+        if (n == 0) return;
+        stats.*field += n;
+        cc::metrics::count(metric, static_cast<std::int64_t>(n));
+    }
+
+    // Bajo `m`: agrupa los prompts del batch en trabajos y avisa a los que esperan el plan
+    std::vector<std::shared_ptr<Job>> plan(Batch& b) {
+        b.closed = true;
+        if (open.get() == &b) open.reset();
+
+        std::vector<std::shared_ptr<Job>> jobs;
+        for (const auto& s : b.slots) {
+            std::shared_ptr<Job> home;
+            for (const auto& j : jobs) {
+                const auto& rep = j->tasks.front().front()->prompt;
+                if (opts.mergeTasks ? same_prefix(rep, s->prompt) : same_task(rep, s->prompt)) {
+                    home = j;
+                    break;
+                }
+            }
+            if (!home) {
+                home = std::make_shared<Job>();
+                jobs.push_back(home);
+            }
+            auto dup = std::find_if(home->tasks.begin(), home->tasks.end(), [&](const auto& copies) {
+                return same_task(copies.front()->prompt, s->prompt);
+            });
+            if (dup != home->tasks.end()) {
+                dup->push_back(s);
+                bump(&LlmBatchStats::deduped, "llm.batch.deduped");
+            } else {
+                home->tasks.push_back({s});
+            }
+            s->job = home;
+        }
+        bump(&LlmBatchStats::batches, "llm.batch.batches");
+        cv.notify_all();
+        return jobs;
+    }
+};
+
+BatchingLLMClient::BatchingLLMClient(std::shared_ptr<ILLMClient> inner, LlmBatchOptions opts)
+    : inner_(std::move(inner)), state_(new State{}) {
+    if (opts.maxBatch == 0) opts.maxBatch = 1;
+    state_->opts = opts;
+}
+
+BatchingLLMClient::~BatchingLLMClient() {
+    delete state_;
+}
+
+// Ejecuta un trabajo (sin el lock) y reparte los resultados entre sus prompts
+static void run_job(ILLMClient& inner, BatchingLLMClient::State& st, Job& job, const http::RequestControl& ctl) {
+    std::vector<std::string> results;
+    if (job.tasks.size() == 1) {
+        std::string text = inner.complete(job.tasks.front().front()->prompt, ctl);
+        if (!interrupted(ctl)) results.push_back(std::move(text));
+    } else {
+        std::vector<prompts::Prompt> parts;
+        parts.reserve(job.tasks.size());
+        for (const auto& copies : job.tasks) parts.push_back(copies.front()->prompt);
+
+        const std::string text = inner.complete(prompts::make_multi_task_prompt(parts), ctl);
+        if (!interrupted(ctl)) {
+            if (auto split = prompts::split_multi_task_response(text, parts.size())) {
+                results = std::move(*split);
+            } else {
+                CC_LOG_WARN("[LLM] batch: combined response for " + std::to_string(parts.size()) +
+                            " tasks is missing sections, retrying them one by one");
+                std::lock_guard<std::mutex> lk(st.m);
+                st.bump(&LlmBatchStats::splitFailed, "llm.batch.split_failed");
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lk(st.m);
+    st.bump(&LlmBatchStats::calls, "llm.batch.calls");
+    std::size_t answered = 0;
+    for (std::size_t i = 0; i < job.tasks.size(); ++i) {
+        for (const auto& s : job.tasks[i]) {
+            if (results.empty()) {
+                s->state = SlotState::Fallback;
+            } else {
+                s->state = SlotState::Done;
+                s->text  = results[i];
+                ++answered;
+            }
+        }
+    }
+    if (job.tasks.size() > 1) st.bump(&LlmBatchStats::merged, "llm.batch.merged", answered);
+    st.cv.notify_all();
+}
+
+std::string BatchingLLMClient::complete(const prompts::Prompt& prompt, const http::RequestControl& ctl) {
+    if (!batchable(prompt)) {
+        return inner_->complete(prompt, ctl);
+    }
+
+    auto slot = std::make_shared<Slot>();
+    slot->prompt = prompt;
+
+    State& st = *state_;
+    std::unique_lock<std::mutex> lk(st.m);
+    st.bump(&LlmBatchStats::prompts, "llm.batch.prompts");
+
+    std::shared_ptr<Batch> batch = st.open;
+    const bool leader = !batch;
+    if (leader) {
+        batch = std::make_shared<Batch>();
+        batch->closeAt = std::chrono::steady_clock::now() + st.opts.window;
+        st.open = batch;
+    }
+    batch->slots.push_back(slot);
+    if (batch->slots.size() >= st.opts.maxBatch) {
+        st.plan(*batch);
+    }
+
+    // El que abrió el batch lo cierra al vencer la ventana (antes si lo cancelan)
+    if (leader) {
+        while (!batch->closed) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= batch->closeAt || interrupted(ctl)) {
+                st.plan(*batch);
+                break;
+            }
+            st.cv.wait_until(lk, std::min(batch->closeAt, now + kPollInterval));
+        }
+    }
+    st.cv.wait(lk, [&] { return slot->job != nullptr; });
+
+    if (slot->job->tasks.front().front() == slot) {
+        const auto job = slot->job;
+        lk.unlock();
+        run_job(*inner_, st, *job, ctl);
+        lk.lock();
+    } else {
+        while (slot->state == SlotState::Pending) {
+            if (interrupted(ctl)) return {};
+            st.cv.wait_for(lk, kPollInterval);
+        }
+    }
+
+    if (slot->state == SlotState::Done) {
+        return std::move(slot->text);
+    }
+    if (interrupted(ctl)) return {};
+    st.bump(&LlmBatchStats::calls, "llm.batch.calls");
+    lk.unlock();
+    return inner_->complete(prompt, ctl);
+}
+
+std::vector<std::string> BatchingLLMClient::completeAll(const std::vector<prompts::Prompt>& prompts,
+                                                        const http::RequestControl& ctl) {
+    State& st = *state_;
+    std::vector<std::string> out(prompts.size());
+
+    // slots[i] == nullptr => prompt sin prefijo compartido, va directo
+    std::vector<std::shared_ptr<Slot>> slots(prompts.size());
+    Batch planned;
+    for (std::size_t i = 0; i < prompts.size(); ++i) {
+        if (!batchable(prompts[i])) continue;
+        slots[i] = std::make_shared<Slot>();
+        slots[i]->prompt = prompts[i];
+        planned.slots.push_back(slots[i]);
+    }
+
+    std::vector<std::shared_ptr<Job>> jobs;
+    {
+        std::lock_guard<std::mutex> lk(st.m);
+        st.bump(&LlmBatchStats::prompts, "llm.batch.prompts", planned.slots.size());
+        if (!planned.slots.empty()) jobs = st.plan(planned);
+    }
+
+    // Trabajos distintos (entregas distintas) van en paralelo; el primero en este hilo
+    std::vector<std::future<void>> others;
+    for (std::size_t j = 1; j < jobs.size(); ++j) {
+        others.push_back(std::async(std::launch::async, [&, job = jobs[j]] { run_job(*inner_, st, *job, ctl); }));
+    }
+    if (!jobs.empty()) run_job(*inner_, st, *jobs.front(), ctl);
+    for (auto& f : others) f.get();
+
+    for (std::size_t i = 0; i < prompts.size(); ++i) {
+        const auto& s = slots[i];
+        if (s && s->state == SlotState::Done) {
+            out[i] = std::move(s->text);
+        } else if (!interrupted(ctl)) {
+            if (s) {
+                std::lock_guard<std::mutex> lk(st.m);
+                st.bump(&LlmBatchStats::calls, "llm.batch.calls");
+            }
+            out[i] = inner_->complete(prompts[i], ctl);
+        }
+    }
+    return out;
+}
+
+std::string BatchingLLMClient::complete(const std::string& prompt,
+                                        const std::string& systemPrompt,
+                                        const http::RequestControl& ctl) {
+    return inner_->complete(prompt, systemPrompt, ctl);
+}
+
+std::string BatchingLLMClient::completeStreaming(const prompts::Prompt& prompt,
+                                                 TokenCallback onToken,
+                                                 const http::RequestControl& ctl) {
+    return inner_->completeStreaming(prompt, std::move(onToken), ctl);
+}
+
+cc::async::Task<std::string> BatchingLLMClient::completeAsync(std::string prompt,
+                                                              std::string systemPrompt,
+                                                              http::RequestControl ctl) {
+    return inner_->completeAsync(std::move(prompt), std::move(systemPrompt), std::move(ctl));
+}
+
+bool BatchingLLMClient::isAvailable() const {
+    return inner_ && inner_->isAvailable();
+}
+
+LlmBatchStats BatchingLLMClient::stats() const {
+    std::lock_guard<std::mutex> lk(state_->m);
+    return state_->stats;
+}
+
+} // namespace cc::sdk
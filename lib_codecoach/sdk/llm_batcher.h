@@ -0,0 +1,88 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// llm_batcher.h — Agrupa los prompts que llegan dentro de una ventana corta y resuelve juntos
+// los que comparten system, temperatura y prefijo (Prompt::sharedPrefix, p.ej. análisis,
+// pistas y explicación de la misma entrega armados con make_coach_prompt): una sola llamada
+// con make_multi_task_prompt cuya respuesta se separa por tarea. Los prompts idénticos se
+// resuelven una vez. Si la respuesta combinada no trae todas las secciones, cada prompt
+// vuelve a salir por separado (con el prefijo ya cacheado en el proveedor).
+//
+// Los prompts sin prefijo compartido, el streaming y completeAsync pasan directo al
+// cliente interno. Métricas en cc::metrics ("llm.batch.*").
+#ifndef LIB_CODECOACH_LLM_BATCHER_H
+#define LIB_CODECOACH_LLM_BATCHER_H
+
+#include "llm_client.h"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cc::sdk {
+
+    struct LlmBatchOptions {
+        std::chrono::milliseconds window{5}; // lo que espera el primer prompt de un batch
+        std::size_t               maxBatch{8};
+        bool                      mergeTasks{true}; // false => solo deduplica
+
+        // llm.batchWindowMs / llm.batchMax de cc::config::get()
+        static LlmBatchOptions from_config();
+    };
+
+    struct LlmBatchStats {
+        std::size_t prompts{0};     // prompts con prefijo compartido recibidos
+        std::size_t batches{0};
+        std::size_t calls{0};       // llamadas al cliente interno (incluye reintentos por separado)
+        std::size_t merged{0};      // prompts respondidos por una llamada combinada
+        std::size_t deduped{0};     // prompts idénticos a otro del mismo batch
+        std::size_t splitFailed{0}; // respuestas combinadas sin todas las secciones
+    };
+
+    class BatchingLLMClient : public ILLMClient {
+    public:
+        explicit BatchingLLMClient(std::shared_ptr<ILLMClient> inner,
+                                   LlmBatchOptions opts = LlmBatchOptions::from_config());
+        ~BatchingLLMClient() override;
+        BatchingLLMClient(const BatchingLLMClient&) = delete;
+        BatchingLLMClient& operator=(const BatchingLLMClient&) = delete;
+
+        std::string complete(const std::string& prompt,
+                             const std::string& systemPrompt = "",
+                             const http::RequestControl& ctl = {}) override;
+
+        // Espera como mucho `window` a otros prompts compatibles antes de salir.
+        std::string complete(const prompts::Prompt& prompt,
+                             const http::RequestControl& ctl = {}) override;
+
+        std::string completeStreaming(const prompts::Prompt& prompt,
+                                      TokenCallback onToken,
+                                      const http::RequestControl& ctl = {}) override;
+
+        cc::async::Task<std::string> completeAsync(std::string prompt,
+                                                   std::string systemPrompt = "",
+                                                   http::RequestControl ctl = {}) override;
+
+        bool isAvailable() const override;
+
+        // Los prompts de `prompts` forman un batch propio, sin esperar la ventana (el caller
+        // ya tiene todas las tareas de la entrega). Respuestas en el mismo orden.
+        std::vector<std::string> completeAll(const std::vector<prompts::Prompt>& prompts,
+                                             const http::RequestControl& ctl = {});
+
+        LlmBatchStats stats() const;
+
+        struct State;
+
+    private:
+        std::shared_ptr<ILLMClient> inner_;
+        // PIMPL: batch abierto, planes y contadores viven en el .cpp
+        State* state_;
+    };
+
+} // namespace cc::sdk
+
+#endif // LIB_CODECOACH_LLM_BATCHER_H
@@ -0,0 +1,430 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// llm_cache.cpp — SHA-256 de la clave, LRU en memoria y capa en disco (disk_cache.h:
+// <dir>/llm_cache.idx + <dir>/llm_cache.dat).
+
+#include "llm_cache.h"
+#include "disk_cache.h"
+
+#include "config/config_manager.h"
+#include "logging/logger.h"
+#include "metrics/counters.h"
+#include "prompts/tokenizer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace cc::sdk {
+
+namespace {
+
+// Cambia si cambia la forma de la clave: invalida todo lo guardado
+constexpr std::string_view kKeySchema = "cc-llm-cache/1";
+
+std::int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool expired(const LlmCacheEntry& e, std::int64_t nowMs, std::int64_t ttlMs) {
+    return ttlMs > 0 && e.createdMs + ttlMs <= nowMs;
+}
+
+// -------------------------------
+// SHA-256 (FIPS 180-4)
+// -------------------------------
+class Sha256 {
+public:
+    void update(std::string_view s) {
+        for (unsigned char c : s) {
+            block_[used_++] = c;
+            if (used_ == 64) {
+                compress();
+                used_ = 0;
+            }
+        }
+        bits_ += static_cast<std::uint64_t>(s.size()) * 8;
+    }
+
+    // Campo con largo delante: ("ab","c") y ("a","bc") no colisionan
+    void field(std::string_view s) {
+        std::uint8_t len[8];
+        for (int i = 0; i < 8; ++i) len[i] = static_cast<std::uint8_t>(s.size() >> (56 - 8 * i));
+        update(std::string_view(reinterpret_cast<const char*>(len), sizeof(len)));
+        update(s);
+    }
+
+    LlmCacheKey digest() {
+        const std::uint64_t bits = bits_;
+        block_[used_++] = 0x80;
+        if (used_ > 56) {
+            std::fill(block_ + used_, block_ + 64, std::uint8_t{0});
+            compress();
+            used_ = 0;
+        }
+        std::fill(block_ + used_, block_ + 56, std::uint8_t{0});
+        for (int i = 0; i < 8; ++i) block_[56 + i] = static_cast<std::uint8_t>(bits >> (56 - 8 * i));
+        compress();
+
+        LlmCacheKey out{};
+        for (int i = 0; i < 8; ++i) {
+            for (int j = 0; j < 4; ++j) out[4 * i + j] = static_cast<std::uint8_t>(h_[i] >> (24 - 8 * j));
+        }
+        return out;
+    }
+
+private:
+    static std::uint32_t rotr(std::uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+    void compress() {
+        static constexpr std::uint32_t k[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+        std::uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (std::uint32_t{block_[4 * i]} << 24) | (std::uint32_t{block_[4 * i + 1]} << 16) |
+                   (std::uint32_t{block_[4 * i + 2]} << 8) | std::uint32_t{block_[4 * i + 3]};
+        }
+        for (int i = 16; i < 64; ++i) {
+            const std::uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const std::uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        std::uint32_t a = h_[0], b = h_[1], c = h_[2], d = h_[3];
+        std::uint32_t e = h_[4], f = h_[5], g = h_[6], h = h_[7];
+        for (int i = 0; i < 64; ++i) {
+            const std::uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+            const std::uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        h_[0] += a; h_[1] += b; h_[2] += c; h_[3] += d;
+        h_[4] += e; h_[5] += f; h_[6] += g; h_[7] += h;
+    }
+
+    std::uint32_t h_[8]{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    std::uint8_t  block_[64]{};
+    std::size_t   used_{0};
+    std::uint64_t bits_{0};
+};
+
+struct KeyHash {
+    std::size_t operator()(const LlmCacheKey& k) const noexcept {
+        std::size_t h;
+        std::memcpy(&h, k.data(), sizeof(h)); // ya es uniforme
+        return h;
+    }
+};
+
+std::size_t cost_of(const LlmCacheEntry& e) {
+    return e.text.size() + sizeof(LlmCacheKey) + 64;
+}
+
+// Capa en disco: la clave SHA-256 ocupa los 32 bytes; meta = {tokens, latencyMs}
+DiskCacheFormat disk_format() {
+    return {"llm_cache", {'L', 'L', 'M'}, "[LLM] cache", "llm.cache.compactions"};
+}
+
+} // namespace
+
+// -------------------------------
+// Estado interno
+// -------------------------------
+struct LlmResponseCache::State {
+    struct Node {
+        LlmCacheEntry                    entry;
+        std::size_t                      bytes{0};
+        std::list<LlmCacheKey>::iterator pos;
+    };
+
+    mutable std::mutex                                 m;
+    LlmCacheOptions                                    opts;
+    std::list<LlmCacheKey>                             lru; // frente = más reciente
+    std::unordered_map<LlmCacheKey, Node, KeyHash>     map;
+    std::size_t                                        bytes{0};
+    DiskCacheTier                                      disk{disk_format()};
+    LlmCacheStats                                      counts; // hits/misses/evicted
+
+    std::int64_t ttl_ms() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(opts.ttl).count();
+    }
+
+    void touch(Node& n) { lru.splice(lru.begin(), lru, n.pos); }
+
+    void put(const LlmCacheKey& key, LlmCacheEntry e) {
+        const std::size_t cost = cost_of(e);
+        if (cost > opts.maxBytes) {
+            remove(key);
+            return;
+        }
+        if (auto it = map.find(key); it != map.end()) {
+            bytes -= it->second.bytes;
+            it->second.entry = std::move(e);
+            it->second.bytes = cost;
+            bytes += cost;
+            touch(it->second);
+        } else {
+            lru.push_front(key);
+            Node n;
+            n.entry = std::move(e);
+            n.bytes = cost;
+            n.pos   = lru.begin();
+            map.emplace(key, std::move(n));
+            bytes += cost;
+        }
+        while (bytes > opts.maxBytes && !lru.empty()) {
+            const LlmCacheKey victim = lru.back();
+            remove(victim);
+            ++counts.evicted;
+            cc::metrics::count("llm.cache.evicted");
+        }
+    }
+
+    void remove(const LlmCacheKey& key) {
+        auto it = map.find(key);
+        if (it == map.end()) return;
+        bytes -= it->second.bytes;
+        lru.erase(it->second.pos);
+        map.erase(it);
+    }
+};
+
+// -------------------------------
+// LlmResponseCache
+// -------------------------------
+LlmResponseCache::LlmResponseCache(LlmCacheOptions opts)
+    : state_(new State())
+{
+    state_->opts = std::move(opts);
+    if (!state_->opts.diskDir.empty() && state_->opts.diskMaxBytes > 0) {
+        state_->disk.open(state_->opts.diskDir, state_->opts.diskMaxBytes);
+    }
+}
+
+LlmResponseCache::~LlmResponseCache() {
+    delete state_;
+}
+
+std::shared_ptr<LlmResponseCache> LlmResponseCache::shared() {
+    static const std::shared_ptr<LlmResponseCache> inst = [] {
+        const auto& cfg = cc::config::get();
+        if (cfg.llm.cacheMaxBytes <= 0) return std::shared_ptr<LlmResponseCache>{};
+        LlmCacheOptions o;
+        o.maxBytes     = static_cast<std::size_t>(cfg.llm.cacheMaxBytes);
+        o.ttl          = std::chrono::seconds(cfg.llm.cacheTtlSec);
+        o.diskDir      = cfg.llm.cacheDir;
+        o.diskMaxBytes = static_cast<std::size_t>(cfg.llm.cacheDiskMaxBytes);
+        return std::make_shared<LlmResponseCache>(std::move(o));
+    }();
+    return inst;
+}
+
+LlmCacheKey LlmResponseCache::key_of(std::string_view model, const prompts::Prompt& prompt) {
+    // %.17g: el mismo double siempre da el mismo texto (y 0.2 != 0.20000001)
+    char temperature[32];
+    std::snprintf(temperature, sizeof(temperature), "%.17g", prompt.temperature);
+
+    Sha256 h;
+    h.field(kKeySchema);
+    h.field(model);
+    h.field(prompt.version);
+    h.field(prompt.system);
+    h.field(prompt.user);
+    h.field(temperature);
+    h.field(std::to_string(prompt.maxTokens)); // con otro tope la respuesta puede salir truncada
+    return h.digest();
+}
+
+std::optional<LlmCacheEntry> LlmResponseCache::lookup(const LlmCacheKey& key) {
+    std::lock_guard<std::mutex> lk(state_->m);
+    auto& st = *state_;
+    const std::int64_t now = now_ms();
+
+    if (auto it = st.map.find(key); it != st.map.end()) {
+        if (!expired(it->second.entry, now, st.ttl_ms())) {
+            st.touch(it->second);
+            ++st.counts.hits;
+            cc::metrics::count("llm.cache.hit|memory");
+            return it->second.entry;
+        }
+        st.remove(key); // el disco tiene la misma fecha: también vencida
+    } else if (auto rec = st.disk.get(key, now, st.ttl_ms())) {
+        LlmCacheEntry e;
+        e.text      = std::move(rec->value);
+        e.createdMs = rec->createdMs;
+        e.tokens    = rec->meta[0];
+        e.latencyMs = rec->meta[1];
+        st.put(key, e);
+        ++st.counts.hits;
+        ++st.counts.diskHits;
+        cc::metrics::count("llm.cache.hit|disk");
+        return e;
+    }
+
+    ++st.counts.misses;
+    cc::metrics::count("llm.cache.miss");
+    return std::nullopt;
+}
+
+void LlmResponseCache::store(const LlmCacheKey& key, LlmCacheEntry entry) {
+    const std::int64_t now = now_ms();
+    entry.createdMs = now;
+
+    DiskCacheRecord rec;
+    rec.value     = entry.text;
+    rec.createdMs = now;
+    rec.meta[0]   = entry.tokens;
+    rec.meta[1]   = entry.latencyMs;
+
+    std::lock_guard<std::mutex> lk(state_->m);
+    state_->disk.put(key, rec, now, state_->ttl_ms());
+    state_->put(key, std::move(entry));
+}
+
+void LlmResponseCache::clear() {
+    std::lock_guard<std::mutex> lk(state_->m);
+    state_->map.clear();
+    state_->lru.clear();
+    state_->bytes = 0;
+    state_->disk.clear();
+}
+
+LlmCacheStats LlmResponseCache::stats() const {
+    std::lock_guard<std::mutex> lk(state_->m);
+    LlmCacheStats s = state_->counts;
+    s.entries     = state_->map.size();
+    s.bytes       = state_->bytes;
+    s.diskEntries = state_->disk.entries();
+    s.diskBytes   = state_->disk.bytes();
+    s.compactions = state_->disk.compactions();
+    return s;
+}
+
+// -------------------------------
+// CachingLLMClient
+// -------------------------------
+
+// Tokens de prompt + completion con el tokenizer del modelo (estimados si no hay vocabulario)
+static std::uint32_t count_tokens(std::string_view model, const prompts::Prompt& p, const std::string& text) {
+    const prompts::Tokenizer& tok = prompts::tokenizer_for(model);
+    return static_cast<std::uint32_t>(tok.count(p.system) + tok.count(p.user) + tok.count(text));
+}
+
+static bool interrupted(const http::RequestControl& ctl) {
+    return ctl.cancel.is_cancelled() || (ctl.deadline && ctl.deadline->expired());
+}
+
+static prompts::Prompt make_prompt(const std::string& user, const std::string& system) {
+    prompts::Prompt p;
+    p.user   = user;
+    p.system = system;
+    return p;
+}
+
+CachingLLMClient::CachingLLMClient(std::shared_ptr<ILLMClient> inner,
+                                   std::string model,
+                                   std::shared_ptr<LlmResponseCache> cache)
+    : inner_(std::move(inner)), model_(std::move(model)), cache_(std::move(cache)) {}
+
+std::optional<std::string> CachingLLMClient::cached(const LlmCacheKey& key) const {
+    if (!cache_) return std::nullopt;
+    auto hit = cache_->lookup(key);
+    if (!hit) return std::nullopt;
+    cc::metrics::count("llm.cache.saved_tokens", hit->tokens);
+    cc::metrics::count("llm.cache.saved_ms", hit->latencyMs);
+    return std::move(hit->text);
+}
+
+void CachingLLMClient::remember(const LlmCacheKey& key, const prompts::Prompt& prompt,
+                                const std::string& text, std::chrono::steady_clock::time_point t0) const {
+    if (!cache_ || text.empty()) return;
+    LlmCacheEntry e;
+    e.text      = text;
+    e.tokens    = count_tokens(model_, prompt, text);
+    e.latencyMs = static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count());
+    cache_->store(key, std::move(e));
+}
+
+// complete(user, system) del cliente interno ignora maxTokens/temperature: la clave usa los
+// defaults de Prompt, igual que OpenAIClient al delegar.
+std::string CachingLLMClient::complete(const std::string& prompt,
+                                       const std::string& systemPrompt,
+                                       const http::RequestControl& ctl) {
+    const prompts::Prompt p = make_prompt(prompt, systemPrompt);
+    const LlmCacheKey key = LlmResponseCache::key_of(model_, p);
+    if (auto hit = cached(key)) return std::move(*hit);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::string text = inner_->complete(prompt, systemPrompt, ctl);
+    if (!interrupted(ctl)) remember(key, p, text, t0);
+    return text;
+}
+
+std::string CachingLLMClient::complete(const prompts::Prompt& prompt, const http::RequestControl& ctl) {
+    const LlmCacheKey key = LlmResponseCache::key_of(model_, prompt);
+    if (auto hit = cached(key)) return std::move(*hit);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::string text = inner_->complete(prompt, ctl);
+    if (!interrupted(ctl)) remember(key, prompt, text, t0);
+    return text;
+}
+
+std::string CachingLLMClient::completeStreaming(const prompts::Prompt& prompt,
+                                                TokenCallback onToken,
+                                                const http::RequestControl& ctl) {
+    const LlmCacheKey key = LlmResponseCache::key_of(model_, prompt);
+    if (auto hit = cached(key)) {
+        if (onToken) onToken(*hit);
+        return std::move(*hit);
+    }
+
+    // Si el caller corta el stream el texto queda incompleto: no se guarda
+    bool stopped = false;
+    const auto t0 = std::chrono::steady_clock::now();
+    std::string text = inner_->completeStreaming(prompt, [&](std::string_view token) {
+        if (onToken && !onToken(token)) {
+            stopped = true;
+            return false;
+        }
+        return true;
+    }, ctl);
+    if (!stopped && !interrupted(ctl)) remember(key, prompt, text, t0);
+    return text;
+}
+
+cc::async::Task<std::string> CachingLLMClient::completeAsync(std::string prompt,
+                                                             std::string systemPrompt,
+                                                             http::RequestControl ctl) {
+    const prompts::Prompt p = make_prompt(prompt, systemPrompt);
+    const LlmCacheKey key = LlmResponseCache::key_of(model_, p);
+    if (auto hit = cached(key)) co_return std::move(*hit);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::string text = co_await inner_->completeAsync(std::move(prompt), std::move(systemPrompt), ctl);
+    if (!interrupted(ctl)) remember(key, p, text, t0);
+    co_return text;
+}
+
+bool CachingLLMClient::isAvailable() const {
+    return inner_ && inner_->isAvailable();
+}
+
+} // namespace cc::sdk
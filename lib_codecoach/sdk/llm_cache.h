@@ -0,0 +1,130 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// llm_cache.h — Caché de respuestas del LLM direccionada por contenido: la clave es el
+// SHA-256 de (modelo, system, user, temperature, maxTokens, versión del prompt), así que el
+// mismo código equivocado enviado por muchos alumnos al mismo problema paga una sola llamada.
+// Dos capas: LRU en memoria con presupuesto de bytes y, opcional, una capa en disco que
+// sobrevive al proceso (índice hash mapeado en memoria + archivo de datos append-only, con
+// compactación al llegar al tope). Ambas respetan un TTL. Thread-safe.
+//
+// CachingLLMClient decora cualquier ILLMClient con esta caché y reporta aciertos, tokens y
+// latencia ahorrados en cc::metrics ("llm.cache.*").
+#ifndef LIB_CODECOACH_LLM_CACHE_H
+#define LIB_CODECOACH_LLM_CACHE_H
+
+#include "llm_client.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace cc::sdk {
+
+    using LlmCacheKey = std::array<std::uint8_t, 32>; // SHA-256
+
+    struct LlmCacheOptions {
+        std::size_t          maxBytes{4 * 1024 * 1024};        // presupuesto en memoria (texto + clave)
+        std::chrono::seconds ttl{std::chrono::hours(24 * 7)};  // 0 => no vence
+        std::string          diskDir;                          // vacío => solo memoria
+        std::size_t          diskMaxBytes{256 * 1024 * 1024};  // tope del archivo de datos
+    };
+
+    struct LlmCacheEntry {
+        std::string   text;          // completion tal como la devolvió el modelo
+        std::uint32_t tokens{0};     // tokens (prompt + completion) que costó generarla
+        std::uint32_t latencyMs{0};  // lo que tardó la llamada original
+        std::int64_t  createdMs{0};  // epoch (system_clock); lo pone store()
+    };
+
+    struct LlmCacheStats {
+        std::size_t entries{0};      // en memoria
+        std::size_t bytes{0};
+        std::size_t diskEntries{0};
+        std::size_t diskBytes{0};    // archivo de datos, incluidas entradas vencidas/reemplazadas
+        std::size_t hits{0};         // acumulados desde la construcción
+        std::size_t diskHits{0};     // subconjunto de hits que vino del disco
+        std::size_t misses{0};
+        std::size_t evicted{0};
+        std::size_t compactions{0};
+    };
+
+    class LlmResponseCache {
+    public:
+        explicit LlmResponseCache(LlmCacheOptions opts = {});
+        ~LlmResponseCache();
+        LlmResponseCache(const LlmResponseCache&) = delete;
+        LlmResponseCache& operator=(const LlmResponseCache&) = delete;
+
+        // Instancia del proceso, configurada desde cc::config::get().llm en el primer uso.
+        // nullptr si la caché está desactivada (llm.cacheMaxBytes = 0).
+        static std::shared_ptr<LlmResponseCache> shared();
+
+        static LlmCacheKey key_of(std::string_view model, const prompts::Prompt& prompt);
+
+        // Busca en memoria y, si no está, en disco (y la sube a memoria). Las entradas
+        // vencidas cuentan como miss.
+        std::optional<LlmCacheEntry> lookup(const LlmCacheKey& key);
+
+        void store(const LlmCacheKey& key, LlmCacheEntry entry);
+
+        void clear(); // memoria y disco
+
+        LlmCacheStats stats() const;
+
+        struct State;
+
+    private:
+        // PIMPL: LRU, índice mapeado y archivo de datos viven en el .cpp
+        State* state_;
+    };
+
+    // Decorador: sirve desde la caché las completions ya vistas y delega el resto en `inner`.
+    // Solo se guardan respuestas completas (no vacías, sin cancelación ni corte desde onToken).
+    class CachingLLMClient : public ILLMClient {
+    public:
+        // `model` entra en la clave: dos modelos distintos nunca comparten respuestas.
+        // Sin caché (nullptr) el decorador es transparente.
+        CachingLLMClient(std::shared_ptr<ILLMClient> inner,
+                         std::string model,
+                         std::shared_ptr<LlmResponseCache> cache = LlmResponseCache::shared());
+
+        std::string complete(const std::string& prompt,
+                             const std::string& systemPrompt = "",
+                             const http::RequestControl& ctl = {}) override;
+
+        std::string complete(const prompts::Prompt& prompt,
+                             const http::RequestControl& ctl = {}) override;
+
+        // Un acierto entrega el texto guardado en un solo callback.
+        std::string completeStreaming(const prompts::Prompt& prompt,
+                                      TokenCallback onToken,
+                                      const http::RequestControl& ctl = {}) override;
+
+        cc::async::Task<std::string> completeAsync(std::string prompt,
+                                                   std::string systemPrompt = "",
+                                                   http::RequestControl ctl = {}) override;
+
+        bool isAvailable() const override;
+
+        const std::shared_ptr<LlmResponseCache>& cache() const { return cache_; }
+
+    private:
+        std::optional<std::string> cached(const LlmCacheKey& key) const;
+        void remember(const LlmCacheKey& key, const prompts::Prompt& prompt,
+                      const std::string& text, std::chrono::steady_clock::time_point t0) const;
+
+        std::shared_ptr<ILLMClient>       inner_;
+        std::string                       model_;
+        std::shared_ptr<LlmResponseCache> cache_;
+    };
+
+} // namespace cc::sdk
+
+#endif // LIB_CODECOACH_LLM_CACHE_H
@@ -0,0 +1,33 @@
+//
+// Created by andres on 5/10/25.
+//
+
+#include "llm_client.h"
+#include "async/executor.h"
+
+namespace cc::sdk {
+
+std::string ILLMClient::complete(const prompts::Prompt& prompt, const http::RequestControl& ctl) {
+    return complete(prompt.user, prompt.system, ctl);
+}
+
+std::string ILLMClient::completeStreaming(const prompts::Prompt& prompt,
+                                          TokenCallback onToken,
+                                          const http::RequestControl& ctl) {
+    std::string text = complete(prompt, ctl);
+    if (!text.empty() && onToken) onToken(text);
+    return text;
+}
+
+cc::async::Task<std::string> ILLMClient::completeAsync(std::string prompt,
+                                                       std::string systemPrompt,
+                                                       http::RequestControl ctl) {
+    co_await cc::async::Executor::global().schedule();
+
+    if (ctl.cancel.is_cancelled() || (ctl.deadline && ctl.deadline->expired())) {
+        co_return std::string{};
+    }
+    co_return complete(prompt, systemPrompt, ctl);
+}
+
+} // namespace cc::sdk
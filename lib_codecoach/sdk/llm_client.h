@@ -5,7 +5,13 @@
 #ifndef LIB_CODECOACH_LLM_CLIENT_H
 #define LIB_CODECOACH_LLM_CLIENT_H
 
+#include "async/task.h"
+#include "http/http_client.h"
+#include "prompts/coach_prompts.h"
+
+#include <functional>
 #include <string>
+#include <string_view>
 
 namespace cc::sdk {
 
@@ -14,9 +20,34 @@ namespace cc::sdk {
     public:
         virtual ~ILLMClient() = default;
 
+        // Recibe cada trozo de texto (uno o más tokens) apenas el modelo lo genera.
+        // Devolver false corta la generación.
+        using TokenCallback = std::function<bool(std::string_view token)>;
+
         // Completar un prompt con el LLM
+        // `ctl` cancela la llamada en vuelo y acota reintentos al deadline.
         virtual std::string complete(const std::string& prompt,
-                                     const std::string& systemPrompt = "") = 0;
+                                     const std::string& systemPrompt = "",
+                                     const http::RequestControl& ctl = {}) = 0;
+
+        // Prompt ya armado (system/user/maxTokens/temperature). Por defecto delega en
+        // complete(user, system), que ignora maxTokens/temperature.
+        virtual std::string complete(const prompts::Prompt& prompt,
+                                     const http::RequestControl& ctl = {});
+
+        // Streaming: `onToken` recibe el texto a medida que llega (la GUI lo puede ir
+        // mostrando); devuelve el texto completo, "" si falló. Por defecto llama a
+        // complete(prompt) y entrega todo el texto en un solo callback.
+        virtual std::string completeStreaming(const prompts::Prompt& prompt,
+                                              TokenCallback onToken,
+                                              const http::RequestControl& ctl = {});
+
+        // Variante co_await-able. Por defecto ejecuta complete() en el Executor global
+        // (ocupa un hilo del pool); los clientes HTTP la sobreescriben sin bloquear.
+        // El cliente debe sobrevivir hasta que la Task termine.
+        virtual cc::async::Task<std::string> completeAsync(std::string prompt,
+                                                           std::string systemPrompt = "",
+                                                           http::RequestControl ctl = {});
 
         // Verificar si el cliente está disponible (tiene API key, etc)
         virtual bool isAvailable() const = 0;
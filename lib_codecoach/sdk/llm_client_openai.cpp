@@ -3,77 +3,207 @@
 //
 
 #include "llm_client_openai.h"
+#include "async/http_awaitable.h"
+#include "http/rate_limiter.h"
+#include "http/sse_parser.h"
 #include "logging/logger.h"
 
+#include <nlohmann/json.hpp>
+
+#include <optional>
+
 namespace cc::sdk {
 
-OpenAIClient::OpenAIClient(const std::string& apiKey, const std::string& model)
-    : apiKey_(apiKey), model_(model) {
+using nlohmann::json;
+
+// complete(user, system): sin maxTokens/temperature propios, los defaults de Prompt
+static prompts::Prompt make_prompt(const std::string& user, const std::string& system) {
+    prompts::Prompt p;
+    p.user   = user;
+    p.system = system;
+    return p;
+}
+
+// Body de POST /chat/completions
+static std::string chat_body(const std::string& model, const prompts::Prompt& p, bool stream) {
+    json body;
+    body["model"] = model;
+    body["messages"] = json::array();
+    if (!p.system.empty()) {
+        body["messages"].push_back({{"role", "system"}, {"content", p.system}});
+    }
+    body["messages"].push_back({{"role", "user"}, {"content", p.user}});
+    if (p.maxTokens > 0) body["max_tokens"] = p.maxTokens;
+    body["temperature"] = p.temperature;
+    if (stream) body["stream"] = true;
+    return body.dump();
+}
+
+// choices[0].message.content de una respuesta completa; nullopt si el formato no es el esperado
+static std::optional<std::string> content_of(const std::string& responseBody) {
+    const json j = json::parse(responseBody, nullptr, false);
+    if (j.is_discarded() || !j.contains("choices") || !j["choices"].is_array() || j["choices"].empty()) {
+        return std::nullopt;
+    }
+    const auto& choice = j["choices"][0];
+    if (!choice.contains("message") || !choice["message"].contains("content") ||
+        !choice["message"]["content"].is_string()) {
+        return std::nullopt;
+    }
+    return choice["message"]["content"].get<std::string>();
+}
+
+static void log_api_error(const http::HttpResponse& response) {
+    logging::Logger::error("OpenAI API error: " + std::to_string(response.statusCode));
+    logging::Logger::error("Response body: " + response.body);
+}
+
+OpenAIClient::OpenAIClient(const std::string& apiKey, const std::string& model, const std::string& baseUrl)
+    : apiKey_(apiKey), model_(model), completionsUrl_(baseUrl + "/chat/completions") {
     httpClient_.setTimeout(60000); // 60 segundos
     httpClient_.setDefaultHeader("Content-Type", "application/json");
     httpClient_.setDefaultHeader("Authorization", "Bearer " + apiKey);
+
+    // Cuota del proveedor (QPS y requests simultáneos) compartida por todos los clientes
+    const auto& http = cc::config::get().http;
+    http::apply_service_quota(completionsUrl_, http.llmQps, http.llmMaxInFlight);
 }
 
 std::string OpenAIClient::complete(const std::string& prompt,
-                                   const std::string& systemPrompt) {
-    std::string url = "https://api.openai.com/v1/chat/completions";
+                                   const std::string& systemPrompt,
+                                   const http::RequestControl& ctl) {
+    return complete(make_prompt(prompt, systemPrompt), ctl);
+}
 
+std::string OpenAIClient::complete(const prompts::Prompt& prompt, const http::RequestControl& ctl) {
     logging::Logger::info("Calling OpenAI API with model: " + model_);
 
     try {
-        // NOTA: En producción, construir JSON request con nlohmann/json:
-        /*
-        json requestBody;
-        requestBody["model"] = model_;
-        requestBody["temperature"] = 0.7;
-        requestBody["max_tokens"] = 1500;
-
-        if (!systemPrompt.empty()) {
-            requestBody["messages"][0]["role"] = "system";
-            requestBody["messages"][0]["content"] = systemPrompt;
-            requestBody["messages"][1]["role"] = "user";
-            requestBody["messages"][1]["content"] = prompt;
-        } else {
-            requestBody["messages"][0]["role"] = "user";
-            requestBody["messages"][0]["content"] = prompt;
+        auto response = httpClient_.request("POST", completionsUrl_, chat_body(model_, prompt, false),
+                                            {}, std::nullopt, ctl);
+
+        if (!response.isSuccess()) {
+            log_api_error(response);
+            return "";
         }
 
-        std::string jsonBody = requestBody.dump();
-        */
+        auto content = content_of(response.body);
+        if (!content) {
+            logging::Logger::error("Unexpected OpenAI response format");
+            return "";
+        }
+
+        logging::Logger::info("OpenAI API call successful");
+        return std::move(*content);
+
+    } catch (const std::exception& e) {
+        logging::Logger::error("Exception in OpenAIClient: " + std::string(e.what()));
+        return "";
+    }
+}
+
+std::string OpenAIClient::completeStreaming(const prompts::Prompt& prompt,
+                                            TokenCallback onToken,
+                                            const http::RequestControl& ctl) {
+    logging::Logger::info("Calling OpenAI API (stream) with model: " + model_);
+
+    std::string text;
+    bool stoppedByCaller = false;
+    bool streamError     = false;
+
+    // Cada evento: {"choices":[{"delta":{"content":"..."}}]}; el último es "[DONE]"
+    http::SseParser sse([&](const http::SseEvent& ev) {
+        if (ev.data == "[DONE]") return true;
+
+        const json j = json::parse(ev.data, nullptr, false);
+        if (j.is_discarded()) {
+            logging::Logger::error("OpenAI stream: unparseable event: " + ev.data);
+            streamError = true;
+            return false;
+        }
+        if (j.contains("error")) {
+            logging::Logger::error("OpenAI stream error: " + j["error"].dump());
+            streamError = true;
+            return false;
+        }
+        if (!j.contains("choices") || !j["choices"].is_array() || j["choices"].empty()) return true;
 
-        std::string jsonBody = "{}"; // Stub
+        const auto& delta = j["choices"][0].value("delta", json::object());
+        if (!delta.contains("content") || !delta["content"].is_string()) return true; // p.ej. el rol
+        const auto& token = delta["content"].get_ref<const std::string&>();
+        if (token.empty()) return true;
 
-        auto response = httpClient_.post(url, jsonBody);
+        text.append(token);
+        if (onToken && !onToken(token)) {
+            stoppedByCaller = true;
+            return false;
+        }
+        return true;
+    });
 
+    try {
+        auto response = httpClient_.requestStreaming(
+            "POST", completionsUrl_, chat_body(model_, prompt, true),
+            {{"Accept", "text/event-stream"}},
+            [&sse](std::string_view chunk) { return sse.feed(chunk); },
+            std::nullopt, ctl);
+
+        if (stoppedByCaller) {
+            logging::Logger::info("OpenAI stream stopped by caller");
+            return text;
+        }
         if (!response.isSuccess()) {
-            logging::Logger::error("OpenAI API error: " + std::to_string(response.statusCode));
-            logging::Logger::error("Response body: " + response.body);
+            if (!streamError) log_api_error(response);
             return "";
         }
+        sse.finish();
+        if (streamError) return "";
 
-        // NOTA: En producción, parsear response JSON:
-        /*
-        auto responseJson = json::parse(response.body);
+        logging::Logger::info("OpenAI API stream complete (" + std::to_string(sse.events()) + " events)");
+        return text;
 
-        if (responseJson.contains("choices") && !responseJson["choices"].empty()) {
-            return responseJson["choices"][0]["message"]["content"];
+    } catch (const std::exception& e) {
+        logging::Logger::error("Exception in OpenAIClient: " + std::string(e.what()));
+        return "";
+    }
+}
+
+cc::async::Task<std::string> OpenAIClient::completeAsync(std::string prompt,
+                                                         std::string systemPrompt,
+                                                         http::RequestControl ctl) {
+    logging::Logger::info("Calling OpenAI API (async) with model: " + model_);
+
+    std::string jsonBody = chat_body(model_, make_prompt(prompt, systemPrompt), false);
+
+    std::string error;
+    try {
+        auto response = co_await cc::async::http_request(httpClient_, "POST", completionsUrl_,
+                                                         std::move(jsonBody), {}, std::move(ctl));
+
+        if (!response.isSuccess()) {
+            log_api_error(response);
+            co_return std::string{};
         }
 
-        logging::Logger::error("Unexpected OpenAI response format");
-        return "";
-        */
+        auto content = content_of(response.body);
+        if (!content) {
+            logging::Logger::error("Unexpected OpenAI response format");
+            co_return std::string{};
+        }
 
         logging::Logger::info("OpenAI API call successful");
-        return ""; // Stub
+        co_return std::move(*content);
 
     } catch (const std::exception& e) {
-        logging::Logger::error("Exception in OpenAIClient: " + std::string(e.what()));
-        return "";
+        error = e.what();
     }
+
+    logging::Logger::error("Exception in OpenAIClient: " + error);
+    co_return std::string{};
 }
 
 bool OpenAIClient::isAvailable() const{
     return !apiKey_.empty();
 }
 
-} // namespace cc::sdk
\ No newline at end of file
+} // namespace cc::sdk
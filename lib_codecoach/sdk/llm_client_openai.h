@@ -11,19 +11,39 @@
 
 namespace cc::sdk {
 
+    // Cliente de POST /chat/completions (OpenAI o cualquier API compatible).
     class OpenAIClient : public ILLMClient {
     private:
         std::string apiKey_;
         std::string model_;
+        std::string completionsUrl_;
         http::HttpClient httpClient_;
 
     public:
         // model: "gpt-4-turbo-preview", "gpt-3.5-turbo", etc
+        // baseUrl: raíz de la API sin '/' final (p.ej. un proxy o un servidor local compatible)
         explicit OpenAIClient(const std::string& apiKey,
-                             const std::string& model = "gpt-3.5-turbo");
+                             const std::string& model = "gpt-3.5-turbo",
+                             const std::string& baseUrl = "https://api.openai.com/v1");
 
         std::string complete(const std::string& prompt,
-                            const std::string& systemPrompt = "") override;
+                            const std::string& systemPrompt = "",
+                            const http::RequestControl& ctl = {}) override;
+
+        std::string complete(const prompts::Prompt& prompt,
+                             const http::RequestControl& ctl = {}) override;
+
+        // "stream": true; consume los eventos text/event-stream a medida que llegan. Con
+        // cancelación en `ctl` la transferencia corre en el hilo de I/O del AsyncEngine y
+        // `onToken` también: no debe bloquear. Si onToken devuelve false se corta la
+        // generación y se devuelve el texto recibido hasta ahí.
+        std::string completeStreaming(const prompts::Prompt& prompt,
+                                      TokenCallback onToken,
+                                      const http::RequestControl& ctl = {}) override;
+
+        cc::async::Task<std::string> completeAsync(std::string prompt,
+                                                   std::string systemPrompt = "",
+                                                   http::RequestControl ctl = {}) override;
 
         bool isAvailable() const override;
 
@@ -31,4 +51,4 @@ namespace cc::sdk {
 
 } // namespace cc::sdk
 
-#endif //LIB_CODECOACH_LLM_CLIENT_OPENAI_H
\ No newline at end of file
+#endif //LIB_CODECOACH_LLM_CLIENT_OPENAI_H
@@ -2,6 +2,7 @@
 //
 
 #include "problems_client.h"
+#include "async/http_awaitable.h"
 #include "logging/logger.h"
 
 #include <nlohmann/json.hpp>
@@ -75,7 +76,8 @@ from_json_detail(const json& j) {
     }
 
     // Campos propios de ProblemDetail
-    p.statement = j.value("statement", "");
+    p.statement      = j.value("statement", "");
+    p.testSetVersion = j.value("testSetVersion", "");
 
     if (j.contains("samples") && j["samples"].is_array()) {
         for (const auto& js : j["samples"]) {
@@ -89,6 +91,22 @@ from_json_detail(const json& j) {
     return p;
 }
 
+// Interpreta la respuesta de GET /problems/{id} (común a get y getAsync)
+std::optional<cc::contracts::ProblemDetail>
+handle_detail_response(const std::string& id, const cc::http::HttpResponse& response) {
+    if (!response.isSuccess()) {
+        Logger::warn("Problem not found or HTTP error: " + id +
+                     " (status " + std::to_string(response.statusCode) + ")");
+        return std::nullopt;
+    }
+
+    json j = json::parse(response.body);
+    auto detail = from_json_detail(j);
+
+    Logger::info("Problem detail fetched: " + id);
+    return detail;
+}
+
 } // namespace (helpers anónimos)
 
 // ==========================
@@ -97,14 +115,38 @@ from_json_detail(const json& j) {
 
 ProblemsClient::ProblemsClient(const std::string& baseUrl)
     : baseUrl_(baseUrl)
+    , evalCache_(EvalResultCache::shared())
 {
     httpClient_.setTimeout(5000);
     httpClient_.setDefaultHeader("Content-Type", "application/json");
+
+    // Opcional (CODECOACH_HTTP_HEDGE_PERCENTILE): los GET (idempotentes) se hedgean al pN de
+    // la latencia observada y cortan la cola que dejan los backends lentos ocasionales.
+    if (const int p = cc::config::get().http.hedgePercentile; p > 0) {
+        http::HedgePolicy hedge;
+        hedge.percentile = p / 100.0;
+        httpClient_.setHedging(hedge);
+    }
+    // Listas y enunciados cambian poco: GET con caché HTTP (ETag/Cache-Control del servicio)
+    httpClient_.setResponseCache(http::ResponseCache::shared());
+    // Varias vistas piden el mismo listado a la vez: una sola transferencia para todas
+    httpClient_.setSingleFlight(true);
+}
+
+// El servicio de problemas es quien versiona los tests: enterarse acá invalida lo memoizado
+// antes de que un envío vaya al juez, sin esperar a que el juez informe la versión nueva
+void ProblemsClient::note_test_set(const std::string& id,
+                                   const std::optional<cc::contracts::ProblemDetail>& detail) const {
+    if (!evalCache_ || !detail || detail->testSetVersion.empty()) return;
+    if (evalCache_->setTestSetVersion(id, detail->testSetVersion)) {
+        Logger::info("Test set version changed for problem " + id + ": " + detail->testSetVersion);
+    }
 }
 
 std::vector<cc::contracts::ProblemSummary>
 ProblemsClient::list(const std::string& category,
-                     const std::string& difficulty)
+                     const std::string& difficulty,
+                     const http::RequestControl& ctl)
 {
     std::string url = baseUrl_ + "/problems";
 
@@ -125,7 +167,7 @@ ProblemsClient::list(const std::string& category,
     std::vector<cc::contracts::ProblemSummary> problems;
 
     try {
-        auto response = httpClient_.get(url);
+        auto response = httpClient_.request("GET", url, {}, {}, std::nullopt, ctl);
 
         if (!response.isSuccess()) {
             Logger::error("Failed to fetch problems: HTTP "
@@ -156,24 +198,15 @@ ProblemsClient::list(const std::string& category,
 }
 
 std::optional<cc::contracts::ProblemDetail>
-ProblemsClient::get(const std::string& id) {
+ProblemsClient::get(const std::string& id, const http::RequestControl& ctl) {
     std::string url = baseUrl_ + "/problems/" + id;
 
     Logger::debug("Fetching problem detail: " + id);
 
     try {
-        auto response = httpClient_.get(url);
-
-        if (!response.isSuccess()) {
-            Logger::warn("Problem not found or HTTP error: " + id +
-                         " (status " + std::to_string(response.statusCode) + ")");
-            return std::nullopt;
-        }
-
-        json j = json::parse(response.body);
-        auto detail = from_json_detail(j);
-
-        Logger::info("Problem detail fetched: " + id);
+        auto response = httpClient_.request("GET", url, {}, {}, std::nullopt, ctl);
+        auto detail = handle_detail_response(id, response);
+        note_test_set(id, detail);
         return detail;
 
     } catch (const std::exception& e) {
@@ -183,7 +216,30 @@ ProblemsClient::get(const std::string& id) {
     }
 }
 
-std::string ProblemsClient::create(const cc::contracts::ProblemDetail& problem) {
+cc::async::Task<std::optional<cc::contracts::ProblemDetail>>
+ProblemsClient::getAsync(std::string id, http::RequestControl ctl) {
+    std::string url = baseUrl_ + "/problems/" + id;
+
+    Logger::debug("Fetching problem detail (async): " + id);
+
+    std::string error;
+    try {
+        auto response = co_await cc::async::http_request(httpClient_, "GET", url,
+                                                         {}, {}, std::move(ctl));
+        auto detail = handle_detail_response(id, response);
+        note_test_set(id, detail);
+        co_return detail;
+
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+
+    Logger::error("Exception in ProblemsClient::getAsync: " + error);
+    co_return std::nullopt;
+}
+
+std::string ProblemsClient::create(const cc::contracts::ProblemDetail& problem,
+                                   const http::RequestControl& ctl) {
     std::string url = baseUrl_ + "/problems";
 
     Logger::info("Creating new problem: " + problem.title);
@@ -192,7 +248,7 @@ std::string ProblemsClient::create(const cc::contracts::ProblemDetail& problem)
         json bodyJson = to_json(problem);
         std::string body = bodyJson.dump();
 
-        auto response = httpClient_.post(url, body);
+        auto response = httpClient_.request("POST", url, body, {}, std::nullopt, ctl);
 
         if (!response.isSuccess()) {
             Logger::error("Failed to create problem: HTTP "
@@ -221,7 +277,8 @@ std::string ProblemsClient::create(const cc::contracts::ProblemDetail& problem)
 }
 
 bool ProblemsClient::update(const std::string& id,
-                            const cc::contracts::ProblemDetail& problem)
+                            const cc::contracts::ProblemDetail& problem,
+                            const http::RequestControl& ctl)
 {
     std::string url = baseUrl_ + "/problems/" + id;
 
@@ -231,7 +288,7 @@ bool ProblemsClient::update(const std::string& id,
         json bodyJson = to_json(problem);
         std::string body = bodyJson.dump();
 
-        auto response = httpClient_.put(url, body);
+        auto response = httpClient_.request("PUT", url, body, {}, std::nullopt, ctl);
         bool success = response.isSuccess();
 
         if (success) {
@@ -250,13 +307,13 @@ bool ProblemsClient::update(const std::string& id,
     }
 }
 
-bool ProblemsClient::remove(const std::string& id) {
+bool ProblemsClient::remove(const std::string& id, const http::RequestControl& ctl) {
     std::string url = baseUrl_ + "/problems/" + id;
 
     Logger::info("Deleting problem: " + id);
 
     try {
-        auto response = httpClient_.del(url);
+        auto response = httpClient_.request("DELETE", url, {}, {}, std::nullopt, ctl);
         bool success = response.isSuccess();
 
         if (success) {
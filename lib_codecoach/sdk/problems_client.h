@@ -1,9 +1,12 @@
 #ifndef LIB_CODECOACH_PROBLEMS_CLIENT_H
 #define LIB_CODECOACH_PROBLEMS_CLIENT_H
 
+#include "async/task.h"
 #include "contracts/problem_dto.h"
 #include "http/http_client.h"
+#include "sdk/eval_cache.h"
 
+#include <memory>
 #include <vector>
 #include <string>
 #include <optional>
@@ -14,28 +17,48 @@ namespace cc::sdk {
     private:
         http::HttpClient httpClient_;
         std::string      baseUrl_;
+        std::shared_ptr<EvalResultCache> evalCache_;
+
+        void note_test_set(const std::string& id,
+                           const std::optional<cc::contracts::ProblemDetail>& detail) const;
 
     public:
         explicit ProblemsClient(const std::string& baseUrl);
 
         // Listar problemas (con filtro opcional)
+        // Todas las llamadas aceptan un RequestControl: cancelar aborta la transferencia en
+        // curso y el deadline acota la llamada completa (reintentos incluidos).
         std::vector<cc::contracts::ProblemSummary> list(
             const std::string& category   = "",
-            const std::string& difficulty = ""
+            const std::string& difficulty = "",
+            const http::RequestControl& ctl = {}
         );
 
-        // Obtener detalle de un problema
-        std::optional<cc::contracts::ProblemDetail> get(const std::string& id);
+        // Obtener detalle de un problema. Su testSetVersion se informa a la caché de
+        // evaluaciones: lo memoizado contra un set de tests anterior deja de servirse.
+        std::optional<cc::contracts::ProblemDetail> get(const std::string& id,
+                                                        const http::RequestControl& ctl = {});
+
+        // Variante co_await-able de get() (el ProblemsClient debe sobrevivir a la Task)
+        cc::async::Task<std::optional<cc::contracts::ProblemDetail>>
+        getAsync(std::string id, http::RequestControl ctl = {});
 
         // Crear nuevo problema (admin)
-        std::string create(const cc::contracts::ProblemDetail& problem);
+        std::string create(const cc::contracts::ProblemDetail& problem,
+                           const http::RequestControl& ctl = {});
 
         // Actualizar problema (admin)
         bool update(const std::string& id,
-                    const cc::contracts::ProblemDetail& problem);
+                    const cc::contracts::ProblemDetail& problem,
+                    const http::RequestControl& ctl = {});
 
         // Eliminar problema (admin)
-        bool remove(const std::string& id);
+        bool remove(const std::string& id, const http::RequestControl& ctl = {});
+
+        // Caché de evaluaciones que recibe las versiones de los sets de tests (por defecto
+        // EvalResultCache::shared(), la misma que EvalClient). nullptr la desactiva.
+        void setResultCache(std::shared_ptr<EvalResultCache> cache) { evalCache_ = std::move(cache); }
+        const std::shared_ptr<EvalResultCache>& resultCache() const { return evalCache_; }
     };
 
 } // namespace cc::sdk
@@ -0,0 +1,162 @@
+// bench_backoff_sim.cpp — Simulación (eventos discretos, sin red) de una ráfaga de N requests
+// contra un servicio con capacidad fija que rechaza el exceso con 503 + Retry-After. Compara
+// las formas de backoff de cc::time::Backoff (exponencial / decorrelated jitter, con y sin
+// respetar Retry-After): tiempo total hasta terminar, carga upstream (llamadas por request)
+// y requests que se rinden tras agotar los intentos.
+//
+// El servicio reparte turnos: cada rechazo recibe un Retry-After (en segundos, como manda el
+// RFC) hasta el próximo hueco libre de su cola. Se usa la misma política de reintentos que
+// HttpClient (base 200 ms, tope 3 s, ±20 %), con más intentos para que la ráfaga se drene.
+//
+// Uso: bench_backoff_sim [requests=10000] [capacidad_rps=500] [intentos=12]
+
+#include "metrics/timer.h"
+
+#include "support/bench_util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <queue>
+#include <string>
+#include <vector>
+
+using cc::time::Backoff;
+using cc::time::BackoffMode;
+using cc::time::BackoffPolicy;
+using cc::time::Millis;
+
+namespace {
+
+constexpr double kServiceMs = 20.0; // latencia de una respuesta 2xx
+constexpr double kRejectMs  = 2.0;  // latencia de un 503
+
+// Token bucket + agenda de turnos prometidos (para el Retry-After)
+struct Service {
+    double rps;
+    double burst;
+    double tokens;
+    double refilledAt{0};
+    double promisedUntil{0}; // ms hasta donde ya se repartieron turnos
+    std::uint64_t calls{0};
+
+    Service(double r, double b) : rps(r), burst(b), tokens(b) {}
+
+    // true => aceptada. Si no, retryAfterMs = próximo hueco, redondeado a segundos hacia arriba
+    bool call(double nowMs, double& retryAfterMs) {
+        ++calls;
+        tokens     = std::min(burst, tokens + (nowMs - refilledAt) * rps / 1000.0);
+        refilledAt = nowMs;
+        if (tokens >= 1.0) {
+            tokens -= 1.0;
+            return true;
+        }
+        promisedUntil = std::max(promisedUntil, nowMs) + 1000.0 / rps;
+        retryAfterMs  = std::ceil((promisedUntil - nowMs) / 1000.0) * 1000.0;
+        return false;
+    }
+};
+
+struct Outcome {
+    double        totalMs{0};  // hasta la última respuesta
+    double        p50Ms{0};    // tiempo de finalización por request
+    double        p99Ms{0};
+    std::uint64_t calls{0};
+    int           gaveUp{0};
+};
+
+struct Event {
+    double t;
+    int    client;
+    bool operator>(const Event& o) const { return t > o.t; }
+};
+
+Outcome simulate(int requests, double rps, const BackoffPolicy& pol) {
+    Service svc(rps, std::max(1.0, rps / 10.0));
+    std::vector<Backoff> backoffs;
+    backoffs.reserve(static_cast<std::size_t>(requests));
+    for (int i = 0; i < requests; ++i) backoffs.emplace_back(pol, static_cast<std::uint64_t>(i) + 1);
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<>> q;
+    for (int i = 0; i < requests; ++i) q.push({0.0, i}); // todo llega junto
+
+    Outcome out;
+    std::vector<double> finished;
+    finished.reserve(static_cast<std::size_t>(requests));
+    std::vector<int> attempts(static_cast<std::size_t>(requests), 0);
+
+    while (!q.empty()) {
+        const Event ev = q.top();
+        q.pop();
+        const auto c = static_cast<std::size_t>(ev.client);
+        ++attempts[c];
+
+        double retryAfterMs = 0;
+        if (svc.call(ev.t, retryAfterMs)) {
+            finished.push_back(ev.t + kServiceMs);
+            out.totalMs = std::max(out.totalMs, ev.t + kServiceMs);
+            continue;
+        }
+
+        const double doneAt = ev.t + kRejectMs;
+        const Millis hint{static_cast<Millis::rep>(retryAfterMs)};
+        if (attempts[c] >= pol.max_attempts || backoffs[c].server_delay_too_long(hint)) {
+            ++out.gaveUp;
+            out.totalMs = std::max(out.totalMs, doneAt);
+            continue;
+        }
+        const Millis delay = backoffs[c].next_delay(hint);
+        q.push({doneAt + static_cast<double>(delay.count()), ev.client});
+    }
+
+    out.calls = svc.calls;
+    out.p50Ms = cc::testing::percentile(finished, 0.50);
+    out.p99Ms = cc::testing::percentile(finished, 0.99);
+    return out;
+}
+
+void report(const std::string& label, int requests, const Outcome& o) {
+    std::printf("%-34s total=%8.0f ms  p50=%8.0f ms  p99=%8.0f ms  calls=%8llu (%5.2f/req)  gave_up=%d\n",
+                label.c_str(), o.totalMs, o.p50Ms, o.p99Ms,
+                static_cast<unsigned long long>(o.calls),
+                static_cast<double>(o.calls) / requests, o.gaveUp);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int    requests = argc > 1 ? std::max(1, std::atoi(argv[1])) : 10000;
+    const double rps      = argc > 2 ? std::max(1.0, std::atof(argv[2])) : 500.0;
+    const int    attempts = argc > 3 ? std::max(1, std::atoi(argv[3])) : 12;
+
+    std::printf("burst of %d requests, service capacity %.0f req/s (ideal drain %.0f ms), %d attempts\n",
+                requests, rps, requests * 1000.0 / rps, attempts);
+
+    BackoffPolicy pol;
+    pol.base         = Millis{200};
+    pol.max_delay    = Millis{3000};
+    pol.jitter_pct   = 0.20;
+    pol.max_attempts = attempts;
+    pol.max_server_delay = Millis{60000};
+
+    struct Variant {
+        const char* label;
+        BackoffMode mode;
+        bool        honor;
+    };
+    const Variant variants[] = {
+        {"exponential (ignore Retry-After)",  BackoffMode::Exponential,        false},
+        {"decorrelated (ignore Retry-After)", BackoffMode::DecorrelatedJitter, false},
+        {"exponential + Retry-After",         BackoffMode::Exponential,        true},
+        {"decorrelated + Retry-After",        BackoffMode::DecorrelatedJitter, true},
+    };
+    for (const auto& v : variants) {
+        BackoffPolicy p = pol;
+        p.mode               = v.mode;
+        p.honor_server_delay = v.honor;
+        report(v.label, requests, simulate(requests, rps, p));
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+// bench_eval_batch.cpp — Evaluaciones por segundo según el tamaño de lote, contra un servicio
+// de evaluación local (support/mock_eval_service.h) donde cada request HTTP tiene un costo fijo
+// (`request_ms`) y el juez tiene `slots` evaluaciones simultáneas:
+//   submit()       un request por envío desde `threads` hilos
+//   batch=N        submitBatch() con lotes de N envíos y 4 lotes en vuelo
+//
+// Uso: bench_eval_batch [envios=512] [judge_ms=20] [request_ms=15] [slots=32] [threads=4]
+
+#include "contracts/eval_dto.h"
+#include "logging/logger.h"
+#include "sdk/eval_client.h"
+
+#include "support/bench_util.h"
+#include "support/mock_eval_service.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cc::testing::BenchClock;
+
+namespace {
+
+std::vector<cc::contracts::RunRequest> make_requests(std::size_t n) {
+    std::vector<cc::contracts::RunRequest> out(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i].problemId = "p1";
+        out[i].code      = "int main() { return " + std::to_string(i % 7) + "; }";
+    }
+    return out;
+}
+
+void report(const char* name, std::size_t n, double elapsedUs, std::vector<double>& latencyUs,
+            std::size_t failed, const cc::testing::MockEvalService& service) {
+    std::printf("%-16s %8.1f subs/s  p50=%7.1f ms  p99=%7.1f ms  http requests=%5zu  failed=%zu\n",
+                name,
+                static_cast<double>(n) / (elapsedUs / 1e6),
+                cc::testing::percentile(latencyUs, 0.50) / 1000.0,
+                cc::testing::percentile(latencyUs, 0.99) / 1000.0,
+                service.stats().requests.load(),
+                failed);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t n       = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 512;
+    cc::testing::MockEvalOptions opts;
+    opts.judgeMs              = argc > 2 ? std::atoi(argv[2]) : 20;
+    opts.requestMs            = argc > 3 ? std::atoi(argv[3]) : 15;
+    opts.judgeSlots           = argc > 4 ? static_cast<std::size_t>(std::atoi(argv[4])) : 32;
+    const std::size_t threads = argc > 5 ? static_cast<std::size_t>(std::atoi(argv[5])) : 4;
+
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Warn;
+    cc::logging::Logger::init(lc);
+
+    std::printf("submissions=%zu judge=%d ms request overhead=%d ms judge slots=%zu threads/in-flight=%zu\n\n",
+                n, opts.judgeMs, opts.requestMs, opts.judgeSlots, threads);
+    const auto reqs = make_requests(n);
+
+    // Línea base: un request por envío
+    {
+        cc::testing::MockEvalService service(opts);
+        cc::sdk::EvalClient client(service.base_url());
+        std::vector<std::vector<double>> lat(threads);
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> failed{0};
+
+        const auto t0 = BenchClock::now();
+        std::vector<std::thread> workers;
+        for (std::size_t w = 0; w < threads; ++w) {
+            workers.emplace_back([&, w] {
+                for (std::size_t i; (i = next++) < n;) {
+                    if (!client.submit(reqs[i]).passed) ++failed;
+                    lat[w].push_back(cc::testing::elapsed_us(t0));
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+        const double us = cc::testing::elapsed_us(t0);
+
+        std::vector<double> all;
+        for (auto& l : lat) all.insert(all.end(), l.begin(), l.end());
+        report("submit()", n, us, all, failed.load(), service);
+    }
+
+    // Latencia = desde el inicio hasta que llega el resultado de cada envío
+    for (std::size_t batch : {1u, 8u, 32u, 128u}) {
+        cc::testing::MockEvalService service(opts);
+        cc::sdk::EvalClient client(service.base_url());
+
+        cc::sdk::EvalBatchOptions bo;
+        bo.batchSize   = batch;
+        bo.maxInFlight = threads;
+
+        std::vector<double> lat;
+        lat.reserve(n);
+        const auto t0 = BenchClock::now();
+        const auto results = client.submitBatch(reqs, [&](std::size_t, const cc::contracts::RunResult&) {
+            lat.push_back(cc::testing::elapsed_us(t0));
+            return true;
+        }, bo);
+        const double us = cc::testing::elapsed_us(t0);
+
+        std::size_t failed = 0;
+        for (const auto& r : results) failed += r.passed ? 0 : 1;
+        const std::string name = "batch=" + std::to_string(batch);
+        report(name.c_str(), n, us, lat, failed, service);
+    }
+    return 0;
+}
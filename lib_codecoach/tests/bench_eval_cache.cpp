@@ -0,0 +1,151 @@
+// bench_eval_cache.cpp — Re-evaluación de un historial de envíos (como el grader nocturno)
+// contra un servicio de evaluación local (support/mock_eval_service.h), con y sin memoización:
+//   no cache        cada envío va al juez
+//   cache raw       EvalResultCache con la clave sobre el código tal cual
+//   cache norm      clave con el código normalizado (espacios y comentarios no cuentan)
+//   warm disk       otra instancia sobre el directorio de la corrida anterior (segunda noche)
+// El historial repite programas con sesgo (pocos muy reenviados) y una parte de los reenvíos
+// solo cambia comentarios o espacios. Al final, costo de calcular la clave.
+//
+// Uso: bench_eval_cache [historial=600] [unicos=150] [variantes_pct=30] [judge_ms=20] [threads=8]
+
+#include "contracts/eval_dto.h"
+#include "logging/logger.h"
+#include "sdk/eval_cache.h"
+#include "sdk/eval_client.h"
+
+#include "support/bench_util.h"
+#include "support/mock_eval_service.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using cc::testing::BenchClock;
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string program(std::size_t u) {
+    std::string code = "#include <bits/stdc++.h>\nusing namespace std;\n\n";
+    for (int f = 0; f < 8; ++f) {
+        code += "int f" + std::to_string(f) + "(int x) {\n";
+        code += "    int acc = " + std::to_string(u * 31 + f) + ";\n";
+        code += "    for (int i = 0; i < x; ++i) acc += i * " + std::to_string(f + 1) + ";\n";
+        code += "    return acc;\n}\n\n";
+    }
+    code += "int main() {\n    int n; cin >> n;\n    cout << f0(n) + f7(n) << \"\\n\";\n}\n";
+    return code;
+}
+
+// Mismo programa con otro comentario o indentación: el juez da lo mismo
+std::string variant(const std::string& code, std::size_t k) {
+    if (k % 2 == 0) return "// intento " + std::to_string(k) + "\n" + code;
+    std::string out;
+    for (char c : code) {
+        out.push_back(c);
+        if (c == '\n') out += "  ";
+    }
+    return out;
+}
+
+std::vector<cc::contracts::RunRequest> history(std::size_t n, std::size_t unique, int variantPct) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> x(0.0, 1.0);
+    std::vector<std::size_t> sent(unique, 0);
+    std::vector<cc::contracts::RunRequest> out;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto u = static_cast<std::size_t>(static_cast<double>(unique) * x(rng) * x(rng)); // sesgo
+        cc::contracts::RunRequest r;
+        r.problemId = "p" + std::to_string(u % 5);
+        r.code      = program(u);
+        if (sent[u]++ > 0 && x(rng) * 100.0 < variantPct) r.code = variant(r.code, i);
+        out.push_back(std::move(r));
+    }
+    return out;
+}
+
+void run(const char* name, const std::vector<cc::contracts::RunRequest>& reqs, const cc::testing::MockEvalOptions& opts,
+         std::size_t threads, std::shared_ptr<cc::sdk::EvalResultCache> cache) {
+    cc::testing::MockEvalService service(opts);
+    cc::sdk::EvalClient client(service.base_url());
+    client.setResultCache(cache);
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> failed{0};
+    const auto t0 = BenchClock::now();
+    std::vector<std::thread> workers;
+    for (std::size_t w = 0; w < threads; ++w) {
+        workers.emplace_back([&] {
+            for (std::size_t i; (i = next++) < reqs.size();) {
+                if (!client.submit(reqs[i]).passed) ++failed;
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    const double secs = cc::testing::elapsed_us(t0) / 1e6;
+
+    const auto s = cache ? cache->stats() : cc::sdk::EvalCacheStats{};
+    std::printf("%-12s %8.1f subs/s  %6.2f s  judged=%5zu  hit ratio=%5.1f%% (disk %zu)  saved judge=%7.2f s  failed=%zu\n",
+                name, static_cast<double>(reqs.size()) / secs, secs,
+                service.stats().judged.load(), 100.0 * s.hit_ratio(), s.diskHits,
+                static_cast<double>(s.savedJudgeMs) / 1000.0, failed.load());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t n       = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 600;
+    const std::size_t unique  = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 150;
+    const int variantPct      = argc > 3 ? std::atoi(argv[3]) : 30;
+    cc::testing::MockEvalOptions opts;
+    opts.judgeMs              = argc > 4 ? std::atoi(argv[4]) : 20;
+    opts.testSetVersion       = "v1";
+    const std::size_t threads = argc > 5 ? static_cast<std::size_t>(std::atoi(argv[5])) : 8;
+
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Warn;
+    cc::logging::Logger::init(lc);
+
+    const auto reqs = history(n, unique, variantPct);
+    std::printf("history=%zu unique programs=%zu variants=%d%% of resubmissions judge=%d ms threads=%zu\n\n",
+                n, unique, variantPct, opts.judgeMs, threads);
+
+    const fs::path dir = fs::temp_directory_path() / ("cc_bench_eval_cache_" + std::to_string(::getpid()));
+    fs::remove_all(dir);
+
+    run("no cache", reqs, opts, threads, nullptr);
+
+    cc::sdk::EvalCacheOptions raw;
+    run("cache raw", reqs, opts, threads, std::make_shared<cc::sdk::EvalResultCache>(raw));
+
+    cc::sdk::EvalCacheOptions norm;
+    norm.normalizeSource = true;
+    norm.diskDir         = dir.string();
+    run("cache norm", reqs, opts, threads, std::make_shared<cc::sdk::EvalResultCache>(norm));
+    run("warm disk", reqs, opts, threads, std::make_shared<cc::sdk::EvalResultCache>(norm));
+    fs::remove_all(dir);
+
+    // Costo de la clave sobre un programa típico
+    const auto& sample = reqs.front();
+    for (bool normalize : {false, true}) {
+        constexpr int kIters = 20000;
+        std::uint8_t sink = 0;
+        const auto t0 = BenchClock::now();
+        for (int i = 0; i < kIters; ++i) sink ^= cc::sdk::EvalResultCache::key_of(sample, "v1", normalize)[0];
+        const double us = cc::testing::elapsed_us(t0) / kIters;
+        std::printf("\nkey_of %-10s %6.2f us/key  (%zu bytes of code, %.0f MB/s)%s",
+                    normalize ? "normalized" : "raw", us, sample.code.size(),
+                    static_cast<double>(sample.code.size()) / us, sink == 0xff ? " " : "");
+    }
+    std::printf("\n");
+    return 0;
+}
@@ -0,0 +1,160 @@
+// bench_eval_queue.cpp — Evaluaciones sostenidas por segundo contra un servicio de evaluación
+// local (support/mock_eval_service.h) con latencia del juez configurable:
+//   blocking   submit() en W hilos; cada hilo queda bloqueado `judge_ms` por evaluación
+//   held       submitAsync() en P corrutinas; no ocupa hilos pero retiene P conexiones
+//   long-poll  submitQueuedAsync() en P corrutinas; POST /submissions + GET retenido
+//   short-poll igual, con un servicio que no hace long-poll (solo backoff del cliente)
+// Las corrutinas se lanzan desde un solo hilo y se reanudan en Executor::global().
+// Cada escenario corre `secs` segundos; se cuentan las evaluaciones terminadas.
+//
+// Uso: bench_eval_queue [judge_ms=200] [secs=3] [pending=512] [threads=16]
+
+#include "async/executor.h"
+#include "async/task.h"
+#include "contracts/eval_dto.h"
+#include "logging/logger.h"
+#include "sdk/eval_client.h"
+
+#include "support/bench_util.h"
+#include "support/mock_eval_service.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cc::testing::BenchClock;
+
+namespace {
+
+enum class Mode { Blocking, Held, LongPoll, ShortPoll };
+
+const char* mode_name(Mode m) {
+    switch (m) {
+        case Mode::Blocking:  return "blocking submit()";
+        case Mode::Held:      return "submitAsync (held conn)";
+        case Mode::LongPoll:  return "queued + long-poll";
+        case Mode::ShortPoll: return "queued + short-poll";
+    }
+    return "";
+}
+
+cc::contracts::RunRequest make_request(std::size_t i) {
+    cc::contracts::RunRequest r;
+    r.problemId = "p1";
+    r.code      = "int main() { return " + std::to_string(i % 7) + "; }";
+    return r;
+}
+
+// Estado compartido por hilos/corrutinas de un escenario
+struct Run {
+    BenchClock::time_point stopAt;
+    std::atomic<std::size_t> issued{0};
+    std::mutex               m;
+    std::condition_variable  cv;
+    std::vector<double>      latencyUs;
+    std::size_t              failed{0};
+    std::size_t              lanesLeft{0};
+
+    bool take() {
+        if (BenchClock::now() >= stopAt) return false;
+        ++issued;
+        return true;
+    }
+
+    void done(bool ok, double us) {
+        std::lock_guard<std::mutex> lk(m);
+        latencyUs.push_back(us);
+        if (!ok) ++failed;
+    }
+
+    void lane_finished() {
+        std::lock_guard<std::mutex> lk(m);
+        if (--lanesLeft == 0) cv.notify_all();
+    }
+};
+
+cc::async::Task<void> lane(cc::sdk::EvalClient& client, Run& run, Mode mode) {
+    while (run.take()) {
+        const auto t0 = BenchClock::now();
+        cc::contracts::RunResult r;
+        if (mode == Mode::Held) {
+            r = co_await client.submitAsync(make_request(run.issued.load()));
+        } else {
+            r = co_await client.submitQueuedAsync(make_request(run.issued.load()));
+        }
+        run.done(r.passed, cc::testing::elapsed_us(t0));
+    }
+    run.lane_finished();
+}
+
+void run_mode(Mode mode, int judgeMs, int secs, std::size_t pending, std::size_t threads) {
+    cc::testing::MockEvalOptions opts;
+    opts.judgeMs  = judgeMs;
+    opts.longPoll = mode != Mode::ShortPoll;
+    cc::testing::MockEvalService service(opts);
+    cc::sdk::EvalClient client(service.base_url());
+
+    Run run;
+    const auto t0 = BenchClock::now();
+    run.stopAt = t0 + std::chrono::seconds(secs);
+
+    if (mode == Mode::Blocking) {
+        std::vector<std::thread> workers;
+        for (std::size_t w = 0; w < threads; ++w) {
+            workers.emplace_back([&] {
+                while (run.take()) {
+                    const auto s = BenchClock::now();
+                    const auto r = client.submit(make_request(run.issued.load()));
+                    run.done(r.passed, cc::testing::elapsed_us(s));
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+    } else {
+        run.lanesLeft = pending;
+        for (std::size_t i = 0; i < pending; ++i) {
+            cc::async::Executor::global().spawn(lane(client, run, mode));
+        }
+        std::unique_lock<std::mutex> lk(run.m);
+        run.cv.wait(lk, [&] { return run.lanesLeft == 0; });
+    }
+
+    const double elapsedS = cc::testing::elapsed_us(t0) / 1e6;
+    std::lock_guard<std::mutex> lk(run.m);
+    const double n = static_cast<double>(std::max<std::size_t>(1, run.latencyUs.size()));
+    std::printf("%-24s %8.1f subs/s  p50=%7.1f ms  p99=%7.1f ms  conns=%5zu  peak in-flight=%5zu  "
+                "polls/sub=%.2f  failed=%zu\n",
+                mode_name(mode),
+                static_cast<double>(run.latencyUs.size()) / elapsedS,
+                cc::testing::percentile(run.latencyUs, 0.50) / 1000.0,
+                cc::testing::percentile(run.latencyUs, 0.99) / 1000.0,
+                service.connections(),
+                service.stats().peakInFlight.load(),
+                static_cast<double>(service.stats().polls.load()) / n,
+                run.failed);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int judgeMs           = argc > 1 ? std::atoi(argv[1]) : 200;
+    const int secs              = argc > 2 ? std::atoi(argv[2]) : 3;
+    const std::size_t pending   = argc > 3 ? static_cast<std::size_t>(std::atoi(argv[3])) : 512;
+    const std::size_t threads   = argc > 4 ? static_cast<std::size_t>(std::atoi(argv[4])) : 16;
+
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Warn;
+    cc::logging::Logger::init(lc);
+
+    std::printf("judge=%d ms  %d s per mode  pending=%zu coroutines  blocking threads=%zu\n\n",
+                judgeMs, secs, pending, threads);
+    for (Mode m : {Mode::Blocking, Mode::Held, Mode::LongPoll, Mode::ShortPoll}) {
+        run_mode(m, judgeMs, secs, pending, threads);
+    }
+    return 0;
+}
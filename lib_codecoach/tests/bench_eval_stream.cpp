@@ -0,0 +1,92 @@
+// bench_eval_stream.cpp — Latencia hasta el primer fallo y CPU del juez (casos evaluados) por
+// entrega, en un problema con muchos casos donde la solución falla temprano
+// (support/mock_eval_service.h):
+//   buffered      submit(): el fallo se conoce cuando terminan todos los casos
+//   stream        submitStreaming(): el fallo llega apenas se evalúa ese caso
+//   stream+stop   el callback corta en el primer fallo (sin failFast en el servicio)
+//   failFast      submitStreaming() con RunRequest::failFast
+//
+// Uso: bench_eval_stream [rondas=10] [casos=150] [case_ms=10] [fail_at=20]
+
+#include "contracts/eval_dto.h"
+#include "logging/logger.h"
+#include "sdk/eval_client.h"
+
+#include "support/bench_util.h"
+#include "support/mock_eval_service.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cc::testing::BenchClock;
+
+namespace {
+
+enum class Mode { Buffered, Stream, StreamStop, FailFast };
+
+const char* mode_name(Mode m) {
+    switch (m) {
+        case Mode::Buffered:   return "buffered submit()";
+        case Mode::Stream:     return "stream";
+        case Mode::StreamStop: return "stream + caller stop";
+        case Mode::FailFast:   return "stream + failFast";
+    }
+    return "";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 10;
+    cc::testing::MockEvalOptions opts;
+    opts.judgeMs = 100;
+    opts.cases   = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 150;
+    opts.caseMs  = argc > 3 ? std::atoi(argv[3]) : 10;
+    opts.failAt  = argc > 4 ? std::atol(argv[4]) : 20;
+
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Warn;
+    cc::logging::Logger::init(lc);
+
+    std::printf("rounds=%d cases=%zu compile=%d ms case=%d ms first failure at case %ld\n\n",
+                rounds, opts.cases, opts.judgeMs, opts.caseMs, opts.failAt);
+
+    for (Mode m : {Mode::Buffered, Mode::Stream, Mode::StreamStop, Mode::FailFast}) {
+        cc::testing::MockEvalService service(opts);
+        cc::sdk::EvalClient client(service.base_url());
+
+        std::vector<double> firstFailUs;
+        std::vector<double> doneUs;
+        for (int r = 0; r < rounds; ++r) {
+            cc::contracts::RunRequest req;
+            req.problemId = "p1";
+            req.code      = "int main() { return " + std::to_string(r) + "; }";
+            req.failFast  = m == Mode::FailFast;
+
+            const auto t0 = BenchClock::now();
+            double failUs = -1;
+            if (m == Mode::Buffered) {
+                client.submit(req);
+                failUs = cc::testing::elapsed_us(t0);
+            } else {
+                client.submitStreaming(req, [&](std::size_t, const cc::contracts::RunCaseResult& c) {
+                    if (!c.passed && failUs < 0) failUs = cc::testing::elapsed_us(t0);
+                    return c.passed || m != Mode::StreamStop;
+                });
+            }
+            doneUs.push_back(cc::testing::elapsed_us(t0));
+            firstFailUs.push_back(failUs);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50)); // cortes pendientes en el juez
+
+        std::printf("%-22s first failure p50=%7.1f ms  result p50=%7.1f ms  cases judged/sub=%6.1f\n",
+                    mode_name(m),
+                    cc::testing::percentile(firstFailUs, 0.50) / 1000.0,
+                    cc::testing::percentile(doneUs, 0.50) / 1000.0,
+                    static_cast<double>(service.stats().casesJudged.load()) / rounds);
+    }
+    return 0;
+}
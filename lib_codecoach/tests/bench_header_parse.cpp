@@ -0,0 +1,145 @@
+// bench_header_parse.cpp — Parseo de los headers de una respuesta típica (20 líneas, como las
+// entrega el header callback de libcurl) + 4 búsquedas comunes (Content-Type, ETag,
+// Cache-Control, Retry-After): HeaderMap frente al std::unordered_map<std::string,
+// std::string> anterior con búsqueda case-insensitive por recorrido. Tiempo y asignaciones
+// por respuesta (operator new del hilo que mide).
+//
+// Uso: bench_header_parse [respuestas=200000]
+
+#include "http/header_map.h"
+
+#include "support/bench_util.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using cc::http::HeaderMap;
+
+// -------------------------------
+// Conteo de asignaciones
+// -------------------------------
+namespace {
+thread_local bool        t_counting = false;
+thread_local std::size_t t_allocs   = 0;
+
+void* counted_alloc(std::size_t n) {
+    if (t_counting) ++t_allocs;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+} // namespace
+
+void* operator new(std::size_t n) { return counted_alloc(n); }
+void* operator new[](std::size_t n) { return counted_alloc(n); }
+void  operator delete(void* p) noexcept { std::free(p); }
+void  operator delete[](void* p) noexcept { std::free(p); }
+void  operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void  operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+const std::vector<std::string>& response_lines() {
+    static const std::vector<std::string> lines = {
+        "HTTP/1.1 200 OK\r\n",
+        "Date: Tue, 14 Oct 2025 10:21:33 GMT\r\n",
+        "Content-Type: application/json; charset=utf-8\r\n",
+        "Content-Length: 18342\r\n",
+        "Connection: keep-alive\r\n",
+        "Server: nginx/1.25.3\r\n",
+        "Cache-Control: public, max-age=60\r\n",
+        "ETag: \"5f1c-62a8b1d0e7f40\"\r\n",
+        "Last-Modified: Mon, 13 Oct 2025 18:02:11 GMT\r\n",
+        "Vary: Accept-Encoding\r\n",
+        "Content-Encoding: gzip\r\n",
+        "X-Request-Id: 7c1e2d4a-9b3f-4e8a-a1c2-5d6e7f8091a2\r\n",
+        "X-RateLimit-Limit: 600\r\n",
+        "X-RateLimit-Remaining: 587\r\n",
+        "X-RateLimit-Reset: 1760437353\r\n",
+        "Strict-Transport-Security: max-age=31536000; includeSubDomains\r\n",
+        "X-Content-Type-Options: nosniff\r\n",
+        "Access-Control-Allow-Origin: *\r\n",
+        "Age: 12\r\n",
+        "Via: 1.1 varnish\r\n",
+        "X-Cache: HIT\r\n",
+        "\r\n",
+    };
+    return lines;
+}
+
+constexpr std::string_view kLookups[] = {"content-type", "ETag", "Cache-Control", "Retry-After"};
+
+// Lo que hacían on_header + get_header_ci antes de HeaderMap
+using OldHeaders = std::unordered_map<std::string, std::string>;
+
+void old_on_header(OldHeaders& h, std::string_view line) {
+    auto pos = line.find(':');
+    if (pos == std::string_view::npos) return;
+    std::string k(line.substr(0, pos));
+    std::string_view v = line.substr(pos + 1);
+    while (!v.empty() && (v.front() == ' ' || v.front() == '\t')) v.remove_prefix(1);
+    while (!v.empty() && (v.back() == '\r' || v.back() == '\n')) v.remove_suffix(1);
+    while (!k.empty() && (k.back() == '\r' || k.back() == '\n')) k.pop_back();
+    if (k.empty()) return;
+    h[std::move(k)] = std::string(v);
+}
+
+std::optional<std::string> old_get_header_ci(const OldHeaders& headers, std::string_view key) {
+    if (auto it = headers.find(std::string(key)); it != headers.end()) return it->second;
+    std::string key_lc(key);
+    std::transform(key_lc.begin(), key_lc.end(), key_lc.begin(), [](unsigned char c) { return std::tolower(c); });
+    for (const auto& kv : headers) {
+        std::string k = kv.first;
+        std::transform(k.begin(), k.end(), k.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (k == key_lc) return kv.second;
+    }
+    return std::nullopt;
+}
+
+template <typename Fn>
+void measure(const char* label, int n, Fn&& fn) {
+    std::size_t sink = 0;
+    for (int i = 0; i < 1000; ++i) sink += fn(); // calentamiento
+    t_allocs = 0;
+    const auto t0 = cc::testing::BenchClock::now();
+    t_counting = true;
+    for (int i = 0; i < n; ++i) sink += fn();
+    t_counting = false;
+    const double us = cc::testing::elapsed_us(t0);
+    std::printf("%-34s %8.1f ns/response  %6.1f allocs/response  (check %zu)\n",
+                label, us * 1000.0 / n, static_cast<double>(t_allocs) / n, sink % 10);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int n = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200000;
+    const auto& lines = response_lines();
+    std::printf("%zu header lines per response, %zu lookups, %d responses\n",
+                lines.size() - 2, std::size(kLookups), n);
+
+    measure("unordered_map + get_header_ci", n, [&] {
+        OldHeaders h;
+        for (const auto& l : lines) old_on_header(h, l);
+        std::size_t found = 0;
+        for (auto k : kLookups) found += old_get_header_ci(h, k).has_value();
+        return found;
+    });
+
+    measure("HeaderMap (parse_line + get)", n, [&] {
+        HeaderMap h;
+        h.reserve(24, 768); // igual que CurlTransfer
+        for (const auto& l : lines) h.parse_line(l);
+        std::size_t found = 0;
+        for (auto k : kLookups) found += h.get(k).has_value();
+        return found;
+    });
+    return 0;
+}
@@ -0,0 +1,200 @@
+// bench_http2.cpp — EvalClient::submit con 1/16/256 llamadores concurrentes, HTTP/1.1 vs
+// HTTP/2 (h2c prior knowledge). Un nghttpx local hace de proxy HTTP/2 (como en producción)
+// delante del servicio de evaluación simulado con MockHttpServer.
+//
+// Uso: bench_http2 [peticiones por nivel=2048] [delay del backend en ms=2]
+// Variables: NGHTTPX=/ruta/a/nghttpx (default: se busca en el PATH)
+
+#include "config/config_manager.h"
+#include "contracts/eval_dto.h"
+#include "logging/logger.h"
+#include "sdk/eval_client.h"
+
+#include "support/bench_util.h"
+#include "support/mock_http_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern char** environ;
+
+using cc::config::HttpVersion;
+using cc::testing::BenchClock;
+using cc::testing::MockHttpServer;
+using cc::testing::MockRequest;
+using cc::testing::MockResponse;
+
+namespace {
+
+int free_port() {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port        = 0;
+    socklen_t len = sizeof(addr);
+    ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    ::close(fd);
+    return ntohs(addr.sin_port);
+}
+
+bool can_connect(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port        = htons(static_cast<uint16_t>(port));
+    const bool ok = ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    ::close(fd);
+    return ok;
+}
+
+// nghttpx en texto plano: acepta HTTP/1.1 y h2c en el mismo puerto
+class ProxyProcess {
+public:
+    ProxyProcess(int frontendPort, int backendPort) {
+        const char* bin = std::getenv("NGHTTPX");
+        if (!bin || !*bin) bin = "nghttpx";
+
+        const std::string frontend = "--frontend=127.0.0.1," + std::to_string(frontendPort) + ";no-tls";
+        const std::string backend  = "--backend=127.0.0.1," + std::to_string(backendPort);
+        std::vector<std::string> args = {
+            bin, frontend, backend, "--workers=1", "--log-level=ERROR",
+            "--backend-connections-per-host=256", "--errorlog-file=/dev/null",
+            "--accesslog-file=/dev/null"
+        };
+        std::vector<char*> argv;
+        for (auto& a : args) argv.push_back(a.data());
+        argv.push_back(nullptr);
+
+        if (::posix_spawnp(&pid_, bin, nullptr, nullptr, argv.data(), environ) != 0) {
+            pid_ = -1;
+            return;
+        }
+        for (int i = 0; i < 100 && !can_connect(frontendPort); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        if (!can_connect(frontendPort)) stop();
+    }
+    ~ProxyProcess() { stop(); }
+
+    bool running() const { return pid_ > 0; }
+
+private:
+    void stop() {
+        if (pid_ <= 0) return;
+        ::kill(pid_, SIGTERM);
+        ::waitpid(pid_, nullptr, 0);
+        pid_ = -1;
+    }
+
+    pid_t pid_{-1};
+};
+
+struct LevelResult {
+    std::vector<double> samples;
+    double wallMs{0};
+    int    failures{0};
+};
+
+LevelResult run_level(const std::string& baseUrl, int concurrency, int total) {
+    LevelResult out;
+    std::mutex m;
+    std::atomic<int> next{0};
+    std::atomic<int> failures{0};
+
+    const auto t0 = BenchClock::now();
+    std::vector<std::thread> callers;
+    for (int c = 0; c < concurrency; ++c) {
+        callers.emplace_back([&] {
+            cc::sdk::EvalClient ec(baseUrl); // cada llamador con su cliente (como la app)
+            cc::contracts::RunRequest req;
+            req.problemId = "two-sum";
+            req.code      = "int main(){return 0;}";
+            std::vector<double> local;
+            while (next.fetch_add(1) < total) {
+                const auto s = BenchClock::now();
+                auto r = ec.submit(req);
+                local.push_back(cc::testing::elapsed_us(s));
+                if (!r.passed) ++failures;
+            }
+            std::lock_guard<std::mutex> lk(m);
+            out.samples.insert(out.samples.end(), local.begin(), local.end());
+        });
+    }
+    for (auto& t : callers) t.join();
+    out.wallMs   = cc::testing::elapsed_us(t0) / 1000.0;
+    out.failures = failures.load();
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int total   = argc > 1 ? std::atoi(argv[1]) : 2048;
+    const int delayMs = argc > 2 ? std::atoi(argv[2]) : 2;
+
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Error;
+    cc::logging::Logger::init(lc);
+
+    MockHttpServer backend([delayMs](const MockRequest&) {
+        MockResponse r;
+        r.delayMs = delayMs;
+        r.headers.emplace_back("Content-Type", "application/json");
+        r.body = R"({"passed":true,"timeMs":3,"memoryKB":1024,"exitCode":0,"stdout":"3\n","stderr":"",)"
+                 R"("cases":[{"input":"1 2","output":"3","expected":"3","passed":true,"timeMs":3,"memoryKB":1024}]})";
+        return r;
+    });
+
+    const int proxyPort = free_port();
+    ProxyProcess proxy(proxyPort, backend.port());
+    if (!proxy.running()) {
+        std::fprintf(stderr, "nghttpx not available (set NGHTTPX=/path/to/nghttpx); skipping\n");
+        return 0;
+    }
+    const std::string baseUrl = "http://127.0.0.1:" + std::to_string(proxyPort);
+
+    cc::config::Config cfg;
+    cfg.endpoints.evalBaseUrl = baseUrl;
+    cfg.http.retries = 0;
+    cfg.http.poolMaxIdlePerHost = 256;
+    cc::config::set_for_tests(cfg);
+
+    std::printf("EvalClient::submit x %d per level via nghttpx -> mock (backend delay %d ms)\n",
+                total, delayMs);
+
+    const struct { const char* name; HttpVersion v; } modes[] = {
+        {"HTTP/1.1", HttpVersion::Http1_1},
+        {"HTTP/2 (h2c)", HttpVersion::Http2PriorKnowledge},
+    };
+    for (int concurrency : {1, 16, 256}) {
+        for (const auto& mode : modes) {
+            cfg.http.version = mode.v;
+            auto r = run_level(baseUrl, concurrency, total);
+            const std::string label = std::string(mode.name) + " c=" + std::to_string(concurrency);
+            cc::testing::report_latency(label, r.samples);
+            std::printf("%-28s wall=%8.1f ms  rps=%9.0f  failures=%d\n", "",
+                        r.wallMs, 1000.0 * static_cast<double>(r.samples.size()) / r.wallMs,
+                        r.failures);
+        }
+    }
+
+    cc::config::unset_for_tests();
+    return 0;
+}
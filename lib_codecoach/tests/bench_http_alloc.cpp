@@ -0,0 +1,125 @@
+// bench_http_alloc.cpp — Memoria asignada (operator new) por request en el hilo llamador,
+// para bodies de 1 KB, 100 KB y 10 MB: request() con body prestado (const std::string&),
+// request() con std::string&& y PreparedRequest reenviado con send().
+// Solo se cuentan las asignaciones C++ del hilo que mide (no las de libcurl ni del servidor).
+//
+// Uso: bench_http_alloc [iteraciones=200]
+
+#include "http/http_client.h"
+#include "logging/logger.h"
+
+#include "support/bench_util.h"
+#include "support/mock_http_server.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+using cc::testing::MockHttpServer;
+using cc::testing::MockRequest;
+using cc::testing::MockResponse;
+
+// -------------------------------
+// Conteo de asignaciones (solo en el hilo que mide)
+// -------------------------------
+namespace {
+thread_local bool        t_counting = false;
+thread_local std::size_t t_bytes    = 0;
+thread_local std::size_t t_allocs   = 0;
+
+void* counted_alloc(std::size_t n) {
+    if (t_counting) {
+        t_bytes += n;
+        ++t_allocs;
+    }
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+} // namespace
+
+void* operator new(std::size_t n) { return counted_alloc(n); }
+void* operator new[](std::size_t n) { return counted_alloc(n); }
+void  operator delete(void* p) noexcept { std::free(p); }
+void  operator delete[](void* p) noexcept { std::free(p); }
+void  operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void  operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+struct Counted {
+    double bytesPerReq{0};
+    double allocsPerReq{0};
+};
+
+template <typename Fn>
+Counted measure(int iterations, Fn&& fn) {
+    t_bytes = t_allocs = 0;
+    for (int i = 0; i < iterations; ++i) {
+        t_counting = true;
+        const bool ok = fn();
+        t_counting = false;
+        if (!ok) {
+            std::fprintf(stderr, "request failed at iteration %d\n", i);
+            std::exit(1);
+        }
+    }
+    return Counted{static_cast<double>(t_bytes) / iterations,
+                   static_cast<double>(t_allocs) / iterations};
+}
+
+void report(const std::string& label, const Counted& c) {
+    std::printf("%-38s %12.0f bytes/req  %7.1f allocs/req\n", label.c_str(), c.bytesPerReq, c.allocsPerReq);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 200;
+
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Warn;
+    cc::logging::Logger::init(lc);
+
+    MockHttpServer server([](const MockRequest&) {
+        MockResponse r;
+        r.headers.emplace_back("Content-Type", "application/json");
+        r.body = R"({"passed":true})";
+        return r;
+    });
+    const std::string url = server.base_url() + "/evaluate";
+
+    cc::http::HttpClient client;
+    client.setRetries(0);
+    client.setDefaultHeader("Content-Type", "application/json");
+    client.setDefaultHeader("Accept", "application/json");
+
+    for (std::size_t size : {std::size_t{1024}, std::size_t{100 * 1024}, std::size_t{10 * 1024 * 1024}}) {
+        const int n = size >= 1024 * 1024 ? std::max(1, iterations / 20) : iterations;
+        const std::string body(size, 'x');
+        const std::string tag = " [" + std::to_string(size / 1024) + " KB]";
+
+        // Calentamiento: conexión del pool, contadores de métricas, etc.
+        for (int i = 0; i < 3; ++i) (void)client.request("POST", url, body);
+
+        report("request(const std::string&)" + tag, measure(n, [&] {
+            return client.request("POST", url, body).isSuccess();
+        }));
+
+        // El std::string&& se arma fuera de la medición: se mide solo lo que hace el cliente
+        std::vector<std::string> owned(static_cast<std::size_t>(n), std::string());
+        int next = 0;
+        for (auto& s : owned) s = body;
+        report("request(std::string&&)" + tag, measure(n, [&] {
+            return client.request("POST", url, std::move(owned[static_cast<std::size_t>(next++)])).isSuccess();
+        }));
+        owned.clear();
+
+        const auto prepared = client.prepare("POST", url, body);
+        report("PreparedRequest + send()" + tag, measure(n, [&] {
+            return client.send(prepared).isSuccess();
+        }));
+    }
+    return 0;
+}
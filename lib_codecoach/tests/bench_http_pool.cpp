@@ -0,0 +1,84 @@
+// bench_http_pool.cpp — Latencia p50/p99 de ProblemsClient::get repetido contra un servidor
+// HTTP local, con y sin ConnectionPool.
+//
+// Uso: bench_http_pool [iteraciones=2000]
+
+#include "config/config_manager.h"
+#include "http/connection_pool.h"
+#include "logging/logger.h"
+#include "sdk/problems_client.h"
+
+#include "support/bench_util.h"
+#include "support/mock_http_server.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using cc::testing::BenchClock;
+using cc::testing::MockHttpServer;
+using cc::testing::MockRequest;
+using cc::testing::MockResponse;
+
+static std::vector<double> run(const std::string& baseUrl, int iterations) {
+    cc::sdk::ProblemsClient pc(baseUrl);
+    std::vector<double> samples;
+    samples.reserve(static_cast<std::size_t>(iterations));
+
+    // Calentamiento (no se mide)
+    for (int i = 0; i < 20; ++i) (void)pc.get("two-sum");
+
+    for (int i = 0; i < iterations; ++i) {
+        const auto t0 = BenchClock::now();
+        auto p = pc.get("two-sum");
+        samples.push_back(cc::testing::elapsed_us(t0));
+        if (!p) {
+            std::fprintf(stderr, "request failed at iteration %d\n", i);
+            std::exit(1);
+        }
+    }
+    return samples;
+}
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Warn;
+    cc::logging::Logger::init(lc);
+
+    MockHttpServer server([](const MockRequest&) {
+        MockResponse r;
+        r.headers.emplace_back("Content-Type", "application/json");
+        r.body = R"({"id":"two-sum","title":"Two Sum","difficulty":"easy","tags":["array"],)"
+                 R"("statement":"Given an array of integers...","samples":[{"input":"1 2","output":"3"}]})";
+        return r;
+    });
+
+    cc::config::Config cfg;
+    cfg.endpoints.problemsBaseUrl = server.base_url();
+    cfg.http.retries = 0;
+    cc::config::set_for_tests(cfg);
+
+    std::printf("ProblemsClient::get x %d against %s\n", iterations, server.base_url().c_str());
+
+    cfg.http.poolMaxIdlePerHost = 0;
+    std::size_t conns_before = server.connections();
+    auto no_pool = run(server.base_url(), iterations);
+    cc::testing::report_latency("without pool", no_pool);
+    std::printf("%-28s connections opened: %zu\n", "", server.connections() - conns_before);
+
+    cfg.http.poolMaxIdlePerHost = 8;
+    conns_before = server.connections();
+    auto pooled = run(server.base_url(), iterations);
+    cc::testing::report_latency("with pool", pooled);
+    std::printf("%-28s connections opened: %zu\n", "", server.connections() - conns_before);
+
+    const auto st = cc::http::ConnectionPool::instance().stats();
+    std::printf("pool stats: created=%zu reused=%zu discarded=%zu idle=%zu\n",
+                st.created, st.reused, st.discarded, st.idle);
+
+    cc::config::unset_for_tests();
+    return 0;
+}
@@ -0,0 +1,149 @@
+// bench_http_stream.cpp — Respuesta de 50 MB: pico de RSS y tiempo hasta procesar el primer
+// byte, comparando body acumulado (chunked vs Content-Length con pre-reserve) contra
+// HttpClient::requestStreaming con un sink que procesa los trozos al vuelo.
+//
+// Uso: bench_http_stream [MB=50] [repeticiones=3]
+
+#include "http/http_client.h"
+#include "logging/logger.h"
+
+#include "support/bench_util.h"
+#include "support/mock_http_server.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using cc::testing::BenchClock;
+using cc::testing::MockHttpServer;
+using cc::testing::MockRequest;
+using cc::testing::MockResponse;
+
+namespace {
+
+struct Sample {
+    double firstByteMs{0}; // hasta que el llamador procesa el primer byte
+    double totalMs{0};
+    long   peakDeltaKb{0}; // pico de RSS sobre el RSS previo a la petición
+    std::size_t lines{0};
+};
+
+// "Procesamiento" mínimo: contar líneas (resultados por caso)
+std::size_t count_lines(std::string_view s) {
+    return static_cast<std::size_t>(std::count(s.begin(), s.end(), '\n'));
+}
+
+Sample run_buffered(cc::http::HttpClient& client, const std::string& url) {
+    cc::testing::reset_peak_rss();
+    const long base = cc::testing::current_rss_kb();
+    const auto t0 = BenchClock::now();
+
+    Sample s;
+    {
+        auto resp = client.get(url);
+        s.firstByteMs = cc::testing::elapsed_us(t0) / 1000.0; // recién ahora hay datos
+        if (!resp.isSuccess()) {
+            std::fprintf(stderr, "request failed: %d\n", resp.statusCode);
+            std::exit(1);
+        }
+        s.lines = count_lines(resp.body);
+        s.totalMs = cc::testing::elapsed_us(t0) / 1000.0;
+    }
+    s.peakDeltaKb = cc::testing::peak_rss_kb() - base;
+    return s;
+}
+
+Sample run_streaming(cc::http::HttpClient& client, const std::string& url) {
+    cc::testing::reset_peak_rss();
+    const long base = cc::testing::current_rss_kb();
+    const auto t0 = BenchClock::now();
+
+    Sample s;
+    bool first = true;
+    auto resp = client.requestStreaming("GET", url, "", {}, [&](std::string_view chunk) {
+        if (first) {
+            s.firstByteMs = cc::testing::elapsed_us(t0) / 1000.0;
+            first = false;
+        }
+        s.lines += count_lines(chunk);
+        return true;
+    });
+    s.totalMs = cc::testing::elapsed_us(t0) / 1000.0;
+    if (!resp.isSuccess()) {
+        std::fprintf(stderr, "streaming request failed: %d\n", resp.statusCode);
+        std::exit(1);
+    }
+    s.peakDeltaKb = cc::testing::peak_rss_kb() - base;
+    return s;
+}
+
+void report(const char* label, const std::vector<Sample>& xs) {
+    std::vector<double> ttfb, total;
+    long peak = 0;
+    for (const auto& x : xs) {
+        ttfb.push_back(x.firstByteMs);
+        total.push_back(x.totalMs);
+        peak = std::max(peak, x.peakDeltaKb);
+    }
+    std::printf("%-34s first-byte p50=%8.1f ms  total p50=%8.1f ms  peak RSS +%7.1f MB  lines=%zu\n",
+                label, cc::testing::percentile(ttfb, 0.5), cc::testing::percentile(total, 0.5),
+                static_cast<double>(peak) / 1024.0, xs.empty() ? 0 : xs.back().lines);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t mb   = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 50;
+    const int         reps = argc > 2 ? std::atoi(argv[2]) : 3;
+    const std::size_t totalBytes = mb * 1024 * 1024;
+
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Warn;
+    cc::logging::Logger::init(lc);
+
+    // Bloque de 64 KB con líneas tipo NDJSON; el servidor lo repite sin materializar 50 MB
+    std::string block;
+    for (int i = 0; block.size() < 64 * 1024; ++i) {
+        block += R"({"case":)" + std::to_string(i) + R"(,"passed":true,"stdout":"0123456789abcdef0123456789abcdef"})" "\n";
+    }
+    block.resize(64 * 1024);
+    block.back() = '\n';
+
+    MockHttpServer server([&](const MockRequest& req) {
+        MockResponse r;
+        r.headers.emplace_back("Content-Type", "application/x-ndjson");
+        if (req.target == "/sized") r.streamLength = totalBytes;
+        r.stream = [&](const cc::testing::ChunkWriter& write) {
+            for (std::size_t sent = 0; sent < totalBytes;) {
+                const std::size_t n = std::min(block.size(), totalBytes - sent);
+                if (!write(std::string_view(block).substr(0, n))) return;
+                sent += n;
+            }
+        };
+        return r;
+    });
+
+    cc::http::HttpClient client;
+    client.setRetries(0);
+    client.setTimeout(120000);
+
+    if (!cc::testing::reset_peak_rss()) {
+        std::fprintf(stderr, "warning: cannot reset VmHWM; peak RSS numbers are cumulative\n");
+    }
+    std::printf("%zu MB response x %d against %s\n", mb, reps, server.base_url().c_str());
+
+    std::vector<Sample> chunked, sized, streamed;
+    for (int i = 0; i < reps; ++i) {
+        chunked.push_back(run_buffered(client, server.base_url() + "/chunked"));
+        sized.push_back(run_buffered(client, server.base_url() + "/sized"));
+        streamed.push_back(run_streaming(client, server.base_url() + "/sized"));
+    }
+    report("buffered (chunked, no length)", chunked);
+    report("buffered (Content-Length reserve)", sized);
+    report("streaming sink", streamed);
+    return 0;
+}
@@ -0,0 +1,181 @@
+// bench_llm_batching.cpp — Latencia de punta a punta y tokens por entrega del coach (análisis +
+// pistas + explicación del fallo) contra un stand-in local de /chat/completions que simula
+// prefill, caché de prefijos del proveedor y decode (support/llm_standin.h):
+//   legacy   make_analyze/hints/explain_failure_prompt, tres llamadas concurrentes
+//   aligned  make_coach_prompt x3 (mismo system + contexto al principio), tres llamadas concurrentes
+//   batched  make_coach_prompt x3 por BatchingLLMClient: una llamada con make_multi_task_prompt
+// Todas las entregas son del mismo problema con código distinto (lo normal en un curso), así
+// que el prefijo system + problema se puede reutilizar entre entregas.
+//
+// Uso: bench_llm_batching [entregas=20] [answer_tokens=120]
+
+#include "contracts/eval_dto.h"
+#include "contracts/problem_dto.h"
+#include "logging/logger.h"
+#include "prompts/coach_prompts.h"
+#include "sdk/llm_batcher.h"
+#include "sdk/llm_client_openai.h"
+
+#include "support/bench_util.h"
+#include "support/llm_standin.h"
+#include "support/mock_http_server.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+using cc::testing::BenchClock;
+using cc::testing::MockHttpServer;
+
+namespace {
+
+enum class Mode { Legacy, Aligned, Batched };
+
+const char* mode_name(Mode m) {
+    switch (m) {
+        case Mode::Legacy:  return "legacy (3 calls)";
+        case Mode::Aligned: return "aligned prefix (3 calls)";
+        case Mode::Batched: return "batched (1 call)";
+    }
+    return "";
+}
+
+cc::contracts::ProblemDetail make_problem() {
+    cc::contracts::ProblemDetail p;
+    p.id         = "two-sum-stream";
+    p.title      = "Suma de pares en un flujo";
+    p.tags       = {"arrays", "hashing", "two-pointers"};
+    p.difficulty = "medium";
+    for (int i = 0; i < 40; ++i) {
+        p.statement += "Párrafo " + std::to_string(i) + ": se recibe una secuencia de enteros a_1..a_n "
+                       "(1 <= n <= 200000, |a_i| <= 10^9) y un objetivo T. Para cada prefijo hay que "
+                       "informar cuántos pares (i, j) con i < j cumplen a_i + a_j = T, módulo 10^9+7.\n";
+    }
+    p.samples = {{"5 6\n1 5 3 3 2\n", "0 1 1 2 2\n"}, {"3 0\n0 0 0\n", "0 1 3\n"}};
+    return p;
+}
+
+std::string make_code(int submission) {
+    std::string code = "#include <bits/stdc++.h>\nusing namespace std;\n// entrega " +
+                       std::to_string(submission) + "\nint main() {\n    long long n, t; cin >> n >> t;\n"
+                       "    vector<long long> a(n);\n";
+    for (int i = 0; i < 30; ++i) {
+        code += "    for (int i" + std::to_string(i) + " = 0; i" + std::to_string(i) + " < n; ++i" +
+                std::to_string(i) + ") { /* paso " + std::to_string(i + submission) + " */ }\n";
+    }
+    code += "    return 0;\n}\n";
+    return code;
+}
+
+cc::contracts::RunResult make_eval(int submission) {
+    cc::contracts::RunResult r;
+    r.passed = false;
+    for (int i = 0; i < 6; ++i) {
+        cc::contracts::RunCaseResult c;
+        c.input    = std::to_string(i + 3) + " " + std::to_string(submission) + "\n1 2 3 4 5 6 7 8\n";
+        c.expected = "0 0 1 1 2 3\n";
+        c.output   = i % 2 ? "0 0 1 1 2 3\n" : "0 0 1 2 2 4\n";
+        c.passed   = i % 2 == 1;
+        c.timeMs   = 12 + i;
+        r.cases.push_back(c);
+    }
+    r.timeMs = 90;
+    return r;
+}
+
+std::vector<cc::prompts::Prompt> prompts_for(Mode mode, int submission, const cc::contracts::ProblemDetail& problem) {
+    using namespace cc::prompts;
+    const std::string code = make_code(submission);
+    const auto eval = make_eval(submission);
+    if (mode == Mode::Legacy) {
+        return {make_analyze_prompt(code, eval, problem),
+                make_hints_prompt(code, eval, problem),
+                make_explain_failure_prompt(code, eval)};
+    }
+    return {make_coach_prompt(CoachTask::Analyze, code, eval, problem),
+            make_coach_prompt(CoachTask::Hints, code, eval, problem),
+            make_coach_prompt(CoachTask::ExplainFailure, code, eval, problem)};
+}
+
+struct Totals {
+    std::vector<double> latencyUs;
+    std::size_t         requests{0};
+    std::uint64_t       promptTokens{0};
+    std::uint64_t       cachedTokens{0};
+    std::uint64_t       completionTokens{0};
+    int                 emptyAnswers{0};
+};
+
+Totals run(Mode mode, int submissions, const cc::testing::LlmStandinOptions& opts,
+           const cc::contracts::ProblemDetail& problem) {
+    auto log = std::make_shared<cc::testing::LlmStandinLog>();
+    MockHttpServer server(cc::testing::make_llm_standin_handler(opts, log));
+    auto openai = std::make_shared<cc::sdk::OpenAIClient>("sk-test", "gpt-test", server.base_url() + "/v1");
+
+    cc::sdk::LlmBatchOptions bo;
+    bo.window = std::chrono::milliseconds(5);
+    cc::sdk::BatchingLLMClient batcher(openai, bo);
+    cc::sdk::ILLMClient& client = mode == Mode::Batched ? static_cast<cc::sdk::ILLMClient&>(batcher) : *openai;
+
+    Totals out;
+    for (int s = 0; s < submissions; ++s) {
+        const auto prompts = prompts_for(mode, s, problem);
+        const auto t0 = BenchClock::now();
+        // Como el pipeline: las tres tareas salen a la vez, cada una en su hilo
+        std::vector<std::future<std::string>> answers;
+        for (const auto& p : prompts) {
+            answers.push_back(std::async(std::launch::async, [&client, &p] { return client.complete(p); }));
+        }
+        for (auto& a : answers) {
+            if (a.get().empty()) ++out.emptyAnswers;
+        }
+        out.latencyUs.push_back(cc::testing::elapsed_us(t0));
+    }
+
+    std::lock_guard<std::mutex> lk(log->m);
+    out.requests         = log->requests;
+    out.promptTokens     = log->promptTokens;
+    out.cachedTokens     = log->cachedTokens;
+    out.completionTokens = log->completionTokens;
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int submissions = argc > 1 ? std::atoi(argv[1]) : 20;
+    cc::testing::LlmStandinOptions opts;
+    if (argc > 2) opts.answerTokens = static_cast<std::size_t>(std::atoi(argv[2]));
+
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Warn;
+    cc::logging::Logger::init(lc);
+
+    const auto problem = make_problem();
+    std::printf("submissions=%d answer_tokens=%zu prefill=%.0f us/token (cached x%.1f) decode=%.0f tok/s\n\n",
+                submissions, opts.answerTokens, opts.prefillUsPerToken, opts.cachedPrefillRatio,
+                opts.decodeTokensPerSec);
+
+    int failures = 0;
+    for (Mode m : {Mode::Legacy, Mode::Aligned, Mode::Batched}) {
+        const Totals t = run(m, submissions, opts, problem);
+        const double n = submissions;
+        std::printf("%-26s p50=%7.1f ms  p99=%7.1f ms  calls/sub=%.1f  prompt tok/sub=%7.0f "
+                    "(cached %5.1f%%)  completion tok/sub=%5.0f\n",
+                    mode_name(m),
+                    cc::testing::percentile(t.latencyUs, 0.50) / 1000.0,
+                    cc::testing::percentile(t.latencyUs, 0.99) / 1000.0,
+                    static_cast<double>(t.requests) / n,
+                    static_cast<double>(t.promptTokens) / n,
+                    t.promptTokens ? 100.0 * static_cast<double>(t.cachedTokens) / static_cast<double>(t.promptTokens) : 0.0,
+                    static_cast<double>(t.completionTokens) / n);
+        if (t.emptyAnswers > 0) {
+            std::fprintf(stderr, "%s: %d empty answers\n", mode_name(m), t.emptyAnswers);
+            ++failures;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+// bench_startup_prewarm.cpp — Latencia de la PRIMERA llamada a cada servicio tras el arranque,
+// con y sin HttpClient::prewarm(). Cada ronda levanta tres servidores nuevos (problems, eval,
+// analyzer: orígenes sin conexiones abiertas, como un proceso recién lanzado) que demoran la
+// primera respuesta de cada conexión para simular DNS + handshake TCP/TLS.
+//
+// Primeras llamadas medidas: GET /problems (request() síncrono, pool), POST /evaluate
+// (request() síncrono) y POST /analyze (requestAsync(), curl_multi).
+//
+// Uso: bench_startup_prewarm [rondas=20] [handshake_ms=80]
+
+#include "config/config_manager.h"
+#include "http/http_client.h"
+#include "logging/logger.h"
+
+#include "support/bench_util.h"
+#include "support/mock_http_server.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using cc::testing::BenchClock;
+using cc::testing::MockHttpServer;
+using cc::testing::MockRequest;
+using cc::testing::MockResponse;
+
+namespace {
+
+struct Samples {
+    std::vector<double> problems;
+    std::vector<double> eval;
+    std::vector<double> analyzer;
+    std::vector<double> prewarm; // lo que tardó prewarm() en segundo plano
+};
+
+std::unique_ptr<MockHttpServer> make_server(int handshakeMs) {
+    auto s = std::make_unique<MockHttpServer>([](const MockRequest& req) {
+        MockResponse r;
+        r.headers.emplace_back("Content-Type", "application/json");
+        r.body = req.method == "HEAD" ? "" : R"({"ok":true})";
+        return r;
+    });
+    s->set_handshake_delay_ms(handshakeMs);
+    return s;
+}
+
+void run_round(bool warm, int handshakeMs, cc::config::Config& cfg, Samples& out) {
+    auto problems = make_server(handshakeMs);
+    auto eval     = make_server(handshakeMs);
+    auto analyzer = make_server(handshakeMs);
+    cfg.endpoints.problemsBaseUrl = problems->base_url();
+    cfg.endpoints.evalBaseUrl     = eval->base_url();
+    cfg.endpoints.analyzerBaseUrl = analyzer->base_url();
+
+    if (warm) {
+        // En la app corre mientras se arma la UI; acá se espera para medir la llamada ya caliente
+        const auto t0 = BenchClock::now();
+        const std::size_t ready = cc::http::HttpClient::prewarm(
+            {cfg.endpoints.problemsBaseUrl, cfg.endpoints.evalBaseUrl, cfg.endpoints.analyzerBaseUrl}).get();
+        out.prewarm.push_back(cc::testing::elapsed_us(t0));
+        if (ready != 3) {
+            std::fprintf(stderr, "prewarm: only %zu/3 origins ready\n", ready);
+            std::exit(1);
+        }
+    }
+
+    cc::http::HttpClient http;
+    auto timed = [](std::vector<double>& into, auto&& call) {
+        const auto t0 = BenchClock::now();
+        const cc::http::HttpResponse r = call();
+        into.push_back(cc::testing::elapsed_us(t0));
+        if (r.statusCode != 200) {
+            std::fprintf(stderr, "request failed: %d %s\n", r.statusCode, r.body.c_str());
+            std::exit(1);
+        }
+    };
+    timed(out.problems, [&] { return http.get(cfg.endpoints.problemsBaseUrl + "/problems"); });
+    timed(out.eval, [&] { return http.post(cfg.endpoints.evalBaseUrl + "/evaluate", R"({"code":""})"); });
+    timed(out.analyzer, [&] {
+        return http.requestAsync("POST", cfg.endpoints.analyzerBaseUrl + "/analyze", R"({"code":""})").get();
+    });
+}
+
+void report(const char* label, const Samples& s) {
+    std::printf("%s\n", label);
+    cc::testing::report_latency("  first GET problems", s.problems);
+    cc::testing::report_latency("  first POST evaluate", s.eval);
+    cc::testing::report_latency("  first async analyze", s.analyzer);
+    if (!s.prewarm.empty()) cc::testing::report_latency("  prewarm (background)", s.prewarm);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int rounds      = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20;
+    const int handshakeMs = argc > 2 ? std::max(0, std::atoi(argv[2])) : 80;
+
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Warn;
+    cc::logging::Logger::init(lc);
+
+    cc::config::Config cfg;
+    cfg.http.retries = 0;
+    cc::config::set_for_tests(cfg);
+
+    std::printf("%d rounds, 3 fresh origins per round, %d ms connection setup\n", rounds, handshakeMs);
+
+    Samples cold, warm;
+    for (int i = 0; i < rounds; ++i) {
+        run_round(false, handshakeMs, cfg, cold);
+        run_round(true, handshakeMs, cfg, warm);
+    }
+    report("without prewarm", cold);
+    report("with prewarm", warm);
+    return 0;
+}
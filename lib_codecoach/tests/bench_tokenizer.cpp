@@ -0,0 +1,274 @@
+// bench_tokenizer.cpp — Throughput (MB/s) de la tokenización local sobre archivos fuente
+// grandes: pre-tokenización, BpeTokenizer::count/encode, el estimador y, como referencia,
+// la misma pre-tokenización con std::regex. Verifica decode(encode(x)) == x y muestra el
+// reparto de fit_to_token_budget sobre tres secciones.
+//
+// Sin --vocab entrena un vocabulario BPE sobre el propio corpus (los .tiktoken reales no se
+// distribuyen con el repo) y lo carga con BpeTokenizer::load, igual que uno real.
+//
+// Uso: bench_tokenizer [--vocab archivo.tiktoken] [--merges 3000] [--mb 16] [archivos...]
+//      (sin archivos: las fuentes de lib_codecoach)
+
+#include "prompts/coach_prompts.h"
+#include "prompts/tokenizer.h"
+
+#include "support/bench_util.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <queue>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using cc::testing::BenchClock;
+
+namespace {
+
+std::string read_file(const fs::path& p) {
+    std::ifstream in(p, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+std::string load_corpus(const std::vector<std::string>& files) {
+    std::string corpus;
+    if (!files.empty()) {
+        for (const auto& f : files) corpus += read_file(f);
+        return corpus;
+    }
+    std::vector<fs::path> paths;
+    for (const auto& e : fs::recursive_directory_iterator(CC_SOURCE_DIR)) {
+        const auto ext = e.path().extension();
+        const auto rel = e.path().lexically_relative(CC_SOURCE_DIR).string();
+        if ((ext == ".cpp" || ext == ".h") && rel.rfind("_", 0) != 0 && rel.rfind("build", 0) != 0) {
+            paths.push_back(e.path());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    for (const auto& p : paths) corpus += read_file(p);
+    return corpus;
+}
+
+std::string base64(std::string_view in) {
+    static const char* a = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    std::size_t i = 0;
+    for (; i + 3 <= in.size(); i += 3) {
+        const unsigned v = (static_cast<unsigned char>(in[i]) << 16) |
+                           (static_cast<unsigned char>(in[i + 1]) << 8) | static_cast<unsigned char>(in[i + 2]);
+        out += a[v >> 18]; out += a[(v >> 12) & 63]; out += a[(v >> 6) & 63]; out += a[v & 63];
+    }
+    if (i < in.size()) {
+        unsigned v = static_cast<unsigned char>(in[i]) << 16;
+        if (i + 1 < in.size()) v |= static_cast<unsigned char>(in[i + 1]) << 8;
+        out += a[v >> 18]; out += a[(v >> 12) & 63];
+        out += i + 1 < in.size() ? a[(v >> 6) & 63] : '=';
+        out += '=';
+    }
+    return out;
+}
+
+// BPE clásico sobre la frecuencia de las piezas: en cada paso se fusiona el par más
+// frecuente. Conteos incrementales (solo se recuentan las palabras que contienen el par) y
+// cola de prioridad con invalidación perezosa.
+std::string train_vocab(const std::string& corpus, int merges) {
+    std::unordered_map<std::string, std::uint64_t> freq;
+    cc::prompts::for_each_pretoken(corpus, [&](std::string_view piece) { ++freq[std::string(piece)]; });
+
+    std::vector<std::string> vocab;
+    for (int b = 0; b < 256; ++b) vocab.emplace_back(1, static_cast<char>(b));
+
+    struct Word {
+        std::vector<std::uint32_t> syms;
+        std::int64_t               n;
+    };
+    std::vector<Word> words;
+    words.reserve(freq.size());
+    for (const auto& [w, n] : freq) {
+        Word word{{}, static_cast<std::int64_t>(n)};
+        for (unsigned char c : w) word.syms.push_back(c);
+        if (word.syms.size() > 1) words.push_back(std::move(word));
+    }
+
+    auto key = [](std::uint32_t a, std::uint32_t b) { return (std::uint64_t{a} << 32) | b; };
+    std::unordered_map<std::uint64_t, std::int64_t> counts;
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> where; // par -> palabras (puede repetir)
+    auto add_pairs = [&](std::uint32_t wi, std::int64_t sign) {
+        const Word& w = words[wi];
+        for (std::size_t i = 0; i + 1 < w.syms.size(); ++i) {
+            const auto k = key(w.syms[i], w.syms[i + 1]);
+            counts[k] += sign * w.n;
+            if (sign > 0) where[k].push_back(wi);
+        }
+    };
+    for (std::uint32_t wi = 0; wi < words.size(); ++wi) add_pairs(wi, +1);
+
+    // (conteo, -par): a igual conteo gana el par menor (determinista)
+    std::priority_queue<std::pair<std::int64_t, std::int64_t>> heap;
+    for (const auto& [k, n] : counts) heap.emplace(n, -static_cast<std::int64_t>(k));
+
+    for (int m = 0; m < merges && !heap.empty();) {
+        const auto [n, negKey] = heap.top();
+        heap.pop();
+        const auto best = static_cast<std::uint64_t>(-negKey);
+        if (counts[best] != n) continue; // entrada vieja
+        if (n < 2) break;
+
+        const auto a = static_cast<std::uint32_t>(best >> 32);
+        const auto b = static_cast<std::uint32_t>(best & 0xFFFFFFFFu);
+        const auto id = static_cast<std::uint32_t>(vocab.size());
+        vocab.push_back(vocab[a] + vocab[b]);
+        ++m;
+
+        std::vector<std::uint32_t> touched = std::move(where[best]);
+        where.erase(best);
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        for (std::uint32_t wi : touched) {
+            Word& w = words[wi];
+            add_pairs(wi, -1);
+            std::size_t out = 0;
+            for (std::size_t i = 0; i < w.syms.size(); ++i) {
+                if (i + 1 < w.syms.size() && w.syms[i] == a && w.syms[i + 1] == b) {
+                    w.syms[out++] = id;
+                    ++i;
+                } else {
+                    w.syms[out++] = w.syms[i];
+                }
+            }
+            w.syms.resize(out);
+            add_pairs(wi, +1);
+            for (std::size_t i = 0; i + 1 < w.syms.size(); ++i) {
+                const auto k = key(w.syms[i], w.syms[i + 1]);
+                heap.emplace(counts[k], -static_cast<std::int64_t>(k));
+            }
+        }
+    }
+
+    std::string file;
+    std::unordered_map<std::string, bool> seen;
+    for (std::size_t r = 0; r < vocab.size(); ++r) {
+        if (seen.emplace(vocab[r], true).second) file += base64(vocab[r]) + " " + std::to_string(r) + "\n";
+    }
+    return file;
+}
+
+// Mejor de 3 pasadas, en MB/s
+template <class Fn>
+double throughput(std::size_t bytes, Fn&& fn) {
+    double best = 1e300;
+    for (int i = 0; i < 3; ++i) {
+        const auto t0 = BenchClock::now();
+        fn();
+        best = std::min(best, cc::testing::elapsed_us(t0));
+    }
+    return static_cast<double>(bytes) / best; // bytes/us == MB/s
+}
+
+volatile std::size_t g_sink = 0;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string vocabPath;
+    int merges = 3000;
+    double mb = 16;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--vocab") && i + 1 < argc) vocabPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--merges") && i + 1 < argc) merges = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--mb") && i + 1 < argc) mb = std::atof(argv[++i]);
+        else files.emplace_back(argv[i]);
+    }
+
+    const std::string source = load_corpus(files);
+    if (source.empty()) {
+        std::fprintf(stderr, "empty corpus\n");
+        return 1;
+    }
+
+    // Vocabulario
+    std::shared_ptr<cc::prompts::BpeTokenizer> bpe;
+    if (vocabPath.empty()) {
+        const auto t0 = BenchClock::now();
+        const std::string vocab = train_vocab(source, merges);
+        vocabPath = (fs::temp_directory_path() / ("cc_bench_vocab_" + std::to_string(::getpid()) + ".tiktoken")).string();
+        std::ofstream(vocabPath, std::ios::binary) << vocab;
+        std::printf("trained vocabulary: %d merges on %.1f KB in %.0f ms\n",
+                    merges, static_cast<double>(source.size()) / 1024.0, cc::testing::elapsed_us(t0) / 1000.0);
+        bpe = cc::prompts::BpeTokenizer::load(vocabPath, "trained");
+        fs::remove(vocabPath);
+    } else {
+        const auto t0 = BenchClock::now();
+        bpe = cc::prompts::BpeTokenizer::load(vocabPath);
+        std::printf("loaded %s in %.0f ms\n", vocabPath.c_str(), cc::testing::elapsed_us(t0) / 1000.0);
+    }
+    std::printf("vocabulary: %s, %zu tokens\n", bpe->name().c_str(), bpe->vocab_size());
+
+    // Corpus grande: las fuentes repetidas hasta `mb` MB
+    std::string corpus;
+    const auto target = static_cast<std::size_t>(mb * 1024 * 1024);
+    while (corpus.size() < target) corpus += source;
+    std::printf("corpus: %.1f MB (%zu source bytes repeated)\n\n",
+                static_cast<double>(corpus.size()) / (1024.0 * 1024.0), source.size());
+
+    const bool roundtrip = bpe->decode(bpe->encode(source)) == source;
+    const std::size_t tokens = bpe->count(corpus);
+    const std::size_t approx = cc::prompts::approx_tokenizer().count(corpus);
+
+    const double pre = throughput(corpus.size(), [&] {
+        std::size_t n = 0;
+        cc::prompts::for_each_pretoken(corpus, [&](std::string_view) { ++n; });
+        g_sink = n;
+    });
+    const double count = throughput(corpus.size(), [&] { g_sink = bpe->count(corpus); });
+    const double encode = throughput(corpus.size(), [&] { g_sink = bpe->encode(corpus).size(); });
+    const double est = throughput(corpus.size(), [&] { g_sink = cc::prompts::approx_tokenizer().count(corpus); });
+
+    // Referencia: el patrón de cl100k (versión ASCII) con std::regex, sobre una muestra
+    const std::string sample = corpus.substr(0, std::min<std::size_t>(corpus.size(), 256 * 1024));
+    const std::regex re(R"('s|'t|'re|'ve|'m|'ll|'d|[^\r\nA-Za-z0-9]?[A-Za-z]+|[0-9]{1,3}| ?[^\sA-Za-z0-9]+[\r\n]*|\s*[\r\n]+|\s+(?!\S)|\s+)");
+    const double rx = throughput(sample.size(), [&] {
+        std::size_t n = 0;
+        for (auto it = std::sregex_iterator(sample.begin(), sample.end(), re); it != std::sregex_iterator(); ++it) ++n;
+        g_sink = n;
+    });
+
+    std::printf("%-34s %9.1f MB/s\n", "pre-tokenize (std::regex, 256 KB)", rx);
+    std::printf("%-34s %9.1f MB/s\n", "pre-tokenize (byte classes)", pre);
+    std::printf("%-34s %9.1f MB/s\n", "BpeTokenizer::count", count);
+    std::printf("%-34s %9.1f MB/s\n", "BpeTokenizer::encode", encode);
+    std::printf("%-34s %9.1f MB/s\n", "approx_tokenizer().count", est);
+    std::printf("\ntokens: %zu (%.2f bytes/token), estimate %zu (%+.1f%%)\n", tokens,
+                static_cast<double>(corpus.size()) / static_cast<double>(tokens), approx,
+                100.0 * (static_cast<double>(approx) - static_cast<double>(tokens)) / static_cast<double>(tokens));
+    std::printf("8000 chars of this code = %zu tokens\n", bpe->count(source.substr(0, 8000)));
+    std::printf("decode(encode(x)) == x: %s\n", roundtrip ? "yes" : "NO");
+
+    // Reparto por prioridad: código > eval > problema, presupuesto menor que el total
+    std::vector<cc::prompts::PromptSection> sections = {
+        {source.substr(0, 6000), 1, 128},       // "problema"
+        {source.substr(6000, 6000), 2, 192},    // "eval"
+        {source.substr(12000, 24000), 3, 384},  // "código"
+    };
+    std::vector<std::size_t> before;
+    for (const auto& s : sections) before.push_back(bpe->count(s.text));
+    const std::size_t fitted = cc::prompts::fit_to_token_budget(sections, 4000, *bpe);
+    std::printf("\nfit_to_token_budget(4000): problem %zu->%zu, eval %zu->%zu, code %zu->%zu (total %zu)\n",
+                before[0], bpe->count(sections[0].text), before[1], bpe->count(sections[1].text),
+                before[2], bpe->count(sections[2].text), fitted);
+
+    return roundtrip && fitted <= 4000 ? 0 : 1;
+}
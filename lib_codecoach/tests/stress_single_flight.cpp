@@ -0,0 +1,80 @@
+// stress_single_flight.cpp — 1000 llamadores concurrentes piden el mismo listado de problemas
+// (desde varios ProblemsClient) contra un servidor local lento: con single-flight debe salir
+// un solo request upstream y todos reciben la misma respuesta. Devuelve != 0 si falla.
+//
+// Uso: stress_single_flight [llamadores=1000] [clientes=8]
+
+#include "sdk/problems_client.h"
+#include "logging/logger.h"
+#include "metrics/counters.h"
+
+#include "support/bench_util.h"
+#include "support/mock_http_server.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <latch>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using cc::testing::MockHttpServer;
+using cc::testing::MockRequest;
+using cc::testing::MockResponse;
+
+int main(int argc, char** argv) {
+    const int callers = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1000;
+    const int clients = argc > 2 ? std::max(1, std::atoi(argv[2])) : 8;
+
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Warn;
+    cc::logging::Logger::init(lc);
+
+    std::atomic<int> upstream{0};
+    MockHttpServer server([&upstream](const MockRequest&) {
+        upstream.fetch_add(1);
+        MockResponse r;
+        r.delayMs = 300; // ventana para que todos los llamadores se sumen al vuelo
+        r.headers.emplace_back("Content-Type", "application/json");
+        r.headers.emplace_back("Cache-Control", "no-store"); // sin caché: solo coalescencia
+        r.body = R"([{"id":"p1","title":"Two Sum","difficulty":"easy","tags":["array"]},)"
+                 R"({"id":"p2","title":"LRU Cache","difficulty":"medium","tags":["design"]}])";
+        return r;
+    });
+
+    std::vector<std::unique_ptr<cc::sdk::ProblemsClient>> pool;
+    for (int i = 0; i < clients; ++i) pool.push_back(std::make_unique<cc::sdk::ProblemsClient>(server.base_url()));
+
+    std::atomic<int> ok{0};
+    std::latch start(1);
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<std::size_t>(callers));
+    for (int i = 0; i < callers; ++i) {
+        threads.emplace_back([&, i] {
+            start.wait();
+            const auto problems = pool[static_cast<std::size_t>(i % clients)]->list();
+            if (problems.size() == 2 && problems[1].title == "LRU Cache") ok.fetch_add(1);
+        });
+    }
+
+    const auto t0 = cc::testing::BenchClock::now();
+    start.count_down();
+    for (auto& t : threads) t.join();
+    const double ms = cc::testing::elapsed_us(t0) / 1000.0;
+
+    std::printf("callers=%d clients=%d upstream=%d ok=%d elapsed=%.1f ms shared=%lld\n",
+                callers, clients, upstream.load(), ok.load(), ms,
+                static_cast<long long>(cc::metrics::Counters::instance().value("http.singleflight.shared")));
+
+    // Terminado el vuelo, la siguiente llamada vuelve a salir a la red (no se reutiliza)
+    const bool again = pool[0]->list().size() == 2;
+
+    if (upstream.load() != 2 || ok.load() != callers || !again) {
+        std::fprintf(stderr, "FAIL: expected 1 shared upstream request for %d callers (+1 after), got %d; ok=%d\n",
+                     callers, upstream.load(), ok.load());
+        return 1;
+    }
+    std::printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,66 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// bench_util.h — Helpers comunes para los benchmarks (percentiles, cronómetro en µs, reporte,
+// memoria residual del proceso).
+#ifndef LIB_CODECOACH_BENCH_UTIL_H
+#define LIB_CODECOACH_BENCH_UTIL_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace cc::testing {
+
+    using BenchClock = std::chrono::steady_clock;
+
+    inline double elapsed_us(BenchClock::time_point since) {
+        return std::chrono::duration<double, std::micro>(BenchClock::now() - since).count();
+    }
+
+    // Percentil q en [0,1] (nearest-rank). Ordena una copia.
+    inline double percentile(std::vector<double> xs, double q) {
+        if (xs.empty()) return 0.0;
+        std::sort(xs.begin(), xs.end());
+        const auto rank = static_cast<std::size_t>(std::ceil(q * static_cast<double>(xs.size())));
+        return xs[std::min(xs.size() - 1, rank == 0 ? 0 : rank - 1)];
+    }
+
+    inline void report_latency(const std::string& label, const std::vector<double>& samples_us) {
+        std::printf("%-28s n=%-6zu p50=%9.1f us  p99=%9.1f us  max=%9.1f us\n",
+                    label.c_str(), samples_us.size(),
+                    percentile(samples_us, 0.50),
+                    percentile(samples_us, 0.99),
+                    percentile(samples_us, 1.00));
+    }
+
+    // Linux: campo "VmHWM"/"VmRSS" de /proc/self/status en KB (0 si no está disponible).
+    inline long proc_status_kb(const char* field) {
+        std::ifstream in("/proc/self/status");
+        std::string line;
+        const std::string key = std::string(field) + ":";
+        while (std::getline(in, line)) {
+            if (line.rfind(key, 0) == 0) return std::atol(line.c_str() + key.size());
+        }
+        return 0;
+    }
+
+    inline long peak_rss_kb()    { return proc_status_kb("VmHWM"); }
+    inline long current_rss_kb() { return proc_status_kb("VmRSS"); }
+
+    // Reinicia el pico (VmHWM) al RSS actual (Linux >= 4.0). Devuelve false si no se pudo.
+    inline bool reset_peak_rss() {
+        std::ofstream out("/proc/self/clear_refs");
+        out << "5";
+        return static_cast<bool>(out.flush());
+    }
+
+} // namespace cc::testing
+
+#endif // LIB_CODECOACH_BENCH_UTIL_H
@@ -0,0 +1,149 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// llm_standin.h — Stand-in local de POST /chat/completions (respuesta JSON, sin stream) que
+// simula el costo de un proveedor real para MockHttpServer:
+//   - latencia base + prefill por token de prompt no cacheado (los cacheados cuestan una
+//     fracción) + decode a una tasa fija de tokens/s;
+//   - caché de prefijos del proveedor: bloques de `cacheBlockTokens` a partir de
+//     `cacheMinTokens` (como la API de OpenAI); un prefijo queda cacheado al terminar su
+//     prefill, así que dos requests simultáneos con el mismo prefijo pagan los dos;
+//   - prompts con "### TAREA k" (make_multi_task_prompt) reciben una sección
+//     "### RESPUESTA k" por tarea.
+// Devuelve "usage" con prompt_tokens_details.cached_tokens y acumula totales en LlmStandinLog.
+// Tokens contados con cc::prompts::approx_tokenizer(). Header-only, solo para benchmarks.
+#ifndef LIB_CODECOACH_LLM_STANDIN_H
+#define LIB_CODECOACH_LLM_STANDIN_H
+
+#include "mock_http_server.h"
+#include "prompts/tokenizer.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace cc::testing {
+
+    struct LlmStandinOptions {
+        double      baseMs{40.0};            // red + cola del proveedor
+        double      prefillUsPerToken{150.0}; // token de prompt sin caché
+        double      cachedPrefillRatio{0.1};  // costo relativo de un token cacheado
+        double      decodeTokensPerSec{400.0};
+        std::size_t answerTokens{120};        // tokens generados por tarea
+        std::size_t cacheMinTokens{1024};
+        std::size_t cacheBlockTokens{128};
+    };
+
+    struct LlmStandinLog {
+        std::mutex    m;
+        std::size_t   requests{0};
+        std::uint64_t promptTokens{0};
+        std::uint64_t cachedTokens{0};
+        std::uint64_t completionTokens{0};
+        std::unordered_set<std::size_t> prefixes; // hashes de prefijos cacheados
+
+        void reset_totals() {
+            std::lock_guard<std::mutex> lk(m);
+            requests = 0;
+            promptTokens = cachedTokens = completionTokens = 0;
+        }
+    };
+
+    // Cuenta las secciones "### TAREA k" del mensaje (0 => prompt de una sola tarea)
+    inline std::size_t standin_task_count(std::string_view user) {
+        std::size_t n = 0;
+        for (std::size_t pos = 0; (pos = user.find("### TAREA ", pos)) != std::string_view::npos; pos += 10) ++n;
+        return n;
+    }
+
+    inline MockHttpServer::Handler make_llm_standin_handler(LlmStandinOptions opts,
+                                                            std::shared_ptr<LlmStandinLog> log) {
+        return [opts, log](const MockRequest& req) {
+            const auto body = nlohmann::json::parse(req.body, nullptr, false);
+            std::string text; // mensajes concatenados, como los ve el modelo
+            std::string user;
+            if (!body.is_discarded()) {
+                for (const auto& msg : body.value("messages", nlohmann::json::array())) {
+                    const std::string content = msg.value("content", "");
+                    text += msg.value("role", "") + "\n" + content + "\n";
+                    if (msg.value("role", "") == "user") user = content;
+                }
+            }
+
+            const auto& tok = cc::prompts::approx_tokenizer();
+            std::vector<std::size_t> ends;
+            tok.token_ends(text, ends);
+            const std::size_t promptTokens = ends.size();
+
+            // Bloques de prefijo: el más largo ya visto es el cacheado
+            std::vector<std::size_t> blocks;
+            for (std::size_t t = opts.cacheMinTokens; t <= promptTokens; t += opts.cacheBlockTokens) {
+                blocks.push_back(std::hash<std::string_view>{}(std::string_view(text).substr(0, ends[t - 1])));
+            }
+            std::size_t cached = 0;
+            {
+                std::lock_guard<std::mutex> lk(log->m);
+                for (std::size_t i = blocks.size(); i-- > 0;) {
+                    if (log->prefixes.count(blocks[i])) {
+                        cached = opts.cacheMinTokens + i * opts.cacheBlockTokens;
+                        break;
+                    }
+                }
+            }
+
+            const double prefillUs = opts.prefillUsPerToken *
+                (static_cast<double>(promptTokens - cached) + opts.cachedPrefillRatio * static_cast<double>(cached));
+            std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long long>(opts.baseMs * 1000.0 + prefillUs)));
+            {
+                std::lock_guard<std::mutex> lk(log->m);
+                log->prefixes.insert(blocks.begin(), blocks.end());
+            }
+
+            // Respuesta: " paso" x answerTokens por tarea (un token cada uno)
+            const std::size_t tasks = standin_task_count(user);
+            std::string answer;
+            for (std::size_t k = 1; k <= std::max<std::size_t>(tasks, 1); ++k) {
+                if (tasks > 0) answer += "### RESPUESTA " + std::to_string(k) + "\n";
+                answer += "Tarea " + std::to_string(k) + ":";
+                for (std::size_t i = 0; i < opts.answerTokens; ++i) answer += " paso";
+                answer += "\n";
+            }
+            const std::size_t completionTokens = tok.count(answer);
+            std::this_thread::sleep_for(std::chrono::microseconds(
+                static_cast<long long>(1e6 * static_cast<double>(completionTokens) / opts.decodeTokensPerSec)));
+
+            {
+                std::lock_guard<std::mutex> lk(log->m);
+                ++log->requests;
+                log->promptTokens += promptTokens;
+                log->cachedTokens += cached;
+                log->completionTokens += completionTokens;
+            }
+
+            nlohmann::json out;
+            out["choices"] = nlohmann::json::array(
+                {{{"index", 0}, {"message", {{"role", "assistant"}, {"content", answer}}}}});
+            out["usage"] = {{"prompt_tokens", promptTokens},
+                            {"completion_tokens", completionTokens},
+                            {"prompt_tokens_details", {{"cached_tokens", cached}}}};
+            MockResponse r;
+            r.headers.emplace_back("Content-Type", "application/json");
+            r.body = out.dump();
+            return r;
+        };
+    }
+
+} // namespace cc::testing
+
+#endif // LIB_CODECOACH_LLM_STANDIN_H
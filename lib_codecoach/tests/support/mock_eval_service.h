@@ -0,0 +1,304 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// mock_eval_service.h — Servicio de evaluación falso sobre MockHttpServer, con latencia del
+// juez configurable:
+//   POST /evaluate            retiene la conexión mientras el juez evalúa y responde el RunResult
+//   POST /evaluate/stream     NDJSON: una línea por caso apenas termina y un resumen al final;
+//                             si el cliente corta, el juez deja de evaluar
+//   POST /evaluate/batch      {"submissions": [...]} => NDJSON con un resultado por línea en
+//                             orden de finalización ({"type":"result","index":i,"result":{...}})
+//                             y {"type":"done"} al final
+//   POST /submissions         202 {"submissionId": "..."} al instante
+//   GET  /results/{id}        200 con el RunResult si ya pasó `judgeMs`, 202 si no; con
+//                             ?waitMs=N y longPoll activo retiene el GET hasta que esté listo
+//                             (o pasen N ms)
+// Evaluar cuesta `judgeMs` (compilación) + `caseMs` por caso; el caso `failAt` (si >= 0) da
+// respuesta incorrecta y con "failFast" en el request el juez se detiene ahí. `judgeSlots`
+// limita cuántas evaluaciones de /evaluate y /evaluate/batch corren a la vez (0 => sin límite)
+// y cada request HTTP cuesta además `requestMs` (auth, cola, registro). Con `testSetVersion`
+// los resultados informan esa versión del set de tests.
+// Header-only, solo para tests y benchmarks.
+#ifndef LIB_CODECOACH_MOCK_EVAL_SERVICE_H
+#define LIB_CODECOACH_MOCK_EVAL_SERVICE_H
+
+#include "mock_http_server.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace cc::testing {
+
+    struct MockEvalOptions {
+        int         judgeMs{200};
+        bool        longPoll{true};  // false => ignora waitMs (el cliente hace polling corto)
+        std::size_t cases{3};
+        int         caseMs{0};
+        long        failAt{-1};
+        std::size_t judgeSlots{0};
+        int         requestMs{0};
+        std::string testSetVersion;
+    };
+
+    struct MockEvalStats {
+        std::atomic<std::size_t> judged{0};      // evaluaciones recibidas (síncronas + encoladas)
+        std::atomic<std::size_t> casesJudged{0}; // casos que el juez llegó a correr
+        std::atomic<std::size_t> polls{0};       // GET /results
+        std::atomic<std::size_t> requests{0};    // requests HTTP recibidos
+        std::atomic<std::size_t> inFlight{0};    // requests retenidos ahora mismo
+        std::atomic<std::size_t> peakInFlight{0};
+    };
+
+    class MockEvalService {
+    public:
+        explicit MockEvalService(MockEvalOptions opts = {})
+            : state_(std::make_shared<Shared>()),
+              server_(make_handler(opts, state_)) {}
+
+        std::string base_url() const { return server_.base_url(); }
+        std::size_t connections() const noexcept { return server_.connections(); }
+        const MockEvalStats& stats() const noexcept { return state_->stats; }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Shared {
+            std::mutex                                         m;
+            std::unordered_map<std::string, Clock::time_point> readyAt;
+            std::unordered_map<std::string, std::size_t>       judgedCases;
+            std::size_t                                        nextId{0};
+            MockEvalStats                                      stats;
+            std::condition_variable                            slotFreed;
+            std::size_t                                        busySlots{0};
+        };
+
+        // Ocupa un slot del juez mientras dura `time`
+        static void judge(const MockEvalOptions& opts, Shared& st, std::chrono::milliseconds time) {
+            if (opts.judgeSlots > 0) {
+                std::unique_lock<std::mutex> lk(st.m);
+                st.slotFreed.wait(lk, [&] { return st.busySlots < opts.judgeSlots; });
+                ++st.busySlots;
+            }
+            std::this_thread::sleep_for(time);
+            if (opts.judgeSlots > 0) {
+                std::lock_guard<std::mutex> lk(st.m);
+                --st.busySlots;
+                st.slotFreed.notify_one();
+            }
+        }
+
+        static bool fail_fast(const nlohmann::json& j) {
+            return j.is_object() && j.value("failFast", false);
+        }
+
+        static bool fail_fast(const MockRequest& req) {
+            return fail_fast(nlohmann::json::parse(req.body, nullptr, false));
+        }
+
+        // Casos que corre el juez para este request
+        static std::size_t cases_to_judge(const MockEvalOptions& opts, bool failFast) {
+            if (failFast && opts.failAt >= 0 && static_cast<std::size_t>(opts.failAt) < opts.cases) {
+                return static_cast<std::size_t>(opts.failAt) + 1;
+            }
+            return opts.cases;
+        }
+
+        static std::chrono::milliseconds judge_time(const MockEvalOptions& opts, std::size_t cases) {
+            return std::chrono::milliseconds(opts.judgeMs + opts.caseMs * static_cast<long>(cases));
+        }
+
+        static nlohmann::json case_json(const MockEvalOptions& opts, std::size_t i) {
+            const bool ok = static_cast<long>(i) != opts.failAt;
+            return {{"input", std::to_string(i)}, {"output", ok ? std::to_string(i) : "x"},
+                    {"expected", std::to_string(i)}, {"passed", ok}, {"timeMs", opts.caseMs}};
+        }
+
+        static nlohmann::json summary_json(const MockEvalOptions& opts, std::size_t judged) {
+            const bool passed = opts.failAt < 0 || static_cast<std::size_t>(opts.failAt) >= opts.cases;
+            nlohmann::json j{{"passed", passed}, {"timeMs", judge_time(opts, judged).count()},
+                             {"stoppedEarly", judged < opts.cases}};
+            if (!opts.testSetVersion.empty()) j["testSetVersion"] = opts.testSetVersion;
+            return j;
+        }
+
+        static std::string result_json(const MockEvalOptions& opts, std::size_t judged) {
+            nlohmann::json j = summary_json(opts, judged);
+            j["cases"] = nlohmann::json::array();
+            for (std::size_t i = 0; i < judged; ++i) j["cases"].push_back(case_json(opts, i));
+            return j.dump();
+        }
+
+        static MockResponse json_response(int status, std::string body) {
+            MockResponse r;
+            r.status = status;
+            r.headers.emplace_back("Content-Type", "application/json");
+            r.body = std::move(body);
+            return r;
+        }
+
+        static MockHttpServer::Handler make_handler(MockEvalOptions opts, std::shared_ptr<Shared> st) {
+            return [opts, st](const MockRequest& req) {
+                auto& stats = st->stats;
+                const std::size_t now = ++stats.inFlight;
+                std::size_t peak = stats.peakInFlight.load();
+                while (now > peak && !stats.peakInFlight.compare_exchange_weak(peak, now)) {}
+                struct Leave {
+                    MockEvalStats& s;
+                    ~Leave() { --s.inFlight; }
+                } leave{stats};
+                ++stats.requests;
+                if (opts.requestMs > 0) std::this_thread::sleep_for(std::chrono::milliseconds(opts.requestMs));
+
+                if (req.method == "POST" && req.target == "/evaluate") {
+                    ++stats.judged;
+                    const std::size_t n = cases_to_judge(opts, fail_fast(req));
+                    judge(opts, *st, judge_time(opts, n));
+                    stats.casesJudged += n;
+                    return json_response(200, result_json(opts, n));
+                }
+
+                if (req.method == "POST" && req.target == "/evaluate/batch") {
+                    const auto body = nlohmann::json::parse(req.body, nullptr, false);
+                    if (body.is_discarded() || !body.contains("submissions") || !body["submissions"].is_array()) {
+                        return json_response(400, R"({"error":"submissions expected"})");
+                    }
+                    std::vector<std::size_t> cases;
+                    for (const auto& sub : body["submissions"]) cases.push_back(cases_to_judge(opts, fail_fast(sub)));
+                    stats.judged += cases.size();
+
+                    MockResponse r;
+                    r.headers.emplace_back("Content-Type", "application/x-ndjson");
+                    r.stream = [opts, st, cases](const ChunkWriter& write) {
+                        // Varios jueces del lote en paralelo; las líneas salen al terminar cada uno
+                        std::mutex                 qm;
+                        std::condition_variable    qcv;
+                        std::vector<std::string>   ready;
+                        std::atomic<std::size_t>   next{0};
+                        std::atomic<bool>          gone{false};
+                        std::size_t                finished = 0;
+
+                        std::vector<std::thread> judges;
+                        const std::size_t width = std::min<std::size_t>(cases.size(), 32);
+                        for (std::size_t t = 0; t < width; ++t) {
+                            judges.emplace_back([&] {
+                                for (std::size_t i; !gone.load() && (i = next++) < cases.size();) {
+                                    judge(opts, *st, judge_time(opts, cases[i]));
+                                    st->stats.casesJudged += cases[i];
+                                    nlohmann::json line{{"type", "result"}, {"index", i}};
+                                    line["result"] = nlohmann::json::parse(result_json(opts, cases[i]));
+                                    std::lock_guard<std::mutex> lk(qm);
+                                    ready.push_back(line.dump() + "\n");
+                                    qcv.notify_one();
+                                }
+                            });
+                        }
+
+                        std::unique_lock<std::mutex> lk(qm);
+                        while (finished < cases.size() && !gone.load()) {
+                            qcv.wait(lk, [&] { return !ready.empty(); });
+                            std::vector<std::string> out;
+                            out.swap(ready);
+                            lk.unlock();
+                            for (const auto& line : out) {
+                                if (!write(line)) {
+                                    gone.store(true); // el cliente cortó
+                                    break;
+                                }
+                                ++finished;
+                            }
+                            lk.lock();
+                        }
+                        lk.unlock();
+                        for (auto& th : judges) th.join();
+                        if (!gone.load()) write(R"({"type":"done"})" "\n");
+                    };
+                    return r;
+                }
+
+                if (req.method == "POST" && req.target == "/evaluate/stream") {
+                    ++stats.judged;
+                    const std::size_t n = cases_to_judge(opts, fail_fast(req));
+                    MockResponse r;
+                    r.headers.emplace_back("Content-Type", "application/x-ndjson");
+                    r.stream = [opts, st, n](const ChunkWriter& write) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(opts.judgeMs));
+                        for (std::size_t i = 0; i < n; ++i) {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(opts.caseMs));
+                            ++st->stats.casesJudged;
+                            nlohmann::json line = case_json(opts, i);
+                            line["type"]  = "case";
+                            line["index"] = i;
+                            if (!write(line.dump() + "\n")) return; // el cliente cortó
+                        }
+                        nlohmann::json summary = summary_json(opts, n);
+                        summary["type"] = "summary";
+                        write(summary.dump() + "\n");
+                    };
+                    return r;
+                }
+
+                if (req.method == "POST" && req.target == "/submissions") {
+                    ++stats.judged;
+                    const std::size_t n = cases_to_judge(opts, fail_fast(req));
+                    stats.casesJudged += n;
+                    std::string id;
+                    {
+                        std::lock_guard<std::mutex> lk(st->m);
+                        id = "s" + std::to_string(++st->nextId);
+                        st->readyAt[id] = Clock::now() + judge_time(opts, n);
+                        st->judgedCases[id] = n;
+                    }
+                    return json_response(202, nlohmann::json{{"submissionId", id}}.dump());
+                }
+
+                const std::string prefix = "/results/";
+                if (req.method == "GET" && req.target.rfind(prefix, 0) == 0) {
+                    ++stats.polls;
+                    std::string id = req.target.substr(prefix.size());
+                    long waitMs = 0;
+                    if (const auto q = id.find('?'); q != std::string::npos) {
+                        if (const auto w = id.find("waitMs=", q); w != std::string::npos) {
+                            waitMs = std::atol(id.c_str() + w + 7);
+                        }
+                        id.erase(q);
+                    }
+
+                    Clock::time_point ready;
+                    std::size_t       n = 0;
+                    {
+                        std::lock_guard<std::mutex> lk(st->m);
+                        auto it = st->readyAt.find(id);
+                        if (it == st->readyAt.end()) return json_response(404, R"({"error":"unknown submission"})");
+                        ready = it->second;
+                        n     = st->judgedCases[id];
+                    }
+                    if (opts.longPoll && waitMs > 0) {
+                        std::this_thread::sleep_until(std::min(ready, Clock::now() + std::chrono::milliseconds(waitMs)));
+                    }
+                    if (Clock::now() < ready) return json_response(202, R"({"status":"pending"})");
+                    return json_response(200, result_json(opts, n));
+                }
+
+                return json_response(404, R"({"error":"not found"})");
+            };
+        }
+
+        std::shared_ptr<Shared> state_;
+        MockHttpServer          server_;
+    };
+
+} // namespace cc::testing
+
+#endif // LIB_CODECOACH_MOCK_EVAL_SERVICE_H
@@ -0,0 +1,301 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// mock_http_server.h — Servidor HTTP/1.1 mínimo (POSIX, header-only) para benchmarks y pruebas
+// locales. Escucha en 127.0.0.1 con puerto efímero, un hilo por conexión, soporta keep-alive,
+// "Expect: 100-continue" y respuestas en streaming (chunked).
+#ifndef LIB_CODECOACH_MOCK_HTTP_SERVER_H
+#define LIB_CODECOACH_MOCK_HTTP_SERVER_H
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cc::testing {
+
+    using MockHeaders = std::vector<std::pair<std::string, std::string>>;
+
+    struct MockRequest {
+        std::string method;
+        std::string target;   // "/problems/1?x=y"
+        MockHeaders headers;
+        std::string body;
+
+        // Header case-insensitive ("" si no existe)
+        std::string header(std::string_view key) const {
+            for (const auto& [k, v] : headers) {
+                if (k.size() == key.size() &&
+                    std::equal(k.begin(), k.end(), key.begin(), [](char a, char b) {
+                        return std::tolower(static_cast<unsigned char>(a)) ==
+                               std::tolower(static_cast<unsigned char>(b));
+                    })) {
+                    return v;
+                }
+            }
+            return {};
+        }
+    };
+
+    // Escribe un chunk; devuelve false si el cliente cerró la conexión.
+    using ChunkWriter = std::function<bool(std::string_view)>;
+
+    struct MockResponse {
+        int         status{200};
+        MockHeaders headers;
+        std::string body;
+        int         delayMs{0};  // espera antes de responder (simula backend lento)
+        bool        close{false};
+        // Si está definido, la respuesta se envía con Transfer-Encoding: chunked.
+        std::function<void(const ChunkWriter&)> stream;
+        // Con stream: si se conoce el total, se envía Content-Length en vez de chunked
+        // (el handler debe escribir exactamente esa cantidad de bytes).
+        std::optional<std::size_t> streamLength;
+    };
+
+    class MockHttpServer {
+    public:
+        using Handler = std::function<MockResponse(const MockRequest&)>;
+
+        explicit MockHttpServer(Handler handler) : handler_(std::move(handler)) {
+            listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+            if (listen_fd_ < 0) throw std::runtime_error("mock server: socket() failed");
+            int one = 1;
+            ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+            sockaddr_in addr{};
+            addr.sin_family      = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port        = 0;
+            if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+                ::listen(listen_fd_, 1024) != 0) {
+                ::close(listen_fd_);
+                throw std::runtime_error("mock server: bind/listen failed");
+            }
+            socklen_t len = sizeof(addr);
+            ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+            port_ = ntohs(addr.sin_port);
+
+            acceptor_ = std::thread([this] { accept_loop(); });
+        }
+
+        ~MockHttpServer() { stop(); }
+
+        MockHttpServer(const MockHttpServer&) = delete;
+        MockHttpServer& operator=(const MockHttpServer&) = delete;
+
+        void stop() {
+            if (stopping_.exchange(true)) return;
+            ::shutdown(listen_fd_, SHUT_RDWR);
+            ::close(listen_fd_);
+            if (acceptor_.joinable()) acceptor_.join();
+
+            std::list<Conn> conns;
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                conns.swap(conns_);
+            }
+            for (auto& c : conns) ::shutdown(c.fd, SHUT_RDWR);
+            for (auto& c : conns) {
+                if (c.th.joinable()) c.th.join();
+                ::close(c.fd);
+            }
+        }
+
+        int port() const noexcept { return port_; }
+        std::string base_url() const { return "http://127.0.0.1:" + std::to_string(port_); }
+
+        std::size_t connections() const noexcept { return connections_.load(); }
+        std::size_t requests()    const noexcept { return requests_.load(); }
+
+        // Demora la primera respuesta de cada conexión nueva: simula lo que cuesta abrirla
+        // contra un servicio real (resolución DNS, handshake TCP + TLS).
+        void set_handshake_delay_ms(int ms) noexcept { handshakeDelayMs_.store(ms); }
+
+    private:
+        struct Conn {
+            int                                fd{-1};
+            std::thread                        th;
+            std::shared_ptr<std::atomic<bool>> done;
+        };
+
+        // Une hilos de conexiones ya terminadas (llamar con m_ tomado).
+        void reap_locked() {
+            for (auto it = conns_.begin(); it != conns_.end();) {
+                if (it->done->load()) {
+                    it->th.join();
+                    ::close(it->fd);
+                    it = conns_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        void accept_loop() {
+            while (!stopping_.load()) {
+                int fd = ::accept(listen_fd_, nullptr, nullptr);
+                if (fd < 0) {
+                    if (stopping_.load()) return;
+                    continue;
+                }
+                int one = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                ++connections_;
+
+                std::lock_guard<std::mutex> lk(m_);
+                reap_locked();
+                auto done = std::make_shared<std::atomic<bool>>(false);
+                conns_.push_back(Conn{fd, {}, done});
+                conns_.back().th = std::thread([this, fd, done] {
+                    serve(fd);
+                    done->store(true);
+                });
+            }
+        }
+
+        static bool send_all(int fd, std::string_view data) {
+            while (!data.empty()) {
+                const auto n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+                if (n <= 0) return false;
+                data.remove_prefix(static_cast<std::size_t>(n));
+            }
+            return true;
+        }
+
+        // Lee un bloque más del socket y lo agrega a buf. false si EOF/error.
+        static bool read_more(int fd, std::string& buf) {
+            char tmp[64 * 1024];
+            const auto n = ::recv(fd, tmp, sizeof(tmp), 0);
+            if (n <= 0) return false;
+            buf.append(tmp, static_cast<std::size_t>(n));
+            return true;
+        }
+
+        void serve(int fd) {
+            std::string buf;
+            if (const int d = handshakeDelayMs_.load(); d > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(d));
+            }
+            while (!stopping_.load()) {
+                // Cabecera completa
+                std::size_t hdr_end;
+                while ((hdr_end = buf.find("\r\n\r\n")) == std::string::npos) {
+                    if (!read_more(fd, buf)) return;
+                }
+
+                MockRequest req;
+                std::string_view head(buf.data(), hdr_end);
+                const auto line_end = head.find("\r\n");
+                std::string_view line = head.substr(0, line_end);
+                const auto sp1 = line.find(' ');
+                const auto sp2 = line.rfind(' ');
+                req.method = std::string(line.substr(0, sp1));
+                req.target = std::string(line.substr(sp1 + 1, sp2 - sp1 - 1));
+
+                std::size_t pos = line_end == std::string_view::npos ? head.size() : line_end + 2;
+                while (pos < head.size()) {
+                    auto e = head.find("\r\n", pos);
+                    if (e == std::string_view::npos) e = head.size();
+                    std::string_view h = head.substr(pos, e - pos);
+                    if (auto c = h.find(':'); c != std::string_view::npos) {
+                        std::string_view v = h.substr(c + 1);
+                        while (!v.empty() && v.front() == ' ') v.remove_prefix(1);
+                        req.headers.emplace_back(std::string(h.substr(0, c)), std::string(v));
+                    }
+                    pos = e + 2;
+                }
+                buf.erase(0, hdr_end + 4);
+
+                if (req.header("Expect") == "100-continue") {
+                    if (!send_all(fd, "HTTP/1.1 100 Continue\r\n\r\n")) return;
+                }
+
+                const std::string cl = req.header("Content-Length");
+                const std::size_t body_len = cl.empty() ? 0 : std::stoull(cl);
+                while (buf.size() < body_len) {
+                    if (!read_more(fd, buf)) return;
+                }
+                req.body = buf.substr(0, body_len);
+                buf.erase(0, body_len);
+
+                ++requests_;
+                MockResponse resp = handler_(req);
+                if (resp.delayMs > 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(resp.delayMs));
+                }
+
+                std::string out = "HTTP/1.1 " + std::to_string(resp.status) + " X\r\n";
+                for (const auto& [k, v] : resp.headers) out += k + ": " + v + "\r\n";
+                if (resp.close) out += "Connection: close\r\n";
+
+                if (resp.stream && resp.streamLength) {
+                    // Stream con tamaño conocido: Content-Length + bytes crudos
+                    out += "Content-Length: " + std::to_string(*resp.streamLength) + "\r\n\r\n";
+                    if (!send_all(fd, out)) return;
+                    bool alive = true;
+                    resp.stream([&](std::string_view chunk) {
+                        alive = alive && send_all(fd, chunk);
+                        return alive;
+                    });
+                    if (!alive) return;
+                } else if (resp.stream) {
+                    out += "Transfer-Encoding: chunked\r\n\r\n";
+                    if (!send_all(fd, out)) return;
+                    bool alive = true;
+                    resp.stream([&](std::string_view chunk) {
+                        if (!alive || chunk.empty()) return alive;
+                        char size_line[32];
+                        std::snprintf(size_line, sizeof(size_line), "%zx\r\n", chunk.size());
+                        alive = send_all(fd, size_line) && send_all(fd, chunk) && send_all(fd, "\r\n");
+                        return alive;
+                    });
+                    if (!alive || !send_all(fd, "0\r\n\r\n")) return;
+                } else {
+                    out += "Content-Length: " + std::to_string(resp.body.size()) + "\r\n\r\n";
+                    if (!send_all(fd, out)) return;
+                    if (req.method != "HEAD" && !send_all(fd, resp.body)) return;
+                }
+
+                if (resp.close) {
+                    ::shutdown(fd, SHUT_WR);
+                    return;
+                }
+            }
+        }
+
+        Handler                  handler_;
+        int                      listen_fd_{-1};
+        int                      port_{0};
+        std::atomic<bool>        stopping_{false};
+        std::atomic<std::size_t> connections_{0};
+        std::atomic<std::size_t> requests_{0};
+        std::atomic<int>         handshakeDelayMs_{0};
+        std::thread              acceptor_;
+        std::mutex               m_;
+        std::list<Conn>          conns_;
+    };
+
+} // namespace cc::testing
+
+#endif // LIB_CODECOACH_MOCK_HTTP_SERVER_H
@@ -0,0 +1,100 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// sse_replay.h — Stand-in local de POST /chat/completions (API de OpenAI) para MockHttpServer:
+// reproduce una completion grabada (lista de tokens) como text/event-stream a una tasa de
+// tokens/s configurable, o como respuesta JSON completa si el request no pide "stream".
+// Header-only, solo para tests y benchmarks.
+#ifndef LIB_CODECOACH_SSE_REPLAY_H
+#define LIB_CODECOACH_SSE_REPLAY_H
+
+#include "mock_http_server.h"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cc::testing {
+
+    struct RecordedCompletion {
+        std::vector<std::string> tokens;
+        double      tokensPerSec{50.0}; // 0 => sin pausas
+        std::size_t splitEvery{0};      // > 0: cada evento sale en trozos de N bytes (líneas partidas)
+    };
+
+    // Último request recibido (para verificar el body que arma el cliente)
+    struct ReplayLog {
+        std::mutex  m;
+        std::string lastBody;
+        std::size_t requests{0};
+    };
+
+    inline std::string completion_text(const RecordedCompletion& rec) {
+        std::string out;
+        for (const auto& t : rec.tokens) out += t;
+        return out;
+    }
+
+    inline MockHttpServer::Handler make_sse_replay_handler(RecordedCompletion rec,
+                                                           std::shared_ptr<ReplayLog> log = nullptr) {
+        return [rec = std::move(rec), log](const MockRequest& req) {
+            if (log) {
+                std::lock_guard<std::mutex> lk(log->m);
+                log->lastBody = req.body;
+                ++log->requests;
+            }
+
+            const auto body = nlohmann::json::parse(req.body, nullptr, false);
+            const bool stream = !body.is_discarded() && body.value("stream", false);
+
+            MockResponse r;
+            if (!stream) {
+                nlohmann::json out;
+                out["choices"] = nlohmann::json::array(
+                    {{{"index", 0}, {"message", {{"role", "assistant"}, {"content", completion_text(rec)}}}}});
+                r.headers.emplace_back("Content-Type", "application/json");
+                r.body = out.dump();
+                return r;
+            }
+
+            r.headers.emplace_back("Content-Type", "text/event-stream");
+            r.stream = [rec](const ChunkWriter& write) {
+                const auto gap = rec.tokensPerSec > 0
+                    ? std::chrono::microseconds(static_cast<long long>(1e6 / rec.tokensPerSec))
+                    : std::chrono::microseconds(0);
+
+                auto send_event = [&](const std::string& data) {
+                    const std::string ev = "data: " + data + "\n\n";
+                    if (rec.splitEvery == 0) return write(ev);
+                    for (std::size_t i = 0; i < ev.size(); i += rec.splitEvery) {
+                        if (!write(std::string_view(ev).substr(i, rec.splitEvery))) return false;
+                    }
+                    return true;
+                };
+
+                // Primer evento: solo el rol, como la API real
+                nlohmann::json first;
+                first["choices"] = nlohmann::json::array({{{"index", 0}, {"delta", {{"role", "assistant"}}}}});
+                if (!send_event(first.dump())) return;
+
+                for (const auto& token : rec.tokens) {
+                    if (gap.count() > 0) std::this_thread::sleep_for(gap);
+                    nlohmann::json ev;
+                    ev["choices"] = nlohmann::json::array({{{"index", 0}, {"delta", {{"content", token}}}}});
+                    if (!send_event(ev.dump())) return;
+                }
+                send_event("[DONE]");
+            };
+            return r;
+        };
+    }
+
+} // namespace cc::testing
+
+#endif // LIB_CODECOACH_SSE_REPLAY_H
@@ -0,0 +1,64 @@
+//
+// Created by andres on 5/10/25.
+//
+
+// test_check.h — Andamiaje común de los tests (ctest): check() imprime PASS/FAIL y cuenta los
+// fallos, checks_result() da el código de salida del main. Más los fixtures que repiten los
+// tests de evaluación (un RunRequest mínimo) y cronómetro/contadores.
+// Header-only, solo para tests.
+#ifndef LIB_CODECOACH_TEST_CHECK_H
+#define LIB_CODECOACH_TEST_CHECK_H
+
+#include "contracts/eval_dto.h"
+#include "metrics/counters.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace cc::testing {
+
+    inline int& check_failures() {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline void check(bool ok, const char* what) {
+        std::printf("[%s] %s\n", ok ? "PASS" : "FAIL", what);
+        if (!ok) ++check_failures();
+    }
+
+    // return checks_result(); al final del main: != 0 si falló algún check
+    inline int checks_result() {
+        if (check_failures() > 0) {
+            std::fprintf(stderr, "FAIL: %d check(s) failed\n", check_failures());
+            return 1;
+        }
+        std::printf("OK\n");
+        return 0;
+    }
+
+    using TestClock = std::chrono::steady_clock;
+
+    inline long long ms_since(TestClock::time_point t0) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(TestClock::now() - t0).count();
+    }
+
+    inline std::int64_t counter(const std::string& name) {
+        return cc::metrics::Counters::instance().value(name);
+    }
+
+    // Envío mínimo al problema "p1"; `code` distingue programas
+    inline cc::contracts::RunRequest run_request(const std::string& code = "int main() {}",
+                                                 bool failFast = false) {
+        cc::contracts::RunRequest r;
+        r.problemId = "p1";
+        r.code      = code;
+        r.failFast  = failFast;
+        return r;
+    }
+
+} // namespace cc::testing
+
+#endif // LIB_CODECOACH_TEST_CHECK_H
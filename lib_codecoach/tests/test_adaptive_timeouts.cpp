@@ -0,0 +1,94 @@
+// test_adaptive_timeouts.cpp — Timeouts aprendidos (HttpClient::setAdaptiveTimeouts) contra
+// support/mock_http_server.h:
+//   1. Con latencias cortas el timeout aprendido baja hasta el piso de la política.
+//   2. La latencia sube por encima del timeout aprendido: los timeouts cuentan como muestras
+//      (censuradas en su valor) y el timeout se agranda en pocas llamadas, en vez de seguir
+//      venciendo hasta que se vacíe la ventana.
+//   3. Un timeout explícito del llamador no cuenta como muestra.
+// Devuelve != 0 si falla.
+
+#include "http/adaptive_timeouts.h"
+#include "http/http_client.h"
+#include "http/url.h"
+#include "logging/logger.h"
+
+#include "support/mock_http_server.h"
+#include "support/test_check.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+
+using cc::testing::check;
+using cc::testing::counter;
+
+namespace {
+
+std::uint64_t samples_of(const std::string& key) {
+    for (const auto& s : cc::http::EndpointLatencies::instance().snapshot()) {
+        if (s.key == key) return s.samples;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main() {
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Error;
+    cc::logging::Logger::init(lc);
+
+    std::atomic<int> delayMs{0};
+    cc::testing::MockHttpServer server([&](const cc::testing::MockRequest&) {
+        cc::testing::MockResponse r;
+        r.delayMs = delayMs.load();
+        r.body    = "ok";
+        return r;
+    });
+    const std::string url      = server.base_url() + "/step";
+    const std::string endpoint = cc::http::endpoint_of("GET", url);
+
+    cc::http::HttpClient client;
+    client.setRetries(0);
+    client.setTimeout(5000);
+    cc::http::AdaptiveTimeoutPolicy p;
+    p.minSamples = 20;
+    p.multiplier = 4.0;
+    p.floor      = cc::time::Millis{50};
+    client.setAdaptiveTimeouts(p);
+
+    // 1. Latencias cortas
+    {
+        bool ok = true;
+        for (int i = 0; i < 30; ++i) ok = client.get(url).isSuccess() && ok;
+        int learned = 0;
+        for (const auto& s : cc::http::EndpointLatencies::instance().snapshot()) {
+            if (s.key == endpoint) learned = s.learnedTotalMs;
+        }
+        std::printf("learned timeout after fast calls: %d ms\n", learned);
+        check(ok && learned == 50, "fast responses shrink the timeout to the policy floor");
+    }
+
+    // 2. La latencia sube a 150 ms
+    {
+        delayMs = 150;
+        int calls = 0;
+        bool recovered = false;
+        while (calls < 5 && !recovered) {
+            ++calls;
+            recovered = client.get(url).isSuccess();
+        }
+        std::printf("recovered after %d call(s)\n", calls);
+        check(counter("http.timeout.sampled|" + endpoint) >= 1, "timeouts are recorded as latency samples");
+        check(recovered && calls <= 3, "the learned timeout grows once latency steps up");
+    }
+
+    // 3. Timeout explícito
+    {
+        const auto before = samples_of(endpoint);
+        const auto r = client.request("GET", url, {}, {}, 20);
+        check(r.statusCode == 0 && samples_of(endpoint) == before, "an explicit caller timeout is not a sample");
+    }
+
+    return cc::testing::checks_result();
+}
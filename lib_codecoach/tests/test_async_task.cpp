@@ -0,0 +1,193 @@
+// test_async_task.cpp — Task<T>, Executor y los awaitables de http_awaitable.h contra
+// support/mock_http_server.h:
+//   1. co_await http_request desde un Executor: la respuesta llega y la corrutina se reanuda
+//      en un hilo de ese Executor; co_await de Tasks anidadas (por valor y por referencia).
+//   2. Una excepción dentro de Task<T> sale por el co_await del que espera y por sync_wait.
+//   3. Cancelar ctl.cancel mientras la corrutina está suspendida aborta la transferencia
+//      (499) sin ocupar el hilo del Executor; sleep_for cancelable devuelve false.
+//   4. co_await de una Task vacía (default o movida) lanza std::logic_error.
+// Devuelve != 0 si falla.
+
+#include "async/executor.h"
+#include "async/http_awaitable.h"
+#include "async/task.h"
+#include "http/http_client.h"
+#include "logging/logger.h"
+
+#include "support/mock_http_server.h"
+#include "support/test_check.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using cc::async::Executor;
+using cc::async::Task;
+using cc::async::sync_wait;
+using cc::testing::check;
+using cc::testing::ms_since;
+using cc::testing::TestClock;
+
+namespace {
+
+    struct Fetched {
+        int         status{0};
+        std::string body;
+        bool        onExecutor{false};
+    };
+
+    Task<Fetched> fetch_on(Executor& ex, cc::http::HttpClient& client, std::string url,
+                           cc::http::RequestControl ctl = {}) {
+        co_await ex.schedule();
+        const auto r = co_await cc::async::http_request(client, "GET", std::move(url), {}, {}, std::move(ctl));
+        co_return Fetched{r.statusCode, r.body, Executor::current() == &ex};
+    }
+
+    Task<int> answer() {
+        co_return 42;
+    }
+
+    Task<int> throws_after(Executor& ex) {
+        co_await ex.schedule();
+        throw std::runtime_error("boom");
+        co_return 0;
+    }
+
+    Task<void> throws_void() {
+        throw std::invalid_argument("void boom");
+        co_return;
+    }
+
+    // El error de la Task interna llega al co_await de la externa
+    Task<std::string> catches(Executor& ex) {
+        try {
+            co_await throws_after(ex);
+        } catch (const std::runtime_error& e) {
+            co_return std::string("caught ") + e.what();
+        }
+        co_return "not thrown";
+    }
+
+    // co_await sobre una Task con nombre (operator co_await() &) y sobre un temporal
+    Task<int> twice() {
+        Task<int> t = answer();
+        const int a = co_await t;
+        const int b = co_await answer();
+        co_return a + b;
+    }
+
+    Task<std::string> awaits_empty(bool moved) {
+        Task<int> t;
+        if (moved) {
+            t = answer();
+            Task<int> other = std::move(t);
+            (void)other;
+        }
+        try {
+            co_await std::move(t);
+        } catch (const std::logic_error& e) {
+            co_return e.what();
+        }
+        co_return "";
+    }
+
+} // namespace
+
+int main() {
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Error;
+    cc::logging::Logger::init(lc);
+
+    cc::testing::MockHttpServer server([](const cc::testing::MockRequest& req) {
+        cc::testing::MockResponse r;
+        if (req.target == "/slow") r.delayMs = 800;
+        r.body = "hola " + req.target;
+        return r;
+    });
+
+    Executor ex(1);
+    cc::http::HttpClient client;
+    client.setRetries(0);
+
+    // 1. co_await de una llamada HTTP
+    {
+        const auto f = sync_wait(fetch_on(ex, client, server.base_url() + "/ok"));
+        check(f.status == 200 && f.body == "hola /ok", "co_await http_request returns the response");
+        check(f.onExecutor, "the coroutine resumes on the executor it was scheduled on");
+        check(sync_wait(twice()) == 84, "awaiting named and temporary tasks yields their values");
+    }
+
+    // 2. Excepciones
+    {
+        check(sync_wait(catches(ex)) == "caught boom", "an exception in Task<T> reaches the awaiting coroutine");
+
+        bool rethrown = false;
+        try {
+            (void)sync_wait(throws_after(ex));
+        } catch (const std::runtime_error& e) {
+            rethrown = std::string(e.what()) == "boom";
+        }
+        check(rethrown, "sync_wait rethrows the Task's exception");
+
+        bool voidRethrown = false;
+        try {
+            sync_wait(throws_void());
+        } catch (const std::invalid_argument&) {
+            voidRethrown = true;
+        }
+        check(voidRethrown, "Task<void> propagates exceptions too");
+    }
+
+    // 3. Cancelación con la corrutina suspendida
+    {
+        cc::time::CancellationSource src;
+        cc::http::RequestControl ctl;
+        ctl.cancel = src.token();
+
+        // Con un solo hilo, el post corre solo si la corrutina no lo está ocupando
+        std::atomic<bool> ranMeanwhile{false};
+        auto task = fetch_on(ex, client, server.base_url() + "/slow", ctl);
+        const auto t0 = TestClock::now();
+        std::thread canceller([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            std::promise<void> posted;
+            ex.post([&] {
+                ranMeanwhile = true;
+                posted.set_value();
+            });
+            posted.get_future().wait();
+            src.cancel();
+        });
+        const auto f = sync_wait(std::move(task));
+        const auto took = ms_since(t0);
+        canceller.join();
+
+        check(ranMeanwhile, "a suspended coroutine does not hold the executor thread");
+        check(f.status == 499 && took < 500, "cancelling while suspended aborts the call with 499");
+        check(f.onExecutor, "the cancelled call still resumes on the executor");
+
+        cc::time::CancellationSource sleepSrc;
+        std::thread sleepCanceller([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            sleepSrc.cancel();
+        });
+        const auto s0 = TestClock::now();
+        const bool completed = sync_wait(cc::async::sleep_for(cc::time::Millis{2000}, sleepSrc.token()));
+        const auto slept = ms_since(s0);
+        sleepCanceller.join();
+        check(!completed && slept < 500, "a cancelled sleep_for wakes early and returns false");
+    }
+
+    // 4. Task vacía
+    {
+        const std::string e = sync_wait(awaits_empty(false));
+        check(e == "co_await on an empty Task", "co_await on a default-constructed Task throws logic_error");
+        check(sync_wait(awaits_empty(true)) == e, "co_await on a moved-from Task throws logic_error");
+        check(!Task<int>{}.valid() && answer().valid(), "valid() tells empty tasks apart");
+    }
+
+    return cc::testing::checks_result();
+}
@@ -0,0 +1,98 @@
+// test_circuit_breaker.cpp — CircuitBreakers + HttpClient contra support/mock_http_server.h:
+//   1. Con la tasa de errores sobre el umbral el circuito se abre y las llamadas fallan al
+//      instante (503 + X-Circuit-Breaker: open) sin llegar al servidor.
+//   2. Pasado openFor sale una sonda (half-open); si falla, vuelve a open.
+//   3. Si las sondas salen bien, vuelve a closed y el tráfico sigue normal.
+//   4. Los 4xx no cuentan como fallo del servicio.
+// Devuelve != 0 si falla.
+
+#include "http/circuit_breaker.h"
+#include "http/http_client.h"
+#include "http/url.h"
+#include "logging/logger.h"
+
+#include "support/mock_http_server.h"
+#include "support/test_check.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using cc::http::BreakerState;
+using cc::testing::check;
+using cc::testing::counter;
+
+int main() {
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Error;
+    cc::logging::Logger::init(lc);
+
+    std::atomic<int> status{500};
+    cc::testing::MockHttpServer server([&](const cc::testing::MockRequest&) {
+        cc::testing::MockResponse r;
+        r.status = status.load();
+        r.body   = "status " + std::to_string(r.status);
+        return r;
+    });
+    const std::string url    = server.base_url() + "/problems";
+    const std::string origin = cc::http::origin_of(url);
+
+    auto& breakers = cc::http::CircuitBreakers::instance();
+    cc::http::BreakerPolicy p;
+    p.failureRatePct = 50;
+    p.minCalls       = 4;
+    p.halfOpenProbes = 2;
+    p.openFor        = cc::time::Millis{300};
+    breakers.configure(p);
+
+    cc::http::HttpClient client;
+    client.setRetries(0);
+
+    // 1. Abre
+    {
+        for (int i = 0; i < 4; ++i) client.get(url);
+        const auto reached = server.requests();
+        const auto r = client.get(url);
+        check(breakers.state(origin) == BreakerState::Open, "failure rate over the threshold opens the circuit");
+        check(r.statusCode == 503 && cc::http::get_header_ci(r.headers, "X-Circuit-Breaker") == "open" &&
+              server.requests() == reached,
+              "an open circuit fails fast without reaching the server");
+        check(counter("http.breaker.rejected|" + origin) >= 1, "rejected calls are counted");
+    }
+
+    // 2. Half-open con sonda fallida
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(350));
+        const auto reached = server.requests();
+        const auto probe = client.get(url);
+        check(probe.statusCode == 500 && server.requests() == reached + 1,
+              "after openFor a probe reaches the server");
+        check(breakers.state(origin) == BreakerState::Open, "a failed probe opens the circuit again");
+    }
+
+    // 3. Half-open con sondas exitosas
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(350));
+        status = 200;
+        const auto a = client.get(url);
+        check(a.isSuccess() && breakers.state(origin) == BreakerState::HalfOpen,
+              "one successful probe is not enough to close");
+        const auto b = client.get(url);
+        check(b.isSuccess() && breakers.state(origin) == BreakerState::Closed,
+              "all probes succeeding closes the circuit");
+        bool ok = true;
+        for (int i = 0; i < 5; ++i) ok = ok && client.get(url).isSuccess();
+        check(ok, "traffic flows again once closed");
+    }
+
+    // 4. Errores del llamador
+    {
+        breakers.configure(p);
+        status = 404;
+        for (int i = 0; i < 8; ++i) client.get(url);
+        check(breakers.state(origin) == BreakerState::Closed, "4xx responses do not open the circuit");
+    }
+
+    return cc::testing::checks_result();
+}
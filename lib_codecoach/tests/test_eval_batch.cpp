@@ -0,0 +1,172 @@
+// test_eval_batch.cpp — EvalClient::submitBatch contra support/mock_eval_service.h:
+//   1. Todos los resultados vuelven en el orden de `requests`, cada uno por el callback una vez,
+//      en pocos requests HTTP.
+//   2. Servicio sin /evaluate/batch: todo sale por /evaluate con el mismo resultado.
+//   3. Lote que no devuelve todos los envíos: los que faltan se reintentan uno a uno.
+//   4. El callback corta: los envíos no entregados quedan con exitCode -1.
+//   5. El callback tira desde un hilo del lote: submitBatch relanza en el hilo del caller.
+// Devuelve != 0 si falla.
+
+#include "logging/logger.h"
+#include "sdk/eval_client.h"
+
+#include "support/mock_eval_service.h"
+#include "support/mock_http_server.h"
+#include "support/test_check.h"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using cc::testing::check;
+
+namespace {
+
+std::vector<cc::contracts::RunRequest> requests(std::size_t n) {
+    std::vector<cc::contracts::RunRequest> out(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i].problemId = "p1";
+        out[i].code      = "int main() { return " + std::to_string(i) + "; }";
+    }
+    return out;
+}
+
+} // namespace
+
+int main() {
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Error;
+    cc::logging::Logger::init(lc);
+
+    cc::testing::MockEvalOptions o;
+    o.judgeMs = 10;
+
+    // 1. Lotes
+    {
+        cc::testing::MockEvalService service(o);
+        cc::sdk::EvalClient client(service.base_url());
+
+        cc::sdk::EvalBatchOptions bo;
+        bo.batchSize   = 16;
+        bo.maxInFlight = 2;
+        const auto reqs = requests(50);
+
+        std::multiset<std::size_t> seen;
+        const auto results = client.submitBatch(reqs, [&](std::size_t i, const cc::contracts::RunResult& r) {
+            if (r.passed) seen.insert(i);
+            return true;
+        }, bo);
+
+        bool allPassed = results.size() == reqs.size();
+        for (const auto& r : results) allPassed = allPassed && r.passed && r.cases.size() == o.cases;
+        bool once = seen.size() == reqs.size();
+        for (std::size_t i = 0; once && i < reqs.size(); ++i) once = seen.count(i) == 1;
+        std::printf("50 submissions: %zu HTTP requests\n", service.stats().requests.load());
+        check(allPassed, "every submission gets its result");
+        check(once, "callback sees each index exactly once");
+        check(service.stats().requests.load() == 4 && service.stats().judged.load() == reqs.size(),
+              "one HTTP request per batch");
+    }
+
+    // 2. Sin endpoint de lotes
+    {
+        std::atomic<std::size_t> singles{0};
+        cc::testing::MockHttpServer server([&](const cc::testing::MockRequest& req) {
+            cc::testing::MockResponse resp;
+            if (req.target == "/evaluate") {
+                ++singles;
+                resp.headers.emplace_back("Content-Type", "application/json");
+                resp.body = R"({"passed":true,"cases":[{"input":"1","passed":true}]})";
+            } else {
+                resp.status = 404;
+            }
+            return resp;
+        });
+        cc::sdk::EvalClient client(server.base_url());
+
+        const auto results = client.submitBatch(requests(10), {}, {.batchSize = 4, .maxInFlight = 2});
+        bool ok = results.size() == 10;
+        for (const auto& r : results) ok = ok && r.passed;
+        check(ok && singles.load() == 10, "falls back to /evaluate when batches are not supported");
+    }
+
+    // 3. Lote incompleto
+    {
+        std::atomic<std::size_t> singles{0};
+        cc::testing::MockHttpServer server([&](const cc::testing::MockRequest& req) {
+            cc::testing::MockResponse resp;
+            resp.headers.emplace_back("Content-Type", "application/json");
+            if (req.target == "/evaluate/batch") {
+                // Solo devuelve los índices pares y corta sin {"type":"done"}
+                const auto body = nlohmann::json::parse(req.body);
+                for (std::size_t k = 0; k < body["submissions"].size(); k += 2) {
+                    resp.body += nlohmann::json{{"type", "result"}, {"index", k},
+                                                {"result", {{"passed", true}, {"stdout", "batch"}}}}.dump() + "\n";
+                }
+            } else if (req.target == "/evaluate") {
+                ++singles;
+                resp.body = R"({"passed":true,"stdout":"single"})";
+            } else {
+                resp.status = 404;
+            }
+            return resp;
+        });
+        cc::sdk::EvalClient client(server.base_url());
+
+        const auto results = client.submitBatch(requests(6), {}, {.batchSize = 6, .maxInFlight = 1});
+        bool ok = results.size() == 6;
+        for (std::size_t i = 0; ok && i < results.size(); ++i) {
+            ok = results[i].passed && results[i].stdout == (i % 2 == 0 ? "batch" : "single");
+        }
+        check(ok && singles.load() == 3, "submissions missing from a batch are retried one by one");
+    }
+
+    // 4. Corte desde el callback
+    {
+        cc::testing::MockEvalService service(o);
+        cc::sdk::EvalClient client(service.base_url());
+
+        std::size_t calls = 0;
+        const auto results = client.submitBatch(requests(40), [&](std::size_t, const auto&) { return ++calls < 5; },
+                                                {.batchSize = 8, .maxInFlight = 1});
+        std::size_t notRun = 0;
+        for (const auto& r : results) notRun += (!r.passed && r.exitCode == -1) ? 1 : 0;
+        std::printf("caller stop: %zu callbacks, %zu not evaluated\n", calls, notRun);
+        check(calls == 5 && notRun == 35, "callback returning false stops the remaining batches");
+    }
+
+    // 5. Callback que tira (también en el fallback uno a uno, fuera del lote)
+    {
+        cc::testing::MockHttpServer server([](const cc::testing::MockRequest& req) {
+            cc::testing::MockResponse resp;
+            if (req.target == "/evaluate") {
+                resp.headers.emplace_back("Content-Type", "application/json");
+                resp.body = R"({"passed":true})";
+            } else {
+                resp.status = 404;
+            }
+            return resp;
+        });
+        cc::sdk::EvalClient client(server.base_url());
+
+        std::atomic<std::size_t> calls{0};
+        std::string caught;
+        try {
+            client.submitBatch(requests(24), [&](std::size_t, const auto&) {
+                if (++calls == 3) throw std::runtime_error("callback failed");
+                return true;
+            }, {.batchSize = 2, .maxInFlight = 4});
+        } catch (const std::runtime_error& e) {
+            caught = e.what();
+        }
+        check(caught == "callback failed" && calls.load() == 3,
+              "a throwing callback stops the batch and is rethrown on the caller's thread");
+    }
+
+    return cc::testing::checks_result();
+}
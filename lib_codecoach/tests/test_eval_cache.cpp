@@ -0,0 +1,232 @@
+// test_eval_cache.cpp — EvalResultCache + EvalClient::setResultCache contra
+// support/mock_eval_service.h:
+//   1. La clave cambia con problema, versión, código, stdin y failFast; con normalización
+//      ignora espacios y comentarios pero no el contenido de los strings.
+//   2. El mismo envío dos veces: el segundo no llega al juez (aciertos y tiempo ahorrado).
+//   3. Cambio de versión del set de tests (del caller o informada por el juez): se vuelve a
+//      evaluar y queda la versión con que evaluó el juez.
+//   4. Los errores (exitCode -1) no se memoizan.
+//   5. Capa en disco: otra instancia sobre el mismo directorio encuentra resultados y versiones.
+//   6. submitBatch solo manda al juez lo que no está en la caché.
+//   7. Un veredicto que llega después de un cambio de versión, evaluado con la anterior, no
+//      vuelve atrás la versión ni se memoiza.
+//   8. ProblemsClient::get informa a la caché la versión del set de tests del problema.
+// Devuelve != 0 si falla.
+
+#include "async/task.h"
+#include "logging/logger.h"
+#include "metrics/counters.h"
+#include "sdk/eval_cache.h"
+#include "sdk/eval_client.h"
+#include "sdk/problems_client.h"
+
+#include "support/mock_eval_service.h"
+#include "support/mock_http_server.h"
+#include "support/test_check.h"
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+using cc::testing::check;
+using cc::testing::counter;
+using cc::testing::run_request;
+
+int main() {
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Error;
+    cc::logging::Logger::init(lc);
+
+    using cc::sdk::EvalResultCache;
+    const fs::path dir = fs::temp_directory_path() / ("cc_eval_cache_test_" + std::to_string(::getpid()));
+    fs::remove_all(dir);
+
+    // 1. Clave
+    {
+        const auto base = run_request();
+        const auto k = EvalResultCache::key_of(base, "v1", false);
+        auto other = base;
+        other.problemId = "p2";
+        auto withStdin = base;
+        withStdin.stdin = "5";
+        auto ff = base;
+        ff.failFast = true;
+        auto code = base;
+        code.code += " ";
+        check(k == EvalResultCache::key_of(base, "v1", false) &&
+              k != EvalResultCache::key_of(other, "v1", false) &&
+              k != EvalResultCache::key_of(base, "v2", false) &&
+              k != EvalResultCache::key_of(withStdin, "v1", false) &&
+              k != EvalResultCache::key_of(ff, "v1", false) &&
+              k != EvalResultCache::key_of(code, "v1", false),
+              "key depends on problem, version, code, stdin and failFast");
+
+        const auto a = run_request("int main() {\n    return 0; // ok\n}\n");
+        const auto b = run_request("int main()  {   /* entrada */\n\n\treturn 0;   \n}  ");
+        const auto c = run_request("int main() {\n  puts(\"a  b\"); // x\n}");
+        const auto d = run_request("int main() {\n  puts(\"a b\");\n}");
+        check(EvalResultCache::key_of(a, "", true) == EvalResultCache::key_of(b, "", true) &&
+              EvalResultCache::normalize_source("int  x; // c\n\n  int y;") == "int x;\nint y;" &&
+              EvalResultCache::normalize_source("a /* c */ b") == "a b",
+              "normalization drops comments, blank lines and repeated spaces");
+        check(EvalResultCache::key_of(c, "", true) != EvalResultCache::key_of(d, "", true) &&
+              EvalResultCache::normalize_source("s = \"// no\";") == "s = \"// no\";" &&
+              EvalResultCache::normalize_source("int n = 1'000;  // mil") == "int n = 1'000;",
+              "normalization keeps string literals intact");
+        check(EvalResultCache::key_of(a, "", true) != EvalResultCache::key_of(a, "", false),
+              "raw and normalized keys do not mix");
+    }
+
+    cc::testing::MockEvalOptions o;
+    o.judgeMs        = 30;
+    o.testSetVersion = "v1";
+
+    // 2 + 3. Aciertos y versiones
+    {
+        cc::metrics::Counters::instance().reset();
+        cc::testing::MockEvalService service(o);
+        auto cache = std::make_shared<EvalResultCache>();
+        cc::sdk::EvalClient client(service.base_url());
+        client.setResultCache(cache);
+
+        const auto first  = client.submit(run_request());
+        const auto second = client.submit(run_request());
+        const auto s = cache->stats();
+        check(first.passed && second.passed && second.cases.size() == first.cases.size() &&
+              second.testSetVersion == "v1" && service.stats().judged.load() == 1,
+              "an unchanged resubmission is not judged again");
+        check(s.hits == 1 && s.hit_ratio() > 0.0 && s.savedJudgeMs >= 30 &&
+              counter("eval.cache.hit|memory") == 1 && counter("eval.cache.saved_ms") >= 30,
+              "hit ratio and saved judge time are reported");
+
+        const auto streamed = client.submitStreaming(run_request(), {});
+        const auto async    = cc::async::sync_wait(client.submitAsync(run_request()));
+        check(streamed.passed && async.passed && service.stats().judged.load() == 1,
+              "streaming and async paths use the cache too");
+
+        check(cache->setTestSetVersion("p1", "v2") && !cache->setTestSetVersion("p1", "v2"),
+              "version change is detected once");
+        client.submit(run_request());
+        check(service.stats().judged.load() == 2, "a new test set version forces a fresh evaluation");
+        // Este juez sigue en v1: manda la versión del resultado, no la que anunció el caller
+        check(cache->testSetVersion("p1") == "v1" && cache->stats().invalidations == 2,
+              "the version reported by the judge wins");
+
+        // El juez informa otra versión que la conocida: se adopta y lo siguiente acierta
+        auto o3 = o;
+        o3.testSetVersion = "v3";
+        cc::testing::MockEvalService service3(o3);
+        cc::sdk::EvalClient client3(service3.base_url());
+        client3.setResultCache(cache);
+        cache->setTestSetVersion("p1", "v2");
+        client3.submit(run_request("int main() { return 3; }"));
+        client3.submit(run_request("int main() { return 3; }"));
+        check(cache->testSetVersion("p1") == "v3" && service3.stats().judged.load() == 1,
+              "a version change reported by the judge is adopted");
+    }
+
+    // 4. Errores
+    {
+        auto cache = std::make_shared<EvalResultCache>();
+        cc::testing::MockHttpServer down([](const cc::testing::MockRequest&) {
+            cc::testing::MockResponse r;
+            r.status = 404;
+            return r;
+        });
+        cc::sdk::EvalClient client(down.base_url());
+        client.setResultCache(cache);
+        const auto a = client.submit(run_request());
+        const auto b = client.submit(run_request());
+        check(a.exitCode == -1 && b.exitCode == -1 && cache->stats().entries == 0 && cache->stats().hits == 0,
+              "service errors are not memoized");
+    }
+
+    // 5. Disco
+    {
+        cc::sdk::EvalCacheOptions opts;
+        opts.diskDir = dir.string();
+        {
+            cc::testing::MockEvalService service(o);
+            auto cache = std::make_shared<EvalResultCache>(opts);
+            cc::sdk::EvalClient client(service.base_url());
+            client.setResultCache(cache);
+            client.submit(run_request());
+        }
+        cc::testing::MockEvalService service(o);
+        auto cache = std::make_shared<EvalResultCache>(opts);
+        cc::sdk::EvalClient client(service.base_url());
+        client.setResultCache(cache);
+        const auto r = client.submit(run_request());
+        check(r.passed && cache->testSetVersion("p1") == "v1" && cache->stats().diskHits == 1 &&
+              service.stats().judged.load() == 0,
+              "results and test set versions survive a restart");
+    }
+
+    // 6. Lotes con parte memoizada
+    {
+        cc::testing::MockEvalService service(o);
+        auto cache = std::make_shared<EvalResultCache>();
+        cc::sdk::EvalClient client(service.base_url());
+        client.setResultCache(cache);
+
+        std::vector<cc::contracts::RunRequest> reqs;
+        for (int i = 0; i < 20; ++i) reqs.push_back(run_request("int main() { return " + std::to_string(i) + "; }"));
+        client.submitBatch(std::span(reqs).first(10), {}, {.batchSize = 4});
+
+        std::size_t seen = 0;
+        const auto results = client.submitBatch(reqs, [&](std::size_t, const auto&) { return ++seen, true; },
+                                                {.batchSize = 4});
+        bool ok = results.size() == 20;
+        for (const auto& r : results) ok = ok && r.passed;
+        check(ok && seen == 20 && service.stats().judged.load() == 20 && cache->stats().hits == 10,
+              "batches only carry submissions missing from the cache");
+    }
+
+    // 7. Veredicto tardío
+    {
+        auto slow = o;
+        slow.judgeMs = 300;
+        cc::testing::MockEvalService service(slow);
+        auto cache = std::make_shared<EvalResultCache>();
+        cc::sdk::EvalClient client(service.base_url());
+        client.setResultCache(cache);
+        cache->setTestSetVersion("p1", "v1");
+
+        std::thread late([&] { client.submit(run_request()); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        cache->setTestSetVersion("p1", "v9"); // el servicio de problemas publicó otro set
+        late.join();
+        check(cache->testSetVersion("p1") == "v9" && cache->stats().stale == 1 && cache->stats().entries == 0,
+              "a late verdict judged against the old test set is discarded");
+        client.submit(run_request());
+        check(service.stats().judged.load() == 2 && cache->testSetVersion("p1") == "v1",
+              "a verdict sent after the switch is still adopted");
+    }
+
+    // 8. ProblemsClient
+    {
+        cc::testing::MockHttpServer server([](const cc::testing::MockRequest&) {
+            cc::testing::MockResponse r;
+            r.body = R"({"id":"p1","title":"Suma","testSetVersion":"v5"})";
+            return r;
+        });
+        auto cache = std::make_shared<EvalResultCache>();
+        cache->setTestSetVersion("p1", "v4");
+        cc::sdk::ProblemsClient problems(server.base_url());
+        problems.setResultCache(cache);
+        const auto detail = problems.get("p1");
+        check(detail && detail->testSetVersion == "v5" && cache->testSetVersion("p1") == "v5" &&
+              cache->stats().invalidations == 1,
+              "fetching a problem feeds its test set version into the cache");
+    }
+
+    fs::remove_all(dir);
+    return cc::testing::checks_result();
+}
@@ -0,0 +1,145 @@
+// test_eval_queue.cpp — Modo cola de EvalClient (submit-and-poll) contra support/mock_eval_service.h:
+//   1. enqueue() devuelve el id al instante; getResult() da nullopt mientras esté pendiente.
+//   2. awaitResult() con long-poll: una sola consulta retenida hasta que el juez termina.
+//   3. Sin long-poll en el servicio: polling corto con backoff, mismo resultado.
+//   4. El deadline de `ctl` corta la espera (también el backoff entre consultas, que además
+//      despierta al cancelar); un id desconocido falla sin reintentar para siempre.
+//   5. Servicio caído (5xx/red) sin deadline: se abandona tras maxTransientErrors fallos seguidos.
+// Devuelve != 0 si falla.
+
+#include "async/task.h"
+#include "logging/logger.h"
+#include "sdk/eval_client.h"
+
+#include "support/mock_eval_service.h"
+#include "support/mock_http_server.h"
+#include "support/test_check.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+using cc::testing::check;
+using cc::testing::TestClock;
+using cc::testing::ms_since;
+using cc::testing::run_request;
+
+int main() {
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Error;
+    cc::logging::Logger::init(lc);
+
+    // 1 + 2. Long-poll
+    {
+        cc::testing::MockEvalOptions o;
+        o.judgeMs = 300;
+        cc::testing::MockEvalService service(o);
+        cc::sdk::EvalClient client(service.base_url());
+
+        const auto t0 = TestClock::now();
+        const auto id = client.enqueue(run_request());
+        check(id && ms_since(t0) < 150, "enqueue returns the id without waiting for the judge");
+        check(id && !client.getResult(*id), "getResult is empty while pending");
+
+        const auto polls = service.stats().polls.load();
+        const auto r = cc::async::sync_wait(client.awaitResult(id.value_or("")));
+        std::printf("long-poll: done after %lld ms, %zu poll(s)\n", ms_since(t0), service.stats().polls.load() - polls);
+        check(r.passed && r.cases.size() == o.cases, "awaitResult returns the judged result");
+        check(service.stats().polls.load() - polls == 1, "one held GET covers the whole judgement");
+        check(id && client.getResult(*id).has_value(), "getResult returns the finished result");
+    }
+
+    // 3. Polling corto
+    {
+        cc::testing::MockEvalOptions o;
+        o.judgeMs  = 300;
+        o.longPoll = false;
+        cc::testing::MockEvalService service(o);
+        cc::sdk::EvalClient client(service.base_url());
+
+        const auto t0 = TestClock::now();
+        const auto r = cc::async::sync_wait(client.submitQueuedAsync(run_request()));
+        const auto took = ms_since(t0);
+        std::printf("short-poll: done after %lld ms, %zu polls\n", took, service.stats().polls.load());
+        check(r.passed && took >= 300, "short polling reaches the result after the judge finishes");
+        check(service.stats().polls.load() >= 2 && service.stats().polls.load() <= 12,
+              "backoff keeps the number of polls small");
+    }
+
+    // 4. Deadline y id desconocido
+    {
+        cc::testing::MockEvalOptions o;
+        o.judgeMs = 5000;
+        cc::testing::MockEvalService service(o);
+        cc::sdk::EvalClient client(service.base_url());
+
+        cc::http::RequestControl ctl;
+        ctl.deadline = cc::time::Deadline(cc::time::Millis{300});
+        const auto t0 = TestClock::now();
+        const auto r = cc::async::sync_wait(client.submitQueuedAsync(run_request(), ctl));
+        const auto took = ms_since(t0);
+        std::printf("deadline: gave up after %lld ms\n", took);
+        check(!r.passed && r.exitCode == -1 && took < 2000, "deadline cuts the wait short");
+
+        // Polling corto con esperas largas: el backoff no pasa del deadline ni sobrevive a cancel()
+        cc::testing::MockEvalOptions so = o;
+        so.longPoll = false;
+        cc::testing::MockEvalService slow(so);
+        cc::sdk::EvalClient patient(slow.base_url());
+        cc::sdk::EvalPollPolicy pp;
+        pp.longPoll      = cc::time::Millis{0};
+        pp.backoff.base  = cc::time::Millis{3000};
+        pp.backoff.mode  = cc::time::BackoffMode::Exponential;
+        patient.setPollPolicy(pp);
+
+        cc::http::RequestControl dctl;
+        dctl.deadline = cc::time::Deadline(cc::time::Millis{300});
+        const auto d0 = TestClock::now();
+        const auto dr = cc::async::sync_wait(patient.submitQueuedAsync(run_request(), dctl));
+        const auto dtook = ms_since(d0);
+        check(!dr.passed && dtook < 1000, "the poll backoff is capped by the deadline");
+
+        cc::time::CancellationSource src;
+        cc::http::RequestControl cctl;
+        cctl.cancel = src.token();
+        std::thread canceller([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(150));
+            src.cancel();
+        });
+        const auto c0 = TestClock::now();
+        const auto cr = cc::async::sync_wait(patient.submitQueuedAsync(run_request(), cctl));
+        const auto ctook = ms_since(c0);
+        canceller.join();
+        std::printf("backoff: deadline after %lld ms, cancel after %lld ms\n", dtook, ctook);
+        check(!cr.passed && ctook < 1000, "cancelling wakes the poll backoff");
+
+        const auto unknown = cc::async::sync_wait(client.awaitResult("no-such-id"));
+        check(!unknown.passed && unknown.exitCode == -1 && unknown.stderr.find("404") != std::string::npos,
+              "unknown submission fails with the HTTP status");
+    }
+
+    // 5. Servicio caído
+    {
+        cc::testing::MockHttpServer down([](const cc::testing::MockRequest&) {
+            cc::testing::MockResponse r;
+            r.status = 503;
+            return r;
+        });
+        cc::sdk::EvalClient client(down.base_url());
+        cc::sdk::EvalPollPolicy pp;
+        pp.longPoll           = cc::time::Millis{0};
+        pp.backoff.base       = cc::time::Millis{5};
+        pp.backoff.max_delay  = cc::time::Millis{20};
+        pp.maxTransientErrors = 2;
+        client.setPollPolicy(pp);
+
+        const auto t0 = TestClock::now();
+        const auto r = cc::async::sync_wait(client.awaitResult("s1"));
+        std::printf("gave up after %lld ms\n", ms_since(t0));
+        check(!r.passed && r.exitCode == -1 && r.stderr.find("503") != std::string::npos,
+              "awaitResult gives up after repeated transient failures");
+    }
+
+    return cc::testing::checks_result();
+}
@@ -0,0 +1,111 @@
+// test_eval_stream.cpp — EvalClient::submitStreaming contra support/mock_eval_service.h:
+//   1. Los casos llegan uno a uno (el primero mucho antes que el resumen) y en orden.
+//   2. failFast: el juez se detiene en el primer fallo y el resultado lo marca (stoppedEarly).
+//   3. El caller corta desde el callback: el servicio deja de evaluar.
+//   4. Servicio sin /evaluate/stream: cae a /evaluate y entrega los casos al final.
+// Devuelve != 0 si falla.
+
+#include "logging/logger.h"
+#include "sdk/eval_client.h"
+
+#include "support/mock_eval_service.h"
+#include "support/mock_http_server.h"
+#include "support/test_check.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cc::testing::check;
+using cc::testing::TestClock;
+using cc::testing::ms_since;
+using cc::testing::run_request;
+
+int main() {
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Error;
+    cc::logging::Logger::init(lc);
+
+    cc::testing::MockEvalOptions o;
+    o.judgeMs = 20;
+    o.cases   = 40;
+    o.caseMs  = 5;
+
+    // 1. Casos a medida que salen
+    {
+        cc::testing::MockEvalService service(o);
+        cc::sdk::EvalClient client(service.base_url());
+
+        std::vector<std::size_t> order;
+        long long firstMs = -1;
+        const auto t0 = TestClock::now();
+        const auto r = client.submitStreaming(run_request(), [&](std::size_t i, const cc::contracts::RunCaseResult& c) {
+            if (order.empty()) firstMs = ms_since(t0);
+            order.push_back(c.input == std::to_string(i) ? i : 9999);
+            return true;
+        });
+        const auto totalMs = ms_since(t0);
+        std::printf("first case after %lld ms, result after %lld ms\n", firstMs, totalMs);
+
+        bool inOrder = order.size() == o.cases;
+        for (std::size_t i = 0; inOrder && i < order.size(); ++i) inOrder = order[i] == i;
+        check(r.passed && !r.stoppedEarly && r.cases.size() == o.cases && inOrder, "all cases streamed in order");
+        check(firstMs >= 0 && firstMs * 3 < totalMs, "first case arrives long before the summary");
+    }
+
+    // 2. failFast
+    {
+        auto f = o;
+        f.failAt = 5;
+        cc::testing::MockEvalService service(f);
+        cc::sdk::EvalClient client(service.base_url());
+
+        std::size_t seen = 0;
+        const auto r = client.submitStreaming(run_request("int main() {}", true), [&](std::size_t, const auto&) { return ++seen, true; });
+        check(!r.passed && r.stoppedEarly && r.cases.size() == 6 && seen == 6 && !r.cases.back().passed,
+              "failFast stops at the first wrong answer");
+        check(service.stats().casesJudged.load() == 6, "judge ran only the cases up to the failure");
+
+        const auto buffered = client.submit(run_request("int main() {}", true));
+        check(buffered.stoppedEarly && buffered.cases.size() == 6, "failFast also applies to submit()");
+    }
+
+    // 3. Corte desde el callback
+    {
+        auto f = o;
+        f.failAt = 3;
+        cc::testing::MockEvalService service(f);
+        cc::sdk::EvalClient client(service.base_url());
+
+        const auto r = client.submitStreaming(run_request(), [](std::size_t, const cc::contracts::RunCaseResult& c) {
+            return c.passed;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100)); // el juez nota el corte
+        std::printf("caller stop: %zu cases judged of %zu\n", service.stats().casesJudged.load(), f.cases);
+        check(!r.passed && r.stoppedEarly && r.cases.size() == 4, "callback returning false stops reading");
+        check(service.stats().casesJudged.load() < f.cases / 2, "service stops judging after the disconnect");
+    }
+
+    // 4. Sin endpoint de streaming
+    {
+        cc::testing::MockHttpServer server([](const cc::testing::MockRequest& req) {
+            cc::testing::MockResponse resp;
+            if (req.target == "/evaluate") {
+                resp.headers.emplace_back("Content-Type", "application/json");
+                resp.body = R"({"passed":true,"cases":[{"input":"1","passed":true},{"input":"2","passed":true}]})";
+            } else {
+                resp.status = 404;
+            }
+            return resp;
+        });
+        cc::sdk::EvalClient client(server.base_url());
+
+        std::size_t seen = 0;
+        const auto r = client.submitStreaming(run_request(), [&](std::size_t, const auto&) { return ++seen, true; });
+        check(r.passed && r.cases.size() == 2 && seen == 2, "falls back to /evaluate and replays the cases");
+    }
+
+    return cc::testing::checks_result();
+}
@@ -0,0 +1,122 @@
+// test_header_map.cpp — HeaderMap y los headers que arma CurlTransfer:
+//   1. Un campo repetido en la respuesta se une con ", " (RFC 9110 §5.3); Set-Cookie no.
+//   2. La búsqueda no distingue mayúsculas, en headers comunes (índice) y en el resto.
+//   3. erase() quita todas las apariciones y reindexa: los comunes que quedan se siguen
+//      encontrando y el orden de iteración se mantiene.
+//   4. Extremo a extremo contra support/mock_http_server.h: los repetidos llegan unidos a
+//      HttpResponse::headers.
+// Devuelve != 0 si falla.
+
+#include "http/header_map.h"
+#include "http/http_client.h"
+#include "logging/logger.h"
+
+#include "support/mock_http_server.h"
+#include "support/test_check.h"
+
+#include <string>
+#include <vector>
+
+using cc::http::HeaderMap;
+using cc::testing::check;
+
+int main() {
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Error;
+    cc::logging::Logger::init(lc);
+
+    // 1. Repetidos
+    {
+        HeaderMap h;
+        h.parse_line("HTTP/1.1 200 OK\r\n");
+        h.parse_line("Cache-Control: no-cache\r\n");
+        h.parse_line("X-Trace: a\r\n");
+        h.parse_line("cache-control: max-age=0\r\n");
+        h.parse_line("x-trace:  b \r\n");
+        h.parse_line("Set-Cookie: s=1; Path=/\r\n");
+        h.parse_line("Set-Cookie: t=2\r\n");
+        h.parse_line("\r\n");
+
+        check(h.get("Cache-Control") == "no-cache, max-age=0", "a repeated known header is combined with \", \"");
+        check(h.get("X-Trace") == "a, b", "a repeated unknown header is combined with \", \"");
+        check(h.size() == 4, "combined headers keep a single entry each");
+
+        std::vector<std::string> cookies;
+        for (const auto& [k, v] : h) {
+            if (cc::http::iequals_ascii(k, "set-cookie")) cookies.emplace_back(v);
+        }
+        check(cookies == std::vector<std::string>{"s=1; Path=/", "t=2"} && h.get("Set-Cookie") == "t=2",
+              "Set-Cookie fields stay separate");
+
+        h.combine("Vary", "Accept");
+        h.combine("VARY", "Accept-Encoding");
+        check(h.get("vary") == "Accept, Accept-Encoding", "combine() joins values added directly");
+        h.set("Vary", "*");
+        check(h.get("Vary") == "*" && h.size() == 5, "set() still replaces a combined header");
+    }
+
+    // 2. Case-insensitive
+    {
+        HeaderMap h{{"Content-Type", "application/json"}, {"X-Custom-Header", "1"}};
+        check(h.get("content-type") == "application/json" && h.get("CONTENT-TYPE") == "application/json",
+              "known headers are found regardless of case");
+        check(h.get("x-custom-header") == "1" && h.get("X-CUSTOM-HEADER") == "1",
+              "unknown headers are found regardless of case");
+        check(!h.get("X-Custom") && !h.contains("content-typ"), "prefixes do not match");
+
+        h.set("CONTENT-TYPE", "text/plain");
+        check(h.size() == 2 && h.get("Content-Type") == "text/plain", "set() replaces across cases");
+    }
+
+    // 3. erase + reindex
+    {
+        HeaderMap h;
+        h.add("ETag", "\"v1\"");
+        h.add("X-A", "1");
+        h.add("etag", "\"v2\"");
+        h.add("Retry-After", "3");
+        h.add("Content-Length", "10");
+        check(h.get("ETag") == "\"v2\"", "with duplicates get() returns the last one");
+
+        check(h.erase("ETAG") && !h.contains("etag") && h.size() == 3, "erase() removes every occurrence");
+        check(!h.erase("etag"), "erase() of a missing header returns false");
+        check(h.get("Retry-After") == "3" && h.get("content-length") == "10",
+              "known headers after the erased ones are still indexed");
+
+        std::vector<std::string> names;
+        for (const auto& [k, v] : h) names.emplace_back(k);
+        check(names == std::vector<std::string>{"X-A", "Retry-After", "Content-Length"},
+              "iteration keeps insertion order after erase");
+
+        h.combine("retry-after", "4");
+        check(h.get("Retry-After") == "3, 4" && h.size() == 3, "combine() after erase finds the reindexed entry");
+
+        h.clear();
+        check(h.empty() && h.bytes() == 0 && !h.contains("Retry-After"), "clear() drops entries and index");
+    }
+
+    // 4. Extremo a extremo
+    {
+        cc::testing::MockHttpServer server([](const cc::testing::MockRequest&) {
+            cc::testing::MockResponse r;
+            r.headers = {{"Cache-Control", "no-store"}, {"Link", "</a>; rel=next"},
+                         {"cache-control", "private"}, {"Set-Cookie", "a=1"},
+                         {"Link", "</z>; rel=last"},   {"Set-Cookie", "b=2"}};
+            r.body = "ok";
+            return r;
+        });
+
+        cc::http::HttpClient client;
+        client.setRetries(0);
+        const auto r = client.get(server.base_url() + "/headers");
+
+        check(r.isSuccess(), "request succeeds");
+        check(r.headers.get("Cache-Control") == "no-store, private", "repeated response headers arrive combined");
+        check(r.headers.get("link") == "</a>; rel=next, </z>; rel=last", "combined values keep their order");
+        int cookies = 0;
+        for (const auto& [k, v] : r.headers) cookies += cc::http::iequals_ascii(k, "Set-Cookie") ? 1 : 0;
+        check(cookies == 2, "response Set-Cookie fields stay separate");
+    }
+
+    return cc::testing::checks_result();
+}
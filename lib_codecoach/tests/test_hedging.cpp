@@ -0,0 +1,94 @@
+// test_hedging.cpp — Hedging de GETs (HttpClient::setHedging) contra support/mock_http_server.h:
+//   1. Sin muestras suficientes no se hedgea.
+//   2. Con un intento colgado, la copia sale tras el pN observado y gana.
+//   3. El perdedor se cancela: el servidor ve cerrarse su conexión a mitad de respuesta.
+//   4. Los POST no se hedgean.
+// Devuelve != 0 si falla.
+
+#include "http/http_client.h"
+#include "logging/logger.h"
+
+#include "support/mock_http_server.h"
+#include "support/test_check.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using cc::testing::check;
+using cc::testing::counter;
+using cc::testing::ms_since;
+using cc::testing::TestClock;
+
+int main() {
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Error;
+    cc::logging::Logger::init(lc);
+
+    // /slow: la primera vez responde de a un byte cada 20 ms durante ~3 s (intento colgado);
+    // las demás, al instante. `loserClosed` marca que el cliente cortó esa conexión.
+    std::atomic<int>  slowHits{0};
+    std::atomic<bool> loserClosed{false};
+    std::atomic<int>  posts{0};
+    cc::testing::MockHttpServer server([&](const cc::testing::MockRequest& req) {
+        cc::testing::MockResponse r;
+        if (req.method == "POST") {
+            ++posts;
+            r.delayMs = 150;
+            r.body    = "posted";
+            return r;
+        }
+        if (req.target == "/slow" && slowHits++ == 0) {
+            r.stream = [&](const cc::testing::ChunkWriter& write) {
+                for (int i = 0; i < 150; ++i) {
+                    if (!write("x")) {
+                        loserClosed = true;
+                        return;
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                }
+            };
+            return r;
+        }
+        r.body = "fast";
+        return r;
+    });
+
+    cc::http::HttpClient client;
+    client.setRetries(0);
+    cc::http::HedgePolicy hp;
+    hp.percentile = 0.9;
+    hp.minSamples = 10;
+    hp.minDelay   = cc::time::Millis{20};
+    client.setHedging(hp);
+
+    // 1. Sin historia
+    {
+        for (int i = 0; i < 5; ++i) client.get(server.base_url() + "/warm");
+        check(counter("http.hedge.fired") == 0, "no hedging before minSamples observations");
+        for (int i = 0; i < 15; ++i) client.get(server.base_url() + "/warm");
+    }
+
+    // 2 + 3. Intento colgado
+    {
+        const auto t0 = TestClock::now();
+        const auto r = client.get(server.base_url() + "/slow");
+        const auto took = ms_since(t0);
+        std::printf("hedged GET answered in %lld ms\n", took);
+        check(r.isSuccess() && r.body == "fast" && took < 1000, "the hedge answers while the primary hangs");
+        check(counter("http.hedge.fired") == 1 && counter("http.hedge.won") == 1 && slowHits.load() == 2,
+              "exactly one hedge is fired and wins");
+
+        for (int i = 0; i < 40 && !loserClosed.load(); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(25));
+        check(loserClosed.load(), "the losing attempt is cancelled mid-transfer");
+    }
+
+    // 4. No idempotente
+    {
+        const auto r = client.post(server.base_url() + "/submit", "{}");
+        check(r.isSuccess() && posts.load() == 1 && counter("http.hedge.fired") == 1, "POST is never hedged");
+    }
+
+    return cc::testing::checks_result();
+}
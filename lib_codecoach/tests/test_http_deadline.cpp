@@ -0,0 +1,135 @@
+// test_http_deadline.cpp — Deadline y cancelación (RequestControl) contra
+// support/mock_http_server.h, con un servidor que responde de a un byte cada 20 ms:
+//   1. El deadline corta la transferencia a mitad del body (request() y requestAsync()).
+//   2. Cancelar el token aborta la transferencia en curso con 499.
+//   3. Los intentos cortados por el deadline no cuentan como fallos para el circuit breaker
+//      ni como sobrecarga para el límite AIMD del origen.
+// Devuelve != 0 si falla.
+
+#include "http/circuit_breaker.h"
+#include "http/http_client.h"
+#include "http/rate_limiter.h"
+#include "http/url.h"
+#include "logging/logger.h"
+#include "metrics/timer.h"
+
+#include "support/mock_http_server.h"
+#include "support/test_check.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+
+using cc::testing::check;
+using cc::testing::ms_since;
+using cc::testing::TestClock;
+
+namespace {
+
+double limit_of(const std::string& origin) {
+    for (const auto& s : cc::http::RateLimiters::instance().snapshot()) {
+        if (s.origin == origin) return s.limit;
+    }
+    return -1;
+}
+
+} // namespace
+
+int main() {
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Error;
+    cc::logging::Logger::init(lc);
+
+    std::atomic<int> closed{0}; // respuestas que el cliente cortó a mitad
+    cc::testing::MockHttpServer server([&](const cc::testing::MockRequest&) {
+        cc::testing::MockResponse r;
+        r.stream = [&](const cc::testing::ChunkWriter& write) {
+            for (int i = 0; i < 150; ++i) {
+                if (!write("x")) {
+                    ++closed;
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+        };
+        return r;
+    });
+    const std::string url    = server.base_url() + "/slow";
+    const std::string origin = cc::http::origin_of(url);
+
+    cc::http::HttpClient client;
+    client.setRetries(2);
+
+    auto wait_closed = [&](int n) {
+        for (int i = 0; i < 40 && closed.load() < n; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(25));
+        return closed.load() >= n;
+    };
+
+    // 1. Deadline
+    {
+        cc::http::RequestControl ctl;
+        ctl.deadline = cc::time::Deadline(cc::time::Millis{200});
+        const auto t0 = TestClock::now();
+        const auto r = client.request("GET", url, {}, {}, std::nullopt, ctl);
+        const auto took = ms_since(t0);
+        std::printf("sync deadline: %d \"%s\" after %lld ms\n", r.statusCode, r.body.c_str(), took);
+        check(r.statusCode == 0 && r.body == "deadline exceeded" && took >= 150 && took < 1000,
+              "the deadline stops a sync transfer mid-body");
+        check(wait_closed(1), "the server sees the sync transfer aborted");
+
+        std::promise<cc::http::HttpResponse> done;
+        cc::http::RequestControl actl;
+        actl.deadline = cc::time::Deadline(cc::time::Millis{200});
+        const auto a0 = TestClock::now();
+        client.requestAsync("GET", url, "", {}, std::nullopt,
+                            [&](cc::http::HttpResponse resp) { done.set_value(std::move(resp)); }, actl);
+        const auto ar = done.get_future().get();
+        const auto atook = ms_since(a0);
+        check(ar.statusCode == 0 && ar.body == "deadline exceeded" && atook < 1000,
+              "the deadline stops an async transfer mid-body");
+        check(wait_closed(2), "the server sees the async transfer aborted");
+    }
+
+    // 2. Cancelación
+    {
+        cc::time::CancellationSource src;
+        cc::http::RequestControl ctl;
+        ctl.cancel = src.token();
+        std::thread canceller([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            src.cancel();
+        });
+        const auto t0 = TestClock::now();
+        const auto r = client.request("GET", url, {}, {}, std::nullopt, ctl);
+        const auto took = ms_since(t0);
+        canceller.join();
+        std::printf("cancelled: %d after %lld ms\n", r.statusCode, took);
+        check(r.statusCode == 499 && took < 500, "cancelling the token aborts the transfer with 499");
+        check(wait_closed(3), "the server sees the cancelled transfer aborted");
+    }
+
+    // 3. Breaker y AIMD
+    {
+        cc::http::BreakerPolicy bp;
+        bp.failureRatePct = 50;
+        bp.minCalls       = 3;
+        cc::http::CircuitBreakers::instance().configure(bp);
+        cc::http::LimiterPolicy lp;
+        lp.maxInFlight = 8;
+        lp.adaptive    = true;
+        cc::http::RateLimiters::instance().configure(origin, lp);
+
+        for (int i = 0; i < 4; ++i) {
+            cc::http::RequestControl ctl;
+            ctl.deadline = cc::time::Deadline(cc::time::Millis{60});
+            client.request("GET", url, {}, {}, std::nullopt, ctl);
+        }
+        check(cc::http::CircuitBreakers::instance().state(origin) == cc::http::BreakerState::Closed,
+              "deadline-cut attempts do not open the circuit");
+        check(limit_of(origin) == 8.0, "deadline-cut attempts do not shrink the concurrency limit");
+    }
+
+    return cc::testing::checks_result();
+}
@@ -0,0 +1,198 @@
+// test_llm_batcher.cpp — split_multi_task_response y BatchingLLMClient contra un cliente
+// interno en memoria (sin red):
+//   1. La respuesta combinada se separa por número de sección: en orden, desordenada, con
+//      secciones de más o repetidas (se descartan sin mezclarse) y con una faltante (nullopt).
+//   2. completeAll: prompts idénticos se resuelven una vez y las tareas con el mismo prefijo
+//      van en una sola llamada combinada.
+//   3. Si la respuesta combinada no trae todas las secciones, cada prompt sale por separado.
+//   4. Si cancelan al que abrió el batch, los demás salen por separado con su propio ctl.
+// Devuelve != 0 si falla.
+
+#include "sdk/llm_batcher.h"
+#include "logging/logger.h"
+
+#include "support/test_check.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cc::prompts::Prompt;
+using cc::prompts::split_multi_task_response;
+using cc::testing::check;
+
+namespace {
+
+    using Parts = std::vector<std::string>;
+
+    const std::string kPrefix = "Problema: suma dos enteros.\nCódigo: int main() {}\n\n";
+
+    Prompt task_prompt(const std::string& task) {
+        Prompt p;
+        p.system       = "coach";
+        p.user         = kPrefix + task;
+        p.version      = "test/" + task;
+        p.sharedPrefix = kPrefix.size();
+        return p;
+    }
+
+    // Cliente interno: responde "R(<tarea>)" a cada tarea y anota lo que le llegó
+    class FakeLLM : public cc::sdk::ILLMClient {
+    public:
+        // Combinada con todas las secciones (false => sin la última)
+        std::atomic<bool> completeSections{true};
+
+        std::string complete(const std::string&, const std::string&, const cc::http::RequestControl&) override {
+            return {};
+        }
+
+        std::string complete(const Prompt& p, const cc::http::RequestControl& ctl) override {
+            std::lock_guard<std::mutex> lk(m_);
+            calls_.push_back(p.user);
+            if (ctl.cancel.is_cancelled()) return {};
+
+            const std::string tasks = p.user.substr(p.sharedPrefix);
+            const std::string marker = "### TAREA ";
+            if (tasks.find(marker) == std::string::npos) return "R(" + tasks + ")";
+
+            std::string out = "Claro, aquí van:\n";
+            std::size_t k = 0;
+            for (std::size_t pos = tasks.find(marker); pos != std::string::npos;) {
+                const std::size_t body = tasks.find('\n', pos) + 1;
+                const std::size_t next = tasks.find(marker, body);
+                std::string task = tasks.substr(body, (next == std::string::npos ? tasks.size() : next) - body);
+                while (!task.empty() && task.back() == '\n') task.pop_back();
+                if (next != std::string::npos || completeSections) {
+                    out += "### RESPUESTA " + std::to_string(++k) + "\nR(" + task + ")\n\n";
+                }
+                pos = next;
+            }
+            return out;
+        }
+
+        bool isAvailable() const override { return true; }
+
+        std::vector<std::string> calls() {
+            std::lock_guard<std::mutex> lk(m_);
+            return calls_;
+        }
+
+        void reset() {
+            std::lock_guard<std::mutex> lk(m_);
+            calls_.clear();
+        }
+
+    private:
+        std::mutex               m_;
+        std::vector<std::string> calls_;
+    };
+
+    bool is_combined(const std::string& user) {
+        return user.find("### TAREA ") != std::string::npos;
+    }
+
+} // namespace
+
+int main() {
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Error;
+    cc::logging::Logger::init(lc);
+
+    // 1. Separar
+    {
+        const auto inOrder = split_multi_task_response(
+            "Aquí van:\n### RESPUESTA 1\nuno\n\n### RESPUESTA 2\n  dos\n### RESPUESTA 3\ntres\n", 3);
+        check(inOrder && *inOrder == Parts{"uno", "dos", "tres"}, "sections in order are split and trimmed");
+
+        const auto reordered = split_multi_task_response(
+            "### RESPUESTA 3\ntres\n### RESPUESTA 1\nuno\n### RESPUESTA 2\ndos", 3);
+        check(reordered && *reordered == Parts{"uno", "dos", "tres"}, "reordered sections map by number");
+
+        const auto extra = split_multi_task_response(
+            "### RESPUESTA 1\nuno\n### RESPUESTA 4\ncuatro\n### RESPUESTA 2\ndos\n### RESPUESTA 1\notra vez\n", 2);
+        check(extra && *extra == Parts{"uno", "dos"},
+              "extra and repeated sections are dropped without leaking into others");
+
+        const auto big = split_multi_task_response("### RESPUESTA 1\nuno\n### RESPUESTA 99999999999999999999999\nx", 1);
+        check(big && *big == Parts{"uno"}, "huge section numbers are out of range");
+
+        check(!split_multi_task_response("### RESPUESTA 1\nuno\n### RESPUESTA 3\ntres\n", 3),
+              "a missing section gives nullopt");
+        check(!split_multi_task_response("sin secciones", 1), "a response without markers gives nullopt");
+
+        const auto empty = split_multi_task_response("### RESPUESTA 1\n### RESPUESTA 2\ndos", 2);
+        check(empty && *empty == Parts{"", "dos"}, "an empty section is kept as an empty answer");
+    }
+
+    auto inner = std::make_shared<FakeLLM>();
+    cc::sdk::LlmBatchOptions opts;
+    opts.window   = std::chrono::milliseconds(300);
+    opts.maxBatch = 8;
+
+    // 2. Deduplicar y combinar
+    {
+        cc::sdk::BatchingLLMClient client(inner, opts);
+        const auto out = client.completeAll({task_prompt("pistas"), task_prompt("analiza"), task_prompt("pistas")});
+        const auto calls = inner->calls();
+        const auto s = client.stats();
+
+        check(out == Parts{"R(pistas)", "R(analiza)", "R(pistas)"}, "every prompt gets its own answer");
+        check(calls.size() == 1 && is_combined(calls[0]), "same-prefix tasks go out in one combined call");
+        check(s.deduped == 1 && s.merged == 3 && s.calls == 1 && s.splitFailed == 0,
+              "identical prompts are resolved once");
+        inner->reset();
+    }
+
+    // 3. Respuesta combinada incompleta
+    {
+        cc::sdk::BatchingLLMClient client(inner, opts);
+        inner->completeSections = false;
+        const auto out = client.completeAll({task_prompt("pistas"), task_prompt("analiza")});
+        inner->completeSections = true;
+        const auto calls = inner->calls();
+        const auto s = client.stats();
+
+        check(out == Parts{"R(pistas)", "R(analiza)"}, "a combined response with a missing section falls back");
+        check(calls.size() == 3 && is_combined(calls[0]) && !is_combined(calls[1]) && !is_combined(calls[2]),
+              "the fallback calls each prompt on its own");
+        check(s.splitFailed == 1 && s.merged == 0 && s.calls == 3, "the failed split is counted");
+        inner->reset();
+    }
+
+    // 4. Líder cancelado
+    {
+        cc::sdk::BatchingLLMClient client(inner, opts);
+        cc::time::CancellationSource src;
+        cc::http::RequestControl leaderCtl;
+        leaderCtl.cancel = src.token();
+
+        std::string leader, hints, explain;
+        const auto t0 = cc::testing::TestClock::now();
+        std::thread a([&] { leader = client.complete(task_prompt("analiza"), leaderCtl); });
+        while (client.stats().prompts < 1) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::thread b([&] { hints = client.complete(task_prompt("pistas")); });
+        std::thread c([&] { explain = client.complete(task_prompt("explica")); });
+        while (client.stats().prompts < 3) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        src.cancel();
+        a.join();
+        b.join();
+        c.join();
+        const auto elapsed = cc::testing::ms_since(t0);
+        const auto calls = inner->calls();
+        const auto s = client.stats();
+
+        check(leader.empty(), "the cancelled leader returns nothing");
+        check(hints == "R(pistas)" && explain == "R(explica)", "the other prompts fall back to their own calls");
+        check(calls.size() == 3 && is_combined(calls[0]) && !is_combined(calls[1]) && !is_combined(calls[2]),
+              "one cancelled combined call, then one call per remaining prompt");
+        check(s.batches == 1 && s.merged == 0 && s.calls == 3, "nothing is counted as merged");
+        check(elapsed < 250, "cancelling the leader closes the window early");
+        inner->reset();
+    }
+
+    return cc::testing::checks_result();
+}
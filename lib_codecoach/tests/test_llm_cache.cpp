@@ -0,0 +1,224 @@
+// test_llm_cache.cpp — CachingLLMClient + LlmResponseCache contra un ILLMClient falso que
+// cuenta llamadas y tarda un tiempo fijo:
+//   1. La clave cambia con modelo, versión, system, user, temperature y maxTokens.
+//   2. Un miss llama al modelo; el mismo prompt después sale de la caché (métricas de ahorro).
+//   3. Streaming: un acierto entrega el texto; un stream cortado por el caller no se guarda.
+//   4. TTL: una entrada vencida vuelve a llamar al modelo.
+//   5. Capa en disco: otra instancia sobre el mismo directorio encuentra lo guardado, aunque
+//      el archivo de datos tenga basura al final (append interrumpido).
+//   6. Con el tope de disco se compacta y se conservan las entradas más nuevas.
+// Devuelve != 0 si falla.
+
+#include "sdk/llm_cache.h"
+#include "logging/logger.h"
+#include "metrics/counters.h"
+
+#include "support/test_check.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+using cc::testing::check;
+using cc::testing::counter;
+
+namespace {
+
+// "Modelo" que responde con un eco del prompt
+class FakeLLM : public cc::sdk::ILLMClient {
+public:
+    std::atomic<int> calls{0};
+    std::chrono::milliseconds delay{20};
+
+    using ILLMClient::complete;
+
+    std::string complete(const std::string& prompt, const std::string& systemPrompt,
+                         const cc::http::RequestControl&) override {
+        ++calls;
+        std::this_thread::sleep_for(delay);
+        return "feedback[" + systemPrompt + "|" + prompt + "]";
+    }
+
+    std::string completeStreaming(const cc::prompts::Prompt& prompt, TokenCallback onToken,
+                                  const cc::http::RequestControl&) override {
+        ++calls;
+        std::string text;
+        for (const char* token : {"Usá", " un", " hash", " map", " para", " " , prompt.user.c_str()}) {
+            text += token;
+            if (onToken && !onToken(token)) return text;
+        }
+        return text;
+    }
+
+    bool isAvailable() const override { return true; }
+};
+
+cc::prompts::Prompt prompt_for(const std::string& code) {
+    cc::prompts::Prompt p;
+    p.system  = "Sos un coach de programación.";
+    p.user    = "Analizá este código: " + code;
+    p.version = "analyze/v1";
+    return p;
+}
+
+} // namespace
+
+int main() {
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Warn;
+    cc::logging::Logger::init(lc);
+
+    const fs::path dir = fs::temp_directory_path() / ("cc_llm_cache_test_" + std::to_string(::getpid()));
+    fs::remove_all(dir);
+
+    using cc::sdk::LlmResponseCache;
+
+    // 1. Clave
+    {
+        const auto base = prompt_for("int main(){}");
+        const auto key  = LlmResponseCache::key_of("gpt-test", base);
+        auto other = base;
+        other.temperature = 0.7;
+        auto longer = base;
+        longer.maxTokens = 100;
+        auto v2 = base;
+        v2.version = "analyze/v2";
+        auto moved = base;
+        moved.system += moved.user.substr(0, 3); // mismo texto concatenado, otro reparto
+        moved.user.erase(0, 3);
+
+        check(key == LlmResponseCache::key_of("gpt-test", base), "same prompt gives the same key");
+        check(key != LlmResponseCache::key_of("gpt-other", base) &&
+              key != LlmResponseCache::key_of("gpt-test", other) &&
+              key != LlmResponseCache::key_of("gpt-test", longer) &&
+              key != LlmResponseCache::key_of("gpt-test", v2) &&
+              key != LlmResponseCache::key_of("gpt-test", moved),
+              "model, temperature, maxTokens, version and message boundaries change the key");
+    }
+
+    // 2. Miss + hit
+    {
+        cc::metrics::Counters::instance().reset();
+        auto inner = std::make_shared<FakeLLM>();
+        cc::sdk::CachingLLMClient client(inner, "gpt-test", std::make_shared<LlmResponseCache>());
+
+        const auto p = prompt_for("for(i=0;i<=n;i++)");
+        const std::string first = client.complete(p);
+        const auto t0 = std::chrono::steady_clock::now();
+        const std::string second = client.complete(p);
+        const auto hitUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+
+        std::printf("hit served in %lld us (model call ~20 ms)\n", static_cast<long long>(hitUs));
+        check(inner->calls == 1 && first == second && !first.empty(), "second identical prompt served from cache");
+        check(client.complete(prompt_for("otro código")) != first && inner->calls == 2, "different prompt misses");
+
+        const auto st = client.cache()->stats();
+        check(st.hits == 1 && st.misses == 2 && st.entries == 2, "stats count hits, misses and entries");
+        check(counter("llm.cache.hit|memory") == 1 && counter("llm.cache.miss") == 2, "hit/miss counters");
+        check(counter("llm.cache.saved_ms") >= 15 && counter("llm.cache.saved_tokens") > 0,
+              "saved latency and tokens reported");
+    }
+
+    // 3. Streaming
+    {
+        auto inner = std::make_shared<FakeLLM>();
+        cc::sdk::CachingLLMClient client(inner, "gpt-test", std::make_shared<LlmResponseCache>());
+        const auto p = prompt_for("while(true){}");
+
+        int seen = 0;
+        client.completeStreaming(p, [&](std::string_view) { return ++seen < 2; });
+        const std::string full = client.completeStreaming(p, [](std::string_view) { return true; });
+        check(inner->calls == 2, "stream stopped by the caller is not cached");
+
+        std::string delivered;
+        const std::string again = client.completeStreaming(p, [&](std::string_view t) {
+            delivered += t;
+            return true;
+        });
+        check(inner->calls == 2 && again == full && delivered == full, "cached stream delivered through onToken");
+        check(client.complete(p) == full && inner->calls == 2, "stream and complete share the entry");
+    }
+
+    // 4. TTL
+    {
+        cc::sdk::LlmCacheOptions o;
+        o.ttl = std::chrono::seconds(1);
+        auto inner = std::make_shared<FakeLLM>();
+        inner->delay = std::chrono::milliseconds(0);
+        cc::sdk::CachingLLMClient client(inner, "gpt-test", std::make_shared<LlmResponseCache>(o));
+        const auto p = prompt_for("ttl");
+        client.complete(p);
+        client.complete(p);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        client.complete(p);
+        check(inner->calls == 2, "expired entry calls the model again");
+    }
+
+    // 5. Disco
+    {
+        cc::sdk::LlmCacheOptions o;
+        o.diskDir = dir.string();
+        const auto p = prompt_for("persistente");
+        std::string stored;
+        {
+            auto inner = std::make_shared<FakeLLM>();
+            cc::sdk::CachingLLMClient client(inner, "gpt-test", std::make_shared<LlmResponseCache>(o));
+            stored = client.complete(p);
+        }
+        {
+            std::ofstream junk(dir / "llm_cache.dat", std::ios::binary | std::ios::app);
+            junk << "registro a medias";
+        }
+        auto inner = std::make_shared<FakeLLM>();
+        auto cache = std::make_shared<LlmResponseCache>(o);
+        cc::sdk::CachingLLMClient client(inner, "gpt-test", cache);
+        check(client.complete(p) == stored && inner->calls == 0, "new instance finds the entry on disk");
+        check(cache->stats().diskHits == 1 && cache->stats().diskEntries == 1, "disk hit counted");
+
+        client.complete(prompt_for("después del crash"));
+        auto reopened = std::make_shared<LlmResponseCache>(o);
+        check(reopened->stats().diskEntries == 2 &&
+              reopened->lookup(LlmResponseCache::key_of("gpt-test", prompt_for("después del crash"))),
+              "append after truncating the partial record is readable");
+
+        reopened->clear();
+        check(!LlmResponseCache(o).lookup(LlmResponseCache::key_of("gpt-test", p)), "clear() empties the disk tier");
+    }
+
+    // 6. Compactación
+    {
+        cc::sdk::LlmCacheOptions o;
+        o.diskDir      = (dir / "small").string();
+        o.diskMaxBytes = 64 * 1024;
+        o.maxBytes     = 1024; // casi todo se lee del disco
+        auto cache = std::make_shared<LlmResponseCache>(o);
+
+        for (int i = 0; i < 200; ++i) {
+            cc::sdk::LlmCacheEntry e;
+            e.text = std::string(1000, static_cast<char>('a' + i % 26)) + std::to_string(i);
+            cache->store(LlmResponseCache::key_of("gpt-test", prompt_for(std::to_string(i))), std::move(e));
+        }
+        const auto st = cache->stats();
+        std::printf("disk: %zu entries, %zu bytes, %zu compactions\n", st.diskEntries, st.diskBytes, st.compactions);
+        check(st.compactions > 0 && st.diskBytes <= o.diskMaxBytes, "data file stays under the size limit");
+
+        auto newest = cache->lookup(LlmResponseCache::key_of("gpt-test", prompt_for("199")));
+        check(newest && newest->text.size() == 1003 && newest->text.back() == '9', "newest entry kept");
+        check(!cache->lookup(LlmResponseCache::key_of("gpt-test", prompt_for("0"))), "oldest entry dropped");
+    }
+
+    fs::remove_all(dir);
+
+    return cc::testing::checks_result();
+}
@@ -0,0 +1,124 @@
+// test_openai_stream.cpp — OpenAIClient contra un stand-in local de /chat/completions que
+// reproduce una completion grabada (tests/support/sse_replay.h):
+//   1. complete(Prompt): el body lleva model/messages/max_tokens/temperature y se extrae
+//      choices[0].message.content.
+//   2. completeStreaming(): los tokens llegan de a uno (el primero mucho antes del final),
+//      también con eventos partidos en trozos de pocos bytes.
+//   3. Si el callback devuelve false se corta la generación.
+// Devuelve != 0 si falla.
+//
+// Uso: test_openai_stream [tokens_por_seg=200]
+
+#include "sdk/llm_client_openai.h"
+#include "logging/logger.h"
+
+#include "support/bench_util.h"
+#include "support/mock_http_server.h"
+#include "support/sse_replay.h"
+#include "support/test_check.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using cc::testing::MockHttpServer;
+using cc::testing::RecordedCompletion;
+using cc::testing::ReplayLog;
+
+using cc::testing::check;
+
+namespace {
+
+RecordedCompletion recorded(double tokensPerSec) {
+    RecordedCompletion rec;
+    rec.tokens = {"Tu", " solución", " es", " O(n²)", ":", " el", " bucle", " interno", " recorre",
+                  " el", " arreglo", " completo", ".", " Usá", " un", " hash", " map", " para",
+                  " bajar", " a", " O(n)", ".", "\n\n", "Casos", " que", " fallan", ":", " \"[]\""};
+    rec.tokensPerSec = tokensPerSec;
+    return rec;
+}
+
+cc::prompts::Prompt coach_prompt() {
+    cc::prompts::Prompt p;
+    p.system      = "Sos un coach de programación.";
+    p.user        = "Analizá este código: int main(){}";
+    p.maxTokens   = 321;
+    p.temperature = 0.3;
+    return p;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double rate = argc > 1 ? std::max(1.0, std::atof(argv[1])) : 200.0;
+
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Warn;
+    cc::logging::Logger::init(lc);
+
+    const RecordedCompletion rec = recorded(rate);
+    const std::string expected   = cc::testing::completion_text(rec);
+
+    // 1. Request/response completos
+    {
+        auto log = std::make_shared<ReplayLog>();
+        MockHttpServer server(cc::testing::make_sse_replay_handler(rec, log));
+        cc::sdk::OpenAIClient client("sk-test", "gpt-test", server.base_url() + "/v1");
+
+        const std::string text = client.complete(coach_prompt());
+        check(text == expected, "complete(Prompt) returns choices[0].message.content");
+
+        const auto body = nlohmann::json::parse(log->lastBody, nullptr, false);
+        check(!body.is_discarded() && body.value("model", "") == "gpt-test" &&
+              body.value("max_tokens", 0) == 321 && body.value("temperature", 0.0) == 0.3 &&
+              !body.contains("stream"),
+              "request body carries model, max_tokens and temperature");
+        check(body.contains("messages") && body["messages"].size() == 2 &&
+              body["messages"][0].value("role", "") == "system" &&
+              body["messages"][1].value("content", "") == coach_prompt().user,
+              "request body carries system and user messages");
+    }
+
+    // 2. Streaming, con y sin eventos partidos entre trozos
+    for (std::size_t split : {std::size_t{0}, std::size_t{7}}) {
+        RecordedCompletion r = rec;
+        r.splitEvery = split;
+        MockHttpServer server(cc::testing::make_sse_replay_handler(r));
+        cc::sdk::OpenAIClient client("sk-test", "gpt-test", server.base_url() + "/v1");
+
+        std::vector<std::string> tokens;
+        double firstUs = 0;
+        const auto t0 = cc::testing::BenchClock::now();
+        const std::string text = client.completeStreaming(coach_prompt(), [&](std::string_view token) {
+            if (tokens.empty()) firstUs = cc::testing::elapsed_us(t0);
+            tokens.emplace_back(token);
+            return true;
+        });
+        const double totalUs = cc::testing::elapsed_us(t0);
+
+        std::printf("split=%zu tokens=%zu first token %.1f ms, complete %.1f ms (%.0f tokens/s)\n",
+                    split, tokens.size(), firstUs / 1000.0, totalUs / 1000.0, rate);
+        check(text == expected, split ? "stream text with split events" : "stream text matches recording");
+        check(tokens == rec.tokens, "one callback per recorded token, in order");
+        check(firstUs < totalUs / 4, "first token arrives long before the completion ends");
+    }
+
+    // 3. Corte desde el callback
+    {
+        MockHttpServer server(cc::testing::make_sse_replay_handler(rec));
+        cc::sdk::OpenAIClient client("sk-test", "gpt-test", server.base_url() + "/v1");
+
+        int seen = 0;
+        const std::string text = client.completeStreaming(coach_prompt(), [&](std::string_view) {
+            return ++seen < 5;
+        });
+        check(seen == 5 && text == rec.tokens[0] + rec.tokens[1] + rec.tokens[2] + rec.tokens[3] + rec.tokens[4],
+              "returning false from the callback stops the stream");
+    }
+
+    return cc::testing::checks_result();
+}
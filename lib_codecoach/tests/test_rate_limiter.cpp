@@ -0,0 +1,185 @@
+// test_rate_limiter.cpp — RateLimiters + HttpClient contra support/mock_http_server.h:
+//   1. Un 429 recorta a la mitad el límite de concurrencia adaptativo (AIMD) del origen y
+//      los éxitos lo vuelven a subir de a poco.
+//   2. Volver a aplicar la misma cuota (un cliente nuevo del servicio) no pierde lo aprendido;
+//      cambiarla lo acota a los nuevos topes.
+//   3. Un Retry-After pausa al origen: la siguiente llamada espera.
+//   4. La concurrencia en vuelo nunca pasa del límite.
+//   5. El token bucket espacia las llamadas a la tasa configurada.
+//   6. La copia de un GET hedgeado ocupa su propio turno: sin turno libre no sale.
+// Devuelve != 0 si falla.
+
+#include "http/http_client.h"
+#include "http/rate_limiter.h"
+#include "http/url.h"
+#include "logging/logger.h"
+
+#include "support/mock_http_server.h"
+#include "support/test_check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cc::testing::check;
+using cc::testing::counter;
+using cc::testing::ms_since;
+using cc::testing::TestClock;
+
+namespace {
+
+cc::http::LimiterSnapshot snapshot_of(const std::string& origin) {
+    for (const auto& s : cc::http::RateLimiters::instance().snapshot()) {
+        if (s.origin == origin) return s;
+    }
+    return {};
+}
+
+} // namespace
+
+int main() {
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Error;
+    cc::logging::Logger::init(lc);
+
+    std::atomic<int> inFlight{0}, peak{0};
+    std::atomic<bool> slowNext{false};
+    cc::testing::MockHttpServer server([&](const cc::testing::MockRequest& req) {
+        cc::testing::MockResponse r;
+        if (req.target == "/throttle") {
+            r.status = 429;
+        } else if (req.target == "/pause") {
+            r.status  = 429;
+            r.headers = {{"Retry-After", "1"}};
+        } else if (req.target == "/busy") {
+            const int now = ++inFlight;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            --inFlight;
+        } else if (req.target == "/hang" && slowNext.exchange(false)) {
+            r.delayMs = 400;
+        }
+        r.body = "ok";
+        return r;
+    });
+    const std::string base   = server.base_url();
+    const std::string origin = cc::http::origin_of(base);
+    auto& limiters = cc::http::RateLimiters::instance();
+
+    cc::http::HttpClient client;
+    client.setRetries(0);
+
+    cc::http::LimiterPolicy p;
+    p.maxInFlight = 8;
+    p.adaptive    = true;
+    limiters.configure(origin, p);
+
+    // 1. AIMD
+    {
+        client.get(base + "/throttle");
+        const auto s = snapshot_of(origin);
+        check(s.limit == 4.0 && s.decreased == 1, "a 429 halves the adaptive concurrency limit");
+        for (int i = 0; i < 12; ++i) client.get(base + "/ok");
+        const auto grown = snapshot_of(origin).limit;
+        std::printf("limit after 12 successes: %.2f\n", grown);
+        check(grown > 4.0 && grown <= 8.0, "successes grow the limit back additively");
+    }
+
+    // 2. Reconfiguración
+    {
+        client.get(base + "/throttle");
+        const auto learned = snapshot_of(origin).limit;
+        cc::http::apply_service_quota(base, 0, 8);
+        limiters.configure(origin, p);
+        check(snapshot_of(origin).limit == learned, "re-applying the same quota keeps the learned limit");
+        auto lower = p;
+        lower.maxInFlight = 2;
+        limiters.configure(origin, lower);
+        check(snapshot_of(origin).limit == 2.0, "a new policy clamps the learned limit to its bounds");
+        limiters.configure(origin, p);
+    }
+
+    // 3. Retry-After
+    {
+        client.get(base + "/pause");
+        check(snapshot_of(origin).pausedFor.count() > 500, "Retry-After pauses the origin");
+        limiters.configure(origin, p);
+        check(snapshot_of(origin).pausedFor.count() > 500, "reconfiguring keeps the Retry-After pause");
+        const auto t0 = TestClock::now();
+        const auto r = client.get(base + "/ok");
+        const auto took = ms_since(t0);
+        std::printf("call after Retry-After waited %lld ms\n", took);
+        check(r.isSuccess() && took >= 700, "the next call waits out the pause");
+    }
+
+    // 4. Concurrencia
+    {
+        auto tight = p;
+        tight.maxInFlight = 3;
+        tight.adaptive    = false;
+        limiters.configure(origin, tight);
+        std::vector<std::thread> callers;
+        std::atomic<int> ok{0};
+        for (int i = 0; i < 12; ++i) {
+            callers.emplace_back([&] { if (client.get(base + "/busy").isSuccess()) ++ok; });
+        }
+        for (auto& t : callers) t.join();
+        std::printf("peak in flight: %d\n", peak.load());
+        check(ok.load() == 12 && peak.load() <= 3, "in-flight calls never exceed maxInFlight");
+    }
+
+    // 5. Tasa
+    {
+        cc::http::LimiterPolicy rate;
+        rate.qps   = 20;
+        rate.burst = 1;
+        limiters.configure(origin, rate);
+        const auto t0 = TestClock::now();
+        for (int i = 0; i < 6; ++i) client.get(base + "/ok");
+        const auto took = ms_since(t0);
+        std::printf("6 calls at 20 qps took %lld ms\n", took);
+        check(took >= 200, "the token bucket spaces calls at the configured rate");
+    }
+
+    // 6. Hedging
+    {
+        cc::http::HttpClient hedged;
+        hedged.setRetries(0);
+        cc::http::HedgePolicy hp;
+        hp.percentile = 0.9;
+        hp.minSamples = 10;
+        hp.minDelay   = cc::time::Millis{20};
+        hedged.setHedging(hp);
+
+        cc::http::LimiterPolicy one;
+        one.maxInFlight = 1;
+        limiters.configure(origin, one);
+        for (int i = 0; i < 15; ++i) hedged.get(base + "/ok");
+
+        slowNext = true;
+        const auto t0 = TestClock::now();
+        const auto r = hedged.get(base + "/hang");
+        const auto took = ms_since(t0);
+        std::printf("hedged GET with maxInFlight=1 took %lld ms\n", took);
+        check(r.isSuccess() && took >= 350 && counter("http.hedge.fired") == 0 &&
+              counter("http.hedge.throttled") == 1,
+              "a hedge is not fired when the origin has no free slot");
+
+        auto two = one;
+        two.maxInFlight = 2;
+        limiters.configure(origin, two);
+        slowNext = true;
+        const auto h = hedged.get(base + "/hang");
+        for (int i = 0; i < 40 && snapshot_of(origin).inFlight > 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(25));
+        }
+        check(h.isSuccess() && counter("http.hedge.fired") == 1 && snapshot_of(origin).inFlight == 0,
+              "a hedge with a free slot fires and returns its slot");
+    }
+
+    return cc::testing::checks_result();
+}
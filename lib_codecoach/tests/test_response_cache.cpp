@@ -0,0 +1,117 @@
+// test_response_cache.cpp — ResponseCache + HttpClient::setResponseCache contra
+// support/mock_http_server.h:
+//   1. Revalidación: una entrada vencida sale con If-None-Match; el 304 devuelve el body
+//      guardado y sus headers (Cache-Control nuevo) se fusionan en la entrada.
+//   2. Cache-Control: no-store en la respuesta, o no-cache en el request, no pasan por la caché.
+//   3. Credenciales (también como header default del cliente) no se guardan ni se sirven.
+//   4. Un PUT exitoso invalida la URL; requestAsync() usa la misma caché.
+// Devuelve != 0 si falla.
+
+#include "http/http_client.h"
+#include "http/response_cache.h"
+#include "logging/logger.h"
+
+#include "support/mock_http_server.h"
+#include "support/test_check.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+using cc::testing::check;
+using cc::testing::counter;
+
+int main() {
+    cc::logging::LogConfig lc;
+    lc.min_level = cc::logging::Level::Error;
+    cc::logging::Logger::init(lc);
+
+    std::atomic<int> docHits{0}, conditional{0}, privateHits{0}, freshHits{0};
+    cc::testing::MockHttpServer server([&](const cc::testing::MockRequest& req) {
+        cc::testing::MockResponse r;
+        if (req.target == "/doc") {
+            ++docHits;
+            if (req.header("If-None-Match") == "\"v1\"") {
+                ++conditional;
+                r.status  = 304;
+                r.headers = {{"ETag", "\"v1\""}, {"Cache-Control", "max-age=60"}};
+                return r;
+            }
+            r.headers = {{"ETag", "\"v1\""}, {"Cache-Control", "no-cache"}};
+            r.body    = "document v1";
+        } else if (req.target == "/private") {
+            ++privateHits;
+            r.headers = {{"Cache-Control", "no-store"}};
+            r.body    = "secret";
+        } else {
+            if (req.method == "GET") ++freshHits;
+            r.headers = {{"Cache-Control", "max-age=60"}};
+            r.body    = "fresh";
+        }
+        return r;
+    });
+    const std::string base = server.base_url();
+
+    auto cache = std::make_shared<cc::http::ResponseCache>();
+    cc::http::HttpClient client;
+    client.setRetries(0);
+    client.setResponseCache(cache);
+
+    // 1. 304
+    {
+        const auto first  = client.get(base + "/doc");
+        const auto second = client.get(base + "/doc");
+        check(first.isSuccess() && second.statusCode == 200 && second.body == "document v1" &&
+              docHits.load() == 2 && conditional.load() == 1,
+              "a stale entry is revalidated and the 304 returns the stored body");
+        check(counter("http.cache.revalidated") == 1, "revalidations are counted");
+        const auto third = client.get(base + "/doc");
+        check(third.body == "document v1" && docHits.load() == 2,
+              "the 304's Cache-Control is merged into the entry (fresh afterwards)");
+    }
+
+    // 2. no-store / no-cache
+    {
+        client.get(base + "/private");
+        const auto r = client.get(base + "/private");
+        check(r.body == "secret" && privateHits.load() == 2, "no-store responses are not cached");
+
+        const cc::http::HeaderMap noCache{{"Cache-Control", "no-cache"}};
+        client.get(base + "/fresh");
+        client.request("GET", base + "/fresh", {}, noCache);
+        check(freshHits.load() == 2, "a request with Cache-Control: no-cache goes to the origin");
+        client.get(base + "/fresh");
+        check(freshHits.load() == 2, "a fresh entry is served without a request");
+    }
+
+    // 3. Credenciales
+    {
+        cc::http::HttpClient authed;
+        authed.setRetries(0);
+        authed.setResponseCache(cache);
+        authed.setDefaultHeader("Authorization", "Bearer test");
+        const auto before = freshHits.load();
+        authed.get(base + "/fresh");
+        authed.get(base + "/fresh-authed");
+        authed.get(base + "/fresh-authed");
+        check(freshHits.load() == before + 3, "default Authorization bypasses cached entries");
+        client.get(base + "/fresh-authed");
+        check(freshHits.load() == before + 4, "responses fetched with credentials are not stored");
+
+        const cc::http::HeaderMap auth{{"Authorization", "Bearer test"}};
+        client.request("GET", base + "/fresh", {}, auth);
+        check(freshHits.load() == before + 5, "per-call Authorization bypasses the cache");
+    }
+
+    // 4. Invalidación y async
+    {
+        const auto before = freshHits.load();
+        client.put(base + "/fresh", "{}");
+        client.get(base + "/fresh");
+        check(freshHits.load() == before + 1, "a successful PUT invalidates the URL");
+        const auto r = client.requestAsync("GET", base + "/fresh").get();
+        check(r.body == "fresh" && freshHits.load() == before + 1, "requestAsync serves fresh entries too");
+    }
+
+    return cc::testing::checks_result();
+}